@@ -0,0 +1,11 @@
+#define DEFINE_SHADERS(X) \
+    X(example_pass_through_vert) \
+    X(example_simple_vert) \
+    X(example_rounded_cube_vert) \
+    X(example_phong_frag) \
+    X(example_bezier_surface_cubic_tesc) \
+    X(example_bezier_surface_cubic_tese) \
+    X(example_bezier_surface_quadratic_tesc) \
+    X(example_bezier_surface_quadratic_tese) \
+    X(synth_stereo_comp) \
+
@@ -0,0 +1,19 @@
+#define DEFINE_SHADERS(X) \
+    X(sculptor_pass_through_vert) \
+    X(bezier_line_cubic_sculptor_vert) \
+    X(bezier_surface_cubic_sculptor_tesc) \
+    X(bezier_surface_cubic_sculptor_tese) \
+    X(sculptor_object_frag) \
+    X(sculptor_edge_color_frag) \
+    X(sculptor_patch_indices_comp) \
+    X(sculptor_patch_cull_comp) \
+    X(sculptor_patch_tess_comp) \
+    X(sculptor_tessellated_vert) \
+    X(sculptor_patch_task) \
+    X(sculptor_patch_mesh) \
+    X(sculptor_grid_vert) \
+    X(sculptor_grid_frag) \
+    X(sculptor_vertex_select_vert) \
+    X(sculptor_vertex_cull_comp) \
+    X(sculptor_vertex_select_frag) \
+
@@ -0,0 +1,233 @@
+#pragma once
+const uint8_t toolbar[3677] = {
+    0x89,0x50,0x4e,0x47,0x0d,0x0a,0x1a,0x0a,0x00,0x00,0x00,0x0d,0x49,0x48,0x44,0x52,
+    0x00,0x00,0x02,0x58,0x00,0x00,0x00,0x18,0x08,0x06,0x00,0x00,0x00,0x26,0xa1,0x83,
+    0x99,0x00,0x00,0x00,0x01,0x73,0x52,0x47,0x42,0x00,0xae,0xce,0x1c,0xe9,0x00,0x00,
+    0x0e,0x17,0x49,0x44,0x41,0x54,0x78,0x5e,0xed,0x5d,0x4d,0x92,0x64,0xc5,0x0d,0x9e,
+    0x3e,0x82,0x59,0xf8,0x28,0x80,0xed,0x20,0x02,0x76,0x10,0xd8,0xe6,0x40,0xb3,0x9e,
+    0x03,0x81,0x4d,0xc0,0xce,0x44,0x10,0x04,0xd8,0x47,0xf1,0x02,0x1f,0xa1,0x09,0xb5,
+    0x47,0x1d,0x42,0x23,0xe9,0xfb,0xa4,0xcc,0x57,0x5d,0x35,0xf5,0x66,0x33,0x55,0xf5,
+    0x32,0x95,0x4a,0xfd,0x7e,0xa9,0xcc,0x7c,0xfd,0xf0,0xea,0xfc,0x77,0x97,0x12,0xf8,
+    0xee,0xbb,0x7f,0x7c,0xfa,0xc5,0x17,0x7f,0xfb,0x81,0x99,0x7c,0xa7,0xad,0xa7,0x37,
+    0xe9,0x3b,0xe9,0xc3,0xcc,0xe3,0x6c,0x73,0x4a,0xe0,0x94,0xc0,0x29,0x81,0xa3,0x24,
+    0x70,0xc6,0xad,0xa3,0x24,0x7b,0xbb,0x74,0x1f,0x6e,0x97,0xf5,0xf7,0x93,0x73,0x71,
+    0xd2,0x0f,0xfe,0xf0,0xc1,0xbf,0x26,0xb3,0xfb,0xf5,0x7f,0xbf,0x7e,0xc6,0x82,0xa6,
+    0x7f,0xff,0xf2,0xd3,0x23,0xd3,0x5e,0xf9,0xf9,0xe8,0xe3,0xbf,0xb4,0x6d,0x45,0xc6,
+    0xd0,0x79,0xb0,0xfd,0x27,0x7d,0x64,0x0c,0xe1,0x93,0x91,0x19,0x2b,0x1f,0x86,0xd6,
+    0xd9,0xe6,0x94,0xc0,0x29,0x81,0x53,0x02,0x1a,0x7f,0x24,0x6e,0x33,0x31,0x75,0x22,
+    0x31,0x9b,0x17,0x8e,0x1a,0x63,0xc2,0xd7,0x4b,0xf4,0xb1,0x39,0x22,0x1b,0x5f,0x64,
+    0x24,0xcf,0x34,0x97,0xfa,0xef,0x6c,0x3e,0x5a,0x9d,0x5f,0x99,0x34,0x57,0x92,0xfd,
+    0xa5,0x26,0xb0,0x2a,0x80,0x95,0xfe,0x95,0xa2,0x27,0x4e,0xa0,0xf2,0xfe,0xfa,0x9b,
+    0x6f,0x9f,0xd8,0xfa,0xea,0xef,0x5f,0xbe,0xfa,0xf0,0x8f,0x35,0x6e,0xf8,0xcf,0x7f,
+    0x7f,0x78,0x65,0xdb,0xb3,0xe3,0x2a,0xef,0x48,0x4f,0x6c,0xbb,0xa8,0x72,0x65,0x81,
+    0xa2,0x1a,0x38,0x92,0xb7,0xef,0x53,0x01,0x22,0x5d,0x31,0x76,0xec,0x94,0x95,0x8f,
+    0x0d,0x9a,0x88,0xe7,0xe8,0x39,0x92,0xab,0xf6,0x51,0xf9,0xa2,0x80,0xf0,0x52,0x01,
+    0xc2,0xf3,0x39,0x91,0x85,0xef,0x13,0xc9,0x86,0x09,0x9a,0xec,0xd8,0x2f,0x41,0x3f,
+    0xe2,0xad,0x63,0x97,0x8c,0x8c,0x90,0x8f,0xb1,0xf2,0x91,0x76,0x95,0x7d,0xfa,0xc5,
+    0x4a,0xe6,0x83,0x6c,0xbb,0x88,0x6f,0xfb,0xdb,0xd1,0xf4,0x59,0xb9,0x4c,0x17,0x5f,
+    0x36,0x6e,0x4b,0xcc,0xee,0xc4,0x18,0x96,0x37,0xf1,0x0f,0xd5,0x99,0xfd,0xcc,0xf6,
+    0x67,0xdb,0xb1,0x7e,0xc8,0xc6,0xb7,0xca,0x07,0x26,0x72,0x12,0xfe,0x34,0xdf,0x45,
+    0x73,0x12,0xf9,0x57,0xf6,0x3d,0xcd,0x67,0xac,0xfc,0x7c,0xbb,0x14,0x60,0xf9,0x64,
+    0xcf,0x0e,0x80,0x26,0x88,0x02,0x11,0xab,0x38,0x96,0x1f,0xdf,0xce,0x26,0xb4,0xa9,
+    0x43,0xd9,0xa4,0x53,0x05,0xf3,0xae,0x01,0x79,0xe3,0xe9,0x02,0x2c,0x05,0x65,0x8c,
+    0x0c,0x19,0x39,0x58,0xe7,0x60,0x68,0x66,0xb2,0x46,0x01,0xdd,0xf6,0x63,0x2b,0x58,
+    0xca,0x1b,0x0b,0xdc,0x3c,0x6f,0x48,0xf7,0x97,0xb0,0xff,0x49,0xa0,0xbc,0x74,0x80,
+    0x60,0x6c,0x3d,0xf3,0x81,0x7b,0xfa,0x3d,0x03,0x3f,0x5e,0x06,0x7e,0x1b,0xc9,0x7f,
+    0x67,0xf5,0x3b,0xf1,0x4d,0xb6,0x8f,0x4f,0xb2,0x99,0xef,0xb3,0xed,0xaa,0xb8,0xc0,
+    0x24,0x43,0xed,0xcf,0xc6,0x20,0x16,0x24,0x4c,0x40,0x6d,0xa6,0x67,0x9b,0xf4,0x77,
+    0x83,0x2c,0xbf,0x8b,0xc0,0xee,0x3e,0x74,0x73,0x24,0x1b,0xf3,0x64,0x7e,0x8c,0x2e,
+    0x50,0x8c,0xee,0x56,0xfc,0x18,0x70,0x25,0x7a,0xc8,0xf8,0xd3,0x78,0x7b,0xc9,0xad,
+    0xdc,0x10,0x60,0xb1,0x82,0xf6,0x0a,0x94,0x89,0x55,0x13,0x8c,0x14,0x3e,0x75,0xd2,
+    0xae,0xf1,0xd8,0x44,0x61,0xfb,0x32,0x86,0x92,0x8d,0x95,0x25,0x48,0x75,0x80,0x1d,
+    0x06,0xa4,0x80,0x35,0xe3,0xc1,0xa3,0x79,0xd6,0xf8,0x8f,0x06,0x58,0x13,0x23,0xb6,
+    0x15,0x29,0x54,0xb9,0xea,0xca,0xd6,0x3a,0x3b,0xea,0x7b,0x09,0xfb,0x3f,0x52,0x3e,
+    0x53,0xdf,0xa8,0xfa,0x55,0xb6,0x7e,0x4f,0x40,0x8a,0x01,0xc5,0x59,0x62,0x11,0xbb,
+    0xb3,0xb2,0xd2,0x38,0xa1,0x72,0xd7,0xe7,0x68,0x0c,0x9b,0x70,0x51,0x5b,0xa5,0xdd,
+    0xed,0xc3,0x02,0x3d,0xb6,0x5d,0x06,0xb2,0x50,0xfc,0x9d,0xd2,0xef,0xf8,0xc0,0x74,
+    0x8c,0x2a,0x4e,0xec,0x04,0x59,0x1e,0x50,0x79,0xc0,0xd5,0x99,0x2b,0xca,0x65,0x08,
+    0xc4,0x74,0x17,0xf1,0x68,0x01,0xec,0x7d,0xa2,0xe2,0x0f,0xcd,0x13,0xed,0x02,0xa8,
+    0xad,0x4d,0x62,0x2f,0x1a,0x3b,0x7b,0xfe,0x0e,0xc0,0x5a,0x4d,0x2e,0xac,0x02,0xd8,
+    0xf2,0x79,0xb7,0x0a,0x64,0x27,0x7a,0xf4,0x18,0x28,0xe9,0xd8,0x40,0x8b,0x2a,0x26,
+    0xc2,0x37,0x63,0xdc,0x48,0xd1,0xd7,0x00,0xb0,0x26,0x06,0x6c,0xfb,0x54,0xfd,0xbb,
+    0x32,0x15,0x79,0xf9,0x84,0x57,0x01,0xac,0x4b,0xd8,0x3f,0x9b,0x14,0xad,0xae,0x6d,
+    0x1f,0x46,0xbe,0xac,0xed,0xcb,0x18,0x8c,0x8f,0x21,0x5b,0x8f,0x12,0xe8,0x3d,0x01,
+    0xaf,0x08,0xc8,0xd8,0xdf,0xe4,0xb3,0xc6,0x00,0xd1,0x8d,0xfd,0xae,0xbe,0xaf,0x7a,
+    0xa8,0xec,0x23,0xaa,0x66,0x20,0x90,0xb2,0xd2,0xa7,0xb2,0x8d,0x89,0x2f,0x7a,0x39,
+    0x1d,0x45,0x1f,0xc5,0x49,0xcf,0x87,0x7c,0x47,0x72,0x8c,0x6c,0x1c,0x6d,0x57,0x75,
+    0x69,0x46,0x7c,0x47,0xf6,0x30,0x89,0x21,0x99,0x4c,0x6c,0x3c,0x61,0x72,0x50,0x27,
+    0xc7,0xec,0x04,0x58,0x48,0xd6,0xf6,0xa8,0x8c,0x97,0xbb,0x95,0xd7,0x4e,0xd9,0x21,
+    0x3b,0xfb,0x1d,0xc0,0xda,0x91,0x5c,0x58,0x80,0xa5,0x8c,0x55,0x15,0x2c,0x9b,0x24,
+    0x98,0x24,0x10,0x39,0x8d,0xef,0xb7,0x52,0x31,0xab,0x4a,0xcf,0x76,0x1c,0x9f,0x0c,
+    0x51,0xc5,0xc4,0xca,0x22,0x32,0xa2,0xaa,0x8a,0x35,0xad,0x60,0x59,0xd9,0xa2,0x2d,
+    0x00,0x46,0xf6,0x6c,0xf5,0xc9,0x03,0x60,0x49,0x3a,0x1e,0x30,0x64,0x00,0x62,0x12,
+    0xd0,0x7d,0x9f,0x8a,0xc6,0x25,0xec,0x9f,0x01,0x47,0xde,0x69,0x7d,0x1f,0x26,0x40,
+    0xf8,0x36,0x95,0x2f,0x4d,0xe8,0x59,0x9b,0xbd,0x27,0x20,0xc5,0x80,0x1f,0x9b,0x54,
+    0xd4,0xf7,0x55,0x5e,0xfe,0xbb,0xfc,0xae,0xab,0x78,0xd5,0x73,0x36,0x86,0x07,0x4a,
+    0x0a,0xcc,0xd0,0x79,0xaa,0xa8,0x72,0xc6,0x24,0x7e,0x54,0xd9,0x41,0xcf,0x51,0xf2,
+    0x41,0xfd,0xd1,0x73,0x44,0x1f,0x3d,0x9f,0xe6,0x17,0x9b,0x67,0x3e,0xff,0xfc,0xaf,
+    0xcf,0x17,0x92,0x5e,0xbf,0x7e,0xfd,0xea,0xcd,0x9b,0x37,0xcf,0xc3,0x7e,0xff,0xfd,
+    0x3f,0xe9,0x4b,0x47,0x15,0xaf,0x27,0xc0,0xc2,0xc5,0x07,0xdd,0x3d,0xcb,0xf0,0x87,
+    0x07,0x91,0x8c,0xfd,0x23,0xfb,0x61,0x9e,0x3f,0x03,0xac,0x5d,0xc9,0xa5,0x0b,0xb0,
+    0xa4,0x3d,0x4a,0xf6,0x9d,0xc4,0x8a,0xda,0xaa,0xd3,0x32,0xa0,0x21,0x5a,0xb1,0x30,
+    0x67,0xae,0x32,0x20,0x86,0x94,0x9a,0xad,0x1e,0xaa,0x3d,0x65,0xe1,0xd1,0xef,0xff,
+    0xa3,0x71,0xbc,0xcc,0x23,0x59,0x74,0x82,0x8f,0x9d,0x2f,0x33,0xb6,0x26,0x06,0x95,
+    0x2f,0x3a,0xa7,0x62,0xf9,0x45,0x2b,0x22,0xa5,0xa9,0xc0,0xcd,0x83,0xdb,0xcc,0x3e,
+    0x2e,0x61,0xff,0x0c,0x90,0x61,0x6c,0x0e,0xd1,0x41,0x89,0xd8,0xf7,0x97,0xef,0xc8,
+    0x1f,0xce,0x0a,0xd6,0xff,0x35,0xd3,0x01,0x3f,0xcc,0xc2,0xc1,0xca,0x5e,0x2b,0x5b,
+    0xd1,0xb6,0x49,0xa4,0x53,0xf5,0x8b,0xea,0x90,0x78,0x44,0x0b,0xd9,0x8f,0x5f,0xa8,
+    0x56,0xf1,0x01,0xd9,0x4d,0x95,0x84,0x98,0xc5,0xce,0x0a,0x7d,0x66,0x6c,0x69,0xd3,
+    0x19,0x23,0xe3,0xf9,0xf1,0xf1,0xf1,0x51,0x01,0xd6,0xc3,0xc3,0xc3,0x3b,0x79,0xb5,
+    0x33,0x86,0xe5,0x3b,0xd3,0x3b,0xe3,0xb3,0x0c,0x00,0x88,0x62,0x41,0x55,0x29,0xea,
+    0xe4,0x77,0xe5,0xb1,0xe2,0xa3,0xb3,0x45,0xb8,0x52,0xc1,0xb2,0xbe,0x38,0x59,0xe4,
+    0x32,0xb2,0x8c,0xda,0x3c,0x1b,0x42,0x55,0x9d,0xa9,0x88,0x67,0x15,0x17,0x36,0xd1,
+    0xb2,0x8c,0x67,0x86,0x16,0x25,0xa4,0xa9,0x31,0x23,0x5e,0xaa,0x24,0x23,0x63,0x56,
+    0x95,0x2a,0x26,0xa8,0x4d,0x00,0x96,0x8e,0x5b,0x95,0x47,0xb3,0x79,0x55,0x60,0x13,
+    0x81,0x5e,0x1f,0x84,0xf5,0x3b,0x0b,0x80,0xaa,0xdb,0x82,0xa8,0x82,0x85,0xf4,0x64,
+    0x83,0x66,0x94,0xe4,0x22,0x3d,0x1d,0x6d,0xff,0x56,0xd6,0xc2,0x5f,0x76,0x7d,0x98,
+    0xb9,0x2d,0x88,0x02,0x44,0x14,0x7c,0xad,0xfd,0x79,0x5b,0x64,0x7c,0x6b,0x2a,0x9f,
+    0x48,0x57,0xd5,0x22,0x85,0xd1,0x2d,0x6a,0x73,0x4b,0xf4,0x85,0x57,0x5f,0xb9,0xca,
+    0x2a,0x16,0x68,0xde,0x1d,0x59,0xb3,0xf1,0x39,0xab,0x22,0xed,0xaa,0x2e,0x1d,0x4d,
+    0x3f,0x92,0x49,0x67,0xf1,0x18,0x81,0x1d,0x89,0xb5,0x52,0xa9,0xb2,0x40,0x2a,0x03,
+    0x58,0xfa,0xfb,0xe4,0x4c,0x96,0xe5,0x33,0xd3,0xfd,0x4a,0xae,0x8b,0xe2,0x48,0x96,
+    0x83,0xec,0xf8,0xb7,0xbe,0x45,0x88,0xe2,0xe7,0xc4,0xcf,0xb2,0x3e,0xbf,0x03,0x58,
+    0x08,0xb9,0x7a,0x22,0xb6,0x2c,0x37,0x51,0x40,0x77,0x22,0x08,0xb5,0x33,0x89,0xa2,
+    0x3b,0xa6,0x6d,0x8f,0x56,0xf1,0xd5,0x8a,0xec,0x28,0x80,0xa5,0x01,0x5a,0x12,0xf6,
+    0xca,0x05,0x03,0xeb,0xa8,0xde,0xb1,0x51,0x30,0xbe,0x54,0x05,0x4b,0xab,0x52,0x8c,
+    0x0e,0xa3,0xad,0x47,0xe9,0x97,0xe9,0x88,0x09,0x2c,0x2b,0xf6,0xcf,0xe8,0x3f,0x5a,
+    0x2c,0x44,0xb2,0xaf,0x02,0x04,0x13,0x94,0x27,0xc1,0x1a,0xd9,0x3e,0xcb,0xfb,0xbd,
+    0xd0,0x89,0x74,0xe4,0x7f,0x53,0x59,0x68,0xe5,0x4a,0x64,0x28,0x76,0x9b,0x01,0xac,
+    0xae,0x2d,0x74,0x65,0x5d,0x81,0x91,0x28,0x3e,0xac,0x24,0x77,0xbf,0x40,0x3b,0x8a,
+    0xbe,0x9f,0xd3,0x0e,0x70,0x25,0x34,0xbb,0x00,0x4b,0xfa,0x20,0x90,0x95,0xf9,0x2e,
+    0x3a,0xc2,0x61,0xe7,0xd8,0xd1,0xc9,0xbd,0x02,0xac,0x49,0x2c,0x66,0x72,0x4e,0xd4,
+    0xe6,0xa6,0x00,0x16,0x02,0x50,0x08,0x80,0x4d,0x85,0xa4,0xfd,0x98,0x80,0x55,0x25,
+    0x70,0x06,0xa8,0x74,0x2a,0x82,0x96,0x1f,0xb6,0xe2,0x14,0xad,0xc8,0xe4,0xb7,0x0c,
+    0x60,0xb1,0x0e,0x3b,0x59,0x15,0x54,0x95,0x2a,0xbb,0xed,0x51,0x01,0xd7,0x4a,0xa7,
+    0x91,0x3d,0xbc,0x14,0xc0,0xda,0x29,0x9f,0x2a,0x40,0x44,0xcf,0xbc,0xdf,0x64,0x7e,
+    0xd2,0xa5,0x2b,0xb2,0x67,0x7c,0xa2,0xb3,0x48,0x79,0x5f,0x80,0x5a,0x07,0x60,0x59,
+    0xa0,0xd5,0x05,0x58,0x3b,0x75,0x96,0xf9,0x92,0xaf,0x32,0xed,0xaa,0x5e,0xd9,0xb8,
+    0x2a,0x9f,0x35,0x3e,0xee,0xa6,0xef,0xc1,0x9c,0x8f,0x77,0x28,0x2f,0xa8,0xff,0xd8,
+    0xd8,0x6c,0xcf,0x5a,0x69,0x7f,0x7f,0x06,0xcb,0xfe,0xae,0x9f,0x23,0x90,0x55,0x81,
+    0xbe,0x8e,0x7e,0x3b,0xe0,0xb1,0xf2,0x5b,0x54,0x68,0xb9,0xc5,0x0a,0x96,0xf5,0xc7,
+    0x13,0x60,0x25,0x16,0x7f,0xcd,0x00,0x2b,0x62,0xd9,0x5f,0xc9,0x3e,0x02,0x60,0xa1,
+    0x71,0x51,0xf0,0xb0,0xd5,0xa7,0x15,0x5a,0x3b,0x01,0x84,0xa7,0x75,0xaf,0x00,0xab,
+    0x0b,0x5e,0x32,0xff,0xf0,0x80,0x8a,0x6d,0x77,0x8f,0xc0,0xa8,0xb3,0x98,0xaa,0xe4,
+    0xc3,0x02,0x2c,0xdd,0x12,0xb6,0x15,0xd7,0x4e,0x05,0xab,0x93,0x80,0xd1,0xdc,0xb2,
+    0x58,0x11,0x55,0x56,0xd8,0x85,0x17,0x8a,0x3f,0xf2,0xfc,0x68,0xfa,0x7e,0x8c,0x0e,
+    0xef,0x11,0xb8,0x62,0xe6,0x54,0xb5,0xf1,0x20,0x6b,0xa2,0xc3,0x6a,0x71,0x83,0x9e,
+    0x55,0xb1,0x1a,0xe5,0x03,0x9d,0x17,0xca,0x65,0xca,0x03,0x3a,0x32,0x72,0x57,0x67,
+    0xb0,0x10,0x72,0xf5,0x46,0x73,0xe9,0x2d,0xc2,0x6b,0x05,0x58,0x91,0x33,0x79,0xa7,
+    0x61,0x50,0xb3,0xb4,0xe9,0x54,0xb0,0x98,0x71,0x51,0x30,0xc8,0xca,0xd2,0x93,0x55,
+    0x1e,0xf3,0x2a,0x0a,0xcb,0x8f,0x8c,0x2d,0xb7,0x70,0xfc,0x6d,0x9b,0x5d,0x00,0x2b,
+    0xa2,0xbf,0xb3,0x82,0xf5,0xc9,0x27,0x7f,0xfa,0x4c,0xf9,0xff,0xf1,0xc7,0x9f,0x9f,
+    0x6f,0x13,0x45,0x2b,0x3c,0x46,0xff,0x5e,0x57,0xac,0x7c,0x6c,0xe2,0x8c,0x92,0x07,
+    0x9b,0xb0,0x2b,0xff,0xea,0x82,0xbd,0x7b,0x6c,0x5f,0xdd,0x1e,0x14,0x1d,0x45,0x37,
+    0x0a,0xed,0x19,0x2c,0x91,0xbf,0xb6,0xab,0xae,0x99,0x33,0xc0,0xb7,0x4a,0xb2,0x5d,
+    0x5b,0xbc,0x04,0x00,0x52,0x7e,0xe5,0x7f,0x26,0x79,0xa3,0xb8,0xe6,0xe3,0x8c,0x3d,
+    0xf3,0x38,0x89,0x53,0x7a,0x04,0x43,0xe9,0xee,0xac,0x60,0x5d,0x13,0xc0,0x42,0x72,
+    0xed,0x2c,0xa4,0x75,0x61,0x57,0xd1,0xbc,0x14,0xc0,0xf2,0xbb,0x3d,0x5d,0x1b,0x40,
+    0x72,0xc9,0x9e,0x9f,0x5b,0x84,0x0d,0xc9,0xa9,0x92,0x2a,0x94,0x6f,0xcb,0xdc,0x47,
+    0x57,0xb0,0x76,0x00,0xac,0x5d,0x2b,0xc8,0x8e,0xe3,0x29,0xdf,0x0a,0x20,0xe4,0xbb,
+    0x05,0x59,0xbb,0x01,0x96,0xa5,0x7f,0x04,0xc0,0x52,0xfa,0x0a,0xb2,0x76,0x03,0x2c,
+    0x24,0x1f,0xab,0xc3,0xe8,0x46,0x66,0x76,0x93,0x2c,0x03,0x63,0x2c,0x48,0x9b,0x24,
+    0xf1,0x7b,0x01,0x5e,0x6c,0x05,0xab,0x73,0xc8,0xbd,0xf3,0x3a,0x8c,0x89,0x6e,0xb2,
+    0x50,0x78,0xf4,0x16,0xa1,0x5d,0x20,0xec,0x06,0x58,0x9d,0x6d,0xb3,0x2a,0x15,0xf8,
+    0x4a,0xd6,0xce,0x33,0x58,0x68,0x8b,0xf0,0xc3,0x8f,0xfe,0xfc,0xcc,0x9a,0x8d,0x93,
+    0xde,0x97,0x98,0xb9,0x76,0xc1,0x35,0x0b,0xe6,0xb3,0x5c,0x74,0x2d,0x15,0x2c,0x3b,
+    0xef,0x15,0x19,0x34,0xe0,0xc2,0x53,0xd3,0x9b,0x02,0x58,0x7e,0xab,0xc3,0x4f,0x16,
+    0x55,0xb8,0xba,0xc2,0xf1,0xed,0x3b,0x8a,0x39,0xa2,0x82,0x35,0x01,0x76,0xec,0x9c,
+    0x19,0xe7,0x44,0x01,0xa8,0xbb,0x2a,0x50,0x80,0x25,0xb7,0x9a,0x1f,0x1f,0x1f,0x9f,
+    0x40,0x96,0x8c,0xa1,0xab,0x4d,0x4d,0x28,0xd3,0x2d,0xc2,0x8a,0xbe,0x07,0x11,0x59,
+    0xf5,0xb0,0x9a,0xb3,0x56,0xb0,0x2c,0xff,0x02,0xb2,0x22,0x80,0xb5,0x02,0x40,0x2d,
+    0xfd,0xea,0x8c,0x8e,0xde,0x28,0x65,0x75,0x1e,0xb5,0x53,0x1a,0x51,0x05,0x65,0x85,
+    0xae,0xed,0x7b,0x4b,0xb7,0xfc,0xa2,0x39,0x33,0x40,0xa7,0x0b,0xb0,0x74,0x9c,0x6b,
+    0x3b,0x83,0x15,0xf9,0xde,0xd4,0x1f,0x91,0xfd,0x78,0x20,0x87,0xda,0xa3,0xe7,0xab,
+    0x31,0x2d,0xcb,0x2f,0x47,0xdd,0x22,0xcc,0x76,0x13,0x04,0x60,0xc9,0xf9,0x2e,0xf9,
+    0xe7,0xdf,0xb3,0x65,0x6f,0x63,0xcb,0xf3,0x6a,0xfb,0x73,0x12,0x83,0x84,0xa6,0x56,
+    0x56,0xbb,0xf1,0xfd,0x9a,0x2a,0x58,0x76,0xee,0x9d,0x3c,0x8e,0x6c,0x0c,0x3d,0xbf,
+    0x19,0x80,0xc5,0x82,0x27,0x04,0xc2,0x90,0x40,0xaa,0xe7,0xef,0x6b,0x05,0x4b,0xe7,
+    0xbc,0x12,0xe0,0x26,0xce,0x6b,0x01,0x90,0xf0,0xe0,0x41,0x96,0x06,0x8b,0x69,0x40,
+    0xaf,0xe8,0xfb,0x60,0xb1,0x0a,0xb0,0x2c,0xff,0xd9,0x7b,0x8c,0xba,0x01,0x2a,0xe3,
+    0xdf,0xd3,0xa9,0x7c,0x63,0xb2,0xfd,0x10,0xf9,0xd0,0xae,0xca,0x53,0x66,0x27,0x2b,
+    0xf4,0xb3,0xe0,0xc9,0x04,0xd5,0x95,0x71,0x6d,0xac,0x88,0xaa,0x09,0x91,0x9e,0xec,
+    0x6f,0x36,0x9e,0x44,0x95,0xac,0x8a,0xbe,0x26,0x3e,0x9f,0x60,0xb5,0x8f,0x7d,0x6d,
+    0x4c,0xd4,0x86,0xdd,0x86,0xcb,0x62,0xc2,0x4a,0xac,0xc8,0x62,0xec,0x4e,0x9a,0xbb,
+    0xc1,0x95,0xf2,0x9c,0xc5,0xa2,0x23,0xde,0x83,0xa5,0x63,0x59,0x80,0x65,0x65,0x27,
+    0x60,0xab,0xf3,0x32,0xd3,0x49,0x8c,0x5e,0x01,0x23,0x55,0x41,0x00,0x2d,0xb8,0xbc,
+    0x8d,0xa0,0xf8,0xdc,0x79,0xd1,0xe8,0x44,0x0e,0x53,0xdc,0xb0,0x1d,0x60,0xa1,0xab,
+    0xa8,0x13,0x46,0x3b,0x09,0xb6,0xd3,0xb6,0xcb,0x4b,0xc7,0xd8,0x6e,0xad,0x82,0x25,
+    0xb2,0x58,0x09,0x70,0x13,0xa3,0xf5,0x00,0xc2,0x83,0x2c,0xfb,0xa7,0x45,0xd8,0xb7,
+    0xe1,0x5b,0x9d,0x56,0xf4,0x8f,0x00,0x58,0x96,0xff,0x88,0x3e,0x9b,0xd4,0x6c,0x30,
+    0x97,0x33,0x5e,0xe6,0xbd,0x85,0xcf,0x20,0x34,0x4a,0xd4,0xd9,0x8a,0xbb,0xba,0xe6,
+    0x9d,0xad,0x78,0x59,0xfb,0x65,0x00,0x8a,0x24,0x9f,0xcc,0xd7,0xf4,0x5d,0x42,0x0c,
+    0x9d,0x0c,0x70,0x08,0x7d,0x4d,0x34,0x6a,0x87,0x46,0xf7,0x4f,0x31,0x6e,0x95,0x7e,
+    0xc4,0xa7,0x8c,0x9b,0xf1,0xcf,0x56,0xb0,0xfc,0x21,0xf7,0xcc,0xce,0x23,0x00,0x87,
+    0xce,0xaf,0x44,0x73,0xee,0x2c,0x40,0xab,0x58,0x7a,0x44,0x9c,0x5d,0x89,0x3f,0xde,
+    0xef,0x57,0xce,0x5c,0xb1,0x79,0x41,0x6d,0x4c,0xdb,0x1f,0xf1,0x26,0x77,0x1d,0x43,
+    0x2b,0x58,0x3a,0x56,0x17,0x5c,0x75,0x72,0x97,0x82,0x77,0xf9,0xbf,0xbb,0x28,0xf4,
+    0x3e,0x8a,0xce,0x75,0x77,0x6e,0x24,0xae,0xbc,0x68,0xd4,0xce,0x7f,0x92,0xab,0x58,
+    0x9b,0xf0,0xed,0xb6,0x02,0xac,0xdd,0xe0,0x6a,0xba,0x0a,0x99,0xf6,0x43,0x42,0xec,
+    0x56,0xb0,0x3c,0x3d,0x94,0x60,0x33,0x94,0xce,0x1a,0x61,0x95,0x48,0xb2,0x00,0x24,
+    0xbf,0x47,0x5b,0x4b,0xfe,0x37,0x74,0xf3,0x66,0x62,0xb4,0x11,0x00,0x8a,0x40,0xca,
+    0x34,0x98,0xb3,0xf4,0x55,0x6e,0x28,0x18,0x78,0x7d,0xda,0x2d,0x42,0xfb,0x4c,0x2b,
+    0x71,0x0c,0x08,0xaa,0x6c,0x8e,0xe1,0x1f,0x55,0xaf,0xd0,0x96,0x41,0x96,0xa4,0x7d,
+    0x22,0x5e,0x01,0x28,0xde,0xf6,0xf4,0xc6,0xdc,0x5b,0xf0,0xb8,0x05,0x00,0xc9,0x18,
+    0xba,0xc5,0x2c,0x9f,0xf5,0x4f,0x98,0xec,0x02,0x70,0x42,0x53,0x68,0xa9,0x9d,0x2b,
+    0x68,0xb4,0xf4,0x57,0x0f,0xb9,0x57,0xe0,0xc7,0x27,0x08,0x04,0xae,0xa2,0x58,0xd0,
+    0x01,0x57,0xda,0x5f,0xfe,0x47,0xef,0x61,0x42,0x71,0x0d,0xc5,0x55,0x7d,0xbe,0x0b,
+    0x60,0x29,0x1d,0x14,0xb3,0x58,0xbe,0xb2,0x76,0x4c,0x55,0x65,0x87,0x6c,0xb4,0x3a,
+    0x26,0x7c,0xe8,0x16,0x61,0xa7,0x72,0x65,0x75,0x69,0xe7,0x52,0xe9,0x75,0x07,0xdf,
+    0x48,0x3e,0xc2,0x0b,0x9b,0xdb,0x10,0x2d,0x54,0xc1,0xb2,0xfe,0xd3,0x05,0x9b,0x2b,
+    0x76,0xb2,0x0d,0x60,0x75,0xc0,0x15,0x5b,0x3a,0xd4,0xe4,0x3f,0x45,0xd1,0x16,0x68,
+    0x31,0x42,0x42,0x46,0xd5,0x51,0x4c,0xa7,0xad,0x0d,0x30,0xd5,0x2d,0xc2,0x4a,0x6e,
+    0xd9,0xe1,0xfa,0x68,0xde,0x36,0xd0,0x5a,0x19,0xf9,0xf7,0xd0,0xf8,0x2d,0xba,0x4a,
+    0x3e,0xbb,0x00,0x56,0x04,0x4e,0x76,0x02,0xac,0x88,0xfe,0x4e,0x80,0x95,0xd1,0x3f,
+    0x4a,0x3e,0x6c,0x52,0xae,0x92,0x44,0xa4,0x57,0x0f,0xdc,0x76,0x02,0x2c,0x05,0x40,
+    0xd5,0x81,0x5d,0xeb,0x13,0xe8,0xcc,0x93,0xaf,0x24,0x68,0xdf,0xdd,0xf4,0x3d,0x80,
+    0x43,0x07,0x8e,0xd9,0x2d,0x42,0xc6,0xbe,0x55,0xfe,0x15,0xa0,0xf6,0x3a,0xf6,0x49,
+    0xa5,0x03,0x38,0x18,0x9e,0x98,0x36,0x4c,0xdc,0x3d,0x0a,0x60,0xa1,0x78,0xde,0xe1,
+    0x2d,0x6a,0xab,0xf3,0xcf,0x62,0x76,0x47,0xde,0x15,0x2f,0xb6,0x02,0xac,0x36,0xd7,
+    0xcd,0x2f,0x1e,0xa0,0x64,0xe7,0x44,0x85,0x8f,0x69,0xbe,0x8d,0xec,0x0f,0x2d,0x5a,
+    0x8f,0x02,0x58,0xba,0xd8,0xc9,0xfe,0x62,0xc6,0xd1,0xb6,0xa1,0xb2,0xd8,0x02,0xb0,
+    0x3a,0xe0,0x6a,0xd5,0xa8,0x5f,0xb2,0x7f,0xc7,0xa8,0x3b,0x6d,0x75,0x4e,0x99,0xc3,
+    0xb2,0x46,0xa8,0x40,0x01,0x19,0x8f,0xe7,0xcd,0xaf,0x1c,0xa3,0x95,0x24,0x9a,0xcf,
+    0x2a,0x80,0x10,0x60,0xa2,0x5b,0x61,0x6f,0x3f,0x2f,0xff,0x3d,0x2f,0x5b,0x01,0xaa,
+    0xe8,0xef,0x00,0x58,0x88,0xfe,0x51,0xf2,0xe9,0x2c,0x56,0x26,0xbe,0x83,0x80,0x7b,
+    0x17,0x78,0xa9,0x4e,0xfc,0x0a,0xbc,0x4b,0x27,0x6a,0x9f,0xd1,0xae,0xfc,0x82,0x1d,
+    0x57,0x93,0x9c,0xf0,0xed,0xab,0x63,0x11,0xfd,0x48,0xdf,0xfe,0x37,0x1d,0x9b,0xa9,
+    0x2c,0x69,0x1b,0xa6,0x72,0xe5,0xc1,0x29,0x43,0x3f,0x4a,0x8e,0xf2,0x1b,0x13,0x4b,
+    0x98,0x76,0xc8,0xf6,0x76,0xee,0x3a,0x44,0xf1,0x0b,0x8d,0x3f,0x7d,0x1e,0xc5,0xec,
+    0xdd,0xf9,0x50,0xc6,0xb0,0xc0,0xa7,0x03,0xb2,0xb3,0xc5,0xbb,0xcf,0x29,0x28,0xbe,
+    0x4f,0xe4,0x83,0xaa,0x4e,0x42,0x93,0xcd,0x6d,0x88,0x96,0x56,0xb0,0x32,0x7a,0xea,
+    0x7b,0x47,0xcc,0xb3,0x92,0xcd,0x32,0xc0,0x12,0xe2,0xbb,0x90,0xfa,0x44,0x89,0x97,
+    0xec,0xd3,0x51,0x4e,0xa7,0xad,0x9d,0x43,0x56,0x75,0x43,0x81,0xce,0x07,0xd5,0x4a,
+    0x2e,0x11,0xc0,0x8a,0xde,0xe4,0xce,0xbe,0x66,0xc2,0x26,0x79,0x96,0x4f,0x0d,0x1a,
+    0x9a,0xac,0x34,0x71,0xf9,0x1b,0x73,0x16,0x7c,0x4e,0x74,0xcd,0xd2,0x47,0x0e,0x1c,
+    0x8d,0xad,0x5b,0x84,0xf2,0x0c,0xf1,0x3f,0xb1,0x07,0x5b,0x99,0x41,0xf4,0x27,0xb2,
+    0xe9,0xf4,0x59,0x05,0x72,0xba,0xa2,0x8c,0xde,0x7b,0xa6,0x00,0xa5,0xc3,0x8f,0xb6,
+    0xb5,0xdb,0x72,0xaa,0x6b,0x79,0x66,0xff,0x4e,0xdc,0xa5,0xe8,0x5b,0xdb,0x67,0x01,
+    0x16,0x1b,0x3f,0x27,0xa0,0x41,0xfb,0x74,0xe3,0xb3,0xd7,0x35,0xda,0x22,0x54,0x5d,
+    0xb0,0xbe,0x9f,0x81,0x39,0xff,0xfb,0x6e,0x7a,0xc8,0xbe,0xa6,0xe3,0x59,0x90,0xb5,
+    0x1b,0x5c,0x09,0xcf,0x51,0x35,0x79,0xa2,0x53,0x5b,0x4d,0x52,0x20,0xe2,0xc1,0x1b,
+    0x92,0x51,0xe7,0x79,0x55,0xe1,0x53,0x70,0xc5,0xce,0x03,0xc5,0x67,0x99,0x8f,0xfc,
+    0x43,0xb6,0x3a,0xd5,0x71,0x67,0xde,0xb6,0xed,0xf2,0x1f,0x7b,0x66,0x05,0x34,0x65,
+    0xf0,0x9a,0xfa,0x75,0x93,0xcc,0x2e,0x65,0xee,0x1e,0xd7,0xae,0x68,0xb3,0xd5,0x10,
+    0xd3,0xc6,0x3a,0x7f,0x94,0xf0,0x2a,0xdd,0xf9,0x97,0x2e,0x4a,0x59,0xfa,0xed,0xa1,
+    0xe1,0xa7,0x6e,0xbe,0x8a,0x15,0x8d,0x85,0x6c,0xc3,0x26,0x5f,0x44,0xbf,0x2b,0x63,
+    0x3f,0x5f,0x96,0x3e,0x2a,0x5d,0xdb,0xe7,0x1d,0xfe,0x91,0x2c,0x5e,0xfa,0x79,0x55,
+    0x5d,0xda,0xc1,0x9b,0x3d,0x13,0xe5,0xcf,0x47,0xed,0xa0,0xaf,0xf6,0x77,0x04,0x40,
+    0x64,0xb6,0x64,0x56,0xec,0x93,0xa1,0x6f,0x65,0xa4,0x49,0x57,0x7f,0xcb,0xfa,0xb3,
+    0xed,0x90,0xfc,0x3d,0x1d,0x34,0xee,0x94,0x1e,0xea,0xd7,0x95,0x93,0x97,0xd9,0xe4,
+    0x22,0x0e,0xe2,0x49,0x9f,0xdb,0x05,0xda,0x64,0xb1,0x96,0xd9,0xcf,0xae,0x1c,0x95,
+    0xcd,0x23,0x2b,0x18,0x48,0xfb,0x0e,0x76,0x60,0xec,0x1f,0xc5,0xd6,0xa3,0xe7,0x1a,
+    0xc9,0xe0,0x19,0x60,0xb1,0x8a,0x3e,0xdb,0xdd,0xbe,0x04,0xbc,0xd1,0x47,0x86,0xce,
+    0xb4,0xb1,0xce,0xaf,0x9f,0x59,0x23,0x8e,0x56,0xd7,0xc1,0x96,0xde,0x3b,0xf6,0x99,
+    0x05,0xe3,0x48,0x2b,0xd1,0x19,0x18,0xbd,0x95,0x17,0x01,0xb8,0x55,0xcd,0x32,0xfc,
+    0xaf,0x8c,0x71,0x34,0xfd,0x15,0xde,0xaa,0xbe,0x97,0x02,0x57,0xf6,0x26,0x61,0xb4,
+    0x8d,0xb7,0x3a,0xbf,0xa3,0xe7,0xb1,0xca,0xdf,0xd9,0xff,0x65,0x25,0x30,0x39,0x06,
+    0xc0,0x72,0xbc,0x73,0x0b,0x95,0x1d,0xf3,0x6c,0xb7,0x2e,0x81,0x13,0x60,0xad,0xcb,
+    0xf0,0xa4,0xf0,0xb6,0x8c,0xdd,0x5d,0x01,0x66,0xdb,0x28,0x59,0x95,0x60,0x87,0xa0,
+    0x8f,0x4e,0x92,0xb7,0x4e,0x7f,0x87,0x8c,0x3d,0x0d,0xe6,0x35,0x0d,0x2b,0xe3,0xda,
+    0xd7,0x34,0x28,0x1d,0x03,0x46,0xb7,0xc5,0xb8,0xa3,0x75,0xbb,0x22,0x83,0xb3,0xef,
+    0x29,0x81,0x53,0x02,0xd7,0x27,0x81,0xdf,0x00,0x12,0x6d,0x71,0x81,0x09,0xa1,0xa5,
+    0x67,0x00,0x00,0x00,0x00,0x49,0x45,0x4e,0x44,0xae,0x42,0x60,0x82
+};
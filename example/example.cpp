@@ -3,11 +3,13 @@
 
 #include "example.h"
 
+#include "../gpu_synth.h"
 #include "../gui.h"
 #include "../host_filler.h"
 #include "../memory_heap.h"
 #include "../minivulkan.h"
 #include "../mstdc.h"
+#include "../sound.h"
 #include "../vmath.h"
 
 #include "example_shaders.h"
@@ -44,6 +46,9 @@ uint32_t check_device_features()
     missing_features += check_feature(&vk_features.features.fillModeNonSolid);
     missing_features += check_feature(&vk_dyn_rendering_features.dynamicRendering);
 
+    // Sound falls back to the CPU synth on devices without these features
+    check_gpu_synth_features();
+
     return missing_features;
 }
 
@@ -731,6 +736,8 @@ bool init_assets()
     if ( ! init_gui(GuiClear::preserve))
         return false;
 
+    set_gpu_synth_shader(shader_synth_stereo_comp);
+
     return true;
 }
 
@@ -16,3 +16,6 @@ shader_files += example_bezier_surface_cubic.tesc.glsl
 shader_files += example_bezier_surface_cubic.tese.glsl
 shader_files += example_bezier_surface_quadratic.tesc.glsl
 shader_files += example_bezier_surface_quadratic.tese.glsl
+
+# Shared shaders are found relative to the project directory
+shader_files += ../shaders/synth_stereo.comp.glsl
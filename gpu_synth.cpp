@@ -0,0 +1,487 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// The shader is passed to init(), only load_shader() is needed here
+#define DEFINE_SHADERS(X)
+
+#include "gpu_synth.h"
+
+#include "d_printf.h"
+#include "mstdc.h"
+#include "shaders.h"
+
+#include <stddef.h>
+
+namespace {
+    struct PushConstants {
+        uint32_t num_samples;
+        uint32_t base_freq;
+        uint32_t first_sample;
+        uint32_t num_generated;
+        uint32_t out_offs;
+        float    volume;
+        float    pan;
+    };
+
+    struct SpecializationConstants {
+        uint32_t out_format;
+        uint32_t local_size;
+    };
+
+    constexpr uint32_t frame_sizes[] = {
+        2 * sizeof(int16_t),    // SampleFormat::int16
+        2 * sizeof(float),      // SampleFormat::float32
+        2 * sizeof(int32_t)     // SampleFormat::int24
+    };
+}
+
+// After the device is created, only enabled features are set
+static bool has_gpu_synth_features()
+{
+    return vk_timeline_sem_features.timelineSemaphore      &&
+           vk_8b_storage_features.storageBuffer8BitAccess   &&
+           vk_16b_storage_features.storageBuffer16BitAccess &&
+           vk_shader_int8_features.shaderInt8               &&
+           vk_features.features.shaderInt16;
+}
+
+void check_gpu_synth_features()
+{
+    if ( ! has_gpu_synth_features())
+        return;
+
+    check_feature(&vk_timeline_sem_features.timelineSemaphore);
+    check_feature(&vk_8b_storage_features.storageBuffer8BitAccess);
+    check_feature(&vk_16b_storage_features.storageBuffer16BitAccess);
+    check_feature(&vk_shader_int8_features.shaderInt8);
+    check_feature(&vk_features.features.shaderInt16);
+}
+
+bool GpuSynth::is_available()
+{
+    return (vk_compute_queue != vk_queue) && has_gpu_synth_features();
+}
+
+uint32_t GpuSynth::get_frame_size() const
+{
+    return frame_sizes[static_cast<uint32_t>(format)];
+}
+
+bool GpuSynth::create_pipeline(uint8_t* shader)
+{
+    static const VkDescriptorSetLayoutBinding bindings[] = {
+        {
+            0, // binding 0: instrument
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            1, // binding 1: stereo frames
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        }
+    };
+
+    static const VkDescriptorSetLayoutCreateInfo create_set_layout = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        nullptr,
+        0, // flags
+        mstd::array_size(bindings),
+        bindings
+    };
+
+    VkResult res = CHK(vkCreateDescriptorSetLayout(vk_dev, &create_set_layout, nullptr, &desc_set_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static const VkPushConstantRange push_constant_range = {
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,                                  // offset
+        sizeof(PushConstants)               // size
+    };
+
+    static VkPipelineLayoutCreateInfo layout_create_info = {
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        nullptr,
+        0,      // flags
+        1,      // setLayoutCount
+        nullptr,
+        1,      // pushConstantRangeCount
+        &push_constant_range
+    };
+
+    layout_create_info.pSetLayouts = &desc_set_layout;
+
+    res = CHK(vkCreatePipelineLayout(vk_dev, &layout_create_info, nullptr, &pipe_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static const VkSpecializationMapEntry spec_map[] = {
+        {
+            0,                                                  // constantID
+            offsetof(SpecializationConstants, out_format),      // offset
+            sizeof(uint32_t)                                    // size
+        },
+        {
+            1,                                                  // constantID
+            offsetof(SpecializationConstants, local_size),      // offset
+            sizeof(uint32_t)                                    // size
+        }
+    };
+
+    static SpecializationConstants spec_constants;
+
+    static const VkSpecializationInfo spec_info = {
+        mstd::array_size(spec_map),     // mapEntryCount
+        spec_map,                       // pMapEntries
+        sizeof(spec_constants),         // dataSize
+        &spec_constants                 // pData
+    };
+
+    // Large work groups have fewer groups to schedule for each chunk
+    const VkPhysicalDeviceLimits& limits = vk_phys_props.properties.limits;
+    local_size = mstd::min(limits.maxComputeWorkGroupInvocations, limits.maxComputeWorkGroupSize[0]);
+
+    spec_constants.out_format = static_cast<uint32_t>(format);
+    spec_constants.local_size = local_size;
+
+    static VkComputePipelineCreateInfo pipeline_create_info = {
+        VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        nullptr,
+        0,                  // flags
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            nullptr,
+            0,              // flags
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_NULL_HANDLE, // module
+            "main",         // pName
+            &spec_info      // pSpecializationInfo
+        },
+        VK_NULL_HANDLE,     // layout
+        VK_NULL_HANDLE,     // basePipelineHandle
+        -1                  // basePipelineIndex
+    };
+
+    pipeline_create_info.stage.module = load_shader(shader);
+    pipeline_create_info.layout       = pipe_layout;
+
+    res = CHK(vkCreateComputePipelines(vk_dev,
+                                       VK_NULL_HANDLE,
+                                       1,
+                                       &pipeline_create_info,
+                                       nullptr,
+                                       &pipe));
+    return res == VK_SUCCESS;
+}
+
+bool GpuSynth::create_descriptor_sets()
+{
+    static const VkDescriptorPoolSize pool_sizes[] = {
+        {
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            2
+        }
+    };
+
+    static const VkDescriptorPoolCreateInfo pool_create_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        nullptr,
+        0, // flags
+        1, // maxSets
+        mstd::array_size(pool_sizes),
+        pool_sizes
+    };
+
+    static VkDescriptorSetAllocateInfo alloc_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        nullptr,
+        VK_NULL_HANDLE,     // descriptorPool
+        1,                  // descriptorSetCount
+        nullptr             // pSetLayouts
+    };
+
+    alloc_info.pSetLayouts = &desc_set_layout;
+
+    VkResult res = CHK(vkCreateDescriptorPool(vk_dev, &pool_create_info, nullptr, &alloc_info.descriptorPool));
+    if (res != VK_SUCCESS)
+        return false;
+
+    res = CHK(vkAllocateDescriptorSets(vk_dev, &alloc_info, &desc_set));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static VkDescriptorBufferInfo buffer_info[] = {
+        { VK_NULL_HANDLE, 0, VK_WHOLE_SIZE }, // instrument
+        { VK_NULL_HANDLE, 0, VK_WHOLE_SIZE }  // stereo frames
+    };
+
+    buffer_info[0].buffer = instrument_buf.get_buffer();
+    buffer_info[1].buffer = ring_buf.get_buffer();
+
+    static VkWriteDescriptorSet write_desc_set = {
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        nullptr,
+        VK_NULL_HANDLE,                             // dstSet
+        0,                                          // dstBinding
+        0,                                          // dstArrayElement
+        2,                                          // descriptorCount
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+        nullptr,                                    // pImageInfo
+        buffer_info,                                // pBufferInfo
+        nullptr                                     // pTexelBufferView
+    };
+
+    write_desc_set.dstSet = desc_set;
+
+    vkUpdateDescriptorSets(vk_dev,
+                           1,           // descriptorWriteCount
+                           &write_desc_set,
+                           0,           // descriptorCopyCount
+                           nullptr);    // pDescriptorCopies
+
+    return true;
+}
+
+bool GpuSynth::init(uint8_t* shader, SampleFormat new_format)
+{
+    // Drivers are not required to reject shaders using features which are not enabled
+    if ( ! has_gpu_synth_features()) {
+        d_printf("GPU synth requires timeline semaphores, 8-bit and 16-bit storage and integers\n");
+        return false;
+    }
+
+    format = new_format;
+
+    if ( ! instrument_buf.allocate(Usage::dynamic,
+                                   sizeof(Synth::Instrument),
+                                   VK_FORMAT_UNDEFINED,
+                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                   "synth instrument"))
+        return false;
+
+    if ( ! ring_buf.allocate(Usage::host_only,
+                             num_slots * chunk_frames * get_frame_size(),
+                             VK_FORMAT_UNDEFINED,
+                             VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                             "synth ring"))
+        return false;
+
+    if ( ! create_pipeline(shader))
+        return false;
+
+    if ( ! create_descriptor_sets())
+        return false;
+
+    static const VkSemaphoreTypeCreateInfo sem_type_info = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        nullptr,
+        VK_SEMAPHORE_TYPE_TIMELINE,
+        0                           // initialValue
+    };
+
+    static const VkSemaphoreCreateInfo sem_create_info = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        &sem_type_info
+    };
+
+    const VkResult res = CHK(vkCreateSemaphore(vk_dev, &sem_create_info, nullptr, &timeline_sem));
+    if (res != VK_SUCCESS)
+        return false;
+
+    set_vk_object_name(VK_OBJECT_TYPE_SEMAPHORE, timeline_sem, "synth timeline");
+
+    return allocate_command_buffers(&cmd_bufs, num_slots, vk_compute_queue_family_index);
+}
+
+bool GpuSynth::wait_for_chunk(uint64_t chunk)
+{
+    const uint64_t value = chunk + 1;
+
+    // Not static, the info refers to members and locals
+    const VkSemaphoreWaitInfo wait_info = {
+        VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        nullptr,
+        0,              // flags
+        1,              // semaphoreCount
+        &timeline_sem,  // pSemaphores
+        &value          // pValues
+    };
+
+    const VkResult res = CHK(vkWaitSemaphores(vk_dev, &wait_info, ~0ULL));
+    return res == VK_SUCCESS;
+}
+
+bool GpuSynth::start_note(const Synth::Instrument& instrument,
+                          uint32_t                 new_base_freq,
+                          uint32_t                 num_samples,
+                          float                    new_volume,
+                          float                    new_pan)
+{
+    assert(timeline_sem);
+
+    // The instrument buffer is still read by chunks of the previous note
+    if (num_submitted && ! wait_for_chunk(num_submitted - 1))
+        return false;
+
+    mstd::mem_copy(instrument_buf.get_ptr<Synth::Instrument>(), &instrument, static_cast<uint32_t>(sizeof(instrument)));
+    if ( ! instrument_buf.flush())
+        return false;
+
+    base_freq    = new_base_freq;
+    note_samples = num_samples;
+    volume       = new_volume;
+    pan          = new_pan;
+    next_sample  = 0;
+    num_read     = num_submitted;
+    read_pos     = 0;
+
+    return true;
+}
+
+bool GpuSynth::submit_chunk()
+{
+    const uint32_t slot       = static_cast<uint32_t>(num_submitted % num_slots);
+    const uint32_t slot_offs  = slot * chunk_frames;
+    const uint32_t num_gen    = mstd::min(chunk_frames, note_samples - next_sample);
+    const uint32_t num_groups = (num_gen + local_size - 1) / local_size;
+
+    // The slot was last used by chunk num_submitted - num_slots, which has already been read
+    const VkCommandBuffer cmd_buf = cmd_bufs.bufs[slot];
+
+    if ( ! reset_and_begin_command_buffer(cmd_buf))
+        return false;
+
+    const PushConstants push = {
+        note_samples,
+        base_freq,
+        next_sample,
+        num_gen,
+        slot_offs,
+        volume,
+        pan
+    };
+
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, pipe);
+    vkCmdBindDescriptorSets(cmd_buf,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            pipe_layout,
+                            0,          // firstSet
+                            1,          // descriptorSetCount
+                            &desc_set,
+                            0,          // dynamicOffsetCount
+                            nullptr);   // pDynamicOffsets
+    vkCmdPushConstants(cmd_buf, pipe_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+    vkCmdDispatch(cmd_buf, num_groups, 1, 1);
+
+    // Make the stereo frames available to the host once the semaphore is signaled
+    static const VkMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        nullptr,
+        VK_ACCESS_SHADER_WRITE_BIT, // srcAccessMask
+        VK_ACCESS_HOST_READ_BIT     // dstAccessMask
+    };
+
+    vkCmdPipelineBarrier(cmd_buf,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0,         // dependencyFlags
+                         1,         // memoryBarrierCount
+                         &barrier,  // pMemoryBarriers
+                         0,         // bufferMemoryBarrierCount
+                         nullptr,   // pBufferMemoryBarriers
+                         0,         // imageMemoryBarrierCount
+                         nullptr);  // pImageMemoryBarriers
+
+    VkResult res = CHK(vkEndCommandBuffer(cmd_buf));
+    if (res != VK_SUCCESS)
+        return false;
+
+    const uint64_t signal_value = num_submitted + 1;
+
+    // Not static, the submission refers to locals
+    const VkTimelineSemaphoreSubmitInfo timeline_info = {
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        nullptr,
+        0,                  // waitSemaphoreValueCount
+        nullptr,            // pWaitSemaphoreValues
+        1,                  // signalSemaphoreValueCount
+        &signal_value       // pSignalSemaphoreValues
+    };
+
+    const VkSubmitInfo submit_info = {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        &timeline_info,
+        0,                  // waitSemaphoreCount
+        nullptr,            // pWaitSemaphores
+        nullptr,            // pWaitDstStageMask
+        1,                  // commandBufferCount
+        &cmd_buf,
+        1,                  // signalSemaphoreCount
+        &timeline_sem       // pSignalSemaphores
+    };
+
+    res = CHK(vkQueueSubmit(vk_compute_queue, 1, &submit_info, VK_NULL_HANDLE));
+    if (res != VK_SUCCESS)
+        return false;
+
+    slot_frames[slot] = num_gen;
+    next_sample      += num_gen;
+    ++num_submitted;
+
+    return true;
+}
+
+uint32_t GpuSynth::render(void* frames, uint32_t num_frames)
+{
+    uint8_t* const out_frames   = static_cast<uint8_t*>(frames);
+    const uint32_t frame_size   = get_frame_size();
+    uint32_t       num_rendered = 0;
+
+    while (num_rendered < num_frames) {
+        // Keep the GPU busy with the following chunks while the oldest one is read
+        while (num_submitted - num_read < num_slots && next_sample < note_samples) {
+            if ( ! submit_chunk())
+                return num_rendered;
+        }
+
+        if (num_read == num_submitted)
+            break;
+
+        const uint32_t slot = static_cast<uint32_t>(num_read % num_slots);
+
+        if ( ! read_pos) {
+            if ( ! wait_for_chunk(num_read))
+                break;
+
+            if ( ! ring_buf.invalidate(slot, chunk_frames * frame_size))
+                break;
+        }
+
+        const uint32_t num_copied = mstd::min(num_frames - num_rendered, slot_frames[slot] - read_pos);
+
+        mstd::mem_copy(&out_frames[num_rendered * frame_size],
+                       ring_buf.get_ptr<uint8_t>(slot * chunk_frames + read_pos, frame_size),
+                       num_copied * frame_size);
+
+        num_rendered += num_copied;
+        read_pos     += num_copied;
+
+        if (read_pos == slot_frames[slot]) {
+            read_pos = 0;
+            ++num_read;
+        }
+    }
+
+    return num_rendered;
+}
+
+uint32_t GpuSynth::render_stream(void* user, Sample16Stereo* frames, uint32_t num_frames)
+{
+    assert(static_cast<GpuSynth*>(user)->format == SampleFormat::int16);
+    return static_cast<GpuSynth*>(user)->render(frames, num_frames);
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include "minivulkan.h"
+#include "resource.h"
+#include "sound.h"
+#include "synth.h"
+
+// Enables features required by the synth shaders, to be called from check_device_features().
+// The synth is optional, so features are only enabled if the device has all of them
+// and they are never reported as missing.
+void check_gpu_synth_features();
+
+// Renders notes with shaders/synth_stereo.comp.glsl on vk_compute_queue, so audio
+// is produced without stalling graphics submissions.
+//
+// A note is rendered in chunks, a few chunks are kept in flight and each chunk
+// signals a timeline semaphore when it is done.  Stereo frames are read back
+// from a host-visible ring with one slot per chunk in flight.
+//
+// After init(), only one thread may use the object, e.g. the sound producer thread.
+class GpuSynth {
+    public:
+        // Same values as format_* constants in the shader, frames are interleaved stereo
+        enum class SampleFormat : uint32_t {
+            int16,
+            float32,
+            int24       // 24-bit samples in low bits of 32-bit integers
+        };
+
+        // There is no point in rendering on the GPU if it competes with graphics on vk_queue,
+        // the CPU synth should be used instead, also if the device lacks required features
+        static bool is_available();
+
+        // The shader is compiled by the application, because shaders are built per project.
+        // The format should match the output, e.g. int16 for Sample16Stereo sound streams.
+        // Fails if the device lacks features enabled by check_gpu_synth_features().
+        bool init(uint8_t* shader, SampleFormat new_format);
+
+        // Waits until the previous note is no longer being rendered
+        bool start_note(const Synth::Instrument& instrument,
+                        uint32_t                 base_freq,
+                        uint32_t                 num_samples,
+                        float                    volume = 1,
+                        float                    pan    = 0.5f);
+
+        // Returns fewer frames than requested when the note ends or if rendering fails,
+        // frames are stored in the format selected in init()
+        uint32_t render(void* frames, uint32_t num_frames);
+        uint32_t get_frame_size() const;
+
+        // Can be used as SoundStreamConfig::render with SampleFormat::int16, with the synth as user
+        static uint32_t render_stream(void* user, Sample16Stereo* frames, uint32_t num_frames);
+
+        static constexpr uint32_t chunk_frames = 4096;
+        static constexpr uint32_t num_slots    = 4;
+
+    private:
+        bool create_pipeline(uint8_t* shader);
+        bool create_descriptor_sets();
+        bool submit_chunk();
+        bool wait_for_chunk(uint64_t chunk);
+
+        VkDescriptorSetLayout desc_set_layout = VK_NULL_HANDLE;
+        VkPipelineLayout      pipe_layout     = VK_NULL_HANDLE;
+        VkPipeline            pipe            = VK_NULL_HANDLE;
+        VkDescriptorSet       desc_set        = VK_NULL_HANDLE;
+        VkSemaphore           timeline_sem    = VK_NULL_HANDLE;
+        uint32_t              local_size      = 1;
+        SampleFormat          format          = SampleFormat::int16;
+
+        CommandBuffers<num_slots> cmd_bufs;
+
+        Buffer instrument_buf;
+        Buffer ring_buf;        // Stereo frames of each chunk in flight, read by the host
+
+        uint32_t base_freq      = 0;
+        uint32_t note_samples   = 0;
+        float    volume         = 1;
+        float    pan            = 0.5f;
+        uint32_t next_sample    = 0; // First sample of the note in the next submitted chunk
+        uint64_t num_submitted  = 0; // Chunk N signals value N + 1 of the timeline semaphore
+        uint64_t num_read       = 0; // Number of chunks completely read back
+        uint32_t read_pos       = 0; // Frames read from the oldest chunk in flight
+        uint32_t slot_frames[num_slots] = { };
+};
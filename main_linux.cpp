@@ -52,18 +52,6 @@ uint64_t get_current_time_ms()
     return time_ms;
 }
 
-bool load_sound_track(const void* data, uint32_t size)
-{
-    // TODO
-    return true;
-}
-
-bool play_sound_track()
-{
-    // TODO
-    return true;
-}
-
 static xcb_intern_atom_reply_t* intern_atom(xcb_connection_t* conn,
                                             const char*       str,
                                             uint16_t          str_size)
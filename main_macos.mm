@@ -9,6 +9,7 @@
 #include "minivulkan.h"
 #include "mstdc.h"
 #include "d_printf.h"
+#include "sound.h"
 #include <time.h>
 
 struct Window {
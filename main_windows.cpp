@@ -6,6 +6,7 @@
 #include "minivulkan.h"
 #include "d_printf.h"
 #include "mstdc.h"
+#include "sound.h"
 
 /* TODO Just including xaudio2.h somehow calls LoadLibraryEx - figure out how to avoid that */
 #include <xaudio2.h>
@@ -8,6 +8,7 @@
 #include "memory_heap.h"
 #include "mstdc.h"
 #include "resource.h"
+#include "sound.h"
 #include "vmath.h"
 #include "vulkan_extensions.h"
 
@@ -426,11 +427,14 @@ VkPhysicalDeviceProperties2 vk_phys_props = {
     &vk11_props
 };
 
-static const float queue_priorities[] = { 1 };
+static const float queue_priorities[] = { 1, 1 };
 
 static constexpr uint32_t no_queue_family = ~0u;
 
-uint32_t vk_queue_family_index = no_queue_family;
+uint32_t     vk_queue_family_index         = no_queue_family;
+VkQueueFlags vk_queue_flags                = 0;
+uint32_t     vk_compute_queue_family_index = no_queue_family;
+static uint32_t vk_compute_queue_index     = 0;
 
 VkSwapchainCreateInfoKHR swapchain_create_info = {
     VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
@@ -514,6 +518,25 @@ bool find_optimal_tiling_format(const VkFormat* preferred_formats,
     return false;
 }
 
+static void find_compute_queue(const VkQueueFamilyProperties* queues, uint32_t num_queues)
+{
+    // Prefer a family without graphics, which can run compute concurrently with graphics
+    for (uint32_t i_queue = 0; i_queue < num_queues; i_queue++) {
+        const VkQueueFlags flags = queues[i_queue].queueFlags;
+
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && ! (flags & VK_QUEUE_GRAPHICS_BIT)) {
+            vk_compute_queue_family_index = i_queue;
+            vk_compute_queue_index        = 0;
+            return;
+        }
+    }
+
+    // Otherwise use another queue from the graphics family or share the graphics queue
+    vk_compute_queue_family_index = vk_queue_family_index;
+    vk_compute_queue_index        = ((vk_queue_flags & VK_QUEUE_COMPUTE_BIT) &&
+                                     queues[vk_queue_family_index].queueCount > 1) ? 1 : 0;
+}
+
 static bool find_gpu()
 {
     VkPhysicalDevice        phys_devices[8];
@@ -569,12 +592,15 @@ static bool find_gpu()
                     continue;
 
                 vk_queue_family_index = i_queue;
+                vk_queue_flags        = queues[i_queue].queueFlags;
                 break;
             }
 
             if (i_queue == num_queues)
                 continue;
 
+            find_compute_queue(queues, num_queues);
+
             vk_phys_dev = phys_devices[i_dev];
             d_printf("Selected device %u: %s, supports Vulkan %u.%u\n",
                      i_dev,
@@ -591,6 +617,7 @@ static bool find_gpu()
 
 VkDevice           vk_dev                   = VK_NULL_HANDLE;
 VkQueue            vk_queue                 = VK_NULL_HANDLE;
+VkQueue            vk_compute_queue         = VK_NULL_HANDLE;
 static const char* vk_device_extensions[16];
 static uint32_t    vk_num_device_extensions = 0;
 
@@ -631,6 +658,15 @@ static bool get_device_extensions()
                              &vk_num_device_extensions);
 }
 
+static bool is_device_extension_enabled(const char* name)
+{
+    for (uint32_t i = 0; i < vk_num_device_extensions; i++) {
+        if (mstd::strcmp(vk_device_extensions[i], name) == 0)
+            return true;
+    }
+    return false;
+}
+
 static bool load_device_functions()
 {
     return load_functions(vk_device_function_names, vk_device_functions,
@@ -745,28 +781,50 @@ static bool create_device()
     if ( ! get_device_extensions())
         return false;
 
+    // Features of an optional extension can only be chained if the extension is enabled,
+    // otherwise they remain cleared
+    if ( ! is_device_extension_enabled("VK_EXT_mesh_shader"))
+        vk_timeline_sem_features.pNext = nullptr;
+
     vkGetPhysicalDeviceFeatures2(vk_phys_dev, &vk_features);
 
     if ( ! check_device_features_internal())
         return false;
 
-    static VkDeviceQueueCreateInfo queue_create_info = {
-        VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        nullptr,
-        0,
-        no_queue_family, // queueFamilyIndex
-        1,               // queueCount
-        queue_priorities
+    // These depend on features which are not enabled
+    if ( ! vk_multiview_features.multiview)
+        vk_mesh_shader_features.multiviewMeshShader                = VK_FALSE;
+    vk_mesh_shader_features.primitiveFragmentShadingRateMeshShader = VK_FALSE;
+
+    static VkDeviceQueueCreateInfo queue_create_info[] = {
+        {
+            VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            nullptr,
+            0,
+            no_queue_family, // queueFamilyIndex
+            1,               // queueCount
+            queue_priorities
+        },
+        {
+            VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            nullptr,
+            0,
+            no_queue_family, // queueFamilyIndex
+            1,               // queueCount
+            queue_priorities
+        }
     };
 
-    queue_create_info.queueFamilyIndex = vk_queue_family_index;
+    queue_create_info[0].queueFamilyIndex = vk_queue_family_index;
+    queue_create_info[0].queueCount       = 1 + vk_compute_queue_index;
+    queue_create_info[1].queueFamilyIndex = vk_compute_queue_family_index;
 
     static VkDeviceCreateInfo dev_create_info = {
         VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
         &vk_features,
         0,
-        1,
-        &queue_create_info,
+        1,       // queueCreateInfoCount
+        queue_create_info,
         0,
         nullptr,
         0,       // enabledExtensionCount
@@ -774,6 +832,7 @@ static bool create_device()
         nullptr  // pEnabledFeatures
     };
 
+    dev_create_info.queueCreateInfoCount    = (vk_compute_queue_family_index != vk_queue_family_index) ? 2 : 1;
     dev_create_info.enabledExtensionCount   = vk_num_device_extensions;
     dev_create_info.ppEnabledExtensionNames = vk_device_extensions;
 
@@ -789,6 +848,11 @@ static bool create_device()
         return false;
 
     vkGetDeviceQueue(vk_dev, vk_queue_family_index, 0, &vk_queue);
+    vkGetDeviceQueue(vk_dev, vk_compute_queue_family_index, vk_compute_queue_index, &vk_compute_queue);
+
+    d_printf("Using %s compute queue\n",
+             (vk_compute_queue_family_index != vk_queue_family_index) ? "dedicated" :
+             vk_compute_queue_index ? "second graphics" : "graphics");
 
     return true;
 }
@@ -1069,7 +1133,7 @@ static bool update_resolution()
     return true;
 }
 
-bool allocate_command_buffers(CommandBuffersBase* bufs, uint32_t num_buffers)
+bool allocate_command_buffers(CommandBuffersBase* bufs, uint32_t num_buffers, uint32_t queue_family_index)
 {
     assert(bufs->pool == VK_NULL_HANDLE);
 
@@ -1079,7 +1143,7 @@ bool allocate_command_buffers(CommandBuffersBase* bufs, uint32_t num_buffers)
         VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
     };
 
-    create_info.queueFamilyIndex = vk_queue_family_index;
+    create_info.queueFamilyIndex = queue_family_index;
 
     VkResult res = CHK(vkCreateCommandPool(vk_dev,
                                            &create_info,
@@ -14,18 +14,25 @@ extern VkSurfaceKHR                vk_surface;
 extern VkPhysicalDevice            vk_phys_dev;
 extern VkDevice                    vk_dev;
 extern uint32_t                    vk_queue_family_index;
+extern VkQueueFlags                vk_queue_flags;
 extern VkSwapchainCreateInfoKHR    swapchain_create_info;
 extern VkQueue                     vk_queue;
+extern uint32_t                    vk_compute_queue_family_index;
+extern VkQueue                     vk_compute_queue; // Same as vk_queue if there is no other compute queue
 extern uint32_t                    vk_num_swapchain_images;
 extern VkSurfaceCapabilitiesKHR    vk_surface_caps;
 extern VkPhysicalDeviceProperties2 vk_phys_props;
 
 #define FEATURE_SETS \
-    X(_shader_int8_features,   nullptr,                    VkPhysicalDeviceShaderFloat16Int8Features, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES) \
-    X(_8b_storage_features,    &vk_shader_int8_features,   VkPhysicalDevice8BitStorageFeatures,       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES)        \
-    X(_16b_storage_features,   &vk_8b_storage_features,    VkPhysicalDevice16BitStorageFeatures,      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES)       \
-    X(_dyn_rendering_features, &vk_16b_storage_features,   VkPhysicalDeviceDynamicRenderingFeatures,  VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES)   \
-    X(_features,               &vk_dyn_rendering_features, VkPhysicalDeviceFeatures2,                 VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2)
+    X(_mesh_shader_features,   nullptr,                    VkPhysicalDeviceMeshShaderFeaturesEXT,      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT)     \
+    X(_timeline_sem_features,  &vk_mesh_shader_features,   VkPhysicalDeviceTimelineSemaphoreFeatures,  VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES)  \
+    X(_shader_int8_features,   &vk_timeline_sem_features,  VkPhysicalDeviceShaderFloat16Int8Features,  VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES) \
+    X(_desc_indexing_features, &vk_shader_int8_features,   VkPhysicalDeviceDescriptorIndexingFeatures, VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES) \
+    X(_multiview_features,     &vk_desc_indexing_features, VkPhysicalDeviceMultiviewFeatures,          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES)           \
+    X(_8b_storage_features,    &vk_multiview_features,     VkPhysicalDevice8BitStorageFeatures,        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES)        \
+    X(_16b_storage_features,   &vk_8b_storage_features,    VkPhysicalDevice16BitStorageFeatures,       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES)       \
+    X(_dyn_rendering_features, &vk_16b_storage_features,   VkPhysicalDeviceDynamicRenderingFeatures,   VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES)   \
+    X(_features,               &vk_dyn_rendering_features, VkPhysicalDeviceFeatures2,                  VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2)
 
 #define X(set, prev, type, tag) extern type vk##set;
 FEATURE_SETS
@@ -42,8 +49,6 @@ bool draw_frame();
 bool draw_frame(uint32_t image_idx, uint64_t time_ms, VkFence queue_fence, uint32_t sem_id);
 bool idle_queue();
 uint64_t get_current_time_ms();
-bool load_sound_track(const void* data, uint32_t size);
-bool play_sound_track();
 
 uint32_t check_device_features();
 bool init_assets();
@@ -132,7 +137,7 @@ struct CommandBuffersBase {
 bool reset_and_begin_command_buffer(VkCommandBuffer cmd_buf);
 bool send_to_device_and_wait(VkCommandBuffer cmd_buf);
 
-bool allocate_command_buffers(CommandBuffersBase* bufs, uint32_t num_buffers);
+bool allocate_command_buffers(CommandBuffersBase* bufs, uint32_t num_buffers, uint32_t queue_family_index = vk_queue_family_index);
 inline bool allocate_command_buffers_once(CommandBuffersBase* bufs, uint32_t num_buffers)
 {
     return bufs->pool ? true : allocate_command_buffers(bufs, num_buffers);
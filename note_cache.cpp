@@ -0,0 +1,283 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "note_cache.h"
+
+#include "mstdc.h"
+
+#include <assert.h>
+
+uint64_t NoteCache::hash_instrument(const Synth::Instrument& instrument)
+{
+    // FNV-1a
+    const uint8_t* const bytes = reinterpret_cast<const uint8_t*>(&instrument);
+    uint64_t             hash  = 0xCBF29CE484222325U;
+
+    for (uint32_t i = 0; i < sizeof(instrument); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3U;
+    }
+
+    return hash;
+}
+
+void NoteCache::set_resampling(float new_max_pitch_ratio)
+{
+    max_pitch_ratio = mstd::max(new_max_pitch_ratio, 1.0f);
+}
+
+const float* NoteCache::get_page(const Entry& entry, uint32_t pos) const
+{
+    uint16_t page = entry.first_page;
+
+    for (uint32_t i = pos / page_size; i; i--)
+        page = next_page[page];
+
+    return samples[page];
+}
+
+float* NoteCache::get_page(const Entry& entry, uint32_t pos)
+{
+    return const_cast<float*>(static_cast<const NoteCache*>(this)->get_page(entry, pos));
+}
+
+bool NoteCache::alloc_pages(Entry& entry, uint32_t num_pages)
+{
+    while (num_free_pages < num_pages) {
+        if ( ! evict_lru())
+            return false;
+    }
+
+    // Move pages from the head of the free list to the entry
+    entry.first_page = first_free_page;
+
+    uint16_t last_page = first_free_page;
+    for (uint32_t i = 1; i < num_pages; i++)
+        last_page = next_page[last_page];
+
+    first_free_page      = next_page[last_page];
+    next_page[last_page] = no_page;
+    num_free_pages      -= num_pages;
+
+    return true;
+}
+
+void NoteCache::free_entry(Entry& entry)
+{
+    assert(entry.used);
+    assert( ! entry.num_users);
+
+    uint16_t last_page = entry.first_page;
+    uint32_t num_pages = 1;
+    while (next_page[last_page] != no_page) {
+        last_page = next_page[last_page];
+        ++num_pages;
+    }
+
+    next_page[last_page] = first_free_page;
+    first_free_page      = entry.first_page;
+    num_free_pages      += num_pages;
+
+    entry.used = false;
+}
+
+bool NoteCache::evict_lru()
+{
+    Entry* lru = nullptr;
+
+    for (Entry& entry : entries) {
+        if (entry.used && ! entry.num_users && ( ! lru || entry.last_used < lru->last_used))
+            lru = &entry;
+    }
+
+    if ( ! lru)
+        return false;
+
+    free_entry(*lru);
+    ++stats.evictions;
+
+    return true;
+}
+
+NoteCache::Lookup NoteCache::acquire(uint64_t instrument_hash, uint32_t base_freq, uint32_t num_samples)
+{
+    if ( ! initialized) {
+        for (uint32_t i = 0; i < max_pages; i++)
+            next_page[i] = static_cast<uint16_t>((i + 1 < max_pages) ? (i + 1) : no_page);
+
+        first_free_page = 0;
+        num_free_pages  = max_pages;
+        initialized     = true;
+    }
+
+    ++use_counter;
+
+    Lookup lookup = { no_entry, false, 1 };
+
+    Entry* free_slot = nullptr;
+    Entry* similar   = nullptr;
+
+    for (Entry& entry : entries) {
+        if ( ! entry.used) {
+            if ( ! free_slot)
+                free_slot = &entry;
+            continue;
+        }
+
+        if (entry.instrument_hash != instrument_hash || entry.num_samples != num_samples)
+            continue;
+
+        if (entry.base_freq == base_freq) {
+            // The note is still being rendered by another voice, render it again
+            if ( ! is_complete(entry)) {
+                ++stats.misses;
+                return lookup;
+            }
+
+            ++entry.num_users;
+            entry.last_used = use_counter;
+            ++stats.hits;
+
+            lookup.entry    = static_cast<uint32_t>(&entry - entries);
+            lookup.complete = true;
+            return lookup;
+        }
+
+        // Find the closest higher pitch which can be slowed down to the requested pitch
+        if (is_complete(entry) && entry.base_freq > base_freq &&
+            static_cast<float>(entry.base_freq) <= static_cast<float>(base_freq) * max_pitch_ratio &&
+            ( ! similar || entry.base_freq < similar->base_freq))
+            similar = &entry;
+    }
+
+    if (similar) {
+        ++similar->num_users;
+        similar->last_used = use_counter;
+        ++stats.resampled_hits;
+
+        lookup.entry    = static_cast<uint32_t>(similar - entries);
+        lookup.complete = true;
+        lookup.step     = static_cast<float>(base_freq) / static_cast<float>(similar->base_freq);
+        return lookup;
+    }
+
+    ++stats.misses;
+
+    // Long notes would evict too many other notes
+    const uint32_t num_pages = (num_samples + page_size - 1) / page_size;
+    if ( ! num_pages || num_pages > max_pages / 4)
+        return lookup;
+
+    if ( ! free_slot) {
+        if ( ! evict_lru())
+            return lookup;
+
+        for (Entry& entry : entries) {
+            if ( ! entry.used) {
+                free_slot = &entry;
+                break;
+            }
+        }
+    }
+
+    if ( ! alloc_pages(*free_slot, num_pages))
+        return lookup;
+
+    free_slot->instrument_hash = instrument_hash;
+    free_slot->base_freq       = base_freq;
+    free_slot->num_samples     = num_samples;
+    free_slot->num_written     = 0;
+    free_slot->last_used       = use_counter;
+    free_slot->num_users       = 1;
+    free_slot->used            = true;
+
+    lookup.entry = static_cast<uint32_t>(free_slot - entries);
+    return lookup;
+}
+
+void NoteCache::release(uint32_t entry_idx)
+{
+    if (entry_idx == no_entry)
+        return;
+
+    Entry& entry = entries[entry_idx];
+
+    assert(entry.used);
+    assert(entry.num_users);
+
+    --entry.num_users;
+
+    // The note was not rendered completely, e.g. because playback has been restarted
+    if ( ! is_complete(entry) && ! entry.num_users)
+        free_entry(entry);
+}
+
+void NoteCache::read(uint32_t entry_idx, uint32_t pos, uint32_t num_samples, float* out) const
+{
+    const Entry& entry = entries[entry_idx];
+
+    assert(is_complete(entry));
+    assert(pos + num_samples <= entry.num_samples);
+
+    while (num_samples) {
+        const uint32_t page_offs   = pos % page_size;
+        const uint32_t num_to_copy = mstd::min(num_samples, page_size - page_offs);
+
+        mstd::mem_copy(out, &get_page(entry, pos)[page_offs], num_to_copy * static_cast<uint32_t>(sizeof(float)));
+
+        out         += num_to_copy;
+        pos         += num_to_copy;
+        num_samples -= num_to_copy;
+    }
+}
+
+void NoteCache::read_resampled(uint32_t entry_idx, float pos, float step, uint32_t num_samples, float* out) const
+{
+    const Entry& entry = entries[entry_idx];
+
+    assert(is_complete(entry));
+
+    const float* pages[max_pages];
+    uint16_t     page = entry.first_page;
+    for (uint32_t i = 0; page != no_page; i++) {
+        pages[i] = samples[page];
+        page     = next_page[page];
+    }
+
+    const uint32_t last = entry.num_samples - 1;
+
+    // Linear interpolation between neighboring samples
+    for (uint32_t i = 0; i < num_samples; i++) {
+        const float    src_pos = pos + static_cast<float>(i) * step;
+        const uint32_t idx0    = mstd::min(static_cast<uint32_t>(src_pos), last);
+        const uint32_t idx1    = mstd::min(idx0 + 1, last);
+        const float    frac    = src_pos - static_cast<float>(idx0);
+
+        const float value0 = pages[idx0 / page_size][idx0 % page_size];
+        const float value1 = pages[idx1 / page_size][idx1 % page_size];
+
+        out[i] = value0 + (value1 - value0) * frac;
+    }
+}
+
+void NoteCache::write(uint32_t entry_idx, uint32_t pos, uint32_t num_samples, const float* in)
+{
+    Entry& entry = entries[entry_idx];
+
+    assert(entry.used);
+    assert(pos == entry.num_written);
+    assert(pos + num_samples <= entry.num_samples);
+
+    entry.num_written += num_samples;
+
+    while (num_samples) {
+        const uint32_t page_offs   = pos % page_size;
+        const uint32_t num_to_copy = mstd::min(num_samples, page_size - page_offs);
+
+        mstd::mem_copy(&get_page(entry, pos)[page_offs], in, num_to_copy * static_cast<uint32_t>(sizeof(float)));
+
+        in          += num_to_copy;
+        pos         += num_to_copy;
+        num_samples -= num_to_copy;
+    }
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include "synth.h"
+
+// Cache of rendered notes, keyed by instrument, base frequency and note length.
+// The envelopes depend on note length, so notes of different lengths are cached
+// separately.  A note is stored while it is rendered for the first time and can
+// be read back once it has been rendered completely.
+//
+// Samples are kept in a fixed arena divided into pages, the least recently used
+// notes are evicted when the arena is full.  The cache is not thread-safe.
+class NoteCache {
+    public:
+        static constexpr uint32_t no_entry = ~0U;
+
+        struct Lookup {
+            uint32_t entry;     // no_entry if the note cannot be cached
+            bool     complete;  // Note can be read, otherwise it must be written as it is rendered
+            float    step;      // Position increment in the cached note for one sample
+        };
+
+        struct Stats {
+            uint32_t hits;
+            uint32_t resampled_hits;
+            uint32_t misses;
+            uint32_t evictions;
+        };
+
+        static uint64_t hash_instrument(const Synth::Instrument& instrument);
+
+        // Allows playing a note by reading a cached note of the same instrument and length,
+        // which has up to max_pitch_ratio times higher pitch, at a slower rate instead of
+        // rendering the note.  Resampling stretches the envelope and cuts off the end
+        // of the note, so it is disabled by default.
+        void set_resampling(float new_max_pitch_ratio);
+
+        // The entry must be released when the note is no longer played
+        Lookup acquire(uint64_t instrument_hash, uint32_t base_freq, uint32_t num_samples);
+        void release(uint32_t entry);
+
+        // Reads samples of a complete note starting at pos
+        void read(uint32_t entry, uint32_t pos, uint32_t num_samples, float* out) const;
+        void read_resampled(uint32_t entry, float pos, float step, uint32_t num_samples, float* out) const;
+
+        // Stores subsequent samples of a note which is not complete yet
+        void write(uint32_t entry, uint32_t pos, uint32_t num_samples, const float* in);
+
+        Stats get_stats() const { return stats; }
+
+        static constexpr uint32_t page_size   = 4096;
+        static constexpr uint32_t max_pages   = 256;     // About 24 s of samples
+        static constexpr uint32_t max_entries = 256;
+
+    private:
+        struct Entry {
+            uint64_t instrument_hash;
+            uint32_t base_freq;
+            uint32_t num_samples;
+            uint32_t num_written;
+            uint32_t last_used;
+            uint16_t first_page;
+            uint16_t num_users;
+            bool     used;
+        };
+
+        bool is_complete(const Entry& entry) const { return entry.num_written == entry.num_samples; }
+        float* get_page(const Entry& entry, uint32_t pos);
+        const float* get_page(const Entry& entry, uint32_t pos) const;
+        bool alloc_pages(Entry& entry, uint32_t num_pages);
+        void free_entry(Entry& entry);
+        bool evict_lru();
+
+        static constexpr uint16_t no_page = 0xFFFFU;
+
+        Entry    entries[max_entries]      = { };
+        uint16_t next_page[max_pages]      = { };
+        uint16_t first_free_page           = no_page;
+        uint32_t num_free_pages            = 0;
+        bool     initialized               = false;
+        uint32_t use_counter               = 0;
+        float    max_pitch_ratio           = 1;
+        Stats    stats                     = { };
+        float    samples[max_pages][page_size];
+};
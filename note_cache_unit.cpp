@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "note_cache.h"
+#include "tracker.h"
+#include <stdio.h>
+
+#define TEST(test) if ( ! (test)) { failed(#test, __FILE__, __LINE__); }
+
+static int exit_code = 0;
+
+static void failed(const char* test, const char* file, int line)
+{
+    exit_code = 1;
+    fprintf(stderr, "%s:%d: Error: Failed condition %s\n",
+            file, line, test);
+}
+
+static const Synth::Instrument instruments[] = {
+    {
+        { { Synth::wave_sine, 0, 300, 20, 0 } },
+        { { 0, 65535, 40000, 0, 10, 50, 0, 20 } },
+        {
+            { 1, Synth::wave_sine,     0, 0, 1, 1, 0 },
+            { 2, Synth::wave_triangle, 0, 0, 0, 1, 0 },
+            { 3, Synth::wave_noise,    0, 0, 0, 1, 0 }
+        },
+        3
+    }
+};
+
+// Renders a note into the cache in blocks, like the sequencer does
+static void write_note(NoteCache& cache, uint32_t entry, uint32_t base_freq, uint32_t num_samples)
+{
+    static float block[1024];
+
+    for (uint32_t pos = 0; pos < num_samples; pos += 1024) {
+        const uint32_t end = (pos + 1024 < num_samples) ? (pos + 1024) : num_samples;
+
+        Synth::render_note_range(instruments[0], base_freq, num_samples, pos, end, block);
+        cache.write(entry, pos, end - pos, block);
+    }
+}
+
+static uint32_t count_mismatches(const float* samples1, const float* samples2, uint32_t num_samples)
+{
+    uint32_t num_mismatched = 0;
+
+    for (uint32_t i = 0; i < num_samples; i++) {
+        if (samples1[i] != samples2[i])
+            ++num_mismatched;
+    }
+
+    return num_mismatched;
+}
+
+static NoteCache cache;
+
+int main()
+{
+    const uint64_t hash = NoteCache::hash_instrument(instruments[0]);
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // cache hit returns the same samples as a fresh render
+
+    {
+        // Spans multiple pages and does not end on a page boundary
+        constexpr uint32_t num_samples = 3 * NoteCache::page_size + 100;
+
+        static float fresh[num_samples];
+        static float cached[num_samples];
+
+        Synth::render_note(instruments[0], 440, num_samples, fresh);
+
+        const NoteCache::Lookup miss = cache.acquire(hash, 440, num_samples);
+        TEST(miss.entry != NoteCache::no_entry);
+        TEST( ! miss.complete);
+
+        // The note is still being written, so another voice must render it as well
+        const NoteCache::Lookup pending = cache.acquire(hash, 440, num_samples);
+        TEST(pending.entry == NoteCache::no_entry);
+
+        write_note(cache, miss.entry, 440, num_samples);
+        cache.release(miss.entry);
+
+        const NoteCache::Lookup hit = cache.acquire(hash, 440, num_samples);
+        TEST(hit.entry == miss.entry);
+        TEST(hit.complete);
+        TEST(hit.step == 1.0f);
+
+        cache.read(hit.entry, 0, num_samples, cached);
+        TEST(count_mismatches(fresh, cached, num_samples) == 0);
+
+        // Reads which start in the middle of a page
+        constexpr uint32_t pos = NoteCache::page_size - 10;
+        cache.read(hit.entry, pos, num_samples - pos, cached);
+        TEST(count_mismatches(&fresh[pos], cached, num_samples - pos) == 0);
+
+        cache.release(hit.entry);
+
+        // Notes of a different length or frequency are different notes
+        const NoteCache::Lookup other_length = cache.acquire(hash, 440, num_samples - 4);
+        TEST(other_length.entry != hit.entry);
+        TEST( ! other_length.complete);
+        cache.release(other_length.entry);
+
+        const NoteCache::Lookup other_freq = cache.acquire(hash, 415, num_samples);
+        TEST(other_freq.entry != hit.entry);
+        TEST( ! other_freq.complete);
+        cache.release(other_freq.entry);
+
+        //////////////////////////////////////////////////////////////////////////////////////
+        // resampling a higher note
+
+        cache.set_resampling(1.1f);
+
+        const NoteCache::Lookup resampled = cache.acquire(hash, 415, num_samples);
+        TEST(resampled.entry == hit.entry);
+        TEST(resampled.complete);
+        TEST(resampled.step == 415.0f / 440.0f);
+
+        // Without fractional position, resampling reads the exact samples
+        cache.read_resampled(resampled.entry, 0, 1, 100, cached);
+        TEST(count_mismatches(fresh, cached, 100) == 0);
+
+        cache.release(resampled.entry);
+        cache.set_resampling(1);
+
+        const NoteCache::Stats stats = cache.get_stats();
+        TEST(stats.hits           == 1);
+        TEST(stats.resampled_hits == 1);
+        TEST(stats.misses         == 4);
+        TEST(stats.evictions      == 0);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // least recently used notes are evicted when the cache is full
+
+    {
+        // Each note takes the maximum number of pages allowed for a single note
+        constexpr uint32_t num_samples = NoteCache::max_pages / 4 * NoteCache::page_size;
+
+        for (uint32_t i = 0; i < 5; i++) {
+            const NoteCache::Lookup lookup = cache.acquire(hash, 100 + i, num_samples);
+            TEST(lookup.entry != NoteCache::no_entry);
+            write_note(cache, lookup.entry, 100 + i, num_samples);
+            cache.release(lookup.entry);
+        }
+
+        TEST(cache.get_stats().evictions > 0);
+
+        // The first note was evicted, but the last one is still there
+        const NoteCache::Lookup first = cache.acquire(hash, 100, num_samples);
+        TEST( ! first.complete);
+        cache.release(first.entry);
+
+        const NoteCache::Lookup last = cache.acquire(hash, 104, num_samples);
+        TEST(last.complete);
+        cache.release(last.entry);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // songs played from the cache sound the same as without the cache
+
+    {
+        static const Tracker::Cell cells[] = {
+            { 69, 1, 0, 0 }, { 57, 1, 0, 0 },
+            { 72, 0, 0, 0 }, { Tracker::note_off, 0, 0, 0 }
+        };
+        static const Tracker::Pattern patterns[] = { { cells, 2 } };
+        static const uint8_t          order[]    = { 0, 0, 0, 0 };
+
+        static const Tracker::Song song = { instruments, patterns, order, 4, 4408, 2 };
+
+        const uint32_t song_length = Tracker::get_song_length(song);
+
+        static Sample16Stereo     expected[8 * 4408];
+        static Sample16Stereo     actual[8 * 4408];
+        static Tracker::Sequencer sequencer;
+
+        sequencer.start(song);
+        TEST(sequencer.render(expected, song_length) == song_length);
+
+        const NoteCache::Stats old_stats = cache.get_stats();
+
+        sequencer.set_note_cache(&cache);
+        sequencer.start(song);
+        TEST(sequencer.render(actual, song_length) == song_length);
+
+        uint32_t num_mismatched = 0;
+        for (uint32_t i = 0; i < song_length; i++) {
+            if ((actual[i].left != expected[i].left) || (actual[i].right != expected[i].right))
+                ++num_mismatched;
+        }
+        TEST(num_mismatched == 0);
+
+        TEST(cache.get_stats().hits > old_stats.hits);
+    }
+
+    return exit_code;
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "parallel.h"
+
+#include "d_printf.h"
+#include "mstdc.h"
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t max_threads = 64;
+
+    struct WorkRange {
+        RangeFunc func;
+        void*     user;
+        uint32_t  begin;
+        uint32_t  end;
+    };
+
+#ifdef _WIN32
+    DWORD WINAPI worker_thread(LPVOID param)
+    {
+        const WorkRange* const range = static_cast<const WorkRange*>(param);
+        range->func(range->user, range->begin, range->end);
+        return 0;
+    }
+#else
+    void* worker_thread(void* param)
+    {
+        const WorkRange* const range = static_cast<const WorkRange*>(param);
+        range->func(range->user, range->begin, range->end);
+        return nullptr;
+    }
+#endif
+}
+
+uint32_t get_num_cpus()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<uint32_t>(info.dwNumberOfProcessors);
+#else
+    const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (num_cpus > 0) ? static_cast<uint32_t>(num_cpus) : 1U;
+#endif
+}
+
+void run_parallel(RangeFunc func,
+                  void*     user,
+                  uint32_t  num_items,
+                  uint32_t  min_items_per_thread,
+                  uint32_t  granularity)
+{
+    const uint32_t num_threads = mstd::max(mstd::min(mstd::min(get_num_cpus(), max_threads),
+                                                     num_items / mstd::max(min_items_per_thread, 1U)),
+                                           1U);
+
+    WorkRange ranges[max_threads];
+#ifdef _WIN32
+    HANDLE    threads[max_threads];
+#else
+    pthread_t threads[max_threads];
+#endif
+    bool      started[max_threads];
+
+    for (uint32_t i = 0; i < num_threads; i++) {
+        const uint64_t begin = static_cast<uint64_t>(num_items) * i / num_threads;
+        const uint64_t end   = static_cast<uint64_t>(num_items) * (i + 1) / num_threads;
+
+        ranges[i].func  = func;
+        ranges[i].user  = user;
+        ranges[i].begin = mstd::align_down(static_cast<uint32_t>(begin), granularity);
+        ranges[i].end   = (i + 1 == num_threads) ? num_items
+                                                 : mstd::align_down(static_cast<uint32_t>(end), granularity);
+    }
+
+    for (uint32_t i = 1; i < num_threads; i++) {
+#ifdef _WIN32
+        threads[i] = CreateThread(nullptr, 0, worker_thread, &ranges[i], 0, nullptr);
+        started[i] = threads[i] != nullptr;
+#else
+        started[i] = pthread_create(&threads[i], nullptr, worker_thread, &ranges[i]) == 0;
+#endif
+        // The range of a thread which failed to start is processed on the calling thread
+        if ( ! started[i]) {
+            d_printf("Failed to start worker thread\n");
+        }
+    }
+
+    func(user, ranges[0].begin, ranges[0].end);
+
+    for (uint32_t i = 1; i < num_threads; i++) {
+        if ( ! started[i]) {
+            func(user, ranges[i].begin, ranges[i].end);
+            continue;
+        }
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], nullptr);
+#endif
+    }
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include <stdint.h>
+
+uint32_t get_num_cpus();
+
+typedef void (*RangeFunc)(void* user, uint32_t begin, uint32_t end);
+
+// Splits items into contiguous ranges of similar size and processes them in parallel,
+// the first range is processed on the calling thread.  If a thread fails to start,
+// its range is processed on the calling thread as well.  Ranges start at multiples
+// of granularity and each range has at least min_items_per_thread items.
+void run_parallel(RangeFunc func,
+                  void*     user,
+                  uint32_t  num_items,
+                  uint32_t  min_items_per_thread,
+                  uint32_t  granularity = 1);
@@ -27,7 +27,7 @@ void* Resource::get_raw_ptr(VkDeviceSize offset) const
     return ptr ? (ptr + heap_offset + offset) : ptr;
 }
 
-bool Resource::flush_range(VkDeviceSize offset, VkDeviceSize size)
+bool Resource::get_mapped_range(VkDeviceSize offset, VkDeviceSize size, VkMappedMemoryRange* range) const
 {
     assert(owning_heap);
     assert(offset < alloc_size);
@@ -35,26 +35,41 @@ bool Resource::flush_range(VkDeviceSize offset, VkDeviceSize size)
     assert(offset + size <= alloc_size);
 
     if ( ! owning_heap->get_host_ptr())
-        return true;
+        return false;
 
     const VkDeviceSize alignment = vk_phys_props.properties.limits.nonCoherentAtomSize;
     const VkDeviceSize begin     = heap_offset + offset;
 
-    static VkMappedMemoryRange range = {
-        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-        nullptr,
-        VK_NULL_HANDLE,     // memory
-        0,                  // offset
-        0                   // size
-    };
-    range.memory = owning_heap->get_memory();
-    range.offset = mstd::align_down(begin, alignment);
-    range.size   = mstd::align_up(size + (begin - range.offset), alignment);
+    // Not static, invalidating may happen on a different thread than flushing
+    range->sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range->pNext  = nullptr;
+    range->memory = owning_heap->get_memory();
+    range->offset = mstd::align_down(begin, alignment);
+    range->size   = mstd::align_up(size + (begin - range->offset), alignment);
+
+    return true;
+}
+
+bool Resource::flush_range(VkDeviceSize offset, VkDeviceSize size)
+{
+    VkMappedMemoryRange range;
+    if ( ! get_mapped_range(offset, size, &range))
+        return true;
 
     const VkResult res = CHK(vkFlushMappedMemoryRanges(vk_dev, 1, &range));
     return res == VK_SUCCESS;
 }
 
+bool Resource::invalidate_range(VkDeviceSize offset, VkDeviceSize size)
+{
+    VkMappedMemoryRange range;
+    if ( ! get_mapped_range(offset, size, &range))
+        return true;
+
+    const VkResult res = CHK(vkInvalidateMappedMemoryRanges(vk_dev, 1, &range));
+    return res == VK_SUCCESS;
+}
+
 bool Resource::flush_whole()
 {
     return flush_range(0, alloc_size);
@@ -86,6 +101,7 @@ bool Image::allocate(const ImageInfo& image_info, Description desc)
     create_info.extent.width  = image_info.width;
     create_info.extent.height = image_info.height;
     create_info.mipLevels     = image_info.mip_levels;
+    create_info.arrayLayers   = image_info.array_layers ? image_info.array_layers : 1U;
     create_info.tiling        = host_access ? VK_IMAGE_TILING_LINEAR : VK_IMAGE_TILING_OPTIMAL;
     create_info.usage         = image_info.usage;
 
@@ -100,6 +116,7 @@ bool Image::allocate(const ImageInfo& image_info, Description desc)
     aspect     = image_info.aspect;
     heap_usage = image_info.heap_usage;
     mip_levels = image_info.mip_levels;
+    layers     = create_info.arrayLayers;
 
     VkMemoryRequirements memory_reqs;
     vkGetImageMemoryRequirements(vk_dev, image, &memory_reqs);
@@ -148,9 +165,12 @@ bool Image::allocate(const ImageInfo& image_info, Description desc)
             }
         };
         view_create_info.image                       = image;
+        view_create_info.viewType                    = (layers > 1) ? VK_IMAGE_VIEW_TYPE_2D_ARRAY
+                                                                    : VK_IMAGE_VIEW_TYPE_2D;
         view_create_info.format                      = format;
         view_create_info.subresourceRange.aspectMask = aspect;
         view_create_info.subresourceRange.levelCount = mip_levels;
+        view_create_info.subresourceRange.layerCount = layers;
 
         res = CHK(vkCreateImageView(vk_dev, &view_create_info, nullptr, &view));
         if (res != VK_SUCCESS)
@@ -195,7 +215,7 @@ void Image::set_image_layout(VkCommandBuffer buf, const Transition& transition)
     img_barrier.image                       = image;
     img_barrier.subresourceRange.aspectMask = aspect;
     img_barrier.subresourceRange.levelCount = 1;
-    img_barrier.subresourceRange.layerCount = 1;
+    img_barrier.subresourceRange.layerCount = layers;
 
     vkCmdPipelineBarrier(buf,
                          transition.src_stage,
@@ -300,6 +320,12 @@ bool Buffer::flush(VkDeviceSize idx, VkDeviceSize stride)
     return flush_range(idx * stride, stride);
 }
 
+bool Buffer::invalidate(VkDeviceSize idx, VkDeviceSize stride)
+{
+    assert(idx * stride + stride <= alloc_size);
+    return invalidate_range(idx * stride, stride);
+}
+
 bool ImageWithHostCopy::allocate(const ImageInfo& image_info, Description desc)
 {
     if ( ! Image::allocate(image_info, desc))
@@ -62,6 +62,8 @@ class Resource {
         void* get_raw_ptr(VkDeviceSize offset) const;
         bool flush_range(VkDeviceSize offset, VkDeviceSize size);
         bool flush_whole();
+        bool invalidate_range(VkDeviceSize offset, VkDeviceSize size);
+        bool get_mapped_range(VkDeviceSize offset, VkDeviceSize size, VkMappedMemoryRange* range) const;
 
         MemoryHeap*  owning_heap = nullptr;
         VkDeviceSize heap_offset = 0;
@@ -76,6 +78,7 @@ struct ImageInfo {
     VkImageAspectFlags aspect;
     VkImageUsageFlags  usage;
     Usage              heap_usage;
+    uint32_t           array_layers; // 0 is the same as 1, more layers make the view an array
 };
 
 class Image: public Resource {
@@ -110,6 +113,7 @@ class Image: public Resource {
             assert(image == VK_NULL_HANDLE);
             image  = new_image;
             aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+            layers = 1;
         }
         void set_view(VkImageView new_view) {
             assert(view == VK_NULL_HANDLE);
@@ -123,6 +127,7 @@ class Image: public Resource {
         VkImageAspectFlags aspect     = VK_IMAGE_ASPECT_COLOR_BIT;
         Usage              heap_usage = Usage::fixed;
         uint32_t           mip_levels = 0;
+        uint32_t           layers     = 1;
         uint32_t           pitch      = 0;
 };
 
@@ -143,6 +148,7 @@ class Buffer: public Resource {
         void cpu_fill(const void* data, uint32_t size);
         bool flush() { return flush_whole(); }
         bool flush(VkDeviceSize idx, VkDeviceSize stride);
+        bool invalidate(VkDeviceSize idx, VkDeviceSize stride); // Makes GPU writes visible to the host
         void free(); // GUI only
 
     private:
@@ -5,11 +5,7 @@
 
 #extension GL_GOOGLE_include_directive: require
 
-#include "sculptor_material.glsl"
+// Used on devices without multiview, only the first view is drawn
+#define view_index 0
 
-layout(location = 0) out vec4 out_color;
-
-void main()
-{
-    out_color = vec4(diffuse_color.xyz, 1);
-}
+#include "bezier_line_cubic_sculptor_vert.glsl"
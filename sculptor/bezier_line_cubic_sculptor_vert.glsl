@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by bezier_line_cubic_sculptor.vert.glsl and bezier_line_cubic_sculptor_single_view.vert.glsl,
+// which define view_index
+
+#include "bezier_cubic_data.glsl"
+#include "transforms.glsl"
+
+layout(location = 0) out vec4 out_pos;
+
+layout(set = 2, binding = 2) buffer edge_indices {
+    uvec4 indices[]; // Vertex indices
+};
+
+struct vertex_data {
+    uint xy;
+    uint z;
+};
+
+layout(set = 2, binding = 3) buffer edge_vertices {
+    vertex_data vertices[];
+};
+
+vec3 read_vertex(uint index)
+{
+    const vertex_data data = vertices[index];
+
+    const int ix = int(data.xy << 16) >> 16;
+    const int iy = int(data.xy) >> 16;
+    const int iz = int(data.z << 16) >> 16;
+
+    const float x = float(ix) / 32767.0;
+    const float y = float(iy) / 32767.0;
+    const float z = float(iz) / 32767.0;
+
+    return vec3(x, y, z);
+}
+
+vec3 calc_current_vertex_pos(uint edge_index, float t)
+{
+    const uvec4 edge = indices[edge_index];
+
+    return bezier_curve_cubic(read_vertex(edge.x),
+                              read_vertex(edge.y),
+                              read_vertex(edge.z),
+                              read_vertex(edge.w),
+                              t);
+}
+
+void main()
+{
+    const float t = float((gl_VertexIndex + 2) / 3) / float(tess_level.x);
+
+    const vec3 pos = calc_current_vertex_pos(gl_InstanceIndex, t);
+
+    const vec4 view_pos = vec4(pos, 1) * views[view_index].model_view;
+    gl_Position = projection(view_pos.xyz);
+
+    out_pos = vec4(view_pos.xyz, gl_Position.z / gl_Position.w);
+}
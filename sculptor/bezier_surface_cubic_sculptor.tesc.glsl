@@ -3,26 +3,9 @@
 
 #version 460 core
 
+#extension GL_EXT_multiview: require
 #extension GL_GOOGLE_include_directive: require
 
-#include "bezier_cubic_data.glsl"
+#define view_index gl_ViewIndex
 
-layout(vertices = 16) out;
-
-void main()
-{
-    if (gl_InvocationID == 0) {
-        // TODO calculate tessellation level based on distance from camera
-        const uint level = tess_level.x;
-
-        gl_TessLevelOuter[0] = level;
-        gl_TessLevelOuter[1] = level;
-        gl_TessLevelOuter[2] = level;
-        gl_TessLevelOuter[3] = level;
-
-        gl_TessLevelInner[0] = level;
-        gl_TessLevelInner[1] = level;
-    }
-
-    gl_out[gl_InvocationID].gl_Position = gl_in[gl_InvocationID].gl_Position;
-}
+#include "bezier_surface_cubic_sculptor_tesc.glsl"
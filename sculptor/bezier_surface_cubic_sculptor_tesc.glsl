@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by bezier_surface_cubic_sculptor.tesc.glsl and bezier_surface_cubic_sculptor_single_view.tesc.glsl,
+// which define view_index
+
+#include "bezier_cubic_data.glsl"
+#include "transforms.glsl"
+#include "patch_level.glsl"
+
+layout(vertices = 16) out;
+
+void main()
+{
+    if (gl_InvocationID == 0) {
+        vec2 p[16];
+        for (uint i = 0; i < 16; i++)
+            p[i] = project_to_screen(gl_in[i].gl_Position.xyz);
+
+        // Rows run along u, columns run along v
+        float row_level[4];
+        float col_level[4];
+        for (uint i = 0; i < 4; i++) {
+            row_level[i] = curve_level(p[i * 4], p[i * 4 + 1], p[i * 4 + 2], p[i * 4 + 3]);
+            col_level[i] = curve_level(p[i], p[i + 4], p[i + 8], p[i + 12]);
+        }
+
+        const float max_level = float(tess_level.y);
+
+        // Outer levels depend only on the control points of the shared edge
+        gl_TessLevelOuter[0] = clamp(ceil(col_level[0]), 1, max_level); // u = 0
+        gl_TessLevelOuter[1] = clamp(ceil(row_level[0]), 1, max_level); // v = 0
+        gl_TessLevelOuter[2] = clamp(ceil(col_level[3]), 1, max_level); // u = 1
+        gl_TessLevelOuter[3] = clamp(ceil(row_level[3]), 1, max_level); // v = 1
+
+        // Inner levels also account for the interior rows and columns
+        const float inner_u = max(max(row_level[0], row_level[1]), max(row_level[2], row_level[3]));
+        const float inner_v = max(max(col_level[0], col_level[1]), max(col_level[2], col_level[3]));
+
+        gl_TessLevelInner[0] = clamp(ceil(inner_u), 1, max_level);
+        gl_TessLevelInner[1] = clamp(ceil(inner_v), 1, max_level);
+    }
+
+    gl_out[gl_InvocationID].gl_Position = gl_in[gl_InvocationID].gl_Position;
+}
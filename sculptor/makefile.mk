@@ -6,21 +6,46 @@ gui_project_name = sculptor
 src_files += sculptor.cpp
 src_files += sculptor_editor.cpp
 src_files += sculptor_geometry.cpp
+src_files += sculptor_geometry_file.cpp
+src_files += sculptor_geometry_export.cpp
+src_files += sculptor_geometry_transform.cpp
+src_files += sculptor_bvh.cpp
+src_files += sculptor_vertex_grid.cpp
+src_files += sculptor_journal.cpp
 src_files += sculptor_materials.cpp
 src_files += sculptor_geom_edit.cpp
 
+unit_test_src_files += sculptor_unit.cpp
+
 shader_files += sculptor_pass_through.vert.glsl
 shader_files += bezier_line_cubic_sculptor.vert.glsl
-shader_files += sculptor_simple.vert.glsl
 shader_files += bezier_surface_cubic_sculptor.tesc.glsl
 shader_files += bezier_surface_cubic_sculptor.tese.glsl
 shader_files += sculptor_object.frag.glsl
+shader_files += sculptor_object_untextured.frag.glsl
 shader_files += sculptor_edge_color.frag.glsl
-shader_files += sculptor_color.frag.glsl
+shader_files += sculptor_patch_indices.comp.glsl
+shader_files += sculptor_patch_cull.comp.glsl
+shader_files += sculptor_patch_tess.comp.glsl
+shader_files += sculptor_tessellated.vert.glsl
+shader_files += sculptor_patch.task.glsl
+shader_files += sculptor_patch.mesh.glsl
+shader_files += sculptor_grid.vert.glsl
+shader_files += sculptor_grid.frag.glsl
+shader_files += ../shaders/sculptor_object_id.frag.glsl
 
 shader_files += sculptor_vertex_select.vert.glsl
+shader_files += sculptor_vertex_cull.comp.glsl
 shader_files += sculptor_vertex_select.frag.glsl
 
+# Used on devices without multiview
+shader_files += bezier_line_cubic_sculptor_single_view.vert.glsl
+shader_files += bezier_surface_cubic_sculptor_single_view.tesc.glsl
+shader_files += bezier_surface_cubic_sculptor_single_view.tese.glsl
+shader_files += sculptor_tessellated_single_view.vert.glsl
+shader_files += sculptor_grid_single_view.frag.glsl
+shader_files += sculptor_vertex_select_single_view.vert.glsl
+
 bin_to_header_files += toolbar.png
 
 $(call OBJ_FROM_SRC,sculptor_geom_edit.cpp): $(gen_headers_dir)/toolbar.png.h
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Checks whether all control points lie outside of one of the frustum planes,
+// the patch lies within the convex hull of its control points
+bool outside_frustum(vec3 view_pos[16], vec4 proj, vec4 proj_w)
+{
+    uint outside_left   = 0;
+    uint outside_right  = 0;
+    uint outside_top    = 0;
+    uint outside_bottom = 0;
+    uint outside_near   = 0;
+    uint outside_far    = 0;
+
+    for (uint i = 0; i < 16; i++) {
+        const vec3  pos = view_pos[i];
+        const vec2  xy  = pos.xy * proj.xy;
+        const float z   = pos.z * proj.z + proj.w;
+        const float w   = pos.z * proj_w.z + proj_w.w;
+
+        outside_left   += (xy.x < -w) ? 1 : 0;
+        outside_right  += (xy.x >  w) ? 1 : 0;
+        outside_top    += (xy.y < -w) ? 1 : 0;
+        outside_bottom += (xy.y >  w) ? 1 : 0;
+        // Depth is reversed, near plane is at z == w and far plane at z == 0
+        outside_near   += (z    >  w) ? 1 : 0;
+        outside_far    += (z    < 0)  ? 1 : 0;
+    }
+
+    return outside_left == 16 || outside_right  == 16 ||
+           outside_top  == 16 || outside_bottom == 16 ||
+           outside_near == 16 || outside_far    == 16;
+}
+
+// Checks whether the whole patch faces away from the camera using a cone of normals.
+// The surface normal is du x dv, which is a combination with non-negative weights of
+// cross products of differences of control points along u and along v, so these
+// cross products bound the directions of all normals of the patch.
+bool back_facing(vec3 view_pos[16], bool perspective)
+{
+    vec3 axis = vec3(0);
+
+    for (uint ui = 0; ui < 12; ui++) {
+        const uint u_row = ui / 3;
+        const uint u_col = ui % 3;
+        const vec3 du    = view_pos[u_row * 4 + u_col + 1] - view_pos[u_row * 4 + u_col];
+
+        for (uint vi = 0; vi < 12; vi++) {
+            const vec3  dv  = view_pos[vi + 4] - view_pos[vi];
+            const vec3  n   = cross(du, dv);
+            const float len = length(n);
+            if (len > 0)
+                axis += n / len;
+        }
+    }
+
+    const float axis_len = length(axis);
+    if (axis_len == 0)
+        return false;
+    axis /= axis_len;
+
+    float min_cos = 1;
+
+    for (uint ui = 0; ui < 12; ui++) {
+        const uint u_row = ui / 3;
+        const uint u_col = ui % 3;
+        const vec3 du    = view_pos[u_row * 4 + u_col + 1] - view_pos[u_row * 4 + u_col];
+
+        for (uint vi = 0; vi < 12; vi++) {
+            const vec3  dv  = view_pos[vi + 4] - view_pos[vi];
+            const vec3  n   = cross(du, dv);
+            const float len = length(n);
+            if (len > 0)
+                min_cos = min(min_cos, dot(n, axis) / len);
+        }
+    }
+
+    // The cone spans 90 degrees or more, some normals face the camera
+    if (min_cos <= 0)
+        return false;
+
+    const float sin_half_angle = sqrt(1 - min_cos * min_cos);
+
+    // The patch is back-facing if the directions from the camera to all control points
+    // are within 90 degrees minus half of the cone's angle from the cone's axis
+    for (uint i = 0; i < 16; i++) {
+        const vec3 view_dir = perspective ? view_pos[i] : vec3(0, 0, 1);
+
+        if (dot(view_dir, axis) <= sin_half_angle * length(view_dir))
+            return false;
+    }
+
+    return true;
+}
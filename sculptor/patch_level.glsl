@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Requires bezier_cubic_data.glsl and transforms.glsl, levels are computed for the current view
+
+// Projects a control point to screen space, in pixels
+vec2 project_to_screen(vec3 obj_pos)
+{
+    const vec4 view_pos = vec4(obj_pos, 1) * views[view_index].model_view;
+    const vec4 clip_pos = projection(view_pos.xyz);
+
+    // Control points behind the camera produce huge levels, which are clamped
+    const float w = max(clip_pos.w, 1.0 / 1024);
+
+    return clip_pos.xy / (w * views[view_index].pixel_dim);
+}
+
+// Computes the number of segments for a curve from its projected control points.
+// The result only depends on the set of control points and not on their order,
+// so that faces sharing an edge compute the same outer level and don't produce cracks.
+float curve_level(vec2 p0, vec2 p1, vec2 p2, vec2 p3)
+{
+    const float target_len = float(tess_level.z);
+
+    // Length of the control polygon is an upper bound of the curve's length
+    precise const float hull_len = (distance(p0, p1) + distance(p2, p3)) + distance(p1, p2);
+
+    // Deviation of a curve from n segments is at most 3/4 * max|p[i] - 2p[i+1] + p[i+2]| / n^2,
+    // for flatness tolerance use a fraction of the target segment length
+    precise const float curvature = max(length((p0 + p2) - 2 * p1), length((p1 + p3) - 2 * p2));
+    const float tolerance = target_len * (1.0 / 16);
+
+    return max(hull_len / target_len, sqrt(0.75 * curvature / tolerance));
+}
@@ -38,10 +38,40 @@ uint32_t check_device_features()
 {
     uint32_t missing_features = 0;
 
-    missing_features += check_feature(&vk_features.features.tessellationShader);
+    // Without tessellation shaders, patches are evaluated in a compute shader
+    if (vk_features.features.tessellationShader)
+        check_feature(&vk_features.features.tessellationShader);
+
+    // With task and mesh shaders, patches are culled and evaluated in these shaders instead
+    if (Sculptor::use_mesh_shading()) {
+        check_feature(&vk_mesh_shader_features.taskShader);
+        check_feature(&vk_mesh_shader_features.meshShader);
+    }
+
     missing_features += check_feature(&vk_features.features.fillModeNonSolid);
     missing_features += check_feature(&vk_dyn_rendering_features.dynamicRendering);
 
+    // All views of the quad view are drawn in one pass, shaders select transforms by view index.
+    // Quad view is only available if it is also supported with the shaders which draw patches,
+    // without multiview shaders only draw the first view.
+    if (vk_multiview_features.multiview) {
+        check_feature(&vk_multiview_features.multiview);
+
+        if (vk_features.features.tessellationShader && vk_multiview_features.multiviewTessellationShader)
+            check_feature(&vk_multiview_features.multiviewTessellationShader);
+
+        if (Sculptor::use_mesh_shading() && vk_mesh_shader_features.multiviewMeshShader)
+            check_feature(&vk_mesh_shader_features.multiviewMeshShader);
+    }
+
+    // Patch materials are indexed per face and their textures are in a partially bound array,
+    // without these features patches are drawn without material textures
+    if (vk_desc_indexing_features.descriptorBindingPartiallyBound &&
+        vk_desc_indexing_features.shaderSampledImageArrayNonUniformIndexing) {
+        check_feature(&vk_desc_indexing_features.descriptorBindingPartiallyBound);
+        check_feature(&vk_desc_indexing_features.shaderSampledImageArrayNonUniformIndexing);
+    }
+
     return missing_features;
 }
 
@@ -0,0 +1,564 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_bvh.h"
+#include "sculptor_geometry.h"
+
+#include "../d_printf.h"
+#include "../mstdc.h"
+#include "../vecfloat.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+using vmath::float4;
+using vmath::vec3;
+
+namespace {
+    // Bounds of empty child slots, which never intersect any ray
+    constexpr float    empty_min      = 1e30f;
+    constexpr float    empty_max      = -1e30f;
+
+    // Distance reported when nothing was hit
+    constexpr float    no_hit         = 1e30f;
+
+    constexpr uint32_t max_stack_size = 64;
+
+    // Newton iterations on the patch surface for each starting point
+    constexpr uint32_t max_iterations = 8;
+
+    // Max distance of the ray from the surface, in units of int16 coordinates
+    constexpr float    max_distance   = 0.5f;
+
+    // Tolerance of u and v outside of the patch
+    constexpr float    uv_tolerance   = 1.0f / 1024.0f;
+
+    // Smallest magnitude of ray direction components, avoids division by zero
+    constexpr float    min_dir        = 1.0f / (1024.0f * 1024.0f);
+}
+
+template<typename T>
+static bool reserve_array(T** array, uint32_t* capacity, uint32_t required)
+{
+    if (required <= *capacity)
+        return true;
+
+    T* const new_array = static_cast<T*>(realloc(*array, required * sizeof(T)));
+    if ( ! new_array) {
+        d_printf("Failed to allocate BVH array of %u entries\n", required);
+        return false;
+    }
+
+    *array    = new_array;
+    *capacity = required;
+    return true;
+}
+
+bool Sculptor::PatchBVH::build(const Geometry& geom)
+{
+    valid        = false;
+    num_faces    = geom.get_num_faces();
+    num_vertices = geom.get_num_vertices();
+    num_nodes    = 0;
+
+    // Every node has at least 2 children, so there are fewer nodes than faces
+    if ( ! reserve_array(&nodes,             &nodes_cap,        num_faces + 1)    ||
+         ! reserve_array(&face_bounds,       &face_bounds_cap,  num_faces)        ||
+         ! reserve_array(&face_order,        &face_order_cap,   num_faces)        ||
+         ! reserve_array(&face_node,         &face_node_cap,    num_faces)        ||
+         ! reserve_array(&vertex_face_start, &vertex_start_cap, num_vertices + 1) ||
+         ! reserve_array(&vertex_faces,      &vertex_faces_cap, num_faces * 16))
+        return false;
+
+    // Build the table of faces which refer to each vertex, used for refitting
+    mstd::mem_zero(vertex_face_start, (num_vertices + 1) * sizeof(uint32_t));
+
+    for (uint32_t i_face = 0; i_face < num_faces; i_face++) {
+        uint32_t indices[16];
+        geom.get_face_indices(i_face, indices);
+
+        for (const uint32_t idx : indices)
+            ++vertex_face_start[idx + 1];
+
+        get_face_bounds(geom, i_face, &face_bounds[i_face]);
+        face_order[i_face] = i_face;
+    }
+
+    for (uint32_t vtx = 1; vtx <= num_vertices; vtx++)
+        vertex_face_start[vtx] += vertex_face_start[vtx - 1];
+
+    for (uint32_t i_face = 0; i_face < num_faces; i_face++) {
+        uint32_t indices[16];
+        geom.get_face_indices(i_face, indices);
+
+        for (const uint32_t idx : indices)
+            vertex_faces[vertex_face_start[idx]++] = i_face;
+    }
+
+    // Filling has moved the start of each vertex to the start of the next vertex
+    for (uint32_t vtx = num_vertices; vtx > 0; vtx--)
+        vertex_face_start[vtx] = vertex_face_start[vtx - 1];
+    vertex_face_start[0] = 0;
+
+    if (num_faces)
+        build_node(0, num_faces, no_child, 0);
+
+    // Children are always created after their parents, so compute bounds bottom-up
+    for (uint32_t node_id = num_nodes; node_id > 0; ) {
+        --node_id;
+
+        for (uint32_t slot = 0; slot < 4; slot++) {
+            const uint32_t child = nodes[node_id].child[slot];
+
+            Bounds bounds;
+            if (child == no_child) {
+                for (uint32_t axis = 0; axis < 3; axis++) {
+                    bounds.min[axis] = empty_min;
+                    bounds.max[axis] = empty_max;
+                }
+            }
+            else if (child & leaf_bit)
+                bounds = face_bounds[child & ~leaf_bit];
+            else
+                get_node_bounds(child, &bounds);
+
+            set_child_bounds(node_id, slot, bounds);
+        }
+    }
+
+    valid = true;
+    return true;
+}
+
+uint32_t Sculptor::PatchBVH::build_node(uint32_t first, uint32_t count, uint32_t parent, uint32_t parent_slot)
+{
+    assert(num_nodes < nodes_cap);
+    assert(count > 0);
+
+    const uint32_t node_id = num_nodes++;
+
+    nodes[node_id].parent      = parent;
+    nodes[node_id].parent_slot = parent_slot;
+
+    uint32_t range_first[4];
+    uint32_t range_count[4];
+    uint32_t num_ranges = 4;
+
+    if (count <= 4) {
+        for (uint32_t i = 0; i < count; i++) {
+            range_first[i] = first + i;
+            range_count[i] = 1;
+        }
+        num_ranges = count;
+    }
+    else {
+        // Split faces in half along the longest axis, then split each half again
+        const uint32_t half       = count / 2;
+        const uint32_t quarter_lo = half / 2;
+        const uint32_t quarter_hi = (count - half) / 2;
+
+        split_faces(first,        count,        half);
+        split_faces(first,        half,         quarter_lo);
+        split_faces(first + half, count - half, quarter_hi);
+
+        range_first[0] = first;
+        range_count[0] = quarter_lo;
+        range_first[1] = first + quarter_lo;
+        range_count[1] = half - quarter_lo;
+        range_first[2] = first + half;
+        range_count[2] = quarter_hi;
+        range_first[3] = first + half + quarter_hi;
+        range_count[3] = count - half - quarter_hi;
+    }
+
+    for (uint32_t slot = 0; slot < 4; slot++) {
+        uint32_t child = no_child;
+
+        if (slot < num_ranges) {
+            if (range_count[slot] == 1) {
+                const uint32_t face_id = face_order[range_first[slot]];
+                face_node[face_id] = node_id;
+                child = leaf_bit | face_id;
+            }
+            else
+                child = build_node(range_first[slot], range_count[slot], node_id, slot);
+        }
+
+        nodes[node_id].child[slot] = child;
+    }
+
+    return node_id;
+}
+
+float Sculptor::PatchBVH::get_centroid(uint32_t face_id, uint32_t axis) const
+{
+    // Scaled by 2, which does not change the ordering
+    return face_bounds[face_id].min[axis] + face_bounds[face_id].max[axis];
+}
+
+// Reorders faces in the range, so that the nth face is in place when sorted by the centroid
+// along the longest axis, and all faces before it have smaller or equal centroids
+void Sculptor::PatchBVH::split_faces(uint32_t first, uint32_t count, uint32_t nth)
+{
+    uint32_t* const order = &face_order[first];
+
+    float min_c[3];
+    float max_c[3];
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        min_c[axis] = get_centroid(order[0], axis);
+        max_c[axis] = min_c[axis];
+    }
+
+    for (uint32_t i = 1; i < count; i++) {
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            const float c = get_centroid(order[i], axis);
+            min_c[axis] = mstd::min(min_c[axis], c);
+            max_c[axis] = mstd::max(max_c[axis], c);
+        }
+    }
+
+    uint32_t axis = 0;
+    for (uint32_t i = 1; i < 3; i++)
+        if (max_c[i] - min_c[i] > max_c[axis] - min_c[axis])
+            axis = i;
+
+    int32_t       left   = 0;
+    int32_t       right  = static_cast<int32_t>(count) - 1;
+    const int32_t target = static_cast<int32_t>(nth);
+
+    while (left < right) {
+        const float pivot = get_centroid(order[(left + right) / 2], axis);
+
+        int32_t i = left;
+        int32_t j = right;
+
+        while (i <= j) {
+            while (get_centroid(order[i], axis) < pivot)
+                ++i;
+            while (get_centroid(order[j], axis) > pivot)
+                --j;
+
+            if (i <= j) {
+                const uint32_t tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+                ++i;
+                --j;
+            }
+        }
+
+        if (target <= j)
+            right = j;
+        else if (target >= i)
+            left = i;
+        else
+            break;
+    }
+}
+
+void Sculptor::PatchBVH::get_face_bounds(const Geometry& geom, uint32_t face_id, Bounds* bounds) const
+{
+    uint32_t indices[16];
+    geom.get_face_indices(face_id, indices);
+
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        bounds->min[axis] = empty_min;
+        bounds->max[axis] = empty_max;
+    }
+
+    for (const uint32_t idx : indices) {
+        const Geometry::Vertex& vertex = geom.get_vertex(idx);
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            const float pos = static_cast<float>(vertex.pos[axis]);
+            bounds->min[axis] = mstd::min(bounds->min[axis], pos);
+            bounds->max[axis] = mstd::max(bounds->max[axis], pos);
+        }
+    }
+}
+
+void Sculptor::PatchBVH::get_node_bounds(uint32_t node_id, Bounds* bounds) const
+{
+    const Node& node = nodes[node_id];
+
+    bounds->min[0] = mstd::min(mstd::min(node.min_x[0], node.min_x[1]), mstd::min(node.min_x[2], node.min_x[3]));
+    bounds->min[1] = mstd::min(mstd::min(node.min_y[0], node.min_y[1]), mstd::min(node.min_y[2], node.min_y[3]));
+    bounds->min[2] = mstd::min(mstd::min(node.min_z[0], node.min_z[1]), mstd::min(node.min_z[2], node.min_z[3]));
+    bounds->max[0] = mstd::max(mstd::max(node.max_x[0], node.max_x[1]), mstd::max(node.max_x[2], node.max_x[3]));
+    bounds->max[1] = mstd::max(mstd::max(node.max_y[0], node.max_y[1]), mstd::max(node.max_y[2], node.max_y[3]));
+    bounds->max[2] = mstd::max(mstd::max(node.max_z[0], node.max_z[1]), mstd::max(node.max_z[2], node.max_z[3]));
+}
+
+void Sculptor::PatchBVH::set_child_bounds(uint32_t node_id, uint32_t slot, const Bounds& bounds)
+{
+    Node& node = nodes[node_id];
+
+    node.min_x[slot] = bounds.min[0];
+    node.min_y[slot] = bounds.min[1];
+    node.min_z[slot] = bounds.min[2];
+    node.max_x[slot] = bounds.max[0];
+    node.max_y[slot] = bounds.max[1];
+    node.max_z[slot] = bounds.max[2];
+}
+
+void Sculptor::PatchBVH::refit_face(const Geometry& geom, uint32_t face_id)
+{
+    get_face_bounds(geom, face_id, &face_bounds[face_id]);
+
+    uint32_t node_id = face_node[face_id];
+
+    uint32_t slot = 0;
+    while (nodes[node_id].child[slot] != (leaf_bit | face_id)) {
+        ++slot;
+        assert(slot < 4);
+    }
+
+    set_child_bounds(node_id, slot, face_bounds[face_id]);
+
+    // Propagate new bounds towards the root
+    while (nodes[node_id].parent != no_child) {
+        Bounds bounds;
+        get_node_bounds(node_id, &bounds);
+
+        const Node& node = nodes[node_id];
+        set_child_bounds(node.parent, node.parent_slot, bounds);
+        node_id = node.parent;
+    }
+}
+
+void Sculptor::PatchBVH::refit_vertex(const Geometry& geom, uint32_t vtx)
+{
+    // Vertices added after the BVH was built are not used by any faces in it
+    if ( ! valid || vtx >= num_vertices)
+        return;
+
+    const uint32_t end = vertex_face_start[vtx + 1];
+    for (uint32_t i = vertex_face_start[vtx]; i < end; i++) {
+        const uint32_t face_id = vertex_faces[i];
+
+        // The same face may be listed more than once
+        if (i > vertex_face_start[vtx] && vertex_faces[i - 1] == face_id)
+            continue;
+
+        refit_face(geom, face_id);
+    }
+}
+
+static void eval_bernstein(float t, float* b, float* db)
+{
+    const float s = 1.0f - t;
+
+    b[0]  = s * s * s;
+    b[1]  = 3.0f * t * s * s;
+    b[2]  = 3.0f * t * t * s;
+    b[3]  = t * t * t;
+
+    db[0] = -3.0f * s * s;
+    db[1] = 3.0f * s * s - 6.0f * t * s;
+    db[2] = 6.0f * t * s - 3.0f * t * t;
+    db[3] = 3.0f * t * t;
+}
+
+// Evaluates position and partial derivatives of a bicubic Bezier patch, the control points
+// are laid out in 4 rows along u, consistent with the tessellation evaluation shader
+static void eval_patch(const vec3* ctrl, float u, float v, vec3* pos, vec3* du, vec3* dv)
+{
+    float bu[4];
+    float dbu[4];
+    float bv[4];
+    float dbv[4];
+
+    eval_bernstein(u, bu, dbu);
+    eval_bernstein(v, bv, dbv);
+
+    *pos = vec3{0.0f};
+    *du  = vec3{0.0f};
+    *dv  = vec3{0.0f};
+
+    for (uint32_t row = 0; row < 4; row++) {
+        vec3 row_pos{0.0f};
+        vec3 row_du{0.0f};
+
+        for (uint32_t col = 0; col < 4; col++) {
+            row_pos += bu[col]  * ctrl[row * 4 + col];
+            row_du  += dbu[col] * ctrl[row * 4 + col];
+        }
+
+        *pos += bv[row]  * row_pos;
+        *du  += bv[row]  * row_du;
+        *dv  += dbv[row] * row_pos;
+    }
+}
+
+// Finds intersection of the ray with the patch surface using Newton iterations.
+// The ray is represented as intersection of two planes and the solver finds u and v
+// at which the surface lies on both planes.
+static bool intersect_patch(const vec3*  ctrl,
+                            const vec3&  origin,
+                            const vec3&  dir,
+                            const vec3&  plane_1,
+                            const vec3&  plane_2,
+                            float*       out_t,
+                            float*       out_u,
+                            float*       out_v)
+{
+    static const float start_uv[][2] = {
+        { 0.5f,  0.5f  },
+        { 0.25f, 0.25f },
+        { 0.75f, 0.25f },
+        { 0.25f, 0.75f },
+        { 0.75f, 0.75f }
+    };
+
+    const float d_1 = -vmath::dot_product(plane_1, origin);
+    const float d_2 = -vmath::dot_product(plane_2, origin);
+    const float rdir_len_sq = 1.0f / vmath::dot_product(dir, dir);
+
+    bool found = false;
+
+    for (const auto& start : start_uv) {
+        float u = start[0];
+        float v = start[1];
+
+        for (uint32_t iter = 0; iter < max_iterations; iter++) {
+            vec3 pos;
+            vec3 du;
+            vec3 dv;
+            eval_patch(ctrl, u, v, &pos, &du, &dv);
+
+            const float f_1 = vmath::dot_product(plane_1, pos) + d_1;
+            const float f_2 = vmath::dot_product(plane_2, pos) + d_2;
+
+            const bool on_ray = (f_1 * f_1 + f_2 * f_2) <= max_distance * max_distance;
+
+            if (on_ray && u >= -uv_tolerance && u <= 1.0f + uv_tolerance &&
+                          v >= -uv_tolerance && v <= 1.0f + uv_tolerance) {
+
+                const float t = vmath::dot_product(pos - origin, dir) * rdir_len_sq;
+
+                if (t > 0.0f && t < *out_t) {
+                    *out_t = t;
+                    *out_u = mstd::min(mstd::max(u, 0.0f), 1.0f);
+                    *out_v = mstd::min(mstd::max(v, 0.0f), 1.0f);
+                    found  = true;
+                }
+                break;
+            }
+
+            const float j_11 = vmath::dot_product(plane_1, du);
+            const float j_12 = vmath::dot_product(plane_1, dv);
+            const float j_21 = vmath::dot_product(plane_2, du);
+            const float j_22 = vmath::dot_product(plane_2, dv);
+            const float det  = j_11 * j_22 - j_12 * j_21;
+
+            if (det == 0.0f)
+                break;
+
+            const float rdet = 1.0f / det;
+
+            u -= (j_22 * f_1 - j_12 * f_2) * rdet;
+            v -= (j_11 * f_2 - j_21 * f_1) * rdet;
+
+            // Diverged far outside of the patch
+            if (u < -1.0f || u > 2.0f || v < -1.0f || v > 2.0f)
+                break;
+        }
+    }
+
+    return found;
+}
+
+bool Sculptor::PatchBVH::intersect(const Geometry&    geom,
+                                   const vec3&        origin,
+                                   const vec3&        dir,
+                                   Hit*               hit) const
+{
+    hit->face_id = ~0U;
+    hit->t       = no_hit;
+    hit->u       = 0;
+    hit->v       = 0;
+
+    if ( ! valid || ! num_nodes)
+        return false;
+
+    // Planes which contain the ray, used for solving the intersection with patch surfaces
+    const float abs_x = (dir.x < 0.0f) ? -dir.x : dir.x;
+    const float abs_y = (dir.y < 0.0f) ? -dir.y : dir.y;
+    const float abs_z = (dir.z < 0.0f) ? -dir.z : dir.z;
+
+    const vec3 plane_1 = vmath::normalize((abs_x > abs_y && abs_x > abs_z) ? vec3{dir.y, -dir.x, 0.0f}
+                                                                           : vec3{0.0f, dir.z, -dir.y});
+    const vec3 plane_2 = vmath::normalize(vmath::cross_product(plane_1, dir));
+
+    float inv_dir[3];
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        const float d = dir[axis];
+        inv_dir[axis] = 1.0f / ((d < 0.0f) ? mstd::min(d, -min_dir) : mstd::max(d, min_dir));
+    }
+
+    const float4 origin_x  = vmath::spread4(origin.x);
+    const float4 origin_y  = vmath::spread4(origin.y);
+    const float4 origin_z  = vmath::spread4(origin.z);
+    const float4 inv_dir_x = vmath::spread4(inv_dir[0]);
+    const float4 inv_dir_y = vmath::spread4(inv_dir[1]);
+    const float4 inv_dir_z = vmath::spread4(inv_dir[2]);
+    const float4 zero      = vmath::spread4(0.0f);
+
+    uint32_t stack[max_stack_size];
+    uint32_t stack_size = 0;
+
+    stack[stack_size++] = 0;
+
+    while (stack_size) {
+        const Node& node = nodes[stack[--stack_size]];
+
+        // Slab test of the ray against bounds of all 4 children at once
+        const float4 t0_x = (float4::load4_aligned(node.min_x) - origin_x) * inv_dir_x;
+        const float4 t1_x = (float4::load4_aligned(node.max_x) - origin_x) * inv_dir_x;
+        const float4 t0_y = (float4::load4_aligned(node.min_y) - origin_y) * inv_dir_y;
+        const float4 t1_y = (float4::load4_aligned(node.max_y) - origin_y) * inv_dir_y;
+        const float4 t0_z = (float4::load4_aligned(node.min_z) - origin_z) * inv_dir_z;
+        const float4 t1_z = (float4::load4_aligned(node.max_z) - origin_z) * inv_dir_z;
+
+        const float4 t_near = vmath::max(vmath::max(vmath::min(t0_x, t1_x), vmath::min(t0_y, t1_y)),
+                                         vmath::max(vmath::min(t0_z, t1_z), zero));
+        const float4 t_far  = vmath::min(vmath::min(vmath::max(t0_x, t1_x), vmath::max(t0_y, t1_y)),
+                                         vmath::min(vmath::max(t0_z, t1_z), vmath::spread4(hit->t)));
+
+        alignas(16) float near[4];
+        alignas(16) float far[4];
+        t_near.store4_aligned(near);
+        t_far.store4_aligned(far);
+
+        for (uint32_t slot = 0; slot < 4; slot++) {
+            const uint32_t child = node.child[slot];
+
+            if (child == no_child || near[slot] > far[slot])
+                continue;
+
+            if (child & leaf_bit) {
+                const uint32_t face_id = child & ~leaf_bit;
+
+                uint32_t indices[16];
+                geom.get_face_indices(face_id, indices);
+
+                vec3 ctrl[16];
+                for (uint32_t i = 0; i < 16; i++) {
+                    const Geometry::Vertex& vertex = geom.get_vertex(indices[i]);
+                    ctrl[i] = vec3{static_cast<float>(vertex.pos[0]),
+                                   static_cast<float>(vertex.pos[1]),
+                                   static_cast<float>(vertex.pos[2])};
+                }
+
+                if (intersect_patch(ctrl, origin, dir, plane_1, plane_2, &hit->t, &hit->u, &hit->v))
+                    hit->face_id = face_id;
+            }
+            else {
+                assert(stack_size < max_stack_size);
+                stack[stack_size++] = child;
+            }
+        }
+    }
+
+    return hit->face_id != ~0U;
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include "../vmath.h"
+
+#include <stdint.h>
+
+namespace Sculptor {
+
+class Geometry;
+
+// Bounding volume hierarchy over Bezier patches, used for picking on the CPU.
+// Each node has 4 children, which are tested against a ray at once.
+// Patch bounds are computed from control points, which enclose the patch.
+class PatchBVH {
+    public:
+        constexpr PatchBVH() = default;
+        PatchBVH(const PatchBVH&)            = delete;
+        PatchBVH& operator=(const PatchBVH&) = delete;
+
+        struct Hit {
+            uint32_t face_id;
+            float    t;     // Distance along the ray, in units of ray direction
+            float    u;
+            float    v;
+        };
+
+        bool is_valid() const { return valid; }
+        void invalidate()     { valid = false; }
+
+        bool build(const Geometry& geom);
+        void refit_vertex(const Geometry& geom, uint32_t vtx);
+        bool intersect(const Geometry& geom, const vmath::vec3& origin, const vmath::vec3& dir, Hit* hit) const;
+
+    private:
+        static constexpr uint32_t leaf_bit = 0x80000000U;
+        static constexpr uint32_t no_child = ~0U;
+
+        // Bounds of 4 children are stored in SoA layout for testing them at once
+        struct alignas(16) Node {
+            float    min_x[4];
+            float    min_y[4];
+            float    min_z[4];
+            float    max_x[4];
+            float    max_y[4];
+            float    max_z[4];
+            uint32_t child[4]; // Node index, leaf_bit | face id or no_child
+            uint32_t parent;
+            uint32_t parent_slot;
+        };
+
+        struct Bounds {
+            float min[3];
+            float max[3];
+        };
+
+        uint32_t build_node(uint32_t first, uint32_t count, uint32_t parent, uint32_t parent_slot);
+        void     split_faces(uint32_t first, uint32_t count, uint32_t nth);
+        float    get_centroid(uint32_t face_id, uint32_t axis) const;
+        void     get_face_bounds(const Geometry& geom, uint32_t face_id, Bounds* bounds) const;
+        void     get_node_bounds(uint32_t node_id, Bounds* bounds) const;
+        void     set_child_bounds(uint32_t node_id, uint32_t slot, const Bounds& bounds);
+        void     refit_face(const Geometry& geom, uint32_t face_id);
+
+        Node*     nodes             = nullptr;
+        Bounds*   face_bounds       = nullptr;
+        uint32_t* face_order        = nullptr;
+        uint32_t* face_node         = nullptr; // Node which holds each face as a leaf
+        uint32_t* vertex_face_start = nullptr; // Faces of vertex v are vertex_faces[start[v]..start[v+1]]
+        uint32_t* vertex_faces      = nullptr;
+        uint32_t  nodes_cap         = 0;
+        uint32_t  face_bounds_cap   = 0;
+        uint32_t  face_order_cap    = 0;
+        uint32_t  face_node_cap     = 0;
+        uint32_t  vertex_start_cap  = 0;
+        uint32_t  vertex_faces_cap  = 0;
+        uint32_t  num_nodes         = 0;
+        uint32_t  num_faces         = 0;
+        uint32_t  num_vertices      = 0;
+        bool      valid             = false;
+};
+
+}
@@ -22,7 +22,7 @@
 Object editor UI
 ----------------
 
-- One viewport, drawing sequence:
+- One viewport or four viewports in quad view, drawing sequence:
     - Background
     - Grid
     - Solid object fill
@@ -48,6 +48,7 @@ User input
     - Num . :: focus on selection
     - Num 1/2/3 orthographic view aligned to axis
     - Alt-Z toggle all vertices (wireframe) and surface vertices (solid) - impacts selection
+    - Alt-Q :: toggle quad view: top, perspective, front and right views, drawn in one pass
     - Middle mouse button :: rotate view
     - Shift + Middle mouse button :: pan view
     - Mouse scroll :: zoom view
@@ -142,7 +143,13 @@ namespace {
         num_materials
     };
 
-    struct Transforms {
+    // Must match max_views in transforms.glsl
+    constexpr uint32_t max_views      = 4;
+    constexpr uint32_t quad_view_mask = (1U << max_views) - 1U;
+
+    static_assert(max_views <= Sculptor::Geometry::max_cull_views, "Culling must handle all views");
+
+    struct ViewTransforms {
         vmath::mat4 model_view;
         vmath::mat3 model_view_normal;
         vmath::vec4 proj;
@@ -150,9 +157,16 @@ namespace {
         vmath::vec2 pixel_dim;
     };
 
+    // With multiview, shaders select transforms by view index
+    struct Transforms {
+        ViewTransforms views[max_views];
+    };
+
     constexpr uint32_t transforms_per_viewport = 1;
     constexpr float    int16_scale             = 32767.0f;
-    constexpr uint32_t max_grid_lines          = 4096;
+
+    // Size of the region around the mouse cursor read back from the selection feedback
+    constexpr uint32_t select_region_size      = 16;
 
     ImageWithHostCopy  toolbar_image;
 
@@ -168,6 +182,34 @@ namespace {
         TOOLBAR_BUTTONS
 #       undef X
     };
+
+    // Shaders which select transforms by view index, the variants without multiview
+    // only draw the first view
+    struct SingleViewShader {
+        uint8_t* multiview;
+        uint8_t* single_view;
+    };
+
+    const SingleViewShader single_view_shaders[] = {
+        { shader_bezier_line_cubic_sculptor_vert,    shader_bezier_line_cubic_sculptor_single_view_vert    },
+        { shader_bezier_surface_cubic_sculptor_tesc, shader_bezier_surface_cubic_sculptor_single_view_tesc },
+        { shader_bezier_surface_cubic_sculptor_tese, shader_bezier_surface_cubic_sculptor_single_view_tese },
+        { shader_sculptor_tessellated_vert,          shader_sculptor_tessellated_single_view_vert          },
+        { shader_sculptor_grid_frag,                 shader_sculptor_grid_single_view_frag                 },
+        { shader_sculptor_vertex_select_vert,        shader_sculptor_vertex_select_single_view_vert        }
+    };
+
+    void use_single_view_shaders(Sculptor::MaterialInfo* mat_info)
+    {
+        for (uint8_t*& shader_id : mat_info->shader_ids) {
+            for (const SingleViewShader& shader : single_view_shaders) {
+                if (shader_id == shader.multiview) {
+                    shader_id = shader.single_view;
+                    break;
+                }
+            }
+        }
+    }
 }
 
 namespace Sculptor {
@@ -251,15 +293,13 @@ bool GeometryEditor::alloc_view_resources(View*     dst_view,
     if (dst_view->res[0].color.get_image())
         return true;
 
-    const uint32_t new_host_sel_size = mstd::align_up(width, 1024U) * mstd::align_up(height, 1024U);
-    const bool     update_host_sel   = new_host_sel_size > dst_view->host_sel_size;
-    if (update_host_sel) {
-        dst_view->host_sel_size = new_host_sel_size;
-        d_printf("Updating host selection feedback surface\n");
-    }
+    // In quad view the window is split into four views of equal size
+    const uint32_t num_columns = dst_view->quad_view ? 2U : 1U;
 
-    dst_view->width  = width;
-    dst_view->height = height;
+    dst_view->num_views   = dst_view->quad_view ? max_views : 1U;
+    dst_view->active_view = 0;
+    dst_view->width       = mstd::max(width  / num_columns, 1U);
+    dst_view->height      = mstd::max(height / num_columns, 1U);
 
     for (uint32_t i_img = 0; i_img < vk_num_swapchain_images; i_img++) {
         Resources& res = dst_view->res[i_img];
@@ -277,9 +317,13 @@ bool GeometryEditor::alloc_view_resources(View*     dst_view,
             Usage::device_only
         };
 
-        color_info.width  = width;
-        color_info.height = height;
+        // In quad view, views are copied into quadrants of the color image
+        color_info.width  = dst_view->width  * num_columns;
+        color_info.height = dst_view->height * num_columns;
         color_info.format = swapchain_create_info.imageFormat;
+        color_info.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (dst_view->quad_view)
+            color_info.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
         static ImageInfo depth_info {
             0, // width
@@ -291,9 +335,10 @@ bool GeometryEditor::alloc_view_resources(View*     dst_view,
             Usage::device_only
         };
 
-        depth_info.width  = width;
-        depth_info.height = height;
-        depth_info.format = vk_depth_format;
+        depth_info.width        = dst_view->width;
+        depth_info.height       = dst_view->height;
+        depth_info.format       = vk_depth_format;
+        depth_info.array_layers = dst_view->num_views;
 
         static ImageInfo select_query_info {
             0, // width
@@ -305,27 +350,32 @@ bool GeometryEditor::alloc_view_resources(View*     dst_view,
             Usage::device_only
         };
 
-        select_query_info.width  = width;
-        select_query_info.height = height;
+        select_query_info.width        = dst_view->width;
+        select_query_info.height       = dst_view->height;
+        select_query_info.array_layers = dst_view->num_views;
 
-        static ImageInfo select_query_host_info {
-            0, // width
-            0, // height
-            VK_FORMAT_R32_UINT,
-            1, // mip_levels
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-            Usage::host_only
-        };
+        if ( ! res.color.allocate(color_info, {"view color output", i_img}))
+            return false;
 
-        select_query_host_info.width  = mstd::align_up(width,  1024U);
-        select_query_host_info.height = mstd::align_up(height, 1024U);
+        if (dst_view->quad_view) {
+            static ImageInfo views_color_info {
+                0, // width
+                0, // height
+                VK_FORMAT_UNDEFINED,
+                1, // mip_levels
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                Usage::device_only,
+                max_views // array_layers
+            };
 
-        if (update_host_sel)
-            res.host_select_feedback.free();
+            views_color_info.width  = dst_view->width;
+            views_color_info.height = dst_view->height;
+            views_color_info.format = swapchain_create_info.imageFormat;
 
-        if ( ! res.color.allocate(color_info, {"view color output", i_img}))
-            return false;
+            if ( ! res.views_color.allocate(views_color_info, {"quad view color", i_img}))
+                return false;
+        }
 
         if ( ! res.depth.allocate(depth_info, {"view depth", i_img}))
             return false;
@@ -333,7 +383,12 @@ bool GeometryEditor::alloc_view_resources(View*     dst_view,
         if ( ! res.select_feedback.allocate(select_query_info, {"view select feedback", i_img}))
             return false;
 
-        if ( ! res.host_select_feedback.allocate(select_query_host_info, {"view host select feedback", i_img}))
+        if ( ! res.host_select_feedback.allocated() &&
+             ! res.host_select_feedback.allocate(Usage::host_only,
+                                                 select_region_size * select_region_size * sizeof(uint32_t),
+                                                 VK_FORMAT_UNDEFINED,
+                                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                 {"view host select feedback", i_img}))
             return false;
 
         res.selection_pending = false;
@@ -393,6 +448,8 @@ void GeometryEditor::free_view_resources(View* dst_view)
         Resources& res = dst_view->res[i_img];
 
         res.color.free();
+        if (res.views_color.get_image())
+            res.views_color.free();
         res.depth.free();
         res.select_feedback.free();
         res.host_select_feedback.free();
@@ -404,7 +461,7 @@ void GeometryEditor::free_view_resources(View* dst_view)
 bool GeometryEditor::allocate_resources_once()
 {
     // Check if already allocated
-    if (gray_patch_mat)
+    if (gray_patch_mat[0])
         return true;
 
     if ( ! patch_geometry.allocate())
@@ -413,13 +470,18 @@ bool GeometryEditor::allocate_resources_once()
     // TODO load user-specified geometry
     patch_geometry.set_cube();
 
+#ifndef NDEBUG
+    if ( ! patch_geometry.verify_gpu_indices())
+        return false;
+#endif
+
     if ( ! create_materials())
         return false;
 
-    if ( ! create_transforms_buffer())
+    if ( ! create_patch_materials())
         return false;
 
-    if ( ! create_grid_buffer())
+    if ( ! create_transforms_buffer())
         return false;
 
     if ( ! create_descriptor_sets())
@@ -495,7 +557,91 @@ bool GeometryEditor::create_materials()
         { 0x00, 0x00, 0x00 } // diffuse
     };
 
-    if ( ! create_material(object_mat_info, &gray_patch_mat))
+    static const VkVertexInputAttributeDescription tess_vertex_attributes[] = {
+        {
+            0, // location
+            0, // binding
+            VK_FORMAT_R32G32B32_SFLOAT,
+            offsetof(Sculptor::Geometry::TessVertex, pos)
+        },
+        {
+            1, // location
+            0, // binding
+            VK_FORMAT_R32_UINT,
+            offsetof(Sculptor::Geometry::TessVertex, face_id)
+        },
+        {
+            2, // location
+            0, // binding
+            VK_FORMAT_R32G32B32_SFLOAT,
+            offsetof(Sculptor::Geometry::TessVertex, normal)
+        },
+        {
+            3, // location
+            0, // binding
+            VK_FORMAT_R16G16_UNORM,
+            offsetof(Sculptor::Geometry::TessVertex, uv)
+        }
+    };
+
+    // Used instead of tessellation shaders on devices which don't support them
+    static const MaterialInfo tess_object_mat_info = {
+        {
+            shader_sculptor_tessellated_vert,
+            shader_sculptor_object_frag
+        },
+        tess_vertex_attributes,
+        0.0f, // depth_bias
+        mstd::array_size(tess_vertex_attributes),
+        sizeof(Sculptor::Geometry::TessVertex),
+        VK_FORMAT_UNDEFINED,
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        0, // patch_control_points
+        VK_POLYGON_MODE_FILL,
+        VK_CULL_MODE_BACK_BIT,
+        true,                // depth_test
+        true,                // depth_write
+        { 0x00, 0x00, 0x00 } // diffuse
+    };
+
+    // Used instead of tessellation shaders on devices which support task and mesh shaders
+    static const MaterialInfo mesh_object_mat_info = {
+        {
+            shader_sculptor_patch_mesh,
+            shader_sculptor_object_frag,
+            shader_sculptor_patch_task
+        },
+        nullptr,
+        0.0f, // depth_bias
+        0,
+        0,
+        VK_FORMAT_UNDEFINED,
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        0, // patch_control_points
+        VK_POLYGON_MODE_FILL,
+        VK_CULL_MODE_BACK_BIT,
+        true,                 // depth_test
+        true,                 // depth_write
+        { 0x00, 0x00, 0x00 }, // diffuse
+        true                  // mesh_shading
+    };
+
+    MaterialInfo patch_mat_info =
+        patch_geometry.uses_mesh_shading()         ? mesh_object_mat_info :
+        patch_geometry.uses_compute_tessellation() ? tess_object_mat_info : object_mat_info;
+
+    if ( ! Sculptor::use_material_textures())
+        patch_mat_info.shader_ids[1] = shader_sculptor_object_untextured_frag;
+
+    if ( ! create_view_materials(patch_mat_info, gray_patch_mat))
+        return false;
+
+    // Patches are drawn with the same shaders into selection feedback, which stores face ids
+    MaterialInfo object_id_mat_info = patch_mat_info;
+    object_id_mat_info.shader_ids[1] = shader_sculptor_object_id_frag;
+    object_id_mat_info.color_format  = VK_FORMAT_R32_UINT;
+
+    if ( ! create_view_materials(object_id_mat_info, object_id_mat))
         return false;
 
     static const MaterialInfo edge_mat_info = {
@@ -517,7 +663,7 @@ bool GeometryEditor::create_materials()
         { 0xEE, 0xEE, 0xEE } // diffuse
     };
 
-    if ( ! create_material(edge_mat_info, &edge_patch_mat))
+    if ( ! create_view_materials(edge_mat_info, edge_patch_mat))
         return false;
     set_material_buf(edge_mat_info, mat_object_edge);
 
@@ -540,36 +686,100 @@ bool GeometryEditor::create_materials()
         { 0xEF, 0xEF, 0xF4 } // diffuse
     };
 
-    if ( ! create_material(vertex_info, &vertex_mat))
+    if ( ! create_view_materials(vertex_info, vertex_mat))
         return false;
     set_material_buf(vertex_info, mat_vertex_sel);
 
     static const MaterialInfo grid_info = {
         {
-            shader_sculptor_simple_vert,
-            shader_sculptor_color_frag
+            shader_sculptor_grid_vert,
+            shader_sculptor_grid_frag
         },
-        vertex_attributes,
+        nullptr,
         0.0f, // depth_bias
-        mstd::array_size(vertex_attributes),
-        sizeof(Sculptor::Geometry::Vertex),
+        0,
+        0,
         VK_FORMAT_UNDEFINED,
-        VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
         0, // patch_control_points
         VK_POLYGON_MODE_FILL,
         VK_CULL_MODE_NONE,
-        true,                // depth_test
-        false,               // depth_write
-        { 0x55, 0x55, 0x55 } // diffuse
+        true,                 // depth_test
+        false,                // depth_write
+        { 0x55, 0x55, 0x55 }, // diffuse
+        false,                // mesh_shading
+        true                  // alpha_blend
     };
 
-    if ( ! Sculptor::create_material(grid_info, &grid_mat))
+    if ( ! create_view_materials(grid_info, grid_mat))
         return false;
     set_material_buf(grid_info, mat_grid);
 
     return true;
 }
 
+bool GeometryEditor::create_view_materials(const MaterialInfo& mat_info, VkPipeline (&pipelines)[2])
+{
+    if ( ! vk_multiview_features.multiview) {
+        MaterialInfo single_view_info = mat_info;
+        use_single_view_shaders(&single_view_info);
+
+        return Sculptor::create_material(single_view_info, &pipelines[0]);
+    }
+
+    if ( ! Sculptor::create_material(mat_info, &pipelines[0]))
+        return false;
+
+    if ( ! is_quad_view_supported())
+        return true;
+
+    MaterialInfo quad_info = mat_info;
+    quad_info.view_mask = quad_view_mask;
+
+    return Sculptor::create_material(quad_info, &pipelines[1]);
+}
+
+bool GeometryEditor::is_quad_view_supported() const
+{
+    if ( ! vk_multiview_features.multiview)
+        return false;
+
+    // Multiview must also be supported by the shaders which draw patches
+    if (patch_geometry.uses_mesh_shading())
+        return vk_mesh_shader_features.multiviewMeshShader;
+
+    if ( ! patch_geometry.uses_compute_tessellation())
+        return vk_multiview_features.multiviewTessellationShader;
+
+    return true;
+}
+
+bool GeometryEditor::create_patch_materials()
+{
+    if ( ! patch_materials_buf.allocate(Usage::dynamic,
+                                        max_patch_materials * sizeof(PatchMaterial),
+                                        VK_FORMAT_UNDEFINED,
+                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        "patch materials buffer"))
+        return false;
+
+    // There is no material editor, so every material is the default gray.  Faces created
+    // in the editor use material 0, but faces loaded from a file can use any material.
+    PatchMaterial* const materials = patch_materials_buf.get_ptr<PatchMaterial>();
+
+    for (uint32_t i = 0; i < max_patch_materials; i++) {
+        PatchMaterial& gray = materials[i];
+
+        for (uint32_t comp = 0; comp < 3; comp++)
+            gray.diffuse_color[comp] = 0.5f;
+
+        gray.diffuse_color[3] = 1.0f;
+        gray.texture_id       = no_texture;
+    }
+
+    return patch_materials_buf.flush();
+}
+
 bool GeometryEditor::create_transforms_buffer()
 {
     transforms_stride = static_cast<uint32_t>(mstd::align_up(
@@ -583,15 +793,6 @@ bool GeometryEditor::create_transforms_buffer()
                                    "transforms buffer");
 }
 
-bool GeometryEditor::create_grid_buffer()
-{
-    return grid_buf.allocate(Usage::dynamic,
-                             max_grid_lines * 2 * max_swapchain_size * sizeof(Sculptor::Geometry::Vertex),
-                             VK_FORMAT_UNDEFINED,
-                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                             "grid buffer");
-}
-
 bool GeometryEditor::create_descriptor_sets()
 {
     static VkDescriptorSetAllocateInfo alloc_info = {
@@ -610,7 +811,15 @@ bool GeometryEditor::create_descriptor_sets()
             },
             {
                 VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-                3
+                6
+            },
+            {
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                2
+            },
+            {
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                max_material_textures
             }
         };
 
@@ -633,117 +842,218 @@ bool GeometryEditor::create_descriptor_sets()
             return false;
     }
 
-    {
-        static VkDescriptorBufferInfo materials_buffer_info = {
-            VK_NULL_HANDLE,     // buffer
-            0,                  // offset
-            0                   // range
-        };
-        static VkDescriptorBufferInfo transforms_buffer_info = {
-            VK_NULL_HANDLE,     // buffer
-            0,                  // offset
-            0                   // range
-        };
-        static VkDescriptorBufferInfo storage_buffer_info = {
-            VK_NULL_HANDLE,     // buffer
-            0,                  // offset
-            VK_WHOLE_SIZE       // range
-        };
-        static VkDescriptorBufferInfo edge_index_buffer_info = {
-            VK_NULL_HANDLE,     // buffer
-            0,                  // offset
-            0                   // range
-        };
-        static VkDescriptorBufferInfo edge_vertex_buffer_info = {
-            VK_NULL_HANDLE,     // buffer
-            0,                  // offset
-            0                   // range
-        };
-        static VkWriteDescriptorSet write_desc_sets[] = {
-            {
-                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                nullptr,
-                VK_NULL_HANDLE,                             // dstSet
-                0,                                          // dstBinding
-                0,                                          // dstArrayElement
-                1,                                          // descriptorCount
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,  // descriptorType
-                nullptr,                                    // pImageInfo
-                &materials_buffer_info,                     // pBufferInfo
-                nullptr                                     // pTexelBufferView
-            },
-            {
-                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                nullptr,
-                VK_NULL_HANDLE,                             // dstSet
-                0,                                          // dstBinding
-                0,                                          // dstArrayElement
-                1,                                          // descriptorCount
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,  // descriptorType
-                nullptr,                                    // pImageInfo
-                &transforms_buffer_info,                    // pBufferInfo
-                nullptr                                     // pTexelBufferView
-            },
-            {
-                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                nullptr,
-                VK_NULL_HANDLE,                             // dstSet
-                1,                                          // dstBinding
-                0,                                          // dstArrayElement
-                1,                                          // descriptorCount
-                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
-                nullptr,                                    // pImageInfo
-                &storage_buffer_info,                       // pBufferInfo
-                nullptr                                     // pTexelBufferView
-            },
-            {
-                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                nullptr,
-                VK_NULL_HANDLE,                             // dstSet
-                2,                                          // dstBinding
-                0,                                          // dstArrayElement
-                1,                                          // descriptorCount
-                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
-                nullptr,                                    // pImageInfo
-                &edge_index_buffer_info,                    // pBufferInfo
-                nullptr                                     // pTexelBufferView
-            },
-            {
-                VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                nullptr,
-                VK_NULL_HANDLE,                             // dstSet
-                3,                                          // dstBinding
-                0,                                          // dstArrayElement
-                1,                                          // descriptorCount
-                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
-                nullptr,                                    // pImageInfo
-                &edge_vertex_buffer_info,                   // pBufferInfo
-                nullptr                                     // pTexelBufferView
-            },
-        };
-
-        materials_buffer_info.buffer  = materials_buf.get_buffer();
-        materials_buffer_info.range   = materials_stride;
-        transforms_buffer_info.buffer = transforms_buf.get_buffer();
-        transforms_buffer_info.range  = transforms_stride;
-        patch_geometry.write_faces_descriptor(&storage_buffer_info);
-        patch_geometry.write_edge_indices_descriptor(&edge_index_buffer_info);
-        patch_geometry.write_edge_vertices_descriptor(&edge_vertex_buffer_info);
+    update_descriptor_sets();
 
-        write_desc_sets[0].dstSet     = desc_set[1];
-        write_desc_sets[1].dstSet     = desc_set[2];
-        write_desc_sets[2].dstSet     = desc_set[2];
-        write_desc_sets[3].dstSet     = desc_set[2];
-        write_desc_sets[4].dstSet     = desc_set[2];
+    return true;
+}
 
-        vkUpdateDescriptorSets(vk_dev,
-                               mstd::array_size(write_desc_sets),
-                               write_desc_sets,
-                               0,           // descriptorCopyCount
-                               nullptr);    // pDescriptorCopies
-    }
+void GeometryEditor::update_descriptor_sets()
+{
+    static VkDescriptorBufferInfo materials_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo patch_materials_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        VK_WHOLE_SIZE       // range
+    };
+    static VkDescriptorBufferInfo transforms_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo storage_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        VK_WHOLE_SIZE       // range
+    };
+    static VkDescriptorBufferInfo edge_index_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo edge_vertex_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo visible_faces_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo patch_index_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo vertex_state_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkDescriptorBufferInfo visible_vertices_buffer_info = {
+        VK_NULL_HANDLE,     // buffer
+        0,                  // offset
+        0                   // range
+    };
+    static VkWriteDescriptorSet write_desc_sets[] = {
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            0,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,  // descriptorType
+            nullptr,                                    // pImageInfo
+            &materials_buffer_info,                     // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            1,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &patch_materials_buffer_info,               // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            0,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,  // descriptorType
+            nullptr,                                    // pImageInfo
+            &transforms_buffer_info,                    // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            1,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &storage_buffer_info,                       // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            2,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &edge_index_buffer_info,                    // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            3,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &edge_vertex_buffer_info,                   // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            4,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,  // descriptorType
+            nullptr,                                    // pImageInfo
+            &visible_faces_buffer_info,                 // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            5,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &patch_index_buffer_info,                   // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            6,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &vertex_state_buffer_info,                  // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            7,                                          // dstBinding
+            0,                                          // dstArrayElement
+            1,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,  // descriptorType
+            nullptr,                                    // pImageInfo
+            &visible_vertices_buffer_info,              // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+    };
 
-    return true;
+    materials_buffer_info.buffer  = materials_buf.get_buffer();
+    materials_buffer_info.range   = materials_stride;
+    patch_materials_buffer_info.buffer = patch_materials_buf.get_buffer();
+    transforms_buffer_info.buffer = transforms_buf.get_buffer();
+    transforms_buffer_info.range  = transforms_stride;
+    patch_geometry.write_faces_descriptor(&storage_buffer_info);
+    patch_geometry.write_edge_indices_descriptor(&edge_index_buffer_info);
+    patch_geometry.write_edge_vertices_descriptor(&edge_vertex_buffer_info);
+    patch_geometry.write_visible_faces_descriptor(&visible_faces_buffer_info);
+    patch_geometry.write_patch_indices_descriptor(&patch_index_buffer_info);
+    patch_geometry.write_vertex_state_descriptor(&vertex_state_buffer_info);
+    patch_geometry.write_visible_vertices_descriptor(&visible_vertices_buffer_info);
+
+    // Textures are not written, the texture array is partially bound or has no descriptors
+    write_desc_sets[0].dstSet     = desc_set[1];
+    write_desc_sets[1].dstSet     = desc_set[1];
+    write_desc_sets[2].dstSet     = desc_set[2];
+    write_desc_sets[3].dstSet     = desc_set[2];
+    write_desc_sets[4].dstSet     = desc_set[2];
+    write_desc_sets[5].dstSet     = desc_set[2];
+    write_desc_sets[6].dstSet     = desc_set[2];
+    write_desc_sets[7].dstSet     = desc_set[2];
+    write_desc_sets[8].dstSet     = desc_set[2];
+    write_desc_sets[9].dstSet     = desc_set[2];
+
+    vkUpdateDescriptorSets(vk_dev,
+                           mstd::array_size(write_desc_sets),
+                           write_desc_sets,
+                           0,           // descriptorCopyCount
+                           nullptr);    // pDescriptorCopies
+
+    geom_generation = patch_geometry.get_generation();
 }
 
 void GeometryEditor::gui_status_bar()
@@ -785,9 +1095,16 @@ void GeometryEditor::gui_status_bar()
 
             ImGui::Text("%s", mode_names[static_cast<unsigned>(mode)]);
             ImGui::Separator();
-            ImGui::Text("%s", view_names[view_idx]);
+            if (view.num_views > 1)
+                ImGui::Text("Quad: %s", view_names[view_idx]);
+            else
+                ImGui::Text("%s", view_names[view_idx]);
             ImGui::Separator();
             ImGui::Text("Mouse: %dx%d", static_cast<int>(view.mouse_pos.x), static_cast<int>(view.mouse_pos.y));
+            if (hovered_object != ~0U) {
+                ImGui::Separator();
+                ImGui::Text("Face: %u", hovered_object);
+            }
 
             ImGui::EndMenuBar();
         }
@@ -974,11 +1291,35 @@ void GeometryEditor::handle_mouse_actions(const UserInput& input, bool view_hove
     }
 
     if ((mode == Mode::select) && view_hovered && (mouse_action != Action::select)) {
-        // TODO draw hover selection of selectable items
+        // Faces are picked on the CPU, which does not wait for the selection feedback
+        vmath::vec3 ray_origin;
+        vmath::vec3 ray_dir;
+        get_mouse_ray(view, &ray_origin, &ray_dir);
+
+        float          hit_dist = 0;
+        const uint32_t face_id  = patch_geometry.pick_face(ray_origin, ray_dir, &hit_dist);
+        patch_geometry.set_hovered_face(face_id);
+
+        // The hovered vertex is the one nearest to the point where the ray hits the hovered face
+        constexpr float hover_distance = 64.0f;
+
+        uint32_t vtx = ~0U;
+        if (face_id != ~0U)
+            patch_geometry.find_nearest_vertices(ray_origin + hit_dist * ray_dir, hover_distance, &vtx, 1);
+
+        patch_geometry.set_hovered_vertex(vtx);
+    }
+    else if ( ! view_hovered) {
+        patch_geometry.set_hovered_face(~0U);
+        patch_geometry.set_hovered_vertex(~0U);
     }
 
-    if ((mode != Mode::select) && ! has_captured_mouse() && mouse_moved) {
-        // TODO adjust modification
+    if ((mode != Mode::select) && ! has_captured_mouse() && mouse_moved && edit_batch.size()) {
+        // Each adjustment transforms the original positions, the whole drag is a single undo step
+        patch_geometry.begin_edit(edit_key);
+        patch_geometry.transform_vertices(edit_batch, get_edit_transform());
+        patch_geometry.end_edit();
+        edit_modified = true;
     }
 
     if (input.wheel_delta != 0) {
@@ -1023,14 +1364,13 @@ void GeometryEditor::handle_keyboard_actions()
         return ImGui::IsKeyDown(left_ctrl) || ImGui::IsKeyDown(right_ctrl);
     };
 
-    if (ImGui::IsKeyPressed(ImGuiKey_Z) && IsCtrl()) {
-        // TODO undo
-    }
+    const bool is_shift = ImGui::IsKeyDown(ImGuiKey_LeftShift) || ImGui::IsKeyDown(ImGuiKey_RightShift);
 
-    if (ImGui::IsKeyPressed(ImGuiKey_Z) && IsCtrl() &&
-        (ImGui::IsKeyDown(ImGuiKey_LeftShift) || ImGui::IsKeyDown(ImGuiKey_RightShift))) {
-        // TODO redo
-    }
+    if (ImGui::IsKeyPressed(ImGuiKey_Z) && IsCtrl() && ! is_shift)
+        patch_geometry.undo();
+
+    if (ImGui::IsKeyPressed(ImGuiKey_Z) && IsCtrl() && is_shift)
+        patch_geometry.redo();
 
     if (ImGui::IsKeyPressed(ImGuiKey_C) && IsCtrl()) {
         // TODO copy
@@ -1071,6 +1411,7 @@ void GeometryEditor::handle_keyboard_actions()
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = false;
         view.view_type = ViewType::free_moving;
+        view.quad_view = false;
     }
 
     if (ImGui::IsKeyPressed(ImGuiKey_6)) {
@@ -1082,6 +1423,7 @@ void GeometryEditor::handle_keyboard_actions()
         toolbar_state.view_ortho_x = false;
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = true;
+        view.quad_view = false;
     }
 
     if (ImGui::IsKeyPressed(ImGuiKey_7)) {
@@ -1093,6 +1435,7 @@ void GeometryEditor::handle_keyboard_actions()
         toolbar_state.view_ortho_x = true;
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = false;
+        view.quad_view = false;
     }
 
     if (ImGui::IsKeyPressed(ImGuiKey_8)) {
@@ -1104,6 +1447,7 @@ void GeometryEditor::handle_keyboard_actions()
         toolbar_state.view_ortho_x = false;
         toolbar_state.view_ortho_y = true;
         toolbar_state.view_ortho_z = false;
+        view.quad_view = false;
     }
 
     if (ImGui::IsKeyPressed(ImGuiKey_T) &&
@@ -1114,6 +1458,10 @@ void GeometryEditor::handle_keyboard_actions()
             (ImGui::IsKeyDown(ImGuiKey_LeftAlt) || ImGui::IsKeyDown(ImGuiKey_RightAlt)))
         toolbar_state.toggle_wireframe = ! toolbar_state.toggle_wireframe;
 
+    if (ImGui::IsKeyPressed(ImGuiKey_Q) &&
+            (ImGui::IsKeyDown(ImGuiKey_LeftAlt) || ImGui::IsKeyDown(ImGuiKey_RightAlt)))
+        view.quad_view = ! view.quad_view && is_quad_view_supported();
+
     if (ImGui::IsKeyPressed(ImGuiKey_X))
         toolbar_state.snap_x = ! toolbar_state.snap_x;
 
@@ -1172,13 +1520,11 @@ bool GeometryEditor::gui_toolbar()
         // TODO new cube
     }
 
-    if (toolbar_button(ToolbarButton::undo)) {
-        // TODO undo
-    }
+    if (toolbar_button(ToolbarButton::undo))
+        patch_geometry.undo();
 
-    if (toolbar_button(ToolbarButton::redo)) {
-        // TODO redo
-    }
+    if (toolbar_button(ToolbarButton::redo))
+        patch_geometry.redo();
 
     if (toolbar_button(ToolbarButton::copy)) {
         // TODO copy
@@ -1217,6 +1563,7 @@ bool GeometryEditor::gui_toolbar()
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = false;
         view.view_type = ViewType::free_moving;
+        view.quad_view = false;
     }
 
     if (toolbar_button(ToolbarButton::view_ortho_z, &toolbar_state.view_ortho_z)) {
@@ -1228,6 +1575,7 @@ bool GeometryEditor::gui_toolbar()
         toolbar_state.view_ortho_x = false;
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = true;
+        view.quad_view = false;
     }
 
     if (toolbar_button(ToolbarButton::view_ortho_x, &toolbar_state.view_ortho_x)) {
@@ -1239,6 +1587,7 @@ bool GeometryEditor::gui_toolbar()
         toolbar_state.view_ortho_x = true;
         toolbar_state.view_ortho_y = false;
         toolbar_state.view_ortho_z = false;
+        view.quad_view = false;
     }
 
     if (toolbar_button(ToolbarButton::view_ortho_y, &toolbar_state.view_ortho_y)) {
@@ -1250,6 +1599,7 @@ bool GeometryEditor::gui_toolbar()
         toolbar_state.view_ortho_x = false;
         toolbar_state.view_ortho_y = true;
         toolbar_state.view_ortho_z = false;
+        view.quad_view = false;
     }
 
     toolbar_button(ToolbarButton::toggle_tessell, &toolbar_state.toggle_tessellation);
@@ -1321,6 +1671,9 @@ void GeometryEditor::switch_mode(Mode new_mode)
         }
 
         mode = new_mode;
+
+        if ((mode == Mode::move) || (mode == Mode::rotate) || (mode == Mode::scale) || (mode == Mode::extrude))
+            start_edit_mode();
     }
 
     // At least one thing is always selectable
@@ -1363,11 +1716,20 @@ bool GeometryEditor::create_gui_frame(uint32_t image_idx, bool* need_realloc, co
     if ((new_width != window_width) || (new_height != window_height))
         *need_realloc = true;
 
+    // Switching to or from quad view changes sizes and layers of all view images
+    if (view.quad_view != (view.num_views > 1))
+        *need_realloc = true;
+
     window_width  = new_width;
     window_height = new_height;
 
+    // In quad view the displayed image consists of four views of equal size
+    const uint32_t num_columns = view.quad_view ? 2U : 1U;
+    const uint32_t image_width  = mstd::max(window_width  / num_columns, 1U) * num_columns;
+    const uint32_t image_height = mstd::max(window_height / num_columns, 1U) * num_columns;
+
     const ImVec2 image_pos = ImGui::GetCursorPos();
-    const ImVec2 image_size{static_cast<float>(window_width), static_cast<float>(window_height)};
+    const ImVec2 image_size{static_cast<float>(image_width), static_cast<float>(image_height)};
 
     {
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2{0, 0});
@@ -1376,12 +1738,41 @@ bool GeometryEditor::create_gui_frame(uint32_t image_idx, bool* need_realloc, co
         ImGui::PopStyleVar();
     }
 
+    const bool view_hovered = ImGui::IsItemHovered();
+
     UserInput local_input = input;
     local_input.abs_mouse_pos -= vmath::vec2(ImGui::GetItemRectMin());
 
+    if (view.num_views > 1) {
+        const float view_width  = static_cast<float>(view.width);
+        const float view_height = static_cast<float>(view.height);
+
+        // Input goes to the view under the mouse cursor, unless the mouse is captured by a view
+        if ( ! has_captured_mouse()) {
+            const uint32_t column = (local_input.abs_mouse_pos.x >= view_width)  ? 1U : 0U;
+            const uint32_t row    = (local_input.abs_mouse_pos.y >= view_height) ? 1U : 0U;
+
+            view.active_view = row * 2U + column;
+            view.view_type   = get_view_type(view, view.active_view);
+        }
+
+        local_input.abs_mouse_pos -= vmath::vec2{static_cast<float>(view.active_view % 2U) * view_width,
+                                                 static_cast<float>(view.active_view / 2U) * view_height};
+
+        const ImVec2 image_min = ImGui::GetItemRectMin();
+        const ImVec2 image_max = ImGui::GetItemRectMax();
+        const float  center_x  = image_min.x + view_width;
+        const float  center_y  = image_min.y + view_height;
+        const ImU32  color     = IM_COL32(0x80, 0x80, 0x80, 0xFF);
+
+        ImDrawList* const draw_list = ImGui::GetWindowDrawList();
+        draw_list->AddLine(ImVec2{center_x, image_min.y}, ImVec2{center_x, image_max.y}, color);
+        draw_list->AddLine(ImVec2{image_min.x, center_y}, ImVec2{image_max.x, center_y}, color);
+    }
+
     view.mouse_pos = local_input.abs_mouse_pos;
 
-    handle_mouse_actions(local_input, ImGui::IsItemHovered());
+    handle_mouse_actions(local_input, view_hovered);
 
     const ImVec2 status_bar_pos = ImGui::GetCursorPos();
 
@@ -1417,11 +1808,24 @@ bool GeometryEditor::draw_frame(VkCommandBuffer cmdbuf, uint32_t image_idx)
     if ( ! patch_geometry.send_to_gpu(cmdbuf))
         return false;
 
+    // Geometry buffers are reallocated when the geometry outgrows them
+    if (patch_geometry.get_generation() != geom_generation)
+        update_descriptor_sets();
+
+    // The fence for this swapchain image has signaled, so the region read back
+    // when this image was last drawn is now available on the host
+    read_selection_feedback(view, image_idx);
+
     if ( ! draw_geometry_view(cmdbuf, view, image_idx))
         return false;
 
-    if ( ! draw_selection_feedback(cmdbuf, view, image_idx))
-        return false;
+    // Selection feedback is only needed when the CPU pick found a face under the cursor
+    if (patch_geometry.get_hovered_face() != ~0U) {
+        if ( ! draw_selection_feedback(cmdbuf, view, image_idx))
+            return false;
+    }
+    else
+        hovered_object = ~0U;
 
     return true;
 }
@@ -1479,7 +1883,11 @@ bool GeometryEditor::draw_geometry_view(VkCommandBuffer cmdbuf,
 {
     Resources& res = dst_view.res[image_idx];
 
-    res.color.set_image_layout(cmdbuf, render_viewport_layout);
+    // In quad view all views are drawn in one pass into layers of a separate image
+    const bool quad_view = dst_view.num_views > 1;
+    Image&     target    = quad_view ? res.views_color : res.color;
+
+    target.set_image_layout(cmdbuf, render_viewport_layout);
 
     static const Image::Transition depth_init = {
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
@@ -1492,13 +1900,28 @@ bool GeometryEditor::draw_geometry_view(VkCommandBuffer cmdbuf,
     if (res.depth.layout != VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
         res.depth.set_image_layout(cmdbuf, depth_init);
 
-    color_att.imageView  = res.color.get_view();
+    // Culling runs in a compute shader, so it has to be recorded outside of rendering.
+    // Patches are culled once for all views and are kept if they are visible in any view.
+    Geometry::CullView cull_views[max_views];
+
+    for (uint32_t i = 0; i < dst_view.num_views; i++) {
+        const ViewType view_type = get_view_type(dst_view, i);
+
+        cull_views[i].model_view  = get_model_view(dst_view, view_type);
+        cull_views[i].proj        = get_projection(dst_view, view_type);
+        cull_views[i].perspective = view_type == ViewType::free_moving;
+    }
+
+    patch_geometry.cull(cmdbuf, image_idx, cull_views, dst_view.num_views);
+
+    color_att.imageView  = target.get_view();
     color_att.clearValue = make_clear_color(0.2f, 0.2f, 0.2f, 1);
     depth_att.imageView  = res.depth.get_view();
     depth_att.loadOp     = VK_ATTACHMENT_LOAD_OP_CLEAR;
     depth_att.storeOp    = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     rendering_info.renderArea.extent.width  = dst_view.width;
     rendering_info.renderArea.extent.height = dst_view.height;
+    rendering_info.viewMask                 = quad_view ? quad_view_mask : 0U;
 
     vkCmdBeginRenderingKHR(cmdbuf, &rendering_info);
 
@@ -1515,11 +1938,15 @@ bool GeometryEditor::draw_geometry_view(VkCommandBuffer cmdbuf,
     if ( ! render_geometry(cmdbuf, dst_view, image_idx))
         return false;
 
-    if ( ! render_grid(cmdbuf, dst_view, image_idx))
-        return false;
+    render_grid(cmdbuf, dst_view, image_idx);
 
     vkCmdEndRenderingKHR(cmdbuf);
 
+    if (quad_view) {
+        copy_quad_views(cmdbuf, dst_view, image_idx);
+        return true;
+    }
+
     static const Image::Transition gui_image_layout = {
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
         VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
@@ -1532,6 +1959,67 @@ bool GeometryEditor::draw_geometry_view(VkCommandBuffer cmdbuf,
     return true;
 }
 
+void GeometryEditor::copy_quad_views(VkCommandBuffer cmdbuf, View& dst_view, uint32_t image_idx)
+{
+    Resources& res = dst_view.res[image_idx];
+
+    static const Image::Transition transfer_src_layout = {
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_READ_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+    };
+    res.views_color.set_image_layout(cmdbuf, transfer_src_layout);
+
+    static const Image::Transition transfer_dst_layout = {
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        0,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    };
+    res.color.set_image_layout(cmdbuf, transfer_dst_layout);
+
+    // Each layer is copied into its quadrant: top left, top right, bottom left, bottom right
+    VkImageCopy regions[max_views];
+
+    for (uint32_t i = 0; i < max_views; i++) {
+        VkImageCopy& region = regions[i];
+
+        region.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.srcSubresource.mipLevel       = 0;
+        region.srcSubresource.baseArrayLayer = i;
+        region.srcSubresource.layerCount     = 1;
+        region.srcOffset                     = { 0, 0, 0 };
+        region.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.dstSubresource.mipLevel       = 0;
+        region.dstSubresource.baseArrayLayer = 0;
+        region.dstSubresource.layerCount     = 1;
+        region.dstOffset.x                   = static_cast<int32_t>((i % 2U) * dst_view.width);
+        region.dstOffset.y                   = static_cast<int32_t>((i / 2U) * dst_view.height);
+        region.dstOffset.z                   = 0;
+        region.extent                        = { dst_view.width, dst_view.height, 1 };
+    }
+
+    vkCmdCopyImage(cmdbuf,
+                   res.views_color.get_image(),
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   res.color.get_image(),
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   max_views,
+                   regions);
+
+    static const Image::Transition gui_image_layout = {
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    res.color.set_image_layout(cmdbuf, gui_image_layout);
+}
+
 bool GeometryEditor::draw_selection_feedback(VkCommandBuffer cmdbuf,
                                              View&           dst_view,
                                              uint32_t        image_idx)
@@ -1542,15 +2030,56 @@ bool GeometryEditor::draw_selection_feedback(VkCommandBuffer cmdbuf,
 
     assert(res.depth.layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 
-    color_att.imageView                  = res.select_feedback.get_view();
-    color_att.clearValue.color.uint32[0] = 0;
-    depth_att.imageView                  = res.depth.get_view();
-    depth_att.loadOp                     = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depth_att.storeOp                    = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    // The depth buffer is cleared again after the geometry view finished writing it
+    static const Image::Transition depth_reuse = {
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    };
+    res.depth.set_image_layout(cmdbuf, depth_reuse);
+
+    const uint32_t quad = (dst_view.num_views > 1) ? 1U : 0U;
+
+    // Object ids are biased by 1, so clearing to 0 means no object
+    color_att.imageView  = res.select_feedback.get_view();
+    color_att.clearValue = make_clear_color(0, 0, 0, 0);
+    depth_att.imageView  = res.depth.get_view();
+    depth_att.loadOp     = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_att.storeOp    = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     rendering_info.renderArea.extent.width  = dst_view.width;
     rendering_info.renderArea.extent.height = dst_view.height;
+    rendering_info.viewMask                 = quad ? quad_view_mask : 0U;
 
     vkCmdBeginRenderingKHR(cmdbuf, &rendering_info);
+
+    // Patches were culled and transforms were set for this image by draw_geometry_view()
+    const uint32_t edge_mat_id  = (image_idx * num_materials) + mat_object_edge;
+    const uint32_t transform_id = image_idx * transforms_per_viewport;
+
+    const uint32_t dynamic_offsets[] = {
+        edge_mat_id * materials_stride,
+        transform_id * transforms_stride,
+        patch_geometry.get_visible_faces_dynamic_offset(image_idx),
+        patch_geometry.get_visible_vertices_dynamic_offset(image_idx)
+    };
+
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, object_id_mat[quad]);
+
+    send_viewport_and_scissor(cmdbuf, dst_view.width, dst_view.height);
+
+    vkCmdBindDescriptorSets(cmdbuf,
+                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            Sculptor::material_layout,
+                            1,          // firstSet
+                            2,          // descriptorSetCount
+                            &desc_set[1],
+                            mstd::array_size(dynamic_offsets),
+                            dynamic_offsets);
+
+    patch_geometry.render(cmdbuf, image_idx);
+
     vkCmdEndRenderingKHR(cmdbuf);
 
     static const Image::Transition transfer_src_image_layout = {
@@ -1562,53 +2091,160 @@ bool GeometryEditor::draw_selection_feedback(VkCommandBuffer cmdbuf,
     };
     res.select_feedback.set_image_layout(cmdbuf, transfer_src_image_layout);
 
-    if (res.host_select_feedback.layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        static const Image::Transition transfer_dst_image_layout = {
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_ACCESS_TRANSFER_WRITE_BIT,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-        };
-        res.host_select_feedback.set_image_layout(cmdbuf, transfer_dst_image_layout);
+    // Copy only a small region around the mouse cursor, clipped to the view
+    const int32_t mouse_x = static_cast<int32_t>(dst_view.mouse_pos.x);
+    const int32_t mouse_y = static_cast<int32_t>(dst_view.mouse_pos.y);
+    const int32_t width   = static_cast<int32_t>(dst_view.width);
+    const int32_t height  = static_cast<int32_t>(dst_view.height);
+
+    // When the cursor is outside of the view, an empty region clears the hover
+    if (mouse_x < 0 || mouse_y < 0 || mouse_x >= width || mouse_y >= height) {
+        res.select_rect.extent.width  = 0;
+        res.select_rect.extent.height = 0;
+        res.selection_pending         = true;
+        return true;
     }
 
-    res.selection_pending = true;
+    constexpr int32_t half_size = static_cast<int32_t>(select_region_size / 2);
 
-    #if 0
-    static VkImageCopy region = {
-        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
-        { },        // srcOffset
+    const int32_t left   = mstd::max(mouse_x - half_size, 0);
+    const int32_t top    = mstd::max(mouse_y - half_size, 0);
+    const int32_t right  = mstd::min(mouse_x + half_size, width);
+    const int32_t bottom = mstd::min(mouse_y + half_size, height);
+
+    res.select_rect.offset.x      = left;
+    res.select_rect.offset.y      = top;
+    res.select_rect.extent.width  = static_cast<uint32_t>(right - left);
+    res.select_rect.extent.height = static_cast<uint32_t>(bottom - top);
+    res.select_cursor.x           = mouse_x - left;
+    res.select_cursor.y           = mouse_y - top;
+
+    static VkBufferImageCopy region = {
+        0,          // bufferOffset
+        0,          // bufferRowLength
+        0,          // bufferImageHeight
         { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 },
-        { },        // dstOffset
-        { 0, 0, 1 } // extent
+        { },        // imageOffset
+        { 0, 0, 1 } // imageExtent
     };
 
-    region.extent.width  = dst_view.width;
-    region.extent.height = dst_view.height;
+    // In quad view only the layer of the view under the mouse cursor is read back
+    region.imageSubresource.baseArrayLayer = dst_view.active_view;
 
-    vkCmdCopyImage(cmdbuf,
-                   res.select_feedback.get_image(),
-                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   res.host_select_feedback.get_image(),
-                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                   1,
-                   &region);
-    #endif
+    region.imageOffset.x      = res.select_rect.offset.x;
+    region.imageOffset.y      = res.select_rect.offset.y;
+    region.imageExtent.width  = res.select_rect.extent.width;
+    region.imageExtent.height = res.select_rect.extent.height;
+
+    vkCmdCopyImageToBuffer(cmdbuf,
+                           res.select_feedback.get_image(),
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           res.host_select_feedback.get_buffer(),
+                           1,
+                           &region);
+
+    static VkBufferMemoryBarrier host_barrier = {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        nullptr,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_HOST_READ_BIT,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_NULL_HANDLE,
+        0,
+        VK_WHOLE_SIZE
+    };
+
+    host_barrier.buffer = res.host_select_feedback.get_buffer();
+
+    vkCmdPipelineBarrier(cmdbuf,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0,             // dependencyFlags
+                         0,             // memoryBarrierCount
+                         nullptr,       // pMemoryBarriers
+                         1,             // bufferMemoryBarrierCount
+                         &host_barrier,
+                         0,             // imageMemoryBarrierCount
+                         nullptr);      // pImageMemoryBarriers
+
+    // The region is read back when this swapchain image is drawn again, after its fence signals
+    res.selection_pending = true;
 
     return true;
 }
 
-bool GeometryEditor::set_patch_transforms(const View& dst_view, uint32_t transform_id)
+void GeometryEditor::read_selection_feedback(View& dst_view, uint32_t image_idx)
 {
-    Transforms* const transforms = transforms_buf.get_ptr<Transforms>(transform_id, transforms_stride);
-    assert(transforms);
+    Resources& res = dst_view.res[image_idx];
+
+    if ( ! res.selection_pending)
+        return;
+
+    res.selection_pending = false;
+
+    const uint32_t width  = res.select_rect.extent.width;
+    const uint32_t height = res.select_rect.extent.height;
+
+    // Host memory may not be coherent, make the copied region visible to the host
+    if (width && height &&
+        ! res.host_select_feedback.invalidate(0, width * height * static_cast<uint32_t>(sizeof(uint32_t)))) {
+        hovered_object = ~0U;
+        return;
+    }
+
+    const uint32_t* const ids = res.host_select_feedback.get_ptr<uint32_t>();
+
+    // Pick the face under the cursor or the nearest face in the region, in case
+    // the face was rasterized a pixel away from the ray of the CPU pick
+    uint32_t found_id   = 0;
+    int32_t  found_dist = 0;
 
-    const Camera& camera = dst_view.camera[static_cast<int>(dst_view.view_type)];
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t id = ids[y * width + x];
+            if ( ! id)
+                continue;
+
+            const int32_t dx   = static_cast<int32_t>(x) - res.select_cursor.x;
+            const int32_t dy   = static_cast<int32_t>(y) - res.select_cursor.y;
+            const int32_t dist = dx * dx + dy * dy;
+
+            if ( ! found_id || dist < found_dist) {
+                found_id   = id;
+                found_dist = dist;
+            }
+        }
+    }
+
+    // Object ids are stored biased by 1, 0 means no object
+    hovered_object = found_id - 1;
+}
+
+GeometryEditor::ViewType GeometryEditor::get_view_type(const View& dst_view, uint32_t view_idx)
+{
+    // Quadrants of the quad view: top left, top right, bottom left, bottom right
+    static const ViewType quad_view_types[max_views] = {
+        ViewType::top,
+        ViewType::free_moving,
+        ViewType::front,
+        ViewType::right
+    };
+
+    if (dst_view.num_views == 1)
+        return dst_view.view_type;
+
+    assert(view_idx < max_views);
+    return quad_view_types[view_idx];
+}
+
+vmath::mat4 GeometryEditor::get_model_view(const View& dst_view, ViewType view_type) const
+{
+    const Camera& camera = dst_view.camera[static_cast<int>(view_type)];
 
     vmath::mat4 model_view;
 
-    switch (dst_view.view_type) {
+    switch (view_type) {
 
         case ViewType::free_moving:
             {
@@ -1658,34 +2294,87 @@ bool GeometryEditor::set_patch_transforms(const View& dst_view, uint32_t transfo
             assert(0);
     }
 
-    transforms->model_view = model_view;
+    return model_view;
+}
 
-    transforms->model_view_normal = vmath::transpose(vmath::inverse(vmath::mat3(model_view)));
+vmath::vec4 GeometryEditor::get_projection(const View& dst_view, ViewType view_type) const
+{
+    const Camera& camera = dst_view.camera[static_cast<int>(view_type)];
 
     const float aspect = static_cast<float>(dst_view.width) / static_cast<float>(dst_view.height);
 
     constexpr float near_plane = 0.01f;
     constexpr float far_plane  = 3.0f;
 
+    if (view_type == ViewType::free_moving)
+        return vmath::projection_vector(aspect,
+                                        vmath::radians(30.0f),
+                                        near_plane,
+                                        far_plane);
+    else
+        return vmath::ortho_vector(aspect,
+                                   camera.view_height / int16_scale,
+                                   near_plane,
+                                   far_plane);
+}
+
+bool GeometryEditor::set_patch_transforms(const View& dst_view, uint32_t transform_id)
+{
+    Transforms* const transforms = transforms_buf.get_ptr<Transforms>(transform_id, transforms_stride);
+    assert(transforms);
+
+    for (uint32_t i = 0; i < dst_view.num_views; i++) {
+        ViewTransforms& view_transforms = transforms->views[i];
+
+        const ViewType    view_type  = get_view_type(dst_view, i);
+        const vmath::mat4 model_view = get_model_view(dst_view, view_type);
+
+        view_transforms.model_view = model_view;
+
+        view_transforms.model_view_normal = vmath::transpose(vmath::inverse(vmath::mat3(model_view)));
+
+        view_transforms.proj   = get_projection(dst_view, view_type);
+        view_transforms.proj_w = (view_type == ViewType::free_moving)
+                                 ? vmath::vec4(0.0f, 0.0f, 1.0f, 0.0f)
+                                 : vmath::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+        view_transforms.pixel_dim = vmath::vec2(2.0f) / vmath::vec2(static_cast<float>(dst_view.width),
+                                                                    static_cast<float>(dst_view.height));
+    }
+
+    return transforms_buf.flush(transform_id, transforms_stride);
+}
+
+// Computes the ray under the mouse cursor in int16 object coordinates, which is the inverse
+// of the transforms applied in shaders
+void GeometryEditor::get_mouse_ray(const View& dst_view, vmath::vec3* origin, vmath::vec3* dir) const
+{
+    const vmath::mat4 model_view = get_model_view(dst_view, dst_view.view_type);
+    const vmath::vec4 proj       = get_projection(dst_view, dst_view.view_type);
+
+    // The view matrix is orthonormal, rows contain the axes of the view
+    const vmath::vec3 x_axis{&model_view.data[0]};
+    const vmath::vec3 y_axis{&model_view.data[4]};
+    const vmath::vec3 z_axis{&model_view.data[8]};
+    const vmath::vec3 eye = -(model_view.a30 * x_axis + model_view.a31 * y_axis + model_view.a32 * z_axis);
+
+    const float ndc_x  = dst_view.mouse_pos.x * 2.0f / static_cast<float>(dst_view.width)  - 1.0f;
+    const float ndc_y  = dst_view.mouse_pos.y * 2.0f / static_cast<float>(dst_view.height) - 1.0f;
+    const float view_x = ndc_x / proj.x;
+    const float view_y = ndc_y / proj.y;
+
     if (dst_view.view_type == ViewType::free_moving) {
-        transforms->proj = vmath::projection_vector(aspect,
-                                                    vmath::radians(30.0f),
-                                                    near_plane,
-                                                    far_plane);
-        transforms->proj_w = vmath::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+        *origin = eye;
+        *dir    = view_x * x_axis + view_y * y_axis + z_axis;
     }
     else {
-        transforms->proj = vmath::ortho_vector(aspect,
-                                               camera.view_height / int16_scale,
-                                               near_plane,
-                                               far_plane);
-        transforms->proj_w = vmath::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        *origin = eye + view_x * x_axis + view_y * y_axis;
+        *dir    = z_axis;
     }
 
-    transforms->pixel_dim = vmath::vec2(2.0f) / vmath::vec2(static_cast<float>(dst_view.width),
-                                                            static_cast<float>(dst_view.height));
-
-    return transforms_buf.flush(transform_id, transforms_stride);
+    // Vertex positions are int16 normalized to [-1, 1]
+    *origin *= int16_scale;
+    *dir    *= int16_scale;
 }
 
 bool GeometryEditor::render_geometry(VkCommandBuffer cmdbuf,
@@ -1694,19 +2383,23 @@ bool GeometryEditor::render_geometry(VkCommandBuffer cmdbuf,
 {
     const uint32_t edge_mat_id = (image_idx * num_materials) + mat_object_edge;
 
+    const uint32_t quad = (dst_view.num_views > 1) ? 1U : 0U;
+
     const uint32_t transform_id_base = image_idx * transforms_per_viewport;
 
     const uint32_t transform_id = transform_id_base + 0;
 
     uint32_t dynamic_offsets[] = {
         edge_mat_id * materials_stride,
-        transform_id * transforms_stride
+        transform_id * transforms_stride,
+        patch_geometry.get_visible_faces_dynamic_offset(image_idx),
+        patch_geometry.get_visible_vertices_dynamic_offset(image_idx)
     };
 
     if ( ! set_patch_transforms(dst_view, transform_id))
         return false;
 
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, gray_patch_mat);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, gray_patch_mat[quad]);
 
     send_viewport_and_scissor(cmdbuf, dst_view.width, dst_view.height);
 
@@ -1719,9 +2412,9 @@ bool GeometryEditor::render_geometry(VkCommandBuffer cmdbuf,
                             mstd::array_size(dynamic_offsets),
                             dynamic_offsets);
 
-    patch_geometry.render(cmdbuf);
+    patch_geometry.render(cmdbuf, image_idx);
 
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, edge_patch_mat);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, edge_patch_mat[quad]);
 
     send_viewport_and_scissor(cmdbuf, dst_view.width, dst_view.height);
 
@@ -1736,7 +2429,7 @@ bool GeometryEditor::render_geometry(VkCommandBuffer cmdbuf,
 
     patch_geometry.render_edges(cmdbuf);
 
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, vertex_mat);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, vertex_mat[quad]);
 
     send_viewport_and_scissor(cmdbuf, dst_view.width, dst_view.height);
 
@@ -1752,76 +2445,18 @@ bool GeometryEditor::render_geometry(VkCommandBuffer cmdbuf,
                             mstd::array_size(dynamic_offsets),
                             dynamic_offsets);
 
-    patch_geometry.render_vertices(cmdbuf);
+    patch_geometry.render_vertices(cmdbuf, image_idx);
 
     return true;
 }
 
-bool GeometryEditor::render_grid(VkCommandBuffer cmdbuf,
+void GeometryEditor::render_grid(VkCommandBuffer cmdbuf,
                                  const View&     dst_view,
                                  uint32_t        image_idx)
 {
-    const uint32_t sub_buf_stride = max_grid_lines * 2 * sizeof(Sculptor::Geometry::Vertex);
-
-    auto     vertices  = grid_buf.get_ptr<Sculptor::Geometry::Vertex>(image_idx, sub_buf_stride);
-    uint32_t num_lines = 0;
-
-    uint32_t idx_1  = 0;
-    uint32_t idx_2  = 2;
-    uint32_t idx_z  = 1;
-    int32_t  min_1  = -0x8000;
-    int32_t  max_1  = 0x8000;
-    int32_t  step_1 = 0x800;
-    int32_t  min_2  = -0x8000;
-    int32_t  max_2  = 0x8000;
-    int32_t  step_2 = 0x800;
-
-    const auto fix_pos = [](int32_t x) -> int16_t {
-        return (x == 0x8000) ? 0x7FFF : static_cast<int16_t>(x);
-    };
-
-    switch (dst_view.view_type) {
-        case ViewType::front:
-        case ViewType::back:
-            idx_2 = 1;
-            idx_z = 2;
-            break;
+    const uint32_t quad = (dst_view.num_views > 1) ? 1U : 0U;
 
-        case ViewType::right:
-        case ViewType::left:
-            idx_1 = 2;
-            idx_2 = 1;
-            idx_z = 0;
-            break;
-
-        default:
-            break;
-    }
-
-    for (int32_t x = min_1; x <= max_1 && num_lines < max_grid_lines; x += step_1, num_lines++) {
-        Sculptor::Geometry::Vertex* const vtx = &vertices[num_lines * 2];
-        vtx[0].pos[idx_1] = fix_pos(x);
-        vtx[0].pos[idx_2] = fix_pos(min_2);
-        vtx[0].pos[idx_z] = 0;
-        vtx[1].pos[idx_1] = fix_pos(x);
-        vtx[1].pos[idx_2] = fix_pos(max_2);
-        vtx[1].pos[idx_z] = 0;
-    }
-
-    for (int32_t x = min_2; x <= max_2 && num_lines < max_grid_lines; x += step_2, num_lines++) {
-        Sculptor::Geometry::Vertex* const vtx = &vertices[num_lines * 2];
-        vtx[0].pos[idx_2] = fix_pos(x);
-        vtx[0].pos[idx_1] = fix_pos(min_1);
-        vtx[0].pos[idx_z] = 0;
-        vtx[1].pos[idx_2] = fix_pos(x);
-        vtx[1].pos[idx_1] = fix_pos(max_1);
-        vtx[1].pos[idx_z] = 0;
-    }
-
-    if ( ! grid_buf.flush(image_idx, sub_buf_stride))
-        return false;
-
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, grid_mat);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, grid_mat[quad]);
 
     send_viewport_and_scissor(cmdbuf, dst_view.width, dst_view.height);
 
@@ -1833,7 +2468,9 @@ bool GeometryEditor::render_grid(VkCommandBuffer cmdbuf,
 
     uint32_t dynamic_offsets[] = {
         grid_mat_id * materials_stride,
-        transform_id * transforms_stride
+        transform_id * transforms_stride,
+        patch_geometry.get_visible_faces_dynamic_offset(image_idx),
+        patch_geometry.get_visible_vertices_dynamic_offset(image_idx)
     };
 
     vkCmdBindDescriptorSets(cmdbuf,
@@ -1845,29 +2482,129 @@ bool GeometryEditor::render_grid(VkCommandBuffer cmdbuf,
                             mstd::array_size(dynamic_offsets),
                             dynamic_offsets);
 
-    const VkDeviceSize vb_offset = image_idx * sub_buf_stride;
-
-    vkCmdBindVertexBuffers(cmdbuf,
-                           0, // firstBinding
-                           1, // bindingCount
-                           &grid_buf.get_buffer(),
-                           &vb_offset);
-
+    // The grid is computed in the fragment shader from the transforms
     vkCmdDraw(cmdbuf,
-              num_lines * 2,
+              3,  // vertexCount
               1,  // instanceCount
               0,  // firstVertex
               0); // firstInstance
+}
 
-    return true;
+void GeometryEditor::start_edit_mode()
+{
+    // Switching between modes keeps the previous modification
+    finish_edit_mode();
+
+    if ( ! ++edit_key)
+        edit_key = 1;
+
+    // New faces are added in the same undoable step as the following move, so cancelling
+    // the move also removes them.  Selected faces now use the copied vertices, which are moved.
+    if (mode == Mode::extrude) {
+        patch_geometry.begin_edit(edit_key);
+        edit_modified = patch_geometry.extrude_selected_faces();
+        patch_geometry.end_edit();
+    }
+
+    if ( ! patch_geometry.gather_selected_vertices(&edit_batch))
+        edit_batch.clear();
+
+    edit_mouse_init = view.mouse_pos;
+    get_mouse_ray(view, &edit_ray_origin, &edit_ray_dir);
 }
 
 void GeometryEditor::finish_edit_mode()
 {
+    edit_batch.clear();
+    edit_modified = false;
 }
 
 void GeometryEditor::cancel_edit_mode()
 {
+    if (edit_batch.size() && edit_modified)
+        patch_geometry.undo();
+
+    finish_edit_mode();
+}
+
+vmath::mat4 GeometryEditor::get_edit_transform()
+{
+    constexpr float rotate_factor = 0.01f;
+    constexpr float scale_factor  = 0.005f;
+    constexpr float snap_distance = 64.0f;
+
+    const vmath::vec3 center = edit_batch.get_center();
+    const vmath::vec3 normal = vmath::normalize(edit_ray_dir);
+    const float       delta  = view.mouse_pos.x - edit_mouse_init.x;
+
+    switch (mode) {
+
+        case Mode::move:
+        case Mode::extrude: {
+            // Vertices follow the mouse in the plane through their center, which faces the view
+            vmath::vec3 ray_origin;
+            vmath::vec3 ray_dir;
+            get_mouse_ray(view, &ray_origin, &ray_dir);
+
+            const float init_dot = vmath::dot_product(edit_ray_dir, normal);
+            const float cur_dot  = vmath::dot_product(ray_dir, normal);
+            if ((init_dot == 0.0f) || (cur_dot == 0.0f))
+                break;
+
+            const vmath::vec3 init_pos = edit_ray_origin +
+                (vmath::dot_product(center - edit_ray_origin, normal) / init_dot) * edit_ray_dir;
+            const vmath::vec3 cur_pos  = ray_origin +
+                (vmath::dot_product(center - ray_origin, normal) / cur_dot) * ray_dir;
+
+            vmath::vec3 offset = cur_pos - init_pos;
+
+            // With snapping, the center moves onto the nearest vertex which is not being moved,
+            // but only along the axes which are snapped
+            if (toolbar_state.snap_x || toolbar_state.snap_y || toolbar_state.snap_z) {
+                uint32_t nearest[Sculptor::VertexGrid::max_nearest];
+
+                const uint32_t num_nearest = patch_geometry.find_nearest_vertices(center + offset,
+                                                                                  snap_distance,
+                                                                                  nearest,
+                                                                                  mstd::array_size(nearest));
+
+                for (uint32_t i = 0; i < num_nearest; i++) {
+                    if (edit_batch.contains(nearest[i]))
+                        continue;
+
+                    const Sculptor::Geometry::Vertex& vertex = patch_geometry.get_vertex(nearest[i]);
+
+                    if (toolbar_state.snap_x)
+                        offset.x = static_cast<float>(vertex.pos[0]) - center.x;
+                    if (toolbar_state.snap_y)
+                        offset.y = static_cast<float>(vertex.pos[1]) - center.y;
+                    if (toolbar_state.snap_z)
+                        offset.z = static_cast<float>(vertex.pos[2]) - center.z;
+                    break;
+                }
+            }
+
+            return vmath::translate(offset);
+        }
+
+        case Mode::rotate:
+            // Rotate around the view axis going through the center
+            return vmath::translate(-center) *
+                   vmath::mat4(vmath::quat(normal, delta * rotate_factor)) *
+                   vmath::translate(center);
+
+        case Mode::scale: {
+            const float scale = mstd::max(1.0f + delta * scale_factor, 0.0f);
+            return vmath::translate(-center) *
+                   vmath::scale(scale, scale, scale) *
+                   vmath::translate(center);
+        }
+
+        default:
+            break;
+    }
+
+    return vmath::mat4::identity();
 }
 
 } // namespace Sculptor
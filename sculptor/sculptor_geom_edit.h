@@ -56,9 +56,12 @@ class GeometryEditor: public Editor {
 
         struct Resources {
             Image           color;
+            Image           views_color;          // Quad view only, views are copied to color
             Image           depth;
             Image           select_feedback;
-            Image           host_select_feedback;
+            Buffer          host_select_feedback; // Region around the mouse cursor
+            VkRect2D        select_rect       = { };
+            VkOffset2D      select_cursor     = { }; // Mouse cursor inside select_rect
             bool            selection_pending = false;
             VkDescriptorSet gui_texture       = VK_NULL_HANDLE;
         };
@@ -85,14 +88,18 @@ class GeometryEditor: public Editor {
             void move(const vmath::vec3& delta);
         };
 
+        // In quad view all four views are drawn in one pass with multiview into layers
+        // of the same images, then copied into quadrants of the displayed image
         struct View {
-            uint32_t    width         = 0;
+            uint32_t    width         = 0;     // Size of one view
             uint32_t    height        = 0;
-            uint32_t    host_sel_size = 0;
-            ViewType    view_type     = ViewType::free_moving;
+            uint32_t    num_views     = 1;     // Number of layers in the images
+            uint32_t    active_view   = 0;     // View under the mouse cursor in quad view
+            ViewType    view_type     = ViewType::free_moving; // Type of the active view
+            bool        quad_view     = false; // Takes effect when resources are reallocated
             Camera      camera[static_cast<int>(ViewType::num_types)];
             Resources   res[max_swapchain_size];
-            vmath::vec2 mouse_pos;
+            vmath::vec2 mouse_pos;             // Relative to the active view
         };
 
         struct SelectState {
@@ -151,10 +158,12 @@ class GeometryEditor: public Editor {
         bool allocate_resources_once();
         void free_view_resources(View* dst_view);
         bool create_materials();
+        bool create_view_materials(const MaterialInfo& mat_info, VkPipeline (&pipelines)[2]);
+        bool create_patch_materials();
         void set_material_buf(const MaterialInfo& mat_info, uint32_t mat_id);
         bool create_transforms_buffer();
-        bool create_grid_buffer();
         bool create_descriptor_sets();
+        void update_descriptor_sets();
         void handle_mouse_actions(const UserInput& input, bool view_hovered);
         void handle_keyboard_actions();
         void gui_status_bar();
@@ -163,36 +172,56 @@ class GeometryEditor: public Editor {
         void switch_mode(Mode new_mode);
         bool draw_geometry_view(VkCommandBuffer cmdbuf, View& dst_view, uint32_t image_idx);
         bool draw_selection_feedback(VkCommandBuffer cmdbuf, View& dst_view, uint32_t image_idx);
+        void read_selection_feedback(View& dst_view, uint32_t image_idx);
         bool render_geometry(VkCommandBuffer cmdbuf, const View& dst_view, uint32_t image_idx);
-        bool render_grid(VkCommandBuffer cmdbuf, const View& dst_view, uint32_t image_idx);
+        void render_grid(VkCommandBuffer cmdbuf, const View& dst_view, uint32_t image_idx);
+        void copy_quad_views(VkCommandBuffer cmdbuf, View& dst_view, uint32_t image_idx);
         bool set_patch_transforms(const View& dst_view, uint32_t transform_id);
+        bool is_quad_view_supported() const;
+        static ViewType get_view_type(const View& dst_view, uint32_t view_idx);
+        vmath::mat4 get_model_view(const View& dst_view, ViewType view_type) const;
+        vmath::vec4 get_projection(const View& dst_view, ViewType view_type) const;
+        void get_mouse_ray(const View& dst_view, vmath::vec3* origin, vmath::vec3* dir) const;
+        void start_edit_mode();
         void finish_edit_mode();
         void cancel_edit_mode();
+        vmath::mat4 get_edit_transform();
 
         View               view;
         uint32_t           window_width      = 0;
         uint32_t           window_height     = 0;
         uint32_t           materials_stride  = 0;
         uint32_t           transforms_stride = 0;
+        uint32_t           geom_generation   = 0;
+        uint32_t           hovered_object    = ~0U; // Face drawn under the mouse cursor, read back from the GPU
         // 3 descriptor sets:
         // - desc set 0: global and per-frame resources
         // - desc set 1: per-material resources
         // - desc set 2: per-object resources
         VkDescriptorSet    desc_set[3]       = { };
-        VkPipeline         gray_patch_mat    = VK_NULL_HANDLE;
-        VkPipeline         edge_patch_mat    = VK_NULL_HANDLE;
-        VkPipeline         vertex_mat        = VK_NULL_HANDLE;
-        VkPipeline         grid_mat          = VK_NULL_HANDLE;
+        // Each material has a pipeline for a single view and a pipeline for quad view
+        VkPipeline         gray_patch_mat[2] = { };
+        VkPipeline         edge_patch_mat[2] = { };
+        VkPipeline         vertex_mat[2]     = { };
+        VkPipeline         grid_mat[2]       = { };
+        VkPipeline         object_id_mat[2]  = { }; // Writes face ids into selection feedback
         VkDescriptorSet    toolbar_texture   = VK_NULL_HANDLE;
         Sculptor::Geometry patch_geometry;
         Buffer             materials_buf;
+        Buffer             patch_materials_buf;
         Buffer             transforms_buf;
-        Buffer             grid_buf;
         ToolbarState       toolbar_state     = { };
         SelectState        saved_select      = { };
         Mode               mode              = Mode::select;
         Action             mouse_action      = Action::none;
         vmath::vec2        mouse_action_init {0.0f, 0.0f};
+        // Vertices modified by the move, rotate and scale modes, and the mouse when the mode started
+        Sculptor::Geometry::VertexBatch edit_batch;
+        vmath::vec2        edit_mouse_init   {0.0f, 0.0f};
+        vmath::vec3        edit_ray_origin   {0.0f};
+        vmath::vec3        edit_ray_dir      {0.0f};
+        uint32_t           edit_key          = 0;     // Coalesces undo steps of one modification
+        bool               edit_modified     = false;
 };
 
 }
@@ -2,57 +2,958 @@
 // SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
 
 #include "sculptor_geometry.h"
+#include "sculptor_materials.h"
 
+#include "../d_printf.h"
+#include "../minivulkan.h"
 #include "../mstdc.h"
 
-constexpr uint32_t tess_level           = 3; // TODO
+#include "sculptor_shaders.h"
+#include "../shaders.h"
+
+#include <stdlib.h>
+
+// Number of segments for drawing edges
+constexpr uint32_t edge_tess_level      = 3;
+
+// Patch tessellation levels are computed in the tessellation control shader from the
+// projected size of each patch, this is the maximum level guaranteed by the spec
+constexpr uint32_t max_patch_tess_level = 64;
 
-constexpr uint32_t max_vertices         = 65536;
-constexpr uint32_t max_indices          = 65536;
-constexpr uint32_t max_face_indices     = 43008;
-constexpr uint32_t max_edge_indices     = 22528;
-static_assert(max_edge_indices + max_face_indices == max_indices);
 constexpr uint32_t num_host_copies      = 3;
 
-constexpr uint32_t host_vertices_offset = 0;
-constexpr uint32_t gpu_vertices_offset  = 0;
-constexpr uint32_t vertices_stride      = max_vertices * sizeof(Sculptor::Geometry::Vertex);
+// Initial capacities of GPU buffers, these grow as the geometry grows.  With the heaps
+// created by init_vulkan(), 256MB of device memory and 128MB of host memory, the limit is
+// about 130k patches, set by the host copies of the buffer, or about 32k patches when
+// patches are evaluated in a compute shader, set by the evaluated vertices.
+constexpr uint32_t init_vertices_cap    = 16384;
+constexpr uint32_t init_faces_cap       = 2048;
+constexpr uint32_t init_edges_cap       = 4096;
+
+// Initial capacity of host tables
+constexpr uint32_t init_table_cap       = 1024;
+
+// Size of the undo journal, the oldest steps are discarded when it's full
+constexpr uint32_t journal_size         = 4U * 1024U * 1024U;
+
+// Regions inside the GPU buffer are bound as storage buffers, so their offsets
+// are aligned to the largest minStorageBufferOffsetAlignment allowed by the spec
+constexpr uint32_t region_alignment     = 256;
+
+static uint32_t grow_capacity(uint32_t capacity, uint32_t required, uint32_t init_capacity)
+{
+    uint32_t new_capacity = mstd::max(capacity, init_capacity);
+
+    while (new_capacity < required)
+        new_capacity *= 2;
+
+    return new_capacity;
+}
+
+template<typename T>
+static bool reserve_table(T** table, uint32_t* capacity, uint32_t required)
+{
+    if (required <= *capacity)
+        return true;
+
+    const uint32_t new_capacity = grow_capacity(*capacity, required, init_table_cap);
+
+    T* const new_table = static_cast<T*>(realloc(*table, new_capacity * sizeof(T)));
+    if ( ! new_table) {
+        d_printf("Failed to grow geometry table to %u entries\n", new_capacity);
+        return false;
+    }
+
+    *table    = new_table;
+    *capacity = new_capacity;
+    return true;
+}
+
+struct IndexGenPushConstants {
+    uint32_t first_face;
+    uint32_t num_faces;
+    uint32_t hovered_face;
+    uint32_t wide_indices;
+};
+
+constexpr uint32_t index_gen_group_size = 64;
+
+static VkDescriptorSetLayout index_gen_set_layout = VK_NULL_HANDLE;
+static VkPipelineLayout      index_gen_layout     = VK_NULL_HANDLE;
+static VkPipeline            index_gen_pipeline   = VK_NULL_HANDLE;
+
+struct CullPushConstants {
+    uint32_t num_faces;
+    uint32_t wide_indices;
+    uint32_t backface_cull;
+    uint32_t num_views;
+    uint32_t num_vertices;
+};
+
+// View transforms read by the culling shader, written to the slot before culling
+struct CullViewData {
+    vmath::mat4 model_view;
+    vmath::vec4 proj;
+    vmath::vec4 proj_w;
+};
+
+constexpr uint32_t cull_group_size = 64;
+
+// Each swapchain image has its own slot for culling results, because culling depends on the view
+constexpr uint32_t num_cull_slots  = max_swapchain_size;
+
+static VkDescriptorSetLayout cull_set_layout        = VK_NULL_HANDLE;
+static VkPipelineLayout      cull_layout            = VK_NULL_HANDLE;
+static VkPipeline            cull_pipeline          = VK_NULL_HANDLE;
+static VkPipeline            vertex_cull_pipeline   = VK_NULL_HANDLE;
+
+struct TessPushConstants {
+    uint32_t first_face;
+    uint32_t num_faces;
+    uint32_t wide_indices;
+    uint32_t tess_level;
+};
+
+constexpr uint32_t tess_group_size      = 64;
+
+// Without tessellation shaders, patches are evaluated in a compute shader into a mesh with
+// a fixed number of quads along each side of a patch.  The mesh is cached and only patches
+// whose control points have changed are evaluated again.
+constexpr uint32_t compute_tess_level   = 8;
+constexpr uint32_t tess_verts_per_patch = (compute_tess_level + 1) * (compute_tess_level + 1);
+constexpr uint32_t tess_idx_per_patch   = compute_tess_level * compute_tess_level * 6;
+
+static VkDescriptorSetLayout tess_set_layout = VK_NULL_HANDLE;
+static VkPipelineLayout      tess_layout     = VK_NULL_HANDLE;
+static VkPipeline            tess_pipeline   = VK_NULL_HANDLE;
+
+// Must match patches_per_task in sculptor_mesh_patch.glsl
+constexpr uint32_t mesh_patches_per_task = 32;
+
+static bool create_index_gen_pipeline()
+{
+    if (index_gen_pipeline)
+        return true;
+
+    static const VkDescriptorSetLayoutBinding bindings[] = {
+        {
+            0, // binding 0: face records
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            1, // binding 1: edge indices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            2, // binding 2: output patch indices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            3, // binding 3: output face data
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        }
+    };
+
+    static const VkDescriptorSetLayoutCreateInfo create_set_layout = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        nullptr,
+        0, // flags
+        mstd::array_size(bindings),
+        bindings
+    };
+
+    VkResult res = CHK(vkCreateDescriptorSetLayout(vk_dev, &create_set_layout, nullptr, &index_gen_set_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static const VkPushConstantRange push_constant_range = {
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,                                  // offset
+        sizeof(IndexGenPushConstants)       // size
+    };
+
+    static const VkPipelineLayoutCreateInfo layout_create_info = {
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        nullptr,
+        0,      // flags
+        1,      // setLayoutCount
+        &index_gen_set_layout,
+        1,      // pushConstantRangeCount
+        &push_constant_range
+    };
+
+    res = CHK(vkCreatePipelineLayout(vk_dev, &layout_create_info, nullptr, &index_gen_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static VkComputePipelineCreateInfo pipeline_create_info = {
+        VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        nullptr,
+        0,                  // flags
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            nullptr,
+            0,              // flags
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_NULL_HANDLE, // module
+            "main",         // pName
+            nullptr         // pSpecializationInfo
+        },
+        VK_NULL_HANDLE,     // layout
+        VK_NULL_HANDLE,     // basePipelineHandle
+        -1                  // basePipelineIndex
+    };
+
+    pipeline_create_info.stage.module = load_shader(shader_sculptor_patch_indices_comp);
+    pipeline_create_info.layout       = index_gen_layout;
+
+    res = CHK(vkCreateComputePipelines(vk_dev,
+                                       VK_NULL_HANDLE,
+                                       1,
+                                       &pipeline_create_info,
+                                       nullptr,
+                                       &index_gen_pipeline));
+    return res == VK_SUCCESS;
+}
+
+static bool create_cull_pipeline()
+{
+    if (cull_pipeline)
+        return true;
+
+    static const VkDescriptorSetLayoutBinding bindings[] = {
+        {
+            0, // binding 0: vertices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            1, // binding 1: patch indices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            2, // binding 2: output indirect draw command
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            3, // binding 3: output face ids of visible patches
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            4, // binding 4: output patch indices of visible patches
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            5, // binding 5: views
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            6, // binding 6: vertex marks
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            7, // binding 7: output indirect draw command for vertex handles
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            8, // binding 8: output ids of visible vertices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        }
+    };
+
+    if (vk_phys_props.properties.limits.maxPerStageDescriptorStorageBuffers < mstd::array_size(bindings)) {
+        d_printf("Culling requires %u storage buffers per shader stage, device supports %u\n",
+                 mstd::array_size(bindings),
+                 vk_phys_props.properties.limits.maxPerStageDescriptorStorageBuffers);
+        return false;
+    }
+
+    static const VkDescriptorSetLayoutCreateInfo create_set_layout = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        nullptr,
+        0, // flags
+        mstd::array_size(bindings),
+        bindings
+    };
+
+    VkResult res = CHK(vkCreateDescriptorSetLayout(vk_dev, &create_set_layout, nullptr, &cull_set_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static const VkPushConstantRange push_constant_range = {
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,                                  // offset
+        sizeof(CullPushConstants)           // size
+    };
+
+    static const VkPipelineLayoutCreateInfo layout_create_info = {
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        nullptr,
+        0,      // flags
+        1,      // setLayoutCount
+        &cull_set_layout,
+        1,      // pushConstantRangeCount
+        &push_constant_range
+    };
+
+    res = CHK(vkCreatePipelineLayout(vk_dev, &layout_create_info, nullptr, &cull_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static VkComputePipelineCreateInfo pipeline_create_info = {
+        VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        nullptr,
+        0,                  // flags
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            nullptr,
+            0,              // flags
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_NULL_HANDLE, // module
+            "main",         // pName
+            nullptr         // pSpecializationInfo
+        },
+        VK_NULL_HANDLE,     // layout
+        VK_NULL_HANDLE,     // basePipelineHandle
+        -1                  // basePipelineIndex
+    };
+
+    pipeline_create_info.stage.module = load_shader(shader_sculptor_patch_cull_comp);
+    pipeline_create_info.layout       = cull_layout;
+
+    res = CHK(vkCreateComputePipelines(vk_dev,
+                                       VK_NULL_HANDLE,
+                                       1,
+                                       &pipeline_create_info,
+                                       nullptr,
+                                       &cull_pipeline));
+    if (res != VK_SUCCESS)
+        return false;
+
+    // Vertex handles are culled with the same descriptor set, after patches
+    pipeline_create_info.stage.module = load_shader(shader_sculptor_vertex_cull_comp);
+
+    res = CHK(vkCreateComputePipelines(vk_dev,
+                                       VK_NULL_HANDLE,
+                                       1,
+                                       &pipeline_create_info,
+                                       nullptr,
+                                       &vertex_cull_pipeline));
+    return res == VK_SUCCESS;
+}
+
+static bool create_tess_pipeline()
+{
+    if (tess_pipeline)
+        return true;
+
+    static const VkDescriptorSetLayoutBinding bindings[] = {
+        {
+            0, // binding 0: vertices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            1, // binding 1: patch indices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            2, // binding 2: output tessellated vertices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        },
+        {
+            3, // binding 3: output tessellated indices
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            1,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            nullptr
+        }
+    };
+
+    static const VkDescriptorSetLayoutCreateInfo create_set_layout = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        nullptr,
+        0, // flags
+        mstd::array_size(bindings),
+        bindings
+    };
+
+    VkResult res = CHK(vkCreateDescriptorSetLayout(vk_dev, &create_set_layout, nullptr, &tess_set_layout));
+    if (res != VK_SUCCESS)
+        return false;
+
+    static const VkPushConstantRange push_constant_range = {
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,                                  // offset
+        sizeof(TessPushConstants)           // size
+    };
+
+    static const VkPipelineLayoutCreateInfo layout_create_info = {
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        nullptr,
+        0,      // flags
+        1,      // setLayoutCount
+        &tess_set_layout,
+        1,      // pushConstantRangeCount
+        &push_constant_range
+    };
+
+    res = CHK(vkCreatePipelineLayout(vk_dev, &layout_create_info, nullptr, &tess_layout));
+    if (res != VK_SUCCESS)
+        return false;
 
-constexpr uint32_t host_indices_offset  = vertices_stride;
-constexpr uint32_t gpu_indices_offset   = vertices_stride;
-constexpr uint32_t indices_stride       = max_indices * sizeof(uint16_t);
+    static VkComputePipelineCreateInfo pipeline_create_info = {
+        VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        nullptr,
+        0,                  // flags
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            nullptr,
+            0,              // flags
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            VK_NULL_HANDLE, // module
+            "main",         // pName
+            nullptr         // pSpecializationInfo
+        },
+        VK_NULL_HANDLE,     // layout
+        VK_NULL_HANDLE,     // basePipelineHandle
+        -1                  // basePipelineIndex
+    };
 
-constexpr uint32_t host_faces_offset    = vertices_stride + indices_stride * num_host_copies;
-constexpr uint32_t gpu_faces_offset     = vertices_stride + indices_stride;
-constexpr uint32_t faces_stride         = sizeof(Sculptor::Geometry::FacesBuf) + (Sculptor::Geometry::max_faces - 1) * sizeof(Sculptor::Geometry::FaceData);
+    pipeline_create_info.stage.module = load_shader(shader_sculptor_patch_tess_comp);
+    pipeline_create_info.layout       = tess_layout;
+
+    res = CHK(vkCreateComputePipelines(vk_dev,
+                                       VK_NULL_HANDLE,
+                                       1,
+                                       &pipeline_create_info,
+                                       nullptr,
+                                       &tess_pipeline));
+    return res == VK_SUCCESS;
+}
 
 bool Sculptor::Geometry::allocate()
 {
+    assert( ! gpu_buffer.allocated());
+
+    const bool tess_shader = vk_features.features.tessellationShader != VK_FALSE;
+
+    // Task and mesh shaders cull and evaluate patches themselves
+    mesh_shading = use_mesh_shading();
+
+    // Patch indices are generated and patches are culled on the GPU if the queue
+    // supports compute, otherwise indices are generated on the CPU and all patches are drawn.
+    // Without tessellation shaders patches are evaluated in a compute shader instead of culled.
+    if (vk_queue_flags & VK_QUEUE_COMPUTE_BIT) {
+        if ( ! create_index_gen_pipeline())
+            return false;
+
+        if ( ! mesh_shading && ! (tess_shader ? create_cull_pipeline() : create_tess_pipeline()))
+            return false;
+
+        if ( ! allocate_compute_desc_sets(tess_shader))
+            return false;
+    }
+    else if ( ! tess_shader && ! mesh_shading) {
+        d_printf("Patches require tessellation shaders, mesh shaders or compute\n");
+        return false;
+    }
+
+    return reserve_gpu_buffers();
+}
+
+bool Sculptor::Geometry::allocate_compute_desc_sets(bool tess_shader)
+{
+    // Each cull slot has its own set of plain storage buffers, because dynamic storage
+    // buffers are limited to maxDescriptorSetStorageBuffersDynamic, which can be as low as 4
+    static const VkDescriptorPoolSize pool_sizes[] = {
+        {
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            4 + 9 * num_cull_slots
+        }
+    };
+
+    static const VkDescriptorPoolCreateInfo pool_create_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        nullptr,
+        0,                  // flags
+        1 + num_cull_slots, // maxSets
+        mstd::array_size(pool_sizes),
+        pool_sizes
+    };
+
+    static VkDescriptorSetLayout set_layouts[1 + num_cull_slots];
+
+    static VkDescriptorSetAllocateInfo alloc_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        nullptr,
+        VK_NULL_HANDLE,                 // descriptorPool
+        mstd::array_size(set_layouts),  // descriptorSetCount
+        set_layouts                     // pSetLayouts
+    };
+
+    set_layouts[0] = index_gen_set_layout;
+    for (uint32_t i = 1; i < mstd::array_size(set_layouts); i++)
+        set_layouts[i] = tess_shader ? cull_set_layout : tess_set_layout;
+
+    // With mesh shading only indices are generated in a compute shader
+    alloc_info.descriptorSetCount = mesh_shading ? 1U : tess_shader ? (1U + num_cull_slots) : 2U;
+
+    VkResult res = CHK(vkCreateDescriptorPool(vk_dev, &pool_create_info, nullptr, &alloc_info.descriptorPool));
+    if (res != VK_SUCCESS)
+        return false;
+
+    VkDescriptorSet desc_sets[1 + num_cull_slots];
+
+    res = CHK(vkAllocateDescriptorSets(vk_dev, &alloc_info, desc_sets));
+    if (res != VK_SUCCESS)
+        return false;
+
+    index_gen_desc_set = desc_sets[0];
+    if (mesh_shading)
+        return true;
+    if (tess_shader) {
+        for (uint32_t slot = 0; slot < num_cull_slots; slot++)
+            cull_desc_sets[slot] = desc_sets[1 + slot];
+    }
+    else
+        tess_desc_set = desc_sets[1];
+    return true;
+}
+
+void Sculptor::Geometry::update_compute_desc_sets()
+{
+    static VkDescriptorBufferInfo buffer_info[8] = { };
+
+    // Index generation
+    buffer_info[0].buffer = gpu_buffer.get_buffer();
+    buffer_info[0].offset = face_records_offset;
+    buffer_info[0].range  = vertex_state_offset - face_records_offset;
+    buffer_info[1].buffer = gpu_buffer.get_buffer();
+    buffer_info[1].offset = edge_indices_offset;
+    buffer_info[1].range  = faces_offset - edge_indices_offset;
+    buffer_info[2].buffer = gpu_buffer.get_buffer();
+    buffer_info[2].offset = indices_offset;
+    buffer_info[2].range  = edge_indices_offset - indices_offset;
+    buffer_info[3].buffer = gpu_buffer.get_buffer();
+    buffer_info[3].offset = faces_offset;
+    buffer_info[3].range  = face_records_offset - faces_offset;
+
+    // Vertices and patch indices, read by both culling and evaluation of patches
+    buffer_info[4].buffer = gpu_buffer.get_buffer();
+    buffer_info[4].offset = 0;
+    buffer_info[4].range  = indices_offset;
+    buffer_info[5].buffer = gpu_buffer.get_buffer();
+    buffer_info[5].offset = indices_offset;
+    buffer_info[5].range  = edge_indices_offset - indices_offset;
+
+    // Evaluation of patches
+    buffer_info[6].buffer = gpu_buffer.get_buffer();
+    buffer_info[6].offset = tess_vertices_offset;
+    buffer_info[6].range  = tess_indices_offset - tess_vertices_offset;
+    buffer_info[7].buffer = gpu_buffer.get_buffer();
+    buffer_info[7].offset = tess_indices_offset;
+    buffer_info[7].range  = tess_end_offset - tess_indices_offset;
+
+    // Culling, the descriptor set of each slot refers to outputs in that slot
+    static VkDescriptorBufferInfo cull_buffer_info[num_cull_slots][9] = { };
+
+    for (uint32_t slot = 0; slot < num_cull_slots; slot++) {
+        VkDescriptorBufferInfo* const info        = cull_buffer_info[slot];
+        const VkDeviceSize            slot_offset = cull_offset + slot * cull_slot_size;
+
+        info[0] = buffer_info[4];
+        info[1] = buffer_info[5];
+        for (uint32_t i = 2; i < 9; i++)
+            info[i].buffer = gpu_buffer.get_buffer();
+        info[2].offset = slot_offset;
+        info[2].range  = sizeof(VkDrawIndexedIndirectCommand);
+        info[3].offset = slot_offset + cull_faces_offset;
+        info[3].range  = cull_indices_offset - cull_faces_offset;
+        info[4].offset = slot_offset + cull_indices_offset;
+        info[4].range  = cull_slot_size - cull_indices_offset;
+        info[5].offset = slot_offset + cull_views_offset;
+        info[5].range  = max_cull_views * sizeof(CullViewData);
+        info[6].offset = slot_offset + cull_vertex_marks_offset;
+        info[6].range  = cull_vertices_offset - cull_vertex_marks_offset;
+        info[7].offset = slot_offset + cull_vertex_draw_offset;
+        info[7].range  = sizeof(VkDrawIndirectCommand);
+        info[8].offset = slot_offset + cull_vertices_offset;
+        info[8].range  = cull_slot_size - cull_vertices_offset;
+    }
+
+    static VkWriteDescriptorSet write_desc_sets[] = {
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            0,                                          // dstBinding
+            0,                                          // dstArrayElement
+            4,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &buffer_info[0],                            // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            0,                                          // dstBinding
+            0,                                          // dstArrayElement
+            9,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            nullptr,                                    // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            0,                                          // dstBinding
+            0,                                          // dstArrayElement
+            2,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &buffer_info[4],                            // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        },
+        {
+            VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            nullptr,
+            VK_NULL_HANDLE,                             // dstSet
+            2,                                          // dstBinding
+            0,                                          // dstArrayElement
+            2,                                          // descriptorCount
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,          // descriptorType
+            nullptr,                                    // pImageInfo
+            &buffer_info[6],                            // pBufferInfo
+            nullptr                                     // pTexelBufferView
+        }
+    };
+
+    write_desc_sets[0].dstSet = index_gen_desc_set;
+    write_desc_sets[2].dstSet = tess_desc_set;
+    write_desc_sets[3].dstSet = tess_desc_set;
+
+    vkUpdateDescriptorSets(vk_dev,
+                           1,           // descriptorWriteCount
+                           &write_desc_sets[0],
+                           0,           // descriptorCopyCount
+                           nullptr);    // pDescriptorCopies
+
+    if (mesh_shading)
+        return;
+
+    // Only one of the culling and evaluation descriptor sets exists
+    if ( ! uses_gpu_culling()) {
+        vkUpdateDescriptorSets(vk_dev,
+                               2,           // descriptorWriteCount
+                               &write_desc_sets[2],
+                               0,           // descriptorCopyCount
+                               nullptr);    // pDescriptorCopies
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < num_cull_slots; slot++) {
+        write_desc_sets[1].dstSet      = cull_desc_sets[slot];
+        write_desc_sets[1].pBufferInfo = cull_buffer_info[slot];
+
+        vkUpdateDescriptorSets(vk_dev,
+                               1,           // descriptorWriteCount
+                               &write_desc_sets[1],
+                               0,           // descriptorCopyCount
+                               nullptr);    // pDescriptorCopies
+    }
+}
+
+bool Sculptor::Geometry::reserve_gpu_buffers()
+{
+    if (gpu_buffer.allocated() &&
+        (num_vertices <= gpu_vertices_cap) &&
+        (num_faces    <= gpu_faces_cap)    &&
+        (num_edges    <= gpu_edges_cap))
+        return true;
+
+    gpu_vertices_cap = grow_capacity(gpu_vertices_cap, num_vertices, init_vertices_cap);
+    gpu_faces_cap    = grow_capacity(gpu_faces_cap,    num_faces,    init_faces_cap);
+    gpu_edges_cap    = grow_capacity(gpu_edges_cap,    num_edges,    init_edges_cap);
+
+    // Offsets are 32-bit, so check upper bounds of the layout computed below before computing it,
+    // the host buffer holds several copies of the first part of the GPU buffer
+    const VkDeviceSize copy_bound = VkDeviceSize(gpu_vertices_cap) * (sizeof(Vertex) + 1) +
+                                    VkDeviceSize(gpu_faces_cap) * (16 * sizeof(uint32_t) + sizeof(FaceData) + sizeof(FaceRecord)) +
+                                    VkDeviceSize(gpu_edges_cap) * 4 * sizeof(uint32_t) +
+                                    8 * region_alignment;
+    const VkDeviceSize cull_bound = VkDeviceSize(gpu_vertices_cap) * (sizeof(uint32_t) + 1) +
+                                    VkDeviceSize(gpu_faces_cap) * (17 * sizeof(uint32_t)) +
+                                    max_cull_views * sizeof(CullViewData) +
+                                    8 * region_alignment;
+    const VkDeviceSize tess_bound = VkDeviceSize(gpu_faces_cap) * (tess_verts_per_patch * sizeof(TessVertex) +
+                                                                   tess_idx_per_patch * sizeof(uint32_t)) +
+                                    2 * region_alignment;
+    const VkDeviceSize gpu_bound  = copy_bound + mstd::max(cull_bound * num_cull_slots, tess_bound);
+
+    if (copy_bound * num_host_copies > ~0U || gpu_bound > ~0U) {
+        d_printf("Geometry with %u vertices and %u faces does not fit in GPU buffers\n",
+                 num_vertices, num_faces);
+        return false;
+    }
+
+    // Edge indices are only read by shaders and are always 32-bit,
+    // patch indices are used as the index buffer and start as 16-bit
+    index_size = (gpu_vertices_cap > max_16bit_vertices) ? sizeof(uint32_t) : sizeof(uint16_t);
+
+    const uint32_t vertices_size     = gpu_vertices_cap * sizeof(Vertex);
+    const uint32_t indices_size      = gpu_faces_cap * 16 * index_size;
+    const uint32_t edge_indices_size = gpu_edges_cap * 4 * sizeof(uint32_t);
+    const uint32_t faces_size        = static_cast<uint32_t>(sizeof(FacesBuf) + (gpu_faces_cap - 1) * sizeof(FaceData));
+    const uint32_t face_records_size = gpu_faces_cap * sizeof(FaceRecord);
+    const uint32_t face_ids_size     = gpu_faces_cap * sizeof(uint32_t);
+    const uint32_t cull_views_size   = max_cull_views * sizeof(CullViewData);
+    const uint32_t vertex_words      = (gpu_vertices_cap + 31) / 32;
+    const uint32_t vertex_state_size = static_cast<uint32_t>(offsetof(VertexStateBuf, selected) + vertex_words * sizeof(uint32_t));
+    const uint32_t vertex_marks_size = 2 * vertex_words * sizeof(uint32_t);
+    const uint32_t vertex_ids_size   = gpu_vertices_cap * sizeof(uint32_t);
+
+    indices_offset      = mstd::align_up(vertices_size, region_alignment);
+    edge_indices_offset = indices_offset + mstd::align_up(indices_size, region_alignment);
+    faces_offset        = edge_indices_offset + mstd::align_up(edge_indices_size, region_alignment);
+    face_records_offset = faces_offset + mstd::align_up(faces_size, region_alignment);
+    vertex_state_offset = face_records_offset + mstd::align_up(face_records_size, region_alignment);
+    copy_size           = vertex_state_offset + mstd::align_up(vertex_state_size, region_alignment);
+
+    // Culling results and evaluated patches are only produced and consumed on the GPU,
+    // so they follow the part of the buffer which has host copies
+    const uint32_t tess_vertices_size = gpu_faces_cap * tess_verts_per_patch * sizeof(TessVertex);
+    const uint32_t tess_indices_size  = gpu_faces_cap * tess_idx_per_patch * sizeof(uint32_t);
+
+    cull_views_offset    = region_alignment;
+    cull_faces_offset    = cull_views_offset + mstd::align_up(cull_views_size, region_alignment);
+    cull_indices_offset  = cull_faces_offset + mstd::align_up(face_ids_size, region_alignment);
+    cull_vertex_draw_offset  = cull_indices_offset + mstd::align_up(indices_size, region_alignment);
+    cull_vertex_marks_offset = cull_vertex_draw_offset + region_alignment;
+    cull_vertices_offset     = cull_vertex_marks_offset + mstd::align_up(vertex_marks_size, region_alignment);
+    cull_slot_size       = cull_vertices_offset + mstd::align_up(vertex_ids_size, region_alignment);
+    cull_offset          = copy_size;
+    tess_vertices_offset = copy_size;
+    tess_indices_offset  = tess_vertices_offset + mstd::align_up(tess_vertices_size, region_alignment);
+    tess_end_offset      = tess_indices_offset + mstd::align_up(tess_indices_size, region_alignment);
+
+    const uint32_t gpu_size = uses_gpu_culling() ? (cull_offset + cull_slot_size * num_cull_slots) :
+                              tess_desc_set ? tess_end_offset : copy_size;
+
+    // Each region is bound as a separate storage buffer, check the largest ones
+    uint32_t max_range = mstd::max(indices_offset, copy_size - faces_offset);
+    if (uses_gpu_culling())
+        max_range = mstd::max(max_range, cull_slot_size - cull_indices_offset);
+    else if (tess_desc_set)
+        max_range = mstd::max(max_range, tess_indices_offset - tess_vertices_offset);
+
+    if (max_range > vk_phys_props.properties.limits.maxStorageBufferRange) {
+        d_printf("Geometry with %u vertices and %u faces needs %u byte storage buffers, the limit is %u\n",
+                 num_vertices, num_faces, max_range, vk_phys_props.properties.limits.maxStorageBufferRange);
+        return false;
+    }
+
+    if (gpu_buffer.allocated()) {
+        // Frames in flight may still be reading from the old buffers
+        if ( ! idle_queue())
+            return false;
+
+        gpu_buffer.free();
+        host_buffer.free();
+    }
+
     if ( ! gpu_buffer.allocate(Usage::fixed,
-                               vertices_stride + indices_stride + faces_stride,
+                               gpu_size,
                                VK_FORMAT_UNDEFINED,
                                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
                                  VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                 VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                "geometry buffer"))
         return false;
 
     if ( ! host_buffer.allocate(Usage::host_only,
-                                vertices_stride + (indices_stride + faces_stride) * num_host_copies,
+                                copy_size * num_host_copies,
                                 VK_FORMAT_UNDEFINED,
-                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
                                 "geometry host buffer"))
         return false;
 
+    if (index_gen_desc_set)
+        update_compute_desc_sets();
+
+    // The new buffers are filled from the host tables
+    ++generation;
+    set_dirty();
+
     return true;
 }
 
+void Sculptor::DirtyRanges::add(uint32_t first, uint32_t count)
+{
+    if ( ! count)
+        return;
+
+    uint32_t last = first + count;
+
+    for (;;) {
+        // Absorb all ranges which overlap or touch the new range
+        for (uint32_t i = 0; i < num_ranges; ) {
+            if (first <= end[i] && last >= begin[i]) {
+                first = mstd::min(first, begin[i]);
+                last  = mstd::max(last, end[i]);
+                --num_ranges;
+                begin[i] = begin[num_ranges];
+                end[i]   = end[num_ranges];
+            }
+            else
+                ++i;
+        }
+
+        if (num_ranges < max_ranges)
+            break;
+
+        // Out of slots, merge with the closest range, which may in turn touch other ranges
+        uint32_t closest  = 0;
+        uint32_t min_dist = ~0U;
+        for (uint32_t i = 0; i < num_ranges; i++) {
+            const uint32_t dist = (last < begin[i]) ? (begin[i] - last) : (first - end[i]);
+            if (dist < min_dist) {
+                min_dist = dist;
+                closest  = i;
+            }
+        }
+
+        first = mstd::min(first, begin[closest]);
+        last  = mstd::max(last, end[closest]);
+        --num_ranges;
+        begin[closest] = begin[num_ranges];
+        end[closest]   = end[num_ranges];
+    }
+
+    begin[num_ranges] = first;
+    end[num_ranges]   = last;
+    ++num_ranges;
+}
+
+uint32_t Sculptor::DirtyRanges::get_copy_regions(VkBufferCopy* regions,
+                                                 uint32_t      num_elements,
+                                                 uint32_t      elem_size,
+                                                 uint32_t      header_size,
+                                                 VkDeviceSize  src_offset,
+                                                 VkDeviceSize  dst_offset) const
+{
+    uint32_t num_regions = 0;
+
+    for (uint32_t i = 0; i < num_ranges; i++) {
+        const uint32_t first = begin[i];
+        const uint32_t last  = mstd::min(end[i], num_elements);
+        if (first >= last)
+            continue;
+
+        // The header, if any, precedes the elements and is uploaded with the first element
+        const uint32_t prefix = first ? 0U : header_size;
+
+        VkBufferCopy& region = regions[num_regions++];
+        region.srcOffset = src_offset + header_size + first * elem_size - prefix;
+        region.dstOffset = dst_offset + header_size + first * elem_size - prefix;
+        region.size      = (last - first) * elem_size + prefix;
+    }
+
+    return num_regions;
+}
+
+void Sculptor::Geometry::set_dirty()
+{
+    mark_dirty(str_vertices,     0, num_vertices);
+    mark_dirty(str_face_indices, 0, num_faces);
+    mark_dirty(str_edge_indices, 0, num_edges);
+    mark_dirty(str_face_data,    0, num_faces);
+    mark_dirty(str_face_records, 0, num_faces);
+    mark_dirty(str_vertex_state, 0, (num_vertices + 31) / 32);
+}
+
+bool Sculptor::Geometry::is_dirty() const
+{
+    for (const DirtyRanges& ranges : dirty)
+        if (ranges.num_ranges)
+            return true;
+    return false;
+}
+
 void Sculptor::Geometry::set_hovered_face(uint32_t face_id)
 {
     if (face_id != hovered_face_id) {
+        if (hovered_face_id < num_faces)
+            mark_dirty(str_face_data, hovered_face_id);
+        if (face_id < num_faces)
+            mark_dirty(str_face_data, face_id);
         hovered_face_id = face_id;
-        dirty = true;
+    }
+}
+
+void Sculptor::Geometry::set_tess_quality(uint32_t pixels_per_segment)
+{
+    pixels_per_segment = mstd::max(pixels_per_segment, 1U);
+
+    if (pixels_per_segment != tess_segment_px) {
+        tess_segment_px = pixels_per_segment;
+
+        // Tessellation parameters are in the header, which is uploaded with the first face
+        if (num_faces)
+            mark_dirty(str_face_data, 0);
     }
 }
 
@@ -62,7 +963,8 @@ void Sculptor::Geometry::select_face(uint32_t face_id)
 
     if ( ! obj_faces[face_id].selected) {
         obj_faces[face_id].selected = true;
-        dirty = true;
+        mark_dirty(str_face_data,    face_id);
+        mark_dirty(str_face_records, face_id);
     }
 }
 
@@ -72,7 +974,8 @@ void Sculptor::Geometry::deselect_face(uint32_t face_id)
 
     if (obj_faces[face_id].selected) {
         obj_faces[face_id].selected = false;
-        dirty = true;
+        mark_dirty(str_face_data,    face_id);
+        mark_dirty(str_face_records, face_id);
     }
 }
 
@@ -82,6 +985,52 @@ void Sculptor::Geometry::deselect_all_faces()
         deselect_face(i);
 }
 
+void Sculptor::Geometry::set_hovered_vertex(uint32_t vtx)
+{
+    if (vtx != hovered_vertex_id) {
+        hovered_vertex_id = vtx;
+
+        // The hovered vertex is in the header, which is uploaded with the first word
+        mark_dirty(str_vertex_state, 0);
+    }
+}
+
+void Sculptor::Geometry::select_vertex(uint32_t vtx)
+{
+    assert(vtx < num_vertices);
+
+    const uint32_t bit = 1U << (vtx % 32);
+
+    if ( ! (vertex_selection[vtx / 32] & bit)) {
+        vertex_selection[vtx / 32] |= bit;
+        mark_dirty(str_vertex_state, vtx / 32);
+    }
+}
+
+void Sculptor::Geometry::deselect_vertex(uint32_t vtx)
+{
+    assert(vtx < num_vertices);
+
+    const uint32_t bit = 1U << (vtx % 32);
+
+    if (vertex_selection[vtx / 32] & bit) {
+        vertex_selection[vtx / 32] &= ~bit;
+        mark_dirty(str_vertex_state, vtx / 32);
+    }
+}
+
+void Sculptor::Geometry::deselect_all_vertices()
+{
+    const uint32_t num_words = (num_vertices + 31) / 32;
+
+    for (uint32_t i = 0; i < num_words; i++) {
+        if (vertex_selection[i]) {
+            vertex_selection[i] = 0;
+            mark_dirty(str_vertex_state, i);
+        }
+    }
+}
+
 uint32_t Sculptor::Geometry::get_face_state(uint32_t face_id, const Face& face) const
 {
     if (face_id == hovered_face_id)
@@ -127,14 +1076,73 @@ static void buffer_barrier(VkCommandBuffer      cmd_buf,
                          nullptr);      // pImageMemoryBarriers
 }
 
+template<typename T>
+void Sculptor::Geometry::write_face_indices(T* indices_ptr, uint32_t face_id) const
+{
+    const Face& face = obj_faces[face_id];
+
+    static const uint32_t idx_map[] = {
+         0,  1,  2,  3,
+         0,  4,  8, 12,
+         3,  7, 11, 15,
+        12, 13, 14, 15
+    };
+
+    // Write indices for the edges; note the indices of corners overlap
+    for (uint32_t i_edge = 0; i_edge < 4; i_edge++) {
+        const int32_t edge_sel     = face.edges[i_edge];
+        const bool    inverse_edge = edge_sel < 0;
+        const Edge&   edge         = obj_edges[inverse_edge ? (-edge_sel - 1) : edge_sel];
+
+        for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
+            const uint32_t src_idx = inverse_edge ? (3 - i_idx) : i_idx;
+            assert(edge.vertices[src_idx] < num_vertices);
+            const uint32_t dest_idx = idx_map[i_edge * 4 + i_idx];
+            assert(dest_idx < 16);
+            indices_ptr[dest_idx] = static_cast<T>(edge.vertices[src_idx]);
+        }
+    }
+
+    static const uint32_t ctrl_idx_map[] = {
+        5,  6,
+        9, 10
+    };
+
+    // Write 4 center indices which control the face, which are not included in edges
+    for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
+        assert(face.ctrl_vertices[i_idx] < num_vertices);
+        const uint32_t dest_idx = ctrl_idx_map[i_idx];
+        assert(dest_idx < 16);
+        indices_ptr[dest_idx] = static_cast<T>(face.ctrl_vertices[i_idx]);
+    }
+}
+
+void Sculptor::Geometry::write_edge_indices(uint32_t* indices_ptr, uint32_t edge_id) const
+{
+    const Edge& edge = obj_edges[edge_id];
+
+    indices_ptr += edge_id * 4;
+
+    for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
+        assert(edge.vertices[i_idx] < num_vertices);
+        indices_ptr[i_idx] = edge.vertices[i_idx];
+    }
+}
+
 bool Sculptor::Geometry::send_to_gpu(VkCommandBuffer cmd_buf)
 {
-    if ( ! dirty)
+    // Grow GPU buffers if the geometry no longer fits, this marks everything as dirty
+    if ( ! reserve_gpu_buffers())
+        return false;
+
+    if ( ! is_dirty())
         return true;
 
+    const bool gpu_index_gen = index_gen_desc_set != VK_NULL_HANDLE;
+
     buffer_barrier(cmd_buf,
                    gpu_buffer.get_buffer(),
-                   VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+                   VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                    VK_ACCESS_MEMORY_READ_BIT,
                    VK_PIPELINE_STAGE_TRANSFER_BIT,
                    VK_ACCESS_TRANSFER_WRITE_BIT);
@@ -146,214 +1154,903 @@ bool Sculptor::Geometry::send_to_gpu(VkCommandBuffer cmd_buf)
                    VK_PIPELINE_STAGE_TRANSFER_BIT,
                    VK_ACCESS_TRANSFER_READ_BIT);
 
+    // Only dirty ranges are written to the current host copy and only these are uploaded,
+    // the GPU buffer retains everything else from previous uploads
     last_buffer = (last_buffer + 1) % num_host_copies;
 
-    static VkBufferCopy copy_region = {
-        0, // srcOffset
-        0, // dstOffset
-        0  // size
-    };
+    num_indices      = num_faces * 16;
+    num_edge_indices = num_edges * 4;
+
+    const uint32_t cur_copy_offset = last_buffer * copy_size;
+    uint8_t* const host_ptr        = host_buffer.get_ptr<uint8_t>(cur_copy_offset);
+
+    // Write dirty vertices to the host copy of the vertex buffer
+    Vertex* const vertices_ptr = reinterpret_cast<Vertex*>(host_ptr);
+    const DirtyRanges& vertex_ranges = dirty[str_vertices];
+    for (uint32_t i = 0; i < vertex_ranges.num_ranges; i++) {
+        const uint32_t first = vertex_ranges.begin[i];
+        const uint32_t last  = mstd::min(vertex_ranges.end[i], num_vertices);
+        if (first < last)
+            mstd::mem_copy(&vertices_ptr[first], &obj_vertices[first], (last - first) * sizeof(Vertex));
+    }
+
+    // Write 16 indices for each dirty face to the host copy of the index buffer,
+    // unless the indices are generated on the GPU
+    const DirtyRanges& face_ranges = dirty[str_face_indices];
+    for (uint32_t i = 0; ! gpu_index_gen && i < face_ranges.num_ranges; i++) {
+        const uint32_t last = mstd::min(face_ranges.end[i], num_faces);
+        for (uint32_t i_face = face_ranges.begin[i]; i_face < last; i_face++) {
+            if (index_size == sizeof(uint32_t))
+                write_face_indices(reinterpret_cast<uint32_t*>(host_ptr + indices_offset) + i_face * 16, i_face);
+            else
+                write_face_indices(reinterpret_cast<uint16_t*>(host_ptr + indices_offset) + i_face * 16, i_face);
+        }
+    }
+
+    // Write 4 indices for each dirty edge to the host copy of the edge index buffer;
+    // The edge indices are used for drawing patch edges
+    const DirtyRanges& edge_ranges = dirty[str_edge_indices];
+    for (uint32_t i = 0; i < edge_ranges.num_ranges; i++) {
+        const uint32_t last = mstd::min(edge_ranges.end[i], num_edges);
+        for (uint32_t i_edge = edge_ranges.begin[i]; i_edge < last; i_edge++)
+            write_edge_indices(reinterpret_cast<uint32_t*>(host_ptr + edge_indices_offset), i_edge);
+    }
+
+    // Write material and state for each dirty face, unless the state is generated on the GPU
+    FacesBuf* const faces_ptr = reinterpret_cast<FacesBuf*>(host_ptr + faces_offset);
+    faces_ptr->tess_level[0] = edge_tess_level;
+    faces_ptr->tess_level[1] = max_patch_tess_level;
+    faces_ptr->tess_level[2] = static_cast<int32_t>(tess_segment_px);
+    faces_ptr->tess_level[3] = (uses_gpu_culling() ? 1 : 0) |
+                               ((index_size == sizeof(uint32_t)) ? 2 : 0);
+    const DirtyRanges& data_ranges = dirty[str_face_data];
+    for (uint32_t i = 0; ! gpu_index_gen && i < data_ranges.num_ranges; i++) {
+        const uint32_t last = mstd::min(data_ranges.end[i], num_faces);
+        for (uint32_t i_face = data_ranges.begin[i]; i_face < last; i_face++) {
+            const Face& face = obj_faces[i_face];
+
+            faces_ptr->face_data[i_face].material_id = face.material_id;
+            faces_ptr->face_data[i_face].state       = get_face_state(i_face, face);
+        }
+    }
+
+    // Write dirty words of the vertex selection bitset, the header is always written,
+    // but it is only uploaded with the first word
+    VertexStateBuf* const state_ptr = reinterpret_cast<VertexStateBuf*>(host_ptr + vertex_state_offset);
+    state_ptr->hovered_vertex = hovered_vertex_id;
+    state_ptr->flags          = uses_gpu_culling() ? 1U : 0U;
+    state_ptr->padding[0]     = 0;
+    state_ptr->padding[1]     = 0;
+    const uint32_t num_vertex_words = (num_vertices + 31) / 32;
+    const DirtyRanges& state_ranges = dirty[str_vertex_state];
+    for (uint32_t i = 0; i < state_ranges.num_ranges; i++) {
+        const uint32_t first = state_ranges.begin[i];
+        const uint32_t last  = mstd::min(state_ranges.end[i], num_vertex_words);
+        if (first < last)
+            mstd::mem_copy(&state_ptr->selected[first], &vertex_selection[first], (last - first) * sizeof(uint32_t));
+    }
+
+    // Write face records for the compute shader, which generates indices and state
+    FaceRecord* const records_ptr = reinterpret_cast<FaceRecord*>(host_ptr + face_records_offset);
+    const DirtyRanges& record_ranges = dirty[str_face_records];
+    for (uint32_t i = 0; gpu_index_gen && i < record_ranges.num_ranges; i++) {
+        const uint32_t last = mstd::min(record_ranges.end[i], num_faces);
+        for (uint32_t i_face = record_ranges.begin[i]; i_face < last; i_face++) {
+            const Face& face   = obj_faces[i_face];
+            FaceRecord& record = records_ptr[i_face];
+
+            for (uint32_t j = 0; j < 4; j++) {
+                record.edges[j]         = face.edges[j];
+                record.ctrl_vertices[j] = face.ctrl_vertices[j];
+            }
+            record.material_id = face.material_id;
+            record.selected    = face.selected;
+        }
+    }
+
+    static VkBufferCopy copy_regions[num_streams * DirtyRanges::max_ranges + 1];
+    uint32_t num_regions = 0;
+
+    num_regions += vertex_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                  num_vertices,
+                                                  sizeof(Vertex),
+                                                  0,
+                                                  cur_copy_offset,
+                                                  0);
+
+    num_regions += edge_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                num_edges,
+                                                4 * sizeof(uint32_t),
+                                                0,
+                                                cur_copy_offset + edge_indices_offset,
+                                                edge_indices_offset);
+
+    num_regions += state_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                 num_vertex_words,
+                                                 sizeof(uint32_t),
+                                                 offsetof(VertexStateBuf, selected),
+                                                 cur_copy_offset + vertex_state_offset,
+                                                 vertex_state_offset);
+
+    if (gpu_index_gen) {
+        num_regions += record_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                      num_faces,
+                                                      sizeof(FaceRecord),
+                                                      0,
+                                                      cur_copy_offset + face_records_offset,
+                                                      face_records_offset);
+
+        // The compute shader only writes face data, the header is uploaded with the first face
+        for (uint32_t i = 0; i < data_ranges.num_ranges; i++) {
+            if (data_ranges.begin[i] == 0 && num_faces) {
+                VkBufferCopy& region = copy_regions[num_regions++];
+                region.srcOffset = cur_copy_offset + faces_offset;
+                region.dstOffset = faces_offset;
+                region.size      = offsetof(FacesBuf, face_data);
+                break;
+            }
+        }
+    }
+    else {
+        num_regions += face_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                    num_faces,
+                                                    16 * index_size,
+                                                    0,
+                                                    cur_copy_offset + indices_offset,
+                                                    indices_offset);
+
+        num_regions += data_ranges.get_copy_regions(&copy_regions[num_regions],
+                                                    num_faces,
+                                                    sizeof(FaceData),
+                                                    offsetof(FacesBuf, face_data),
+                                                    cur_copy_offset + faces_offset,
+                                                    faces_offset);
+    }
+
+    if (num_regions)
+        vkCmdCopyBuffer(cmd_buf, host_buffer.get_buffer(), gpu_buffer.get_buffer(), num_regions, copy_regions);
+
+    if (gpu_index_gen) {
+        buffer_barrier(cmd_buf,
+                       gpu_buffer.get_buffer(),
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+        // Faces which need new indices or new state
+        DirtyRanges gen_ranges = face_ranges;
+        for (uint32_t i = 0; i < data_ranges.num_ranges; i++)
+            gen_ranges.add(data_ranges.begin[i], data_ranges.end[i] - data_ranges.begin[i]);
+
+        vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, index_gen_pipeline);
+
+        vkCmdBindDescriptorSets(cmd_buf,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                index_gen_layout,
+                                0,          // firstSet
+                                1,          // descriptorSetCount
+                                &index_gen_desc_set,
+                                0,          // dynamicOffsetCount
+                                nullptr);   // pDynamicOffsets
+
+        for (uint32_t i = 0; i < gen_ranges.num_ranges; i++) {
+            const uint32_t first = gen_ranges.begin[i];
+            const uint32_t last  = mstd::min(gen_ranges.end[i], num_faces);
+            if (first >= last)
+                continue;
+
+            const IndexGenPushConstants push = {
+                first,
+                last - first,
+                hovered_face_id,
+                (index_size == sizeof(uint32_t)) ? 1U : 0U
+            };
+
+            vkCmdPushConstants(cmd_buf,
+                               index_gen_layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT,
+                               0,               // offset
+                               sizeof(push),
+                               &push);
+
+            vkCmdDispatch(cmd_buf,
+                          (push.num_faces + index_gen_group_size - 1) / index_gen_group_size,
+                          1,
+                          1);
+        }
 
-    if (num_vertices) {
-        copy_region.srcOffset = host_vertices_offset;
-        copy_region.dstOffset = gpu_vertices_offset;
-        copy_region.size      = num_vertices * sizeof(Vertex);
+        if (tess_desc_set)
+            evaluate_patches(cmd_buf, face_ranges, vertex_ranges);
+    }
 
-        vkCmdCopyBuffer(cmd_buf, host_buffer.get_buffer(), gpu_buffer.get_buffer(), 1, &copy_region);
+    VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkAccessFlags        src_access = VK_ACCESS_TRANSFER_WRITE_BIT;
+    VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                      VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                      VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+                                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                      (mesh_shading ? VK_PIPELINE_STAGE_TASK_SHADER_BIT_EXT |
+                                                      VK_PIPELINE_STAGE_MESH_SHADER_BIT_EXT : 0U);
+    if (gpu_index_gen) {
+        src_stages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        src_access |= VK_ACCESS_SHADER_WRITE_BIT;
+        dst_stages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     }
 
-    const uint32_t cur_faces_offset = host_faces_offset + last_buffer * faces_stride;
-    FacesBuf* const faces_ptr = host_buffer.get_ptr<FacesBuf>(cur_faces_offset);
-    faces_ptr->tess_level[0] = tess_level;
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   src_stages,
+                   src_access,
+                   dst_stages,
+                   VK_ACCESS_MEMORY_READ_BIT);
+
+    buffer_barrier(cmd_buf,
+                   host_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                   VK_ACCESS_TRANSFER_READ_BIT,
+                   VK_PIPELINE_STAGE_HOST_BIT,
+                   VK_ACCESS_HOST_WRITE_BIT);
+
+    for (DirtyRanges& ranges : dirty)
+        ranges.num_ranges = 0;
+
+    return true;
+}
+
+#ifndef NDEBUG
+// Generates indices and face data on the GPU, reads them back and compares them
+// against indices and face data generated on the CPU
+bool Sculptor::Geometry::verify_gpu_indices()
+{
+    if ( ! index_gen_desc_set || ! num_faces)
+        return true;
+
+    if ( ! idle_queue())
+        return false;
+
+    static CommandBuffers<1> verify_cmd_buf;
+
+    if ( ! allocate_command_buffers_once(&verify_cmd_buf))
+        return false;
+
+    const VkCommandBuffer cmd_buf = verify_cmd_buf.bufs[0];
+
+    if ( ! reset_and_begin_command_buffer(cmd_buf))
+        return false;
+
+    set_dirty();
+
+    if ( ! send_to_gpu(cmd_buf))
+        return false;
+
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                   VK_ACCESS_TRANSFER_READ_BIT);
+
+    // Read back into one of the host copies not used by the upload
+    const uint32_t gpu_copy_offset  = ((last_buffer + 1) % num_host_copies) * copy_size;
+    const uint32_t cpu_copy_offset  = ((last_buffer + 2) % num_host_copies) * copy_size;
+    const uint32_t indices_size     = num_indices * index_size;
+    const uint32_t face_data_offset = faces_offset + offsetof(FacesBuf, face_data);
+    const uint32_t face_data_size   = num_faces * sizeof(FaceData);
+
+    const VkBufferCopy readback_regions[] = {
+        {
+            indices_offset,                     // srcOffset
+            gpu_copy_offset + indices_offset,   // dstOffset
+            indices_size                        // size
+        },
+        {
+            face_data_offset,                   // srcOffset
+            gpu_copy_offset + face_data_offset, // dstOffset
+            face_data_size                      // size
+        }
+    };
+
+    vkCmdCopyBuffer(cmd_buf,
+                    gpu_buffer.get_buffer(),
+                    host_buffer.get_buffer(),
+                    mstd::array_size(readback_regions),
+                    readback_regions);
+
+    buffer_barrier(cmd_buf,
+                   host_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                   VK_ACCESS_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_HOST_BIT,
+                   VK_ACCESS_HOST_READ_BIT);
+
+    if ( ! send_to_device_and_wait(cmd_buf))
+        return false;
 
-    // Write 16 indices for each face to the host copy of the index buffer
-    const uint32_t cur_indices_offset = host_indices_offset + last_buffer * indices_stride;
-    num_indices = 0;
-    uint16_t* const indices_ptr = host_buffer.get_ptr<uint16_t>(cur_indices_offset);
+    uint8_t* const gpu_ptr = host_buffer.get_ptr<uint8_t>(gpu_copy_offset);
+    uint8_t* const cpu_ptr = host_buffer.get_ptr<uint8_t>(cpu_copy_offset);
+
+    FacesBuf* const cpu_faces = reinterpret_cast<FacesBuf*>(cpu_ptr + faces_offset);
     for (uint32_t i_face = 0; i_face < num_faces; i_face++) {
-        assert(num_indices + 16 <= max_face_indices);
+        if (index_size == sizeof(uint32_t))
+            write_face_indices(reinterpret_cast<uint32_t*>(cpu_ptr + indices_offset) + i_face * 16, i_face);
+        else
+            write_face_indices(reinterpret_cast<uint16_t*>(cpu_ptr + indices_offset) + i_face * 16, i_face);
 
         const Face& face = obj_faces[i_face];
+        cpu_faces->face_data[i_face].material_id = face.material_id;
+        cpu_faces->face_data[i_face].state       = get_face_state(i_face, face);
+    }
 
-        faces_ptr->face_data[i_face].material_id = face.material_id;
-        faces_ptr->face_data[i_face].state       = get_face_state(i_face, face);
+    const uint8_t* const gpu_indices = gpu_ptr + indices_offset;
+    const uint8_t* const cpu_indices = cpu_ptr + indices_offset;
+    for (uint32_t i = 0; i < indices_size; i++) {
+        if (gpu_indices[i] != cpu_indices[i]) {
+            d_printf("GPU patch indices mismatch at byte %u\n", i);
+            return false;
+        }
+    }
 
-        static const uint32_t idx_map[] = {
-             0,  1,  2,  3,
-             0,  4,  8, 12,
-             3,  7, 11, 15,
-            12, 13, 14, 15
-        };
+    const uint8_t* const gpu_face_data = gpu_ptr + face_data_offset;
+    const uint8_t* const cpu_face_data = cpu_ptr + face_data_offset;
+    for (uint32_t i = 0; i < face_data_size; i++) {
+        if (gpu_face_data[i] != cpu_face_data[i]) {
+            d_printf("GPU face data mismatch at byte %u\n", i);
+            return false;
+        }
+    }
 
-        // Write indices for the edges; note the indices of corners overlap
-        for (uint32_t i_edge = 0; i_edge < 4; i_edge++) {
-            const int32_t edge_sel     = face.edges[i_edge];
-            const bool    inverse_edge = edge_sel < 0;
-            const Edge&   edge         = obj_edges[inverse_edge ? (-edge_sel - 1) : edge_sel];
-
-            for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
-                const uint32_t src_idx = inverse_edge ? (3 - i_idx) : i_idx;
-                assert(edge.vertices[src_idx] < max_vertices);
-                const uint32_t dest_idx = num_indices + idx_map[i_edge * 4 + i_idx];
-                assert(dest_idx < num_indices + 16);
-                indices_ptr[dest_idx] = static_cast<uint16_t>(edge.vertices[src_idx]);
-            }
+    return true;
+}
+#endif
+
+bool Sculptor::Geometry::reserve_tables(uint32_t vertices, uint32_t edges, uint32_t faces)
+{
+    return reserve_table(&obj_vertices, &obj_vertices_cap, vertices) &&
+           reserve_table(&vertex_edges, &vertex_edges_cap, vertices) &&
+           reserve_table(&vertex_selection, &vertex_selection_cap, (vertices + 31) / 32) &&
+           reserve_table(&obj_edges,    &obj_edges_cap,    edges)    &&
+           reserve_table(&obj_faces,    &obj_faces_cap,    faces);
+}
+
+uint32_t Sculptor::Geometry::add_vertex(int16_t x, int16_t y, int16_t z)
+{
+    if ( ! reserve_table(&obj_vertices, &obj_vertices_cap, num_vertices + 1))
+        return ~0U;
+
+    if ( ! reserve_table(&vertex_edges, &vertex_edges_cap, num_vertices + 1))
+        return ~0U;
+
+    if ( ! reserve_table(&vertex_selection, &vertex_selection_cap, num_vertices / 32 + 1))
+        return ~0U;
+
+    const uint32_t vtx = num_vertices++;
+    vertex_edges[vtx] = no_link;
+
+    // Bits of removed vertices may still be set
+    vertex_selection[vtx / 32] &= ~(1U << (vtx % 32));
+    mark_dirty(str_vertex_state, vtx / 32);
+
+    const Vertex vertex = { { x, y, z }, 0 };
+    store_vertex(vtx, vertex);
+
+    if (journal.is_recording()) {
+        Vertex* const added = get_journal_element<Vertex>(rec_add_vertices, vtx, nullptr);
+        if (added)
+            *added = vertex;
+    }
+
+    return vtx;
+}
+
+void Sculptor::Geometry::set_vertex(uint32_t vtx, int16_t x, int16_t y, int16_t z)
+{
+    assert(vtx < num_vertices);
+
+    const Vertex vertex = { { x, y, z }, 0 };
+
+    if (journal.is_recording()) {
+        bool existing = false;
+        VertexDelta* const delta = get_journal_element<VertexDelta>(rec_set_vertices, vtx, &existing);
+        if (delta) {
+            if ( ! existing)
+                delta->old_vertex = obj_vertices[vtx];
+            delta->new_vertex = vertex;
         }
+    }
 
-        static const uint32_t ctrl_idx_map[] = {
-            5,  6,
-            9, 10
-        };
+    store_vertex(vtx, vertex);
+}
 
-        // Write 4 center indices which control the face, which are not included in edges
-        for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
-            assert(face.ctrl_vertices[i_idx] < max_vertices);
-            const uint32_t dest_idx = num_indices + ctrl_idx_map[i_idx];
-            assert(dest_idx < num_indices + 16);
-            indices_ptr[dest_idx] = static_cast<uint16_t>(face.ctrl_vertices[i_idx]);
+void Sculptor::Geometry::store_vertex(uint32_t vtx, const Vertex& vertex)
+{
+    obj_vertices[vtx] = vertex;
+
+    mark_dirty(str_vertices, vtx);
+
+    bvh.refit_vertex(*this, vtx);
+
+    vertex_grid.update_vertex(*this, vtx);
+}
+
+uint32_t Sculptor::Geometry::add_edge(uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+{
+    if ( ! reserve_table(&obj_edges, &obj_edges_cap, num_edges + 1))
+        return ~0U;
+
+    assert(vtx_0 < num_vertices);
+    assert(vtx_3 < num_vertices);
+
+    const uint32_t edge = num_edges++;
+
+    // Link the new edge at the head of the vertex lists, so store_edge() finds it immediately
+    obj_edges[edge].vertices[0]     = vtx_0;
+    obj_edges[edge].vertices[3]     = vtx_3;
+    obj_edges[edge].first_face_slot = no_link;
+    link_edge(edge);
+
+    const EdgeVertices edge_vertices = { { vtx_0, vtx_1, vtx_2, vtx_3 } };
+    store_edge(edge, edge_vertices.vertices);
+
+    if (journal.is_recording()) {
+        EdgeVertices* const added = get_journal_element<EdgeVertices>(rec_add_edges, edge, nullptr);
+        if (added)
+            *added = edge_vertices;
+    }
+
+    return edge;
+}
+
+void Sculptor::Geometry::set_edge(uint32_t edge, uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+{
+    assert(edge < num_edges);
+
+    const EdgeVertices edge_vertices = { { vtx_0, vtx_1, vtx_2, vtx_3 } };
+
+    if (journal.is_recording()) {
+        bool existing = false;
+        EdgeDelta* const delta = get_journal_element<EdgeDelta>(rec_set_edges, edge, &existing);
+        if (delta) {
+            if ( ! existing)
+                mstd::mem_copy(&delta->old_edge, obj_edges[edge].vertices, sizeof(EdgeVertices));
+            delta->new_edge = edge_vertices;
         }
+    }
+
+    store_edge(edge, edge_vertices.vertices);
+}
+
+void Sculptor::Geometry::store_edge(uint32_t edge, const uint32_t* vertices)
+{
+    assert(vertices[0] < num_vertices);
+    assert(vertices[1] < num_vertices);
+    assert(vertices[2] < num_vertices);
+    assert(vertices[3] < num_vertices);
+
+    const bool relink = obj_edges[edge].vertices[0] != vertices[0] ||
+                        obj_edges[edge].vertices[3] != vertices[3];
+    if (relink)
+        unlink_edge(edge);
+
+    obj_edges[edge].vertices[0] = vertices[0];
+    obj_edges[edge].vertices[1] = vertices[1];
+    obj_edges[edge].vertices[2] = vertices[2];
+    obj_edges[edge].vertices[3] = vertices[3];
+    obj_edges[edge].selected    = false;
 
-        num_indices += 16;
+    if (relink)
+        link_edge(edge);
+
+    mark_dirty(str_edge_indices, edge);
+
+    bvh.invalidate();
+
+    // Faces which refer to this edge need their patch indices rewritten
+    for (uint32_t link = obj_edges[edge].first_face_slot; link != no_link; ) {
+        mark_dirty(str_face_indices, link / 4);
+        link = obj_faces[link / 4].next_face_slot[link % 4];
     }
+}
 
-    // Write indices for each edge to the host copy of the index buffer;
-    // The edge indices are used for drawing patch edges and follow face indices
-    num_edge_indices = 0;
-    for (uint32_t i_edge = 0; i_edge < num_edges; i_edge++) {
-        assert(num_edge_indices + 4 <= max_edge_indices);
+uint32_t Sculptor::Geometry::add_face(int32_t edge_0, int32_t edge_1, int32_t edge_2, int32_t edge_3,
+                                      uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+{
+    if ( ! reserve_table(&obj_faces, &obj_faces_cap, num_faces + 1))
+        return ~0U;
 
-        const Edge& edge = obj_edges[i_edge];
+    const uint32_t face = num_faces++;
 
-        for (uint32_t i_idx = 0; i_idx < 4; i_idx++) {
-            assert(edge.vertices[i_idx] < max_vertices);
-            const uint32_t dest_idx = max_face_indices + num_edge_indices + i_idx;
-            indices_ptr[dest_idx] = static_cast<uint16_t>(edge.vertices[i_idx]);
+    // Link the new face at the head of the edge lists, so store_face() finds it immediately
+    obj_faces[face].edges[0] = edge_0;
+    obj_faces[face].edges[1] = edge_1;
+    obj_faces[face].edges[2] = edge_2;
+    obj_faces[face].edges[3] = edge_3;
+    obj_faces[face].selected = false;
+    link_face(face);
+
+    const FaceTopology topology = {
+        { edge_0, edge_1, edge_2, edge_3 },
+        { vtx_0, vtx_1, vtx_2, vtx_3 },
+        0 // material_id
+    };
+    store_face(face, topology);
+    validate_face(face);
+
+    if (journal.is_recording()) {
+        FaceTopology* const added = get_journal_element<FaceTopology>(rec_add_faces, face, nullptr);
+        if (added)
+            *added = topology;
+    }
+
+    return face;
+}
+
+void Sculptor::Geometry::set_face(uint32_t face_id, int32_t edge_0, int32_t edge_1, int32_t edge_2, int32_t edge_3,
+                                  uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+{
+    assert(face_id < num_faces);
+
+    // Only the topology changes, the face keeps its material
+    const FaceTopology topology = {
+        { edge_0, edge_1, edge_2, edge_3 },
+        { vtx_0, vtx_1, vtx_2, vtx_3 },
+        obj_faces[face_id].material_id
+    };
+
+    if (journal.is_recording()) {
+        bool existing = false;
+        FaceDelta* const delta = get_journal_element<FaceDelta>(rec_set_faces, face_id, &existing);
+        if (delta) {
+            if ( ! existing) {
+                mstd::mem_copy(delta->old_face.edges,         obj_faces[face_id].edges,         sizeof(delta->old_face.edges));
+                mstd::mem_copy(delta->old_face.ctrl_vertices, obj_faces[face_id].ctrl_vertices, sizeof(delta->old_face.ctrl_vertices));
+                delta->old_face.material_id = obj_faces[face_id].material_id;
+            }
+            delta->new_face = topology;
         }
+    }
+
+    store_face(face_id, topology);
+    validate_face(face_id);
+}
 
-        num_edge_indices += 4;
+// Selection is not part of the journal, so faces stay selected across undo and redo
+void Sculptor::Geometry::store_face(uint32_t face_id, const FaceTopology& face)
+{
+    const int32_t*  const edges         = face.edges;
+    const uint32_t* const ctrl_vertices = face.ctrl_vertices;
+
+    for (uint32_t i = 0; i < 4; i++) {
+        assert(edges[i] < static_cast<int32_t>(num_edges));
+        assert(edges[i] >= -static_cast<int32_t>(num_edges));
+        assert(ctrl_vertices[i] < num_vertices);
     }
 
-    if (num_indices + num_edge_indices) {
-        copy_region.srcOffset = cur_indices_offset;
-        copy_region.dstOffset = gpu_indices_offset;
-        copy_region.size      = (max_face_indices + num_edge_indices) * sizeof(uint16_t);
+    const bool relink = obj_faces[face_id].edges[0] != edges[0] ||
+                        obj_faces[face_id].edges[1] != edges[1] ||
+                        obj_faces[face_id].edges[2] != edges[2] ||
+                        obj_faces[face_id].edges[3] != edges[3];
+    if (relink)
+        unlink_face(face_id);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        obj_faces[face_id].edges[i]         = edges[i];
+        obj_faces[face_id].ctrl_vertices[i] = ctrl_vertices[i];
+    }
+
+    obj_faces[face_id].material_id = face.material_id;
+
+    mark_dirty(str_face_indices, face_id);
+    mark_dirty(str_face_data,    face_id);
+    mark_dirty(str_face_records, face_id);
+
+    if (relink)
+        link_face(face_id);
+
+    bvh.invalidate();
+}
+
+void Sculptor::Geometry::get_face_indices(uint32_t face_id, uint32_t* indices) const
+{
+    assert(face_id < num_faces);
+
+    write_face_indices(indices, face_id);
+}
+
+uint32_t Sculptor::Geometry::pick_face(const vmath::vec3& origin, const vmath::vec3& dir, float* hit_dist)
+{
+    if ( ! bvh.is_valid() && ! bvh.build(*this))
+        return ~0U;
+
+    PatchBVH::Hit hit;
+    if ( ! bvh.intersect(*this, origin, dir, &hit))
+        return ~0U;
+
+    if (hit_dist)
+        *hit_dist = hit.t;
+
+    return hit.face_id;
+}
+
+uint32_t Sculptor::Geometry::find_nearest_vertices(const vmath::vec3& pos,
+                                                   float              max_dist,
+                                                   uint32_t*          vertices,
+                                                   uint32_t           max_count)
+{
+    if ( ! vertex_grid.is_valid() && ! vertex_grid.build(*this))
+        return 0;
+
+    return vertex_grid.find_nearest(*this, pos, max_dist, vertices, max_count);
+}
+
+uint32_t Sculptor::Geometry::find_vertices_in_radius(const vmath::vec3& pos,
+                                                     float              radius,
+                                                     uint32_t*          vertices,
+                                                     uint32_t           max_count)
+{
+    if ( ! vertex_grid.is_valid() && ! vertex_grid.build(*this))
+        return 0;
+
+    return vertex_grid.find_in_radius(*this, pos, radius, vertices, max_count);
+}
+
+static uint32_t get_edge_id(int32_t edge_sel)
+{
+    return static_cast<uint32_t>((edge_sel < 0) ? (-edge_sel - 1) : edge_sel);
+}
+
+void Sculptor::Geometry::link_edge(uint32_t edge)
+{
+    Edge& e = obj_edges[edge];
+
+    for (uint32_t corner = 0; corner < 2; corner++) {
+        const uint32_t vtx = e.vertices[corner * 3];
+        assert(vtx < num_vertices);
 
-        vkCmdCopyBuffer(cmd_buf, host_buffer.get_buffer(), gpu_buffer.get_buffer(), 1, &copy_region);
+        e.next_at_vertex[corner] = vertex_edges[vtx];
+        vertex_edges[vtx]        = edge * 2 + corner;
     }
+}
 
-    if (num_faces) {
-        copy_region.srcOffset = cur_faces_offset;
-        copy_region.dstOffset = gpu_faces_offset;
-        copy_region.size      = sizeof(FacesBuf) + (num_faces - 1) * sizeof(FaceData);
+void Sculptor::Geometry::unlink_edge(uint32_t edge)
+{
+    for (uint32_t corner = 0; corner < 2; corner++) {
+        const uint32_t vtx  = obj_edges[edge].vertices[corner * 3];
+        const uint32_t link = edge * 2 + corner;
+
+        uint32_t* prev = &vertex_edges[vtx];
+        while (*prev != link) {
+            assert(*prev != no_link);
+            prev = &obj_edges[*prev / 2].next_at_vertex[*prev % 2];
+        }
 
-        vkCmdCopyBuffer(cmd_buf, host_buffer.get_buffer(), gpu_buffer.get_buffer(), 1, &copy_region);
+        *prev = obj_edges[edge].next_at_vertex[corner];
     }
+}
 
-    buffer_barrier(cmd_buf,
-                   gpu_buffer.get_buffer(),
-                   VK_PIPELINE_STAGE_TRANSFER_BIT,
-                   VK_ACCESS_TRANSFER_WRITE_BIT,
-                   VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
-                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
-                     VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
-                     VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                   VK_ACCESS_MEMORY_READ_BIT);
-
-    buffer_barrier(cmd_buf,
-                   host_buffer.get_buffer(),
-                   VK_PIPELINE_STAGE_TRANSFER_BIT,
-                   VK_ACCESS_TRANSFER_READ_BIT,
-                   VK_PIPELINE_STAGE_HOST_BIT,
-                   VK_ACCESS_HOST_WRITE_BIT);
+void Sculptor::Geometry::link_face(uint32_t face_id)
+{
+    Face& face = obj_faces[face_id];
 
-    dirty = false;
+    for (uint32_t slot = 0; slot < 4; slot++) {
+        assert(get_edge_id(face.edges[slot]) < num_edges);
+        Edge& edge = obj_edges[get_edge_id(face.edges[slot])];
 
-    return true;
+        face.next_face_slot[slot] = edge.first_face_slot;
+        edge.first_face_slot      = face_id * 4 + slot;
+    }
 }
 
-uint32_t Sculptor::Geometry::add_vertex(int16_t x, int16_t y, int16_t z)
+void Sculptor::Geometry::unlink_face(uint32_t face_id)
 {
-    assert(num_vertices < max_vertices);
-    const uint32_t vtx = num_vertices++;
-    set_vertex(vtx, x, y, z);
-    return vtx;
+    for (uint32_t slot = 0; slot < 4; slot++) {
+        const uint32_t edge = get_edge_id(obj_faces[face_id].edges[slot]);
+        const uint32_t link = face_id * 4 + slot;
+
+        uint32_t* prev = &obj_edges[edge].first_face_slot;
+        while (*prev != link) {
+            assert(*prev != no_link);
+            prev = &obj_faces[*prev / 4].next_face_slot[*prev % 4];
+        }
+
+        *prev = obj_faces[face_id].next_face_slot[slot];
+    }
 }
 
-void Sculptor::Geometry::set_vertex(uint32_t vtx, int16_t x, int16_t y, int16_t z)
+uint32_t Sculptor::Geometry::get_vertex_edges(uint32_t vtx, uint32_t* edges, uint32_t max_count) const
 {
     assert(vtx < num_vertices);
 
-    Vertex& vertex = host_buffer.get_ptr<Vertex>(host_vertices_offset)[vtx];
-    vertex.pos[0] = x;
-    vertex.pos[1] = y;
-    vertex.pos[2] = z;
-}
+    uint32_t count = 0;
 
-uint32_t Sculptor::Geometry::add_edge(uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
-{
-    assert(num_edges < max_edges);
-    const uint32_t edge = num_edges++;
-    set_edge(edge, vtx_0, vtx_1, vtx_2, vtx_3);
-    return edge;
+    for (uint32_t link = vertex_edges[vtx]; link != no_link; ) {
+        if (count < max_count)
+            edges[count] = link / 2;
+        ++count;
+        link = obj_edges[link / 2].next_at_vertex[link % 2];
+    }
+
+    return count;
 }
 
-void Sculptor::Geometry::set_edge(uint32_t edge, uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+uint32_t Sculptor::Geometry::get_edge_faces(uint32_t edge, uint32_t* faces, uint32_t max_count) const
 {
     assert(edge < num_edges);
 
-    assert(vtx_0 < num_vertices);
-    assert(vtx_1 < num_vertices);
-    assert(vtx_2 < num_vertices);
-    assert(vtx_3 < num_vertices);
+    uint32_t count = 0;
 
-    obj_edges[edge].vertices[0] = vtx_0;
-    obj_edges[edge].vertices[1] = vtx_1;
-    obj_edges[edge].vertices[2] = vtx_2;
-    obj_edges[edge].vertices[3] = vtx_3;
-    obj_edges[edge].selected    = false;
+    for (uint32_t link = obj_edges[edge].first_face_slot; link != no_link; ) {
+        if (count < max_count)
+            faces[count] = link / 4;
+        ++count;
+        link = obj_faces[link / 4].next_face_slot[link % 4];
+    }
+
+    return count;
 }
 
-uint32_t Sculptor::Geometry::add_face(int32_t edge_0, int32_t edge_1, int32_t edge_2, int32_t edge_3,
-                                      uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+uint32_t Sculptor::Geometry::get_adjacent_face(uint32_t face_id, uint32_t i_edge) const
 {
-    assert(num_faces < max_faces);
-    const uint32_t face = num_faces++;
-    set_face(face, edge_0, edge_1, edge_2, edge_3, vtx_0, vtx_1, vtx_2, vtx_3);
-    return face;
+    assert(face_id < num_faces);
+    assert(i_edge < 4);
+
+    const uint32_t edge = get_edge_id(obj_faces[face_id].edges[i_edge]);
+
+    for (uint32_t link = obj_edges[edge].first_face_slot; link != no_link; ) {
+        if (link / 4 != face_id)
+            return link / 4;
+        link = obj_faces[link / 4].next_face_slot[link % 4];
+    }
+
+    return ~0U;
 }
 
-void Sculptor::Geometry::set_face(uint32_t face_id, int32_t edge_0, int32_t edge_1, int32_t edge_2, int32_t edge_3,
-                                  uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3)
+bool Sculptor::Geometry::extrude_selected_faces()
 {
-    assert(face_id < num_faces);
+    const uint32_t old_num_vertices = num_vertices;
+    const uint32_t old_num_edges    = num_edges;
+    const uint32_t old_num_faces    = num_faces;
+
+    // Copies of boundary vertices, edges from boundary corners to their copies and copies of boundary edges
+    const uint32_t  table_size  = 2 * old_num_vertices + old_num_edges;
+    uint32_t* const vertex_copy = static_cast<uint32_t*>(malloc(mstd::max(table_size, 1U) * sizeof(uint32_t)));
+    if ( ! vertex_copy) {
+        d_printf("Failed to allocate extrude tables for %u vertices\n", old_num_vertices);
+        return false;
+    }
+    uint32_t* const corner_edge = vertex_copy + old_num_vertices;
+    uint32_t* const edge_copy   = corner_edge + old_num_vertices;
 
-    assert(edge_0 < static_cast<int32_t>(num_edges));
-    assert(edge_1 < static_cast<int32_t>(num_edges));
-    assert(edge_2 < static_cast<int32_t>(num_edges));
-    assert(edge_3 < static_cast<int32_t>(num_edges));
-    assert(edge_0 >= -static_cast<int32_t>(num_edges));
-    assert(edge_1 >= -static_cast<int32_t>(num_edges));
-    assert(edge_2 >= -static_cast<int32_t>(num_edges));
-    assert(edge_3 >= -static_cast<int32_t>(num_edges));
+    for (uint32_t i = 0; i < table_size; i++)
+        vertex_copy[i] = ~0U;
 
-    assert(vtx_0 < num_vertices);
-    assert(vtx_1 < num_vertices);
-    assert(vtx_2 < num_vertices);
-    assert(vtx_3 < num_vertices);
+    const auto copy_vertex = [this](uint32_t vtx) -> uint32_t {
+        const Vertex vertex = obj_vertices[vtx];
+        return add_vertex(vertex.pos[0], vertex.pos[1], vertex.pos[2]);
+    };
 
-    obj_faces[face_id].edges[0] = edge_0;
-    obj_faces[face_id].edges[1] = edge_1;
-    obj_faces[face_id].edges[2] = edge_2;
-    obj_faces[face_id].edges[3] = edge_3;
-    obj_faces[face_id].ctrl_vertices[0] = vtx_0;
-    obj_faces[face_id].ctrl_vertices[1] = vtx_1;
-    obj_faces[face_id].ctrl_vertices[2] = vtx_2;
-    obj_faces[face_id].ctrl_vertices[3] = vtx_3;
+    bool ok = true;
 
-    obj_faces[face_id].material_id = 0;
-    obj_faces[face_id].selected    = false;
+    // Boundary edges are used by only one selected face, they are copied together with their vertices
+    for (uint32_t face_id = 0; ok && face_id < old_num_faces; face_id++) {
+        if ( ! obj_faces[face_id].selected)
+            continue;
 
-    validate_face(face_id);
+        for (uint32_t slot = 0; ok && slot < 4; slot++) {
+            const uint32_t edge = get_edge_id(obj_faces[face_id].edges[slot]);
+            if (edge_copy[edge] != ~0U)
+                continue;
+
+            uint32_t num_selected = 0;
+            for (uint32_t link = obj_edges[edge].first_face_slot; link != no_link; ) {
+                num_selected += obj_faces[link / 4].selected ? 1U : 0U;
+                link = obj_faces[link / 4].next_face_slot[link % 4];
+            }
+            if (num_selected != 1)
+                continue;
+
+            uint32_t vertices[4];
+            for (uint32_t i = 0; ok && i < 4; i++) {
+                const uint32_t vtx = obj_edges[edge].vertices[i];
+                if (vertex_copy[vtx] == ~0U)
+                    vertex_copy[vtx] = copy_vertex(vtx);
+                vertices[i] = vertex_copy[vtx];
+                ok = vertices[i] != ~0U;
+            }
+
+            if (ok) {
+                edge_copy[edge] = add_edge(vertices[0], vertices[1], vertices[2], vertices[3]);
+                ok = edge_copy[edge] != ~0U;
+            }
+        }
+    }
+
+    for (uint32_t face_id = 0; ok && face_id < old_num_faces; face_id++) {
+        if ( ! obj_faces[face_id].selected)
+            continue;
+
+        int32_t new_edges[4];
+
+        for (uint32_t slot = 0; ok && slot < 4; slot++) {
+            const int32_t  edge_sel = obj_faces[face_id].edges[slot];
+            const uint32_t edge     = get_edge_id(edge_sel);
+            const uint32_t copy     = edge_copy[edge];
+
+            // Edges inside the selection move with it, only their corners on the boundary are replaced
+            if (copy == ~0U) {
+                const uint32_t* const vertices = obj_edges[edge].vertices;
+                const uint32_t        vtx_0    = vertices[0];
+                const uint32_t        vtx_3    = vertices[3];
+                const bool            copy_0   = vtx_0 < old_num_vertices && vertex_copy[vtx_0] != ~0U;
+                const bool            copy_3   = vtx_3 < old_num_vertices && vertex_copy[vtx_3] != ~0U;
+                if (copy_0 || copy_3)
+                    set_edge(edge,
+                             copy_0 ? vertex_copy[vtx_0] : vtx_0,
+                             vertices[1],
+                             vertices[2],
+                             copy_3 ? vertex_copy[vtx_3] : vtx_3);
+                new_edges[slot] = edge_sel;
+                continue;
+            }
+
+            const bool inverse = edge_sel < 0;
+            new_edges[slot] = inverse ? (-static_cast<int32_t>(copy) - 1) : static_cast<int32_t>(copy);
+
+            // Corners a and b in the order in which the face goes around, along edges 0 and 2
+            // and against edges 1 and 3.  The new face goes around a, b, copy of b and copy of a,
+            // so it meets the face and its former neighbor with consistent orientation.
+            const bool     reverse  = inverse != ((slot == 1) || (slot == 3));
+            const uint32_t corner[] = {
+                obj_edges[edge].vertices[reverse ? 3 : 0],
+                obj_edges[edge].vertices[reverse ? 0 : 3]
+            };
+
+            for (uint32_t i = 0; ok && i < 2; i++) {
+                const uint32_t vtx = corner[i];
+                if (corner_edge[vtx] != ~0U)
+                    continue;
+
+                const uint32_t ctrl_0 = copy_vertex(vtx);
+                const uint32_t ctrl_1 = (ctrl_0 != ~0U) ? copy_vertex(vtx) : ~0U;
+                if (ctrl_1 == ~0U)
+                    ok = false;
+                else {
+                    corner_edge[vtx] = add_edge(vtx, ctrl_0, ctrl_1, vertex_copy[vtx]);
+                    ok = corner_edge[vtx] != ~0U;
+                }
+            }
+
+            // Edge 0 of the new face goes from corner a to corner b, edge 3 is its copy
+            const bool     forward = obj_edges[edge].vertices[0] == corner[0];
+            const int32_t  base    = forward ? static_cast<int32_t>(edge) : (-static_cast<int32_t>(edge) - 1);
+            const int32_t  top     = forward ? static_cast<int32_t>(copy) : (-static_cast<int32_t>(copy) - 1);
+            const uint32_t ctrl_a  = obj_edges[edge].vertices[forward ? 1 : 2];
+            const uint32_t ctrl_b  = obj_edges[edge].vertices[forward ? 2 : 1];
+
+            uint32_t ctrl[4] = { ~0U, ~0U, ~0U, ~0U };
+            for (uint32_t i = 0; ok && i < 4; i++) {
+                ctrl[i] = copy_vertex((i & 1U) ? ctrl_b : ctrl_a);
+                ok      = ctrl[i] != ~0U;
+            }
+
+            if (ok)
+                ok = add_face(base,
+                              static_cast<int32_t>(corner_edge[corner[0]]),
+                              static_cast<int32_t>(corner_edge[corner[1]]),
+                              top,
+                              ctrl[0], ctrl[1], ctrl[2], ctrl[3]) != ~0U;
+        }
+
+        if (ok) {
+            const uint32_t* const ctrl_vertices = obj_faces[face_id].ctrl_vertices;
+            set_face(face_id, new_edges[0], new_edges[1], new_edges[2], new_edges[3],
+                     ctrl_vertices[0], ctrl_vertices[1], ctrl_vertices[2], ctrl_vertices[3]);
+        }
+    }
+
+    free(vertex_copy);
+
+    return ok;
 }
 
 void Sculptor::Geometry::validate_face(uint32_t face_id)
@@ -402,12 +2099,263 @@ void Sculptor::Geometry::validate_face(uint32_t face_id)
 #endif
 }
 
+// A face and its edges can change in the same step, e.g. in extrude, so faces replayed
+// from the journal are only consistent once the whole step has been replayed
+void Sculptor::Geometry::validate_faces()
+{
+#ifndef NDEBUG
+    for (uint32_t face_id = 0; face_id < num_faces; face_id++)
+        validate_face(face_id);
+#endif
+}
+
+template<typename T>
+T* Sculptor::Geometry::get_journal_element(JournalRecordType type, uint32_t idx, bool* existing)
+{
+    // Elements changed again in the same step only get their new values updated
+    if (existing) {
+        EditJournal::Record* const record = journal.find_record(type, idx);
+        if (record) {
+            *existing = true;
+            return record->get_payload<T>() + (idx - record->first);
+        }
+    }
+
+    // Consecutive elements share one record
+    void* const elem = journal.extend_record(type, idx, sizeof(T));
+    if (elem)
+        return static_cast<T*>(elem);
+
+    EditJournal::Record* const record = journal.add_record(type, idx, 1, sizeof(T));
+    return record ? record->get_payload<T>() : nullptr;
+}
+
+void Sculptor::Geometry::begin_edit(uint32_t coalesce_key)
+{
+    // Without the journal, edits are made but not recorded
+    if ( ! journal.is_allocated() && ! journal.allocate(journal_size))
+        return;
+
+    journal.begin_step(coalesce_key);
+}
+
+bool Sculptor::Geometry::undo()
+{
+    if ( ! journal.can_undo())
+        return false;
+
+    for (const EditJournal::Record* record = journal.begin_undo(); record; record = journal.next_undo(record))
+        revert_record(*record);
+
+    validate_faces();
+
+    return true;
+}
+
+bool Sculptor::Geometry::redo()
+{
+    if ( ! journal.can_redo())
+        return false;
+
+    for (const EditJournal::Record* record = journal.begin_redo(); record; record = journal.next_redo(record))
+        apply_record(*record);
+
+    validate_faces();
+
+    return true;
+}
+
+void Sculptor::Geometry::revert_record(const EditJournal::Record& record)
+{
+    switch (record.type) {
+
+        case rec_set_vertices: {
+            const VertexDelta* const deltas = record.get_payload<VertexDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_vertex(record.first + i, deltas[i].old_vertex);
+            break;
+        }
+
+        // Elements added in a step are the last ones, because later steps were undone first
+        case rec_add_vertices:
+            for (uint32_t i = record.count; i > 0; i--) {
+                assert(num_vertices == record.first + i);
+                remove_last_vertex();
+            }
+            break;
+
+        case rec_set_edges: {
+            const EdgeDelta* const deltas = record.get_payload<EdgeDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_edge(record.first + i, deltas[i].old_edge.vertices);
+            break;
+        }
+
+        case rec_add_edges:
+            for (uint32_t i = record.count; i > 0; i--) {
+                assert(num_edges == record.first + i);
+                remove_last_edge();
+            }
+            break;
+
+        case rec_set_faces: {
+            const FaceDelta* const deltas = record.get_payload<FaceDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_face(record.first + i, deltas[i].old_face);
+            break;
+        }
+
+        case rec_add_faces:
+            for (uint32_t i = record.count; i > 0; i--) {
+                assert(num_faces == record.first + i);
+                remove_last_face();
+            }
+            break;
+
+        case rec_set_vertex_list:
+            store_vertex_list(record.get_payload<VertexListDelta>(), record.count, false);
+            break;
+
+        default:
+            assert(0);
+    }
+}
+
+void Sculptor::Geometry::apply_record(const EditJournal::Record& record)
+{
+    switch (record.type) {
+
+        case rec_set_vertices: {
+            const VertexDelta* const deltas = record.get_payload<VertexDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_vertex(record.first + i, deltas[i].new_vertex);
+            break;
+        }
+
+        // Host tables never shrink, so adding elements again cannot fail
+        case rec_add_vertices: {
+            const Vertex* const vertices = record.get_payload<Vertex>();
+            for (uint32_t i = 0; i < record.count; i++) {
+                assert(num_vertices == record.first + i);
+                add_vertex(vertices[i].pos[0], vertices[i].pos[1], vertices[i].pos[2]);
+            }
+            break;
+        }
+
+        case rec_set_edges: {
+            const EdgeDelta* const deltas = record.get_payload<EdgeDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_edge(record.first + i, deltas[i].new_edge.vertices);
+            break;
+        }
+
+        case rec_add_edges: {
+            const EdgeVertices* const edges = record.get_payload<EdgeVertices>();
+            for (uint32_t i = 0; i < record.count; i++) {
+                const uint32_t* const v = edges[i].vertices;
+                assert(num_edges == record.first + i);
+                add_edge(v[0], v[1], v[2], v[3]);
+            }
+            break;
+        }
+
+        case rec_set_faces: {
+            const FaceDelta* const deltas = record.get_payload<FaceDelta>();
+            for (uint32_t i = 0; i < record.count; i++)
+                store_face(record.first + i, deltas[i].new_face);
+            break;
+        }
+
+        case rec_add_faces: {
+            const FaceTopology* const faces = record.get_payload<FaceTopology>();
+            for (uint32_t i = 0; i < record.count; i++) {
+                const int32_t*  const e = faces[i].edges;
+                const uint32_t* const v = faces[i].ctrl_vertices;
+                assert(num_faces == record.first + i);
+                add_face(e[0], e[1], e[2], e[3], v[0], v[1], v[2], v[3]);
+            }
+            break;
+        }
+
+        case rec_set_vertex_list:
+            store_vertex_list(record.get_payload<VertexListDelta>(), record.count, true);
+            break;
+
+        default:
+            assert(0);
+    }
+}
+
+// Removed elements are marked as dirty, so that the new counts are uploaded
+void Sculptor::Geometry::remove_last_vertex()
+{
+    assert(num_vertices);
+
+    const uint32_t vtx = --num_vertices;
+
+    // Edges which use the vertex are removed first
+    assert(vertex_edges[vtx] == no_link);
+
+    if (hovered_vertex_id == vtx)
+        set_hovered_vertex(~0U);
+
+    mark_dirty(str_vertices, vtx);
+
+    bvh.invalidate();
+
+    vertex_grid.remove_vertex(vtx);
+}
+
+void Sculptor::Geometry::remove_last_edge()
+{
+    assert(num_edges);
+
+    const uint32_t edge = num_edges - 1;
+
+    // Faces which use the edge are removed first
+    assert(obj_edges[edge].first_face_slot == no_link);
+
+    unlink_edge(edge);
+    --num_edges;
+
+    mark_dirty(str_edge_indices, edge);
+
+    bvh.invalidate();
+}
+
+void Sculptor::Geometry::remove_last_face()
+{
+    assert(num_faces);
+
+    const uint32_t face_id = num_faces - 1;
+
+    unlink_face(face_id);
+    --num_faces;
+
+    if (hovered_face_id == face_id)
+        hovered_face_id = ~0U;
+
+    mark_dirty(str_face_indices, face_id);
+    mark_dirty(str_face_data,    face_id);
+    mark_dirty(str_face_records, face_id);
+
+    bvh.invalidate();
+}
+
 void Sculptor::Geometry::set_cube()
 {
     num_vertices = 0;
     num_edges    = 0;
     num_faces    = 0;
 
+    hovered_vertex_id = ~0U;
+
+    // The new geometry is not undoable
+    journal.clear();
+
+    bvh.invalidate();
+    vertex_grid.invalidate();
+
     static const int16_t cube_vertices[] = {
         -3,  3, -3,
         -1,  3, -3,
@@ -536,60 +2484,370 @@ void Sculptor::Geometry::set_cube()
 void Sculptor::Geometry::write_faces_descriptor(VkDescriptorBufferInfo* desc)
 {
     desc->buffer = gpu_buffer.get_buffer();
-    desc->offset = gpu_faces_offset;
-    desc->range  = faces_stride;
+    desc->offset = faces_offset;
+    desc->range  = copy_size - faces_offset;
 }
 
 void Sculptor::Geometry::write_edge_indices_descriptor(VkDescriptorBufferInfo* desc)
 {
     desc->buffer = gpu_buffer.get_buffer();
-    desc->offset = gpu_indices_offset + max_face_indices * sizeof(uint16_t);
-    desc->range  = max_edge_indices * sizeof(uint16_t);
+    desc->offset = edge_indices_offset;
+    desc->range  = faces_offset - edge_indices_offset;
 }
 
 void Sculptor::Geometry::write_edge_vertices_descriptor(VkDescriptorBufferInfo* desc)
 {
     desc->buffer = gpu_buffer.get_buffer();
-    desc->offset = gpu_vertices_offset;
-    desc->range  = vertices_stride;
+    desc->offset = 0;
+    desc->range  = indices_offset;
+}
+
+void Sculptor::Geometry::write_patch_indices_descriptor(VkDescriptorBufferInfo* desc)
+{
+    desc->buffer = gpu_buffer.get_buffer();
+    desc->offset = indices_offset;
+    desc->range  = edge_indices_offset - indices_offset;
+}
+
+bool Sculptor::DirtyRanges::contains(uint32_t idx) const
+{
+    for (uint32_t i = 0; i < num_ranges; i++) {
+        if (idx >= begin[i] && idx < end[i])
+            return true;
+    }
+    return false;
+}
+
+// Evaluates patches which have new indices or whose control points have moved
+void Sculptor::Geometry::evaluate_patches(VkCommandBuffer    cmd_buf,
+                                          const DirtyRanges& face_ranges,
+                                          const DirtyRanges& vertex_ranges)
+{
+    DirtyRanges tess_ranges = face_ranges;
+
+    if (vertex_ranges.num_ranges) {
+        for (uint32_t i_face = 0; i_face < num_faces; i_face++) {
+            uint32_t indices[16];
+            get_face_indices(i_face, indices);
+
+            for (uint32_t i = 0; i < 16; i++) {
+                if (vertex_ranges.contains(indices[i])) {
+                    tess_ranges.add(i_face, 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    if ( ! tess_ranges.num_ranges)
+        return;
+
+    // Wait for patch indices generated by the previous dispatches
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, tess_pipeline);
+
+    vkCmdBindDescriptorSets(cmd_buf,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            tess_layout,
+                            0,          // firstSet
+                            1,          // descriptorSetCount
+                            &tess_desc_set,
+                            0,          // dynamicOffsetCount
+                            nullptr);   // pDynamicOffsets
+
+    for (uint32_t i = 0; i < tess_ranges.num_ranges; i++) {
+        const uint32_t first = tess_ranges.begin[i];
+        const uint32_t last  = mstd::min(tess_ranges.end[i], num_faces);
+        if (first >= last)
+            continue;
+
+        const TessPushConstants push = {
+            first,
+            last - first,
+            (index_size == sizeof(uint32_t)) ? 1U : 0U,
+            compute_tess_level
+        };
+
+        vkCmdPushConstants(cmd_buf,
+                           tess_layout,
+                           VK_SHADER_STAGE_COMPUTE_BIT,
+                           0,               // offset
+                           sizeof(push),
+                           &push);
+
+        const uint32_t num_invocations = push.num_faces * tess_verts_per_patch;
+
+        vkCmdDispatch(cmd_buf,
+                      (num_invocations + tess_group_size - 1) / tess_group_size,
+                      1,
+                      1);
+    }
+}
+
+void Sculptor::Geometry::write_visible_faces_descriptor(VkDescriptorBufferInfo* desc)
+{
+    desc->buffer = gpu_buffer.get_buffer();
+
+    // Without culling the descriptor is not read by shaders, but it still has to be valid
+    if (uses_gpu_culling()) {
+        desc->offset = cull_offset + cull_faces_offset;
+        desc->range  = cull_indices_offset - cull_faces_offset;
+    }
+    else {
+        desc->offset = faces_offset;
+        desc->range  = face_records_offset - faces_offset;
+    }
+}
+
+void Sculptor::Geometry::write_vertex_state_descriptor(VkDescriptorBufferInfo* desc)
+{
+    desc->buffer = gpu_buffer.get_buffer();
+    desc->offset = vertex_state_offset;
+    desc->range  = copy_size - vertex_state_offset;
+}
+
+void Sculptor::Geometry::write_visible_vertices_descriptor(VkDescriptorBufferInfo* desc)
+{
+    desc->buffer = gpu_buffer.get_buffer();
+
+    // Without culling the descriptor is not read by shaders, but it still has to be valid
+    if (uses_gpu_culling()) {
+        desc->offset = cull_offset + cull_vertices_offset;
+        desc->range  = cull_slot_size - cull_vertices_offset;
+    }
+    else {
+        desc->offset = vertex_state_offset;
+        desc->range  = copy_size - vertex_state_offset;
+    }
+}
+
+uint32_t Sculptor::Geometry::get_visible_faces_dynamic_offset(uint32_t slot) const
+{
+    assert(slot < num_cull_slots);
+    return uses_gpu_culling() ? (slot * cull_slot_size) : 0U;
+}
+
+uint32_t Sculptor::Geometry::get_visible_vertices_dynamic_offset(uint32_t slot) const
+{
+    assert(slot < num_cull_slots);
+    return uses_gpu_culling() ? (slot * cull_slot_size) : 0U;
 }
 
-void Sculptor::Geometry::render(VkCommandBuffer cmd_buf)
+void Sculptor::Geometry::cull(VkCommandBuffer cmd_buf,
+                              uint32_t        slot,
+                              const CullView* views,
+                              uint32_t        num_views)
 {
-    const VkDeviceSize vb_offset = gpu_vertices_offset;
+    if ( ! uses_gpu_culling())
+        return;
+
+    assert(slot < num_cull_slots);
+    assert(num_views > 0 && num_views <= max_cull_views);
+
+    const VkDeviceSize slot_offset = cull_offset + slot * cull_slot_size;
+
+    // Reset the draw command, the compute shader counts indices of visible patches
+    vkCmdFillBuffer(cmd_buf,
+                    gpu_buffer.get_buffer(),
+                    slot_offset,
+                    sizeof(VkDrawIndexedIndirectCommand),
+                    0);
+
+    // Reset the draw command for vertex handles and vertex marks, which directly follow it
+    const uint32_t num_vertex_words = (num_vertices + 31) / 32;
+    vkCmdFillBuffer(cmd_buf,
+                    gpu_buffer.get_buffer(),
+                    slot_offset + cull_vertex_draw_offset,
+                    (cull_vertex_marks_offset - cull_vertex_draw_offset) + 2 * num_vertex_words * sizeof(uint32_t),
+                    0);
+
+    // Views are small, so they are recorded in the command buffer instead of a host buffer
+    CullViewData view_data[max_cull_views];
+
+    for (uint32_t i = 0; i < num_views; i++) {
+        view_data[i].model_view = views[i].model_view;
+        view_data[i].proj       = views[i].proj;
+        view_data[i].proj_w     = views[i].perspective ? vmath::vec4(0.0f, 0.0f, 1.0f, 0.0f)
+                                                       : vmath::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    vkCmdUpdateBuffer(cmd_buf,
+                      gpu_buffer.get_buffer(),
+                      slot_offset + cull_views_offset,
+                      num_views * sizeof(CullViewData),
+                      view_data);
+
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_TRANSFER_BIT,
+                   VK_ACCESS_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, cull_pipeline);
+
+    vkCmdBindDescriptorSets(cmd_buf,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            cull_layout,
+                            0,          // firstSet
+                            1,          // descriptorSetCount
+                            &cull_desc_sets[slot],
+                            0,          // dynamicOffsetCount
+                            nullptr);   // pDynamicOffsets
+
+    CullPushConstants push;
+    push.num_faces     = num_faces;
+    push.wide_indices  = (index_size == sizeof(uint32_t)) ? 1U : 0U;
+    push.backface_cull = 1;
+    push.num_views     = num_views;
+    push.num_vertices  = num_vertices;
+
+    vkCmdPushConstants(cmd_buf,
+                       cull_layout,
+                       VK_SHADER_STAGE_COMPUTE_BIT,
+                       0,               // offset
+                       sizeof(push),
+                       &push);
+
+    // Dispatch at least one group, which sets instance count in the draw command
+    vkCmdDispatch(cmd_buf,
+                  mstd::max((num_faces + cull_group_size - 1) / cull_group_size, 1U),
+                  1,
+                  1);
+
+    // Vertex handles are culled after all patches have marked their vertices
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd_buf, VK_PIPELINE_BIND_POINT_COMPUTE, vertex_cull_pipeline);
+
+    // Dispatch at least one group, which sets vertex count in the draw command
+    vkCmdDispatch(cmd_buf,
+                  mstd::max((num_vertices + cull_group_size - 1) / cull_group_size, 1U),
+                  1,
+                  1);
+
+    buffer_barrier(cmd_buf,
+                   gpu_buffer.get_buffer(),
+                   VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                   VK_ACCESS_SHADER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                     VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                     VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT,
+                   VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                     VK_ACCESS_INDEX_READ_BIT |
+                     VK_ACCESS_SHADER_READ_BIT);
+}
+
+void Sculptor::Geometry::render(VkCommandBuffer cmd_buf, uint32_t slot)
+{
+    // The task shader reads patch indices and control points directly from the storage buffers
+    if (mesh_shading) {
+        vkCmdPushConstants(cmd_buf,
+                           material_layout,
+                           VK_SHADER_STAGE_TASK_BIT_EXT,
+                           0,                   // offset
+                           sizeof(num_faces),
+                           &num_faces);
+
+        VK_FUNCTION(vkCmdDrawMeshTasksEXT)(cmd_buf,
+                                           (num_faces + mesh_patches_per_task - 1) / mesh_patches_per_task,
+                                           1,  // groupCountY
+                                           1); // groupCountZ
+        return;
+    }
+
+    // Patches evaluated in a compute shader are drawn as triangles
+    if (tess_desc_set) {
+        const VkDeviceSize tess_vb_offset = tess_vertices_offset;
+        vkCmdBindVertexBuffers(cmd_buf,
+                               0, // firstBinding
+                               1, // bindingCount
+                               &gpu_buffer.get_buffer(),
+                               &tess_vb_offset);
+
+        vkCmdBindIndexBuffer(cmd_buf, gpu_buffer.get_buffer(), tess_indices_offset, VK_INDEX_TYPE_UINT32);
+
+        vkCmdDrawIndexed(cmd_buf,
+                         num_faces * tess_idx_per_patch,
+                         1,  // instanceCount
+                         0,  // firstVertex
+                         0,  // vertexOffset
+                         0); // firstInstance
+        return;
+    }
+
+    static const VkDeviceSize vb_offset = 0;
     vkCmdBindVertexBuffers(cmd_buf,
                            0, // firstBinding
                            1, // bindingCount
                            &gpu_buffer.get_buffer(),
                            &vb_offset);
 
-    vkCmdBindIndexBuffer(cmd_buf,
-                         gpu_buffer.get_buffer(),
-                         gpu_indices_offset, // offset
-                         VK_INDEX_TYPE_UINT16);
+    const VkIndexType index_type = (index_size == sizeof(uint32_t)) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+
+    if ( ! uses_gpu_culling()) {
+        vkCmdBindIndexBuffer(cmd_buf, gpu_buffer.get_buffer(), indices_offset, index_type);
+
+        vkCmdDrawIndexed(cmd_buf,
+                         num_indices,
+                         1,  // instanceCount
+                         0,  // firstVertex
+                         0,  // vertexOffset
+                         0); // firstInstance
+        return;
+    }
+
+    assert(slot < num_cull_slots);
+
+    const VkDeviceSize slot_offset = cull_offset + slot * cull_slot_size;
+
+    vkCmdBindIndexBuffer(cmd_buf, gpu_buffer.get_buffer(), slot_offset + cull_indices_offset, index_type);
 
-    vkCmdDrawIndexed(cmd_buf,
-                     num_indices,
-                     1,  // instanceCount
-                     0,  // firstVertex
-                     0,  // vertexOffset
-                     0); // firstInstance
+    vkCmdDrawIndexedIndirect(cmd_buf,
+                             gpu_buffer.get_buffer(),
+                             slot_offset,
+                             1,  // drawCount
+                             sizeof(VkDrawIndexedIndirectCommand));
 }
 
 void Sculptor::Geometry::render_edges(VkCommandBuffer cmd_buf)
 {
     vkCmdDraw(cmd_buf,
-              tess_level * 3,   // vertexCount
-              num_edges,        // instanceCount
-              0,                // firstVertex
-              0);               // firstInstance
+              edge_tess_level * 3, // vertexCount
+              num_edges,           // instanceCount
+              0,                   // firstVertex
+              0);                  // firstInstance
 }
 
-void Sculptor::Geometry::render_vertices(VkCommandBuffer cmd_buf)
+void Sculptor::Geometry::render_vertices(VkCommandBuffer cmd_buf, uint32_t slot)
 {
-    vkCmdDraw(cmd_buf,
-              4,                // vertexCount
-              num_vertices,     // instanceCount
-              0,                // firstVertex
-              0);               // firstInstance
+    if ( ! uses_gpu_culling()) {
+        vkCmdDraw(cmd_buf,
+                  4,                // vertexCount
+                  num_vertices,     // instanceCount
+                  0,                // firstVertex
+                  0);               // firstInstance
+        return;
+    }
+
+    assert(slot < num_cull_slots);
+
+    // Each instance is a vertex which survived culling
+    vkCmdDrawIndirect(cmd_buf,
+                      gpu_buffer.get_buffer(),
+                      cull_offset + slot * cull_slot_size + cull_vertex_draw_offset,
+                      1,  // drawCount
+                      sizeof(VkDrawIndirectCommand));
 }
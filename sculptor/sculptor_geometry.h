@@ -3,10 +3,34 @@
 
 #pragma once
 
+#include "sculptor_bvh.h"
+#include "sculptor_journal.h"
+#include "sculptor_vertex_grid.h"
+#include "../minivulkan.h"
 #include "../resource.h"
 
 namespace Sculptor {
 
+// Ranges of elements in a stream which have changed since the last upload
+struct DirtyRanges {
+    static constexpr uint32_t max_ranges = 4;
+
+    uint32_t begin[max_ranges];
+    uint32_t end[max_ranges];
+    uint32_t num_ranges;
+
+    // Overlapping and adjacent ranges are merged, when all ranges are in use
+    // the new range is merged with the closest one
+    void     add(uint32_t first, uint32_t count);
+    bool     contains(uint32_t idx) const;
+    uint32_t get_copy_regions(VkBufferCopy* regions,
+                              uint32_t      num_elements,
+                              uint32_t      elem_size,
+                              uint32_t      header_size,
+                              VkDeviceSize  src_offset,
+                              VkDeviceSize  dst_offset) const;
+};
+
 class Geometry {
     public:
         constexpr Geometry() = default;
@@ -22,25 +46,88 @@ class Geometry {
         };
 
         struct FacesBuf {
-            int32_t  tess_level[4];
+            int32_t  tess_level[4]; // Edge segments, max patch level, target segment length in pixels, flags
             FaceData face_data[1];
         };
 
-        static constexpr uint32_t max_edges = 0x10000U;
-        static constexpr uint32_t max_faces = 0x10000U / 16U;
+        // Vertex of a patch evaluated in a compute shader, used without tessellation shaders
+        struct TessVertex {
+            float    pos[3];
+            uint32_t face_id;
+            float    normal[3];
+            uint32_t uv;      // u and v as 16-bit unorm
+        };
+
+        // Face table consumed by the index generation compute shader
+        struct FaceRecord {
+            int32_t  edges[4];
+            uint32_t ctrl_vertices[4];
+            uint32_t material_id;
+            uint32_t selected;
+            uint32_t padding[2];
+        };
+
+        // Selection state of vertices read by the vertex handle shader
+        struct VertexStateBuf {
+            uint32_t hovered_vertex;
+            uint32_t flags;       // 1: vertex handles are drawn from culling results
+            uint32_t padding[2];
+            uint32_t selected[1]; // One bit per vertex
+        };
+
+        // Above this many vertices the patch index buffer is promoted to 32-bit indices
+        static constexpr uint32_t max_16bit_vertices = 0x10000U;
 
         bool allocate();
-        void set_dirty() { dirty = true; }
+        uint32_t get_generation() const { return generation; }
+        void set_dirty();
         bool send_to_gpu(VkCommandBuffer cmd_buf);
         void write_faces_descriptor(VkDescriptorBufferInfo* desc);
         void write_edge_indices_descriptor(VkDescriptorBufferInfo* desc);
         void write_edge_vertices_descriptor(VkDescriptorBufferInfo* desc);
-        void render(VkCommandBuffer cmd_buf);
+        void write_patch_indices_descriptor(VkDescriptorBufferInfo* desc);
+        void write_visible_faces_descriptor(VkDescriptorBufferInfo* desc);
+        void write_vertex_state_descriptor(VkDescriptorBufferInfo* desc);
+        void write_visible_vertices_descriptor(VkDescriptorBufferInfo* desc);
+        uint32_t get_visible_faces_dynamic_offset(uint32_t slot) const;
+        uint32_t get_visible_vertices_dynamic_offset(uint32_t slot) const;
+
+        struct CullView {
+            vmath::mat4 model_view;
+            vmath::vec4 proj;
+            bool        perspective;
+        };
+
+        // Views which are drawn together with multiview share culling results
+        static constexpr uint32_t max_cull_views = 4;
+
+        // Culls patches for the given views on the GPU, render() then draws only the patches
+        // visible in any of the views.  Each slot holds results for one swapchain image.
+        // Vertex handles are culled too, render_vertices() draws only vertices inside the views,
+        // which belong to at least one visible patch or which are not used by any patch.
+        void cull(VkCommandBuffer cmd_buf,
+                  uint32_t        slot,
+                  const CullView* views,
+                  uint32_t        num_views);
+        void render(VkCommandBuffer cmd_buf, uint32_t slot);
+
+        // Without tessellation shaders, render() draws triangles made of TessVertex
+        bool uses_compute_tessellation() const { return tess_desc_set != VK_NULL_HANDLE; }
+
+        // With task and mesh shaders, render() draws patches with a mesh shading material
+        bool uses_mesh_shading() const { return mesh_shading; }
         void render_edges(VkCommandBuffer cmd_buf);
-        void render_vertices(VkCommandBuffer cmd_buf);
+        void render_vertices(VkCommandBuffer cmd_buf, uint32_t slot);
+#ifndef NDEBUG
+        bool verify_gpu_indices();
+#endif
 
         uint32_t add_vertex(int16_t x, int16_t y, int16_t z);
         uint32_t get_num_vertices() const { return num_vertices; }
+        const Vertex& get_vertex(uint32_t vtx) const {
+            assert(vtx < num_vertices);
+            return obj_vertices[vtx];
+        }
         void     set_vertex(uint32_t vtx, int16_t x, int16_t y, int16_t z);
         uint32_t add_edge(uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3);
         void     set_edge(uint32_t edge, uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3);
@@ -50,41 +137,307 @@ class Geometry {
         void     set_face(uint32_t face_id, int32_t edge_0, int32_t edge_1, int32_t edge_2, int32_t edge_3,
                           uint32_t vtx_0, uint32_t vtx_1, uint32_t vtx_2, uint32_t vtx_3);
         uint32_t get_num_faces() const { return num_faces; }
+        void     get_face_indices(uint32_t face_id, uint32_t* indices) const;
         void     validate_face(uint32_t face_id);
 
+        // Finds the nearest face hit by a ray in int16 object coordinates, returns ~0U if none,
+        // optionally returns distance to the hit in units of dir
+        uint32_t pick_face(const vmath::vec3& origin, const vmath::vec3& dir, float* hit_dist = nullptr);
+
+        // Finds at most max_count vertices nearest to a point in int16 object coordinates within max_dist,
+        // sorted by distance, returns the number of vertices found
+        uint32_t find_nearest_vertices(const vmath::vec3& pos, float max_dist, uint32_t* vertices, uint32_t max_count);
+
+        // Finds vertices within radius of a point in int16 object coordinates, returns the total number
+        // of vertices found, but writes at most max_count of them
+        uint32_t find_vertices_in_radius(const vmath::vec3& pos, float radius, uint32_t* vertices, uint32_t max_count);
+
+        // Adjacency queries return the total number of neighbors, but write at most max_count of them
+        uint32_t get_vertex_edges(uint32_t vtx, uint32_t* edges, uint32_t max_count) const;
+        uint32_t get_edge_faces(uint32_t edge, uint32_t* faces, uint32_t max_count) const;
+        uint32_t get_adjacent_face(uint32_t face_id, uint32_t i_edge) const;
+
         void set_cube();
+
+        // Vertices transformed together, e.g. by the move, rotate and scale tools.  Original positions
+        // are kept as floats in SoA layout and each transform starts from them, so a transform
+        // can be adjusted repeatedly during a drag without accumulating rounding errors.
+        class VertexBatch {
+            public:
+                constexpr VertexBatch() = default;
+                VertexBatch(const VertexBatch&)            = delete;
+                VertexBatch& operator=(const VertexBatch&) = delete;
+                ~VertexBatch();
+
+                uint32_t           size() const       { return count; }
+                const vmath::vec3& get_center() const { return center; }
+                void               clear()            { count = 0; }
+                bool               contains(uint32_t vtx) const;
+
+            private:
+                friend class Geometry;
+
+                bool reserve(uint32_t required);
+
+                uint32_t*   ids      = nullptr; // Ascending vertex ids
+                float*      pos      = nullptr; // Arrays of x, y and z, each with capacity elements
+                uint32_t    count    = 0;
+                uint32_t    capacity = 0;       // Multiple of 4
+                vmath::vec3 center   { 0.0f, 0.0f, 0.0f };
+        };
+
+        // Gathers all vertices of selected faces, including their control vertices
+        bool gather_selected_vertices(VertexBatch* batch) const;
+
+        // Sets vertices of the batch to their original positions transformed by xform,
+        // new positions are rounded and clamped to the int16 range
+        void transform_vertices(const VertexBatch& batch, const vmath::mat4& xform);
+
+        // Moves the selected faces onto copies of their boundary vertices and connects each boundary
+        // edge to its copy with a new face.  The copies start at the positions of the original vertices,
+        // the selected faces stay selected and are then moved like any other selection.
+        // If it fails, the geometry may be partially extruded and undo reverts it.
+        bool extrude_selected_faces();
+
+        // Geometry files have the same layout as the vertex, edge and face streams on the GPU,
+        // the current geometry is kept if loading fails
+        bool save(const char* filename) const;
+        bool load(const char* filename);
+
+        enum class MeshFormat {
+            obj,
+            glb
+        };
+
+        // Evaluates all patches on the CPU at a fixed tessellation level and writes them as one mesh,
+        // vertices on edges shared by patches are welded
+        static constexpr uint32_t max_export_level = 64;
+        bool export_mesh(const char* filename, MeshFormat format, uint32_t tess_level) const;
+
+        // Changes of vertices, edges and faces made between begin_edit() and end_edit() are
+        // recorded as one undoable step.  Edits with the same non-zero key which follow each other,
+        // e.g. in a continuous drag, are coalesced into one step.  The journal is allocated
+        // by the first edit, so geometry which is never edited does not need it.
+        void begin_edit(uint32_t coalesce_key = 0);
+        void end_edit()       { journal.end_step(); }
+        bool can_undo() const { return journal.can_undo(); }
+        bool can_redo() const { return journal.can_redo(); }
+        bool undo();
+        bool redo();
+
         void set_hovered_face(uint32_t face_id);
+        uint32_t get_hovered_face() const { return hovered_face_id; }
+
+        // Patches are tessellated so that each segment is about this many pixels long on screen,
+        // lower values give higher quality at the cost of more triangles
+        void     set_tess_quality(uint32_t pixels_per_segment);
+        uint32_t get_tess_quality() const { return tess_segment_px; }
         void select_face(uint32_t face_id);
         void deselect_face(uint32_t face_id);
         void deselect_all_faces();
+        bool is_face_selected(uint32_t face_id) const {
+            assert(face_id < num_faces);
+            return obj_faces[face_id].selected;
+        }
+
+        // Vertex selection is kept in a bitset, which is uploaded as is for drawing vertex handles
+        void set_hovered_vertex(uint32_t vtx);
+        uint32_t get_hovered_vertex() const { return hovered_vertex_id; }
+        void select_vertex(uint32_t vtx);
+        void deselect_vertex(uint32_t vtx);
+        void deselect_all_vertices();
+        bool is_vertex_selected(uint32_t vtx) const {
+            assert(vtx < num_vertices);
+            return (vertex_selection[vtx / 32] >> (vtx % 32)) & 1U;
+        }
 
     private:
+        bool reserve_gpu_buffers();
+        bool allocate_compute_desc_sets(bool tess_shader);
+        void update_compute_desc_sets();
+        bool uses_gpu_culling() const { return cull_desc_sets[0] != VK_NULL_HANDLE; }
+
         Buffer   gpu_buffer;
         Buffer   host_buffer;
 
+        // GPU buffer layout, each host copy has the same layout
+        uint32_t gpu_vertices_cap    = 0;
+        uint32_t gpu_faces_cap       = 0;
+        uint32_t gpu_edges_cap       = 0;
+        uint32_t index_size          = sizeof(uint16_t);
+        uint32_t indices_offset      = 0;
+        uint32_t edge_indices_offset = 0;
+        uint32_t faces_offset        = 0;
+        uint32_t face_records_offset = 0;
+        uint32_t vertex_state_offset = 0;
+        uint32_t copy_size           = 0;
+        uint32_t cull_offset         = 0; // Culling results for each slot, not present in host copies
+        uint32_t cull_slot_size      = 0;
+        uint32_t cull_views_offset   = 0; // Within a slot, which starts with the draw command
+        uint32_t cull_faces_offset   = 0;
+        uint32_t cull_indices_offset = 0;
+        uint32_t cull_vertex_draw_offset  = 0; // Draw command for vertex handles
+        uint32_t cull_vertex_marks_offset = 0; // Vertices of visible patches and vertices used by patches
+        uint32_t cull_vertices_offset     = 0; // Vertices which survived culling
+        uint32_t generation          = 0; // Incremented when GPU buffers are reallocated
+
+        // Patches evaluated without tessellation shaders, not present in host copies
+        uint32_t tess_vertices_offset = 0;
+        uint32_t tess_indices_offset  = 0;
+        uint32_t tess_end_offset      = 0;
+
+        // Descriptor sets for generating patch indices and for culling or evaluating patches
+        // on the GPU, null when using the CPU path.  Each cull slot has its own descriptor set
+        // with outputs of that slot.
+        VkDescriptorSet index_gen_desc_set = VK_NULL_HANDLE;
+        VkDescriptorSet cull_desc_sets[max_swapchain_size] = { };
+        VkDescriptorSet tess_desc_set      = VK_NULL_HANDLE;
+
+        bool     mesh_shading        = false;
         uint32_t last_buffer         = 0;
         uint32_t hovered_face_id     = ~0U;
+        uint32_t hovered_vertex_id   = ~0U;
+        uint32_t tess_segment_px     = 8;
         uint32_t num_vertices        = 0;
         uint32_t num_indices         = 0;
         uint32_t num_edge_indices    = 0;
         uint32_t num_edges           = 0;
         uint32_t num_faces           = 0;
-        bool     dirty               = true;
+
+        // Streams uploaded to the GPU buffer, each tracked separately
+        enum Stream {
+            str_vertices,
+            str_face_indices,
+            str_edge_indices,
+            str_face_data,
+            str_face_records,
+            str_vertex_state,   // Elements are 32-bit words of the selection bitset
+            num_streams
+        };
+
+        DirtyRanges dirty[num_streams] = { };
+
+        void evaluate_patches(VkCommandBuffer    cmd_buf,
+                              const DirtyRanges& face_ranges,
+                              const DirtyRanges& vertex_ranges);
+
+        void mark_dirty(Stream stream, uint32_t first, uint32_t count = 1) {
+            dirty[stream].add(first, count);
+        }
+        bool is_dirty() const;
+
+        // Adjacency is stored as intrusive lists threaded through the edge and face tables
+        static constexpr uint32_t no_link = ~0U;
 
         struct Edge {
             uint32_t vertices[4];
+            uint32_t next_at_vertex[2]; // Next edge at corner vertex 0 and 3, as edge * 2 + corner
+            uint32_t first_face_slot;   // First face referring to this edge, as face * 4 + slot
             bool     selected;
         };
-        Edge obj_edges[max_edges] = { };
 
         struct Face {
             int32_t  edges[4];
             uint32_t ctrl_vertices[4];
+            uint32_t next_face_slot[4]; // Next face referring to the edge in each slot
             uint32_t material_id;
             bool     selected;
         };
-        Face obj_faces[max_faces] = { };
+
+        // Growable host tables, capacity grows by doubling
+        Vertex*  obj_vertices        = nullptr;
+        Edge*    obj_edges           = nullptr;
+        Face*    obj_faces           = nullptr;
+        uint32_t obj_vertices_cap    = 0;
+        uint32_t obj_edges_cap       = 0;
+        uint32_t obj_faces_cap       = 0;
+
+        // First edge at each vertex, as edge * 2 + corner, only corner vertices of edges are linked
+        uint32_t* vertex_edges       = nullptr;
+        uint32_t  vertex_edges_cap   = 0;
+
+        // One bit per vertex, capacity is in 32-bit words
+        uint32_t* vertex_selection     = nullptr;
+        uint32_t  vertex_selection_cap = 0;
+
+        bool     reserve_tables(uint32_t vertices, uint32_t edges, uint32_t faces);
+        void     store_vertex(uint32_t vtx, const Vertex& vertex);
+        void     store_edge(uint32_t edge, const uint32_t* vertices);
+        void     remove_last_vertex();
+        void     remove_last_edge();
+        void     remove_last_face();
+
+        void     link_edge(uint32_t edge);
+        void     unlink_edge(uint32_t edge);
+        void     link_face(uint32_t face_id);
+        void     unlink_face(uint32_t face_id);
+
+        // Rebuilt lazily after topology changes, refit when vertices move
+        PatchBVH bvh;
+
+        // Built lazily for vertex queries, updated as vertices are added, moved and removed
+        VertexGrid vertex_grid;
+
+        // State of a mesh export shared by worker threads
+        struct ExportJob;
+
+        // Records in the undo journal, each describes a range of vertices, edges or faces.
+        // Changes store both old and new values, so they can be reverted and reapplied.
+        enum JournalRecordType : uint32_t {
+            rec_set_vertices = 1, // VertexDelta for each vertex
+            rec_add_vertices,     // Vertex for each added vertex
+            rec_set_edges,        // EdgeDelta for each edge
+            rec_add_edges,        // EdgeVertices for each added edge
+            rec_set_faces,        // FaceDelta for each face
+            rec_add_faces,        // FaceTopology for each added face
+            rec_set_vertex_list   // VertexListDelta for each vertex, first is 0
+        };
+
+        struct VertexDelta {
+            Vertex old_vertex;
+            Vertex new_vertex;
+        };
+
+        struct VertexListDelta {
+            uint32_t vtx;
+            Vertex   old_vertex;
+            Vertex   new_vertex;
+        };
+
+        struct EdgeVertices {
+            uint32_t vertices[4];
+        };
+
+        struct EdgeDelta {
+            EdgeVertices old_edge;
+            EdgeVertices new_edge;
+        };
+
+        struct FaceTopology {
+            int32_t  edges[4];
+            uint32_t ctrl_vertices[4];
+            uint32_t material_id;
+        };
+
+        struct FaceDelta {
+            FaceTopology old_face;
+            FaceTopology new_face;
+        };
+
+        EditJournal journal;
+
+        template<typename T>
+        T*   get_journal_element(JournalRecordType type, uint32_t idx, bool* existing);
+        void revert_record(const EditJournal::Record& record);
+        void apply_record(const EditJournal::Record& record);
+        void store_vertex_list(const VertexListDelta* deltas, uint32_t count, bool new_vertices);
+        void store_face(uint32_t face_id, const FaceTopology& face);
+        void validate_faces();
+
         uint32_t get_face_state(uint32_t face_id, const Face& face) const;
+        template<typename T>
+        void     write_face_indices(T* indices_ptr, uint32_t face_id) const;
+        void     write_edge_indices(uint32_t* indices_ptr, uint32_t edge_id) const;
 };
 
 }
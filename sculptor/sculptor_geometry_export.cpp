@@ -0,0 +1,568 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_geometry.h"
+
+#include "../d_printf.h"
+#include "../mstdc.h"
+#include "../parallel.h"
+#include "../vecfloat.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+using vmath::float4;
+using vmath::vec3;
+
+// Exported meshes have three kinds of vertices:
+//
+//     corners   - one for each geometry vertex which is a corner of any patch
+//     edges     - tess_level - 1 for each edge used by any patch, in the direction of the edge
+//     interiors - (tess_level - 1)^2 for each patch
+//
+// Patches sharing an edge or a corner refer to the same vertices, whose positions are evaluated
+// from the edge alone, so the mesh is watertight.  Normals of shared vertices are averaged
+// from normals of all patches which share them.
+
+namespace {
+    // Below this many items per thread it's not worth starting more threads
+    constexpr uint32_t min_items_per_thread = 256;
+
+    float4 bezier_curve_cubic(const float4& p0, const float4& p1, const float4& p2, const float4& p3, const float4& t)
+    {
+        const float4 p01  = p0 + (p1 - p0) * t;
+        const float4 p12  = p1 + (p2 - p1) * t;
+        const float4 p23  = p2 + (p3 - p2) * t;
+        const float4 p012 = p01 + (p12 - p01) * t;
+        const float4 p123 = p12 + (p23 - p12) * t;
+        return p012 + (p123 - p012) * t;
+    }
+
+    float4 bezier_derivative_cubic(const float4& p0, const float4& p1, const float4& p2, const float4& p3, const float4& t)
+    {
+        const float4 d01  = p1 - p0;
+        const float4 d12  = p2 - p1;
+        const float4 d23  = p3 - p2;
+        const float4 d012 = d01 + (d12 - d01) * t;
+        const float4 d123 = d12 + (d23 - d12) * t;
+        return (d012 + (d123 - d012) * t) * vmath::spread4(3.0f);
+    }
+
+    vec3 normalize_or_zero(const vec3& v)
+    {
+        const float len = vmath::length(v);
+        return (len > 0.0f) ? (v / len) : v;
+    }
+
+    // Vertex of the exported mesh, same layout as in the glTF buffer
+    struct MeshVertex {
+        float pos[3];
+        float normal[3];
+    };
+
+    void store_vec3(float* dest, const vec3& v)
+    {
+        dest[0] = v.x;
+        dest[1] = v.y;
+        dest[2] = v.z;
+    }
+}
+
+struct Sculptor::Geometry::ExportJob {
+    explicit ExportJob(const Geometry& in_geom) : geom(in_geom) { }
+    ExportJob(const ExportJob&) = delete;
+    ExportJob& operator=(const ExportJob&) = delete;
+    ~ExportJob();
+
+    bool allocate(uint32_t tess_level);
+    void evaluate();
+    bool write_obj(FILE* file) const;
+    bool write_glb(FILE* file) const;
+
+    static void run_faces(void* job, uint32_t begin, uint32_t end) {
+        static_cast<ExportJob*>(job)->evaluate_faces(begin, end);
+    }
+    static void run_edges(void* job, uint32_t begin, uint32_t end) {
+        static_cast<ExportJob*>(job)->evaluate_edges(begin, end);
+    }
+
+    void evaluate_faces(uint32_t begin, uint32_t end);
+    void evaluate_edges(uint32_t begin, uint32_t end);
+    void get_grid_indices(uint32_t face_id, const uint32_t* ctrl_idx, uint32_t* grid) const;
+    uint32_t get_rim_offset(uint32_t face_id, uint32_t slot, uint32_t k) const;
+
+    const Geometry& geom;
+
+    uint32_t    level            = 0;
+    uint32_t    num_corners      = 0;
+    uint32_t    num_out_vertices = 0;
+    uint32_t    num_out_indices  = 0;
+    uint32_t    interior_base    = 0;       // First vertex inside patches
+    uint32_t*   corner_index     = nullptr; // Mesh vertex of each geometry vertex which is a patch corner
+    uint32_t*   edge_base        = nullptr; // First mesh vertex inside each edge
+    MeshVertex* vertices         = nullptr;
+    uint32_t*   indices          = nullptr;
+
+    // Normals of each patch at its boundary, in the direction of edges, averaged for welded vertices
+    vec3*       rim_normals      = nullptr;
+    vec3*       corner_normals   = nullptr;
+};
+
+Sculptor::Geometry::ExportJob::~ExportJob()
+{
+    free(corner_index);
+    free(edge_base);
+    free(vertices);
+    free(indices);
+    free(rim_normals);
+    free(corner_normals);
+}
+
+template<typename T>
+static bool allocate_array(T** array, uint64_t count)
+{
+    if (count > ~0U / sizeof(T)) {
+        d_printf("Exported mesh is too large\n");
+        return false;
+    }
+
+    *array = static_cast<T*>(malloc(mstd::max(static_cast<size_t>(count), static_cast<size_t>(1)) * sizeof(T)));
+    if ( ! *array) {
+        d_printf("Failed to allocate %u bytes for mesh export\n", static_cast<uint32_t>(count * sizeof(T)));
+        return false;
+    }
+
+    return true;
+}
+
+bool Sculptor::Geometry::ExportJob::allocate(uint32_t tess_level)
+{
+    level = tess_level;
+
+    const uint32_t edge_vertices = level - 1;
+
+    if ( ! allocate_array(&corner_index, geom.num_vertices) ||
+        ! allocate_array(&edge_base, geom.num_edges))
+        return false;
+
+    // Assign mesh vertices to patch corners
+    for (uint32_t vtx = 0; vtx < geom.num_vertices; vtx++)
+        corner_index[vtx] = no_link;
+
+    for (uint32_t face_id = 0; face_id < geom.num_faces; face_id++) {
+        uint32_t ctrl_idx[16];
+        geom.get_face_indices(face_id, ctrl_idx);
+
+        static const uint8_t corners[] = { 0, 3, 12, 15 };
+        for (const uint8_t corner : corners) {
+            const uint32_t vtx = ctrl_idx[corner];
+            if (corner_index[vtx] == no_link)
+                corner_index[vtx] = num_corners++;
+        }
+    }
+
+    // Assign mesh vertices to edges used by patches
+    uint64_t next_vertex = num_corners;
+
+    for (uint32_t edge = 0; edge < geom.num_edges; edge++) {
+        if (geom.obj_edges[edge].first_face_slot == no_link)
+            edge_base[edge] = no_link;
+        else {
+            edge_base[edge] = static_cast<uint32_t>(next_vertex);
+            next_vertex += edge_vertices;
+        }
+    }
+
+    const uint64_t total_vertices = next_vertex + static_cast<uint64_t>(geom.num_faces) * edge_vertices * edge_vertices;
+    const uint64_t total_indices  = static_cast<uint64_t>(geom.num_faces) * level * level * 6;
+
+    if (total_vertices > ~0U || total_indices > ~0U) {
+        d_printf("Exported mesh is too large\n");
+        return false;
+    }
+
+    interior_base    = static_cast<uint32_t>(next_vertex);
+    num_out_vertices = static_cast<uint32_t>(total_vertices);
+    num_out_indices  = static_cast<uint32_t>(total_indices);
+
+    if ( ! allocate_array(&vertices,       num_out_vertices) ||
+        ! allocate_array(&indices,        num_out_indices)  ||
+        ! allocate_array(&rim_normals,    static_cast<uint64_t>(geom.num_faces) * 4 * edge_vertices) ||
+        ! allocate_array(&corner_normals, static_cast<uint64_t>(geom.num_faces) * 4))
+        return false;
+
+    for (uint32_t vtx = 0; vtx < geom.num_vertices; vtx++) {
+        const uint32_t out_vtx = corner_index[vtx];
+        if (out_vtx == no_link)
+            continue;
+
+        const Vertex& vertex = geom.obj_vertices[vtx];
+        for (uint32_t c = 0; c < 3; c++) {
+            vertices[out_vtx].pos[c]    = static_cast<float>(vertex.pos[c]);
+            vertices[out_vtx].normal[c] = 0.0f;
+        }
+    }
+
+    return true;
+}
+
+uint32_t Sculptor::Geometry::ExportJob::get_rim_offset(uint32_t face_id, uint32_t slot, uint32_t k) const
+{
+    assert(k > 0 && k < level);
+
+    const bool inverse = geom.obj_faces[face_id].edges[slot] < 0;
+
+    return (face_id * 4 + slot) * (level - 1) + (inverse ? (level - k) : k) - 1;
+}
+
+void Sculptor::Geometry::ExportJob::get_grid_indices(uint32_t face_id, const uint32_t* ctrl_idx, uint32_t* grid) const
+{
+    const Face&    face      = geom.obj_faces[face_id];
+    const uint32_t side      = level + 1;
+    const uint32_t inner     = level - 1;
+    const uint32_t face_base = interior_base + face_id * inner * inner;
+
+    for (uint32_t j = 0; j <= level; j++) {
+        for (uint32_t i = 0; i <= level; i++) {
+            const bool u_edge = i == 0 || i == level;
+            const bool v_edge = j == 0 || j == level;
+
+            uint32_t out_vtx;
+
+            if (u_edge && v_edge) {
+                out_vtx = corner_index[ctrl_idx[(j ? 12 : 0) + (i ? 3 : 0)]];
+            }
+            else if (u_edge || v_edge) {
+                // Edge slots are rows 0 and 3 along u, and columns 0 and 3 along v
+                const uint32_t slot = v_edge ? (j ? 3 : 0) : (i ? 2 : 1);
+                const uint32_t k    = v_edge ? i : j;
+                const int32_t  sel  = face.edges[slot];
+                const uint32_t edge = static_cast<uint32_t>((sel < 0) ? (-sel - 1) : sel);
+
+                out_vtx = edge_base[edge] + ((sel < 0) ? (level - k) : k) - 1;
+            }
+            else {
+                out_vtx = face_base + (j - 1) * inner + (i - 1);
+            }
+
+            assert(out_vtx < num_out_vertices);
+            grid[j * side + i] = out_vtx;
+        }
+    }
+}
+
+void Sculptor::Geometry::ExportJob::evaluate_faces(uint32_t begin, uint32_t end)
+{
+    const uint32_t side      = level + 1;
+    const float    inv_level = 1.0f / static_cast<float>(level);
+
+    uint32_t grid[(max_export_level + 1) * (max_export_level + 1)];
+
+    for (uint32_t face_id = begin; face_id < end; face_id++) {
+        uint32_t ctrl_idx[16];
+        geom.get_face_indices(face_id, ctrl_idx);
+
+        // Each coordinate of each control point is spread across all lanes
+        float4 ctrl[16][3];
+        for (uint32_t i = 0; i < 16; i++) {
+            const Vertex& vertex = geom.obj_vertices[ctrl_idx[i]];
+            for (uint32_t c = 0; c < 3; c++)
+                ctrl[i][c] = vmath::spread4(static_cast<float>(vertex.pos[c]));
+        }
+
+        get_grid_indices(face_id, ctrl_idx, grid);
+
+        // Triangles are counter-clockwise in the (u, v) domain like with the tessellator
+        uint32_t* out_idx = &indices[face_id * level * level * 6];
+        for (uint32_t qv = 0; qv < level; qv++) {
+            for (uint32_t qu = 0; qu < level; qu++) {
+                const uint32_t i00 = grid[qv * side + qu];
+                const uint32_t i10 = grid[qv * side + qu + 1];
+                const uint32_t i01 = grid[(qv + 1) * side + qu];
+                const uint32_t i11 = grid[(qv + 1) * side + qu + 1];
+
+                out_idx[0] = i00;
+                out_idx[1] = i10;
+                out_idx[2] = i11;
+                out_idx[3] = i00;
+                out_idx[4] = i11;
+                out_idx[5] = i01;
+                out_idx += 6;
+            }
+        }
+
+        // Evaluate 4 columns of the grid at a time, each lane has a different u
+        for (uint32_t i0 = 0; i0 <= level; i0 += 4) {
+            const float4 u = (vmath::spread4(static_cast<float>(i0)) + float4{0.0f, 1.0f, 2.0f, 3.0f}) *
+                             vmath::spread4(inv_level);
+
+            // Curves along u in each row of control points and their derivatives,
+            // same as the first step of the tessellation evaluation shader
+            float4 row_pos[4][3];
+            float4 row_deriv[4][3];
+            for (uint32_t row = 0; row < 4; row++) {
+                for (uint32_t c = 0; c < 3; c++) {
+                    row_pos[row][c]   = bezier_curve_cubic(ctrl[row * 4][c], ctrl[row * 4 + 1][c],
+                                                           ctrl[row * 4 + 2][c], ctrl[row * 4 + 3][c], u);
+                    row_deriv[row][c] = bezier_derivative_cubic(ctrl[row * 4][c], ctrl[row * 4 + 1][c],
+                                                                ctrl[row * 4 + 2][c], ctrl[row * 4 + 3][c], u);
+                }
+            }
+
+            const uint32_t num_lanes = mstd::min(side - i0, 4U);
+
+            for (uint32_t j = 0; j <= level; j++) {
+                const float4 v = vmath::spread4(static_cast<float>(j) * inv_level);
+
+                float4 pos[3];
+                float4 du[3];
+                float4 dv[3];
+                for (uint32_t c = 0; c < 3; c++) {
+                    pos[c] = bezier_curve_cubic(row_pos[0][c], row_pos[1][c], row_pos[2][c], row_pos[3][c], v);
+                    dv[c]  = bezier_derivative_cubic(row_pos[0][c], row_pos[1][c], row_pos[2][c], row_pos[3][c], v);
+                    du[c]  = bezier_curve_cubic(row_deriv[0][c], row_deriv[1][c], row_deriv[2][c], row_deriv[3][c], v);
+                }
+
+                float4 normal[3] = {
+                    du[1] * dv[2] - du[2] * dv[1],
+                    du[2] * dv[0] - du[0] * dv[2],
+                    du[0] * dv[1] - du[1] * dv[0]
+                };
+
+                const float4 len = vmath::max(vmath::sqrt(normal[0] * normal[0] +
+                                                          normal[1] * normal[1] +
+                                                          normal[2] * normal[2]),
+                                              vmath::spread4(1e-20f));
+                for (uint32_t c = 0; c < 3; c++)
+                    normal[c] = normal[c] / len;
+
+                alignas(16) float out_pos[3][4];
+                alignas(16) float out_normal[3][4];
+                for (uint32_t c = 0; c < 3; c++) {
+                    pos[c].store4_aligned(out_pos[c]);
+                    normal[c].store4_aligned(out_normal[c]);
+                }
+
+                for (uint32_t lane = 0; lane < num_lanes; lane++) {
+                    const uint32_t i = i0 + lane;
+                    const vec3     n{out_normal[0][lane], out_normal[1][lane], out_normal[2][lane]};
+
+                    const bool u_edge = i == 0 || i == level;
+                    const bool v_edge = j == 0 || j == level;
+
+                    // Boundary vertices are finished once all patches sharing them are evaluated
+                    if (u_edge && v_edge)
+                        corner_normals[face_id * 4 + (j ? 2 : 0) + (i ? 1 : 0)] = n;
+                    else if (v_edge)
+                        rim_normals[get_rim_offset(face_id, j ? 3 : 0, i)] = n;
+                    else if (u_edge)
+                        rim_normals[get_rim_offset(face_id, i ? 2 : 1, j)] = n;
+                    else {
+                        const uint32_t out_vtx = grid[j * side + i];
+                        store_vec3(vertices[out_vtx].pos, vec3{out_pos[0][lane], out_pos[1][lane], out_pos[2][lane]});
+                        store_vec3(vertices[out_vtx].normal, n);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Sculptor::Geometry::ExportJob::evaluate_edges(uint32_t begin, uint32_t end)
+{
+    const float inv_level = 1.0f / static_cast<float>(level);
+
+    for (uint32_t edge_id = begin; edge_id < end; edge_id++) {
+        if (edge_base[edge_id] == no_link)
+            continue;
+
+        const Edge& edge = geom.obj_edges[edge_id];
+
+        // Lanes hold x, y and z
+        float4 ctrl[4];
+        for (uint32_t i = 0; i < 4; i++) {
+            const Vertex& vertex = geom.obj_vertices[edge.vertices[i]];
+            ctrl[i] = float4{static_cast<float>(vertex.pos[0]),
+                             static_cast<float>(vertex.pos[1]),
+                             static_cast<float>(vertex.pos[2]),
+                             0.0f};
+        }
+
+        for (uint32_t k = 1; k < level; k++) {
+            const float4 pos = bezier_curve_cubic(ctrl[0], ctrl[1], ctrl[2], ctrl[3],
+                                                  vmath::spread4(static_cast<float>(k) * inv_level));
+
+            vec3 normal{0.0f};
+            for (uint32_t link = edge.first_face_slot; link != no_link; ) {
+                const uint32_t face_id = link / 4;
+                const uint32_t slot    = link % 4;
+
+                const bool inverse = geom.obj_faces[face_id].edges[slot] < 0;
+                normal += rim_normals[get_rim_offset(face_id, slot, inverse ? (level - k) : k)];
+
+                link = geom.obj_faces[face_id].next_face_slot[slot];
+            }
+
+            const uint32_t out_vtx = edge_base[edge_id] + k - 1;
+            store_vec3(vertices[out_vtx].pos, vec3{pos[0], pos[1], pos[2]});
+            store_vec3(vertices[out_vtx].normal, normalize_or_zero(normal));
+        }
+    }
+}
+
+void Sculptor::Geometry::ExportJob::evaluate()
+{
+    run_parallel(run_faces, this, geom.num_faces, min_items_per_thread);
+
+    // Edge vertices need rim normals of all patches
+    if (level > 1)
+        run_parallel(run_edges, this, geom.num_edges, min_items_per_thread);
+
+    // Corners are shared by any number of patches, so their normals are accumulated serially
+    for (uint32_t face_id = 0; face_id < geom.num_faces; face_id++) {
+        uint32_t ctrl_idx[16];
+        geom.get_face_indices(face_id, ctrl_idx);
+
+        static const uint8_t corners[] = { 0, 3, 12, 15 };
+        for (uint32_t i = 0; i < 4; i++) {
+            float* const normal = vertices[corner_index[ctrl_idx[corners[i]]]].normal;
+            const vec3&  add    = corner_normals[face_id * 4 + i];
+            normal[0] += add.x;
+            normal[1] += add.y;
+            normal[2] += add.z;
+        }
+    }
+
+    for (uint32_t vtx = 0; vtx < num_corners; vtx++) {
+        float* const normal = vertices[vtx].normal;
+        store_vec3(normal, normalize_or_zero(vec3{normal[0], normal[1], normal[2]}));
+    }
+}
+
+bool Sculptor::Geometry::ExportJob::write_obj(FILE* file) const
+{
+    bool ok = fprintf(file, "# %u vertices, %u triangles\n", num_out_vertices, num_out_indices / 3) > 0;
+
+    for (uint32_t i = 0; ok && i < num_out_vertices; i++)
+        ok = fprintf(file, "v %g %g %g\n",
+                     static_cast<double>(vertices[i].pos[0]),
+                     static_cast<double>(vertices[i].pos[1]),
+                     static_cast<double>(vertices[i].pos[2])) > 0;
+
+    for (uint32_t i = 0; ok && i < num_out_vertices; i++)
+        ok = fprintf(file, "vn %g %g %g\n",
+                     static_cast<double>(vertices[i].normal[0]),
+                     static_cast<double>(vertices[i].normal[1]),
+                     static_cast<double>(vertices[i].normal[2])) > 0;
+
+    // Indices are 1-based
+    for (uint32_t i = 0; ok && i < num_out_indices; i += 3)
+        ok = fprintf(file, "f %u//%u %u//%u %u//%u\n",
+                     indices[i] + 1,     indices[i] + 1,
+                     indices[i + 1] + 1, indices[i + 1] + 1,
+                     indices[i + 2] + 1, indices[i + 2] + 1) > 0;
+
+    return ok;
+}
+
+bool Sculptor::Geometry::ExportJob::write_glb(FILE* file) const
+{
+    float pos_min[3] = { };
+    float pos_max[3] = { };
+    for (uint32_t i = 0; i < num_out_vertices; i++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            const float value = vertices[i].pos[c];
+            pos_min[c] = i ? mstd::min(pos_min[c], value) : value;
+            pos_max[c] = i ? mstd::max(pos_max[c], value) : value;
+        }
+    }
+
+    // Binary buffer contains interleaved vertices followed by indices
+    const uint32_t vertices_size = num_out_vertices * static_cast<uint32_t>(sizeof(MeshVertex));
+    const uint32_t indices_size  = num_out_indices * static_cast<uint32_t>(sizeof(uint32_t));
+    const uint64_t bin_size      = static_cast<uint64_t>(vertices_size) + indices_size;
+
+    char json[2048];
+    const int json_len = snprintf(json, sizeof(json),
+        "{\"asset\":{\"version\":\"2.0\",\"generator\":\"sculptor\"},"
+        "\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+        "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1},\"indices\":2,\"mode\":4}]}],"
+        "\"buffers\":[{\"byteLength\":%llu}],"
+        "\"bufferViews\":["
+            "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%u,\"byteStride\":%u,\"target\":34962},"
+            "{\"buffer\":0,\"byteOffset\":%u,\"byteLength\":%u,\"target\":34963}],"
+        "\"accessors\":["
+            "{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":%u,\"type\":\"VEC3\","
+             "\"min\":[%g,%g,%g],\"max\":[%g,%g,%g]},"
+            "{\"bufferView\":0,\"byteOffset\":%u,\"componentType\":5126,\"count\":%u,\"type\":\"VEC3\"},"
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":%u,\"type\":\"SCALAR\"}]}",
+        static_cast<unsigned long long>(bin_size),
+        vertices_size, static_cast<uint32_t>(sizeof(MeshVertex)),
+        vertices_size, indices_size,
+        num_out_vertices,
+        static_cast<double>(pos_min[0]), static_cast<double>(pos_min[1]), static_cast<double>(pos_min[2]),
+        static_cast<double>(pos_max[0]), static_cast<double>(pos_max[1]), static_cast<double>(pos_max[2]),
+        static_cast<uint32_t>(offsetof(MeshVertex, normal)), num_out_vertices,
+        num_out_indices);
+    assert(json_len > 0 && static_cast<uint32_t>(json_len) < sizeof(json));
+
+    // Chunks are 4-byte aligned, JSON is padded with spaces
+    const uint32_t json_size  = mstd::align_up(static_cast<uint32_t>(json_len), 4U);
+    const uint64_t total_size = 12 + 8 + json_size + 8 + bin_size;
+
+    if (total_size > ~0U) {
+        d_printf("Exported mesh is too large for glTF\n");
+        return false;
+    }
+
+    for (uint32_t i = static_cast<uint32_t>(json_len); i < json_size; i++)
+        json[i] = ' ';
+
+    const uint32_t header[] = {
+        0x46546C67U, // "glTF"
+        2,           // version
+        static_cast<uint32_t>(total_size),
+        json_size,
+        0x4E4F534AU  // "JSON"
+    };
+
+    const uint32_t bin_header[] = {
+        static_cast<uint32_t>(bin_size),
+        0x004E4942U  // "BIN"
+    };
+
+    return fwrite(header,     1, sizeof(header),     file) == sizeof(header)     &&
+           fwrite(json,       1, json_size,          file) == json_size          &&
+           fwrite(bin_header, 1, sizeof(bin_header), file) == sizeof(bin_header) &&
+           fwrite(vertices,   1, vertices_size,      file) == vertices_size      &&
+           fwrite(indices,    1, indices_size,       file) == indices_size;
+}
+
+bool Sculptor::Geometry::export_mesh(const char* filename, MeshFormat format, uint32_t tess_level) const
+{
+    ExportJob job(*this);
+
+    if ( ! job.allocate(mstd::min(mstd::max(tess_level, 1U), max_export_level)))
+        return false;
+
+    job.evaluate();
+
+    FILE* const file = fopen(filename, (format == MeshFormat::obj) ? "w" : "wb");
+    if ( ! file) {
+        d_printf("Failed to create %s\n", filename);
+        return false;
+    }
+
+    bool ok = (format == MeshFormat::obj) ? job.write_obj(file) : job.write_glb(file);
+
+    if (fclose(file))
+        ok = false;
+
+    if ( ! ok) {
+        d_printf("Failed to write %s\n", filename);
+        remove(filename);
+    }
+
+    return ok;
+}
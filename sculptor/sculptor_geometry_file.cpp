@@ -0,0 +1,491 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_geometry.h"
+#include "sculptor_materials.h"
+
+#include "../d_printf.h"
+#include "../mstdc.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+// Geometry file layout, all values are little endian:
+//
+//     FileHeader
+//     Vertex     vertices[num_vertices] - same as the vertex stream in the GPU buffer
+//     uint32_t   edges[num_edges][4]    - same as the edge index stream
+//     FaceRecord faces[num_faces]       - same as the face records for index generation
+//
+// Each section starts at an offset aligned to section_alignment, padding is filled with zeroes.
+// The file is mapped into memory when loading, so sections are used in place.
+
+namespace {
+    constexpr char     file_magic[8]     = { 'S', 'C', 'U', 'L', 'P', 'T', 'G', 'M' };
+    constexpr uint32_t file_version      = 1;
+    constexpr uint32_t section_alignment = 16;
+
+    struct FileHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint32_t file_size;
+        uint32_t num_vertices;
+        uint32_t num_edges;
+        uint32_t num_faces;
+        uint32_t vertices_offset;
+        uint32_t edges_offset;
+        uint32_t faces_offset;
+        uint32_t checksum[2]; // Fletcher sums of 32-bit words following the header
+        uint32_t reserved[3];
+    };
+
+    static_assert(sizeof(FileHeader) % section_alignment == 0, "Sections must be aligned");
+
+    constexpr uint32_t edge_size = 4 * sizeof(uint32_t);
+
+    // Computes offsets of sections and the file size from element counts,
+    // returns false if the file would exceed 4GB
+    bool compute_layout(FileHeader* header)
+    {
+        uint64_t offset = sizeof(FileHeader);
+
+        header->vertices_offset = static_cast<uint32_t>(offset);
+        offset += static_cast<uint64_t>(header->num_vertices) * sizeof(Sculptor::Geometry::Vertex);
+        offset  = mstd::align_up(offset, static_cast<uint64_t>(section_alignment));
+
+        header->edges_offset = static_cast<uint32_t>(offset);
+        offset += static_cast<uint64_t>(header->num_edges) * edge_size;
+        offset  = mstd::align_up(offset, static_cast<uint64_t>(section_alignment));
+
+        header->faces_offset = static_cast<uint32_t>(offset);
+        offset += static_cast<uint64_t>(header->num_faces) * sizeof(Sculptor::Geometry::FaceRecord);
+
+        header->file_size = static_cast<uint32_t>(offset);
+
+        return offset <= ~0U;
+    }
+
+    struct Checksum {
+        uint32_t sum1 = 0;
+        uint32_t sum2 = 0;
+
+        void add(const uint32_t* words, uint32_t num_words) {
+            uint32_t s1 = sum1;
+            uint32_t s2 = sum2;
+            for (uint32_t i = 0; i < num_words; i++) {
+                s1 += words[i];
+                s2 += s1;
+            }
+            sum1 = s1;
+            sum2 = s2;
+        }
+    };
+
+    // Writes sections in chunks and computes the checksum as it goes
+    class FileWriter {
+        public:
+            explicit FileWriter(FILE* out_file) : file(out_file) { }
+
+            uint32_t get_offset() const { return offset; }
+            const Checksum& get_checksum() const { return checksum; }
+
+            void write(const void* data, uint32_t size) {
+                assert(size % sizeof(uint32_t) == 0);
+
+                // Sections of empty geometry have no data
+                if ( ! size)
+                    return;
+
+                checksum.add(static_cast<const uint32_t*>(data), size / static_cast<uint32_t>(sizeof(uint32_t)));
+
+                if (ok && fwrite(data, 1, size, file) != size)
+                    ok = false;
+
+                offset += size;
+            }
+
+            void pad_to(uint32_t end_offset) {
+                static const uint32_t zeroes[section_alignment / sizeof(uint32_t)] = { };
+
+                assert(end_offset >= offset);
+                assert(end_offset - offset <= sizeof(zeroes));
+
+                if (end_offset > offset)
+                    write(zeroes, end_offset - offset);
+            }
+
+            bool ok = true;
+
+        private:
+            FILE*    file;
+            uint32_t offset = sizeof(FileHeader);
+            Checksum checksum;
+    };
+
+    // Read-only view of a whole file
+    class MappedFile {
+        public:
+            MappedFile() = default;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+            ~MappedFile();
+
+            bool map(const char* filename);
+            const uint8_t* get_data() const { return data; }
+            uint32_t       get_size() const { return size; }
+
+        private:
+            const uint8_t* data = nullptr;
+            uint32_t       size = 0;
+    };
+
+#ifdef _WIN32
+    bool MappedFile::map(const char* filename)
+    {
+        const HANDLE file = CreateFileA(filename,
+                                        GENERIC_READ,
+                                        FILE_SHARE_READ,
+                                        nullptr,
+                                        OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL,
+                                        nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            d_printf("Failed to open %s\n", filename);
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if ( ! GetFileSizeEx(file, &file_size) || file_size.QuadPart > ~0U) {
+            d_printf("Failed to get size of %s\n", filename);
+            CloseHandle(file);
+            return false;
+        }
+
+        if ( ! file_size.QuadPart) {
+            CloseHandle(file);
+            return true;
+        }
+
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if ( ! mapping) {
+            d_printf("Failed to map %s\n", filename);
+            return false;
+        }
+
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if ( ! data) {
+            d_printf("Failed to map %s\n", filename);
+            return false;
+        }
+
+        size = static_cast<uint32_t>(file_size.QuadPart);
+        return true;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data)
+            UnmapViewOfFile(data);
+    }
+#else
+    bool MappedFile::map(const char* filename)
+    {
+        const int fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            d_printf("Failed to open %s\n", filename);
+            return false;
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) || static_cast<uint64_t>(file_stat.st_size) > ~0U) {
+            d_printf("Failed to get size of %s\n", filename);
+            close(fd);
+            return false;
+        }
+
+        if ( ! file_stat.st_size) {
+            close(fd);
+            return true;
+        }
+
+        void* const ptr = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            d_printf("Failed to map %s\n", filename);
+            return false;
+        }
+
+        data = static_cast<const uint8_t*>(ptr);
+        size = static_cast<uint32_t>(file_stat.st_size);
+        return true;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data)
+            munmap(const_cast<uint8_t*>(data), size);
+    }
+#endif
+
+    bool is_header_valid(const FileHeader& header, uint32_t size)
+    {
+        if (memcmp(header.magic, file_magic, sizeof(file_magic)) != 0 ||
+            header.version != file_version ||
+            header.header_size != sizeof(FileHeader))
+            return false;
+
+        FileHeader layout = { };
+        layout.num_vertices = header.num_vertices;
+        layout.num_edges    = header.num_edges;
+        layout.num_faces    = header.num_faces;
+        if ( ! compute_layout(&layout))
+            return false;
+
+        return header.vertices_offset == layout.vertices_offset &&
+               header.edges_offset    == layout.edges_offset    &&
+               header.faces_offset    == layout.faces_offset    &&
+               header.file_size       == layout.file_size       &&
+               header.file_size       <= size;
+    }
+
+    uint32_t get_edge_id(int32_t edge_sel)
+    {
+        return static_cast<uint32_t>((edge_sel < 0) ? (-edge_sel - 1) : edge_sel);
+    }
+
+    // Checks that all indices are in range and that edges of each face meet at its corners,
+    // so that the loaded geometry satisfies the same invariants as geometry built by editing
+    bool is_topology_valid(const FileHeader&                     header,
+                           const uint32_t*                       edges,
+                           const Sculptor::Geometry::FaceRecord* faces)
+    {
+        for (uint32_t i = 0; i < header.num_edges * 4; i++) {
+            if (edges[i] >= header.num_vertices)
+                return false;
+        }
+
+        const int32_t num_edges = static_cast<int32_t>(header.num_edges);
+
+        for (uint32_t i_face = 0; i_face < header.num_faces; i_face++) {
+            const Sculptor::Geometry::FaceRecord& face = faces[i_face];
+
+            if (face.material_id >= Sculptor::max_patch_materials)
+                return false;
+
+            uint32_t e_vertices[4][2];
+
+            for (uint32_t i = 0; i < 4; i++) {
+                if (face.edges[i] >= num_edges || face.edges[i] < -num_edges)
+                    return false;
+                if (face.ctrl_vertices[i] >= header.num_vertices)
+                    return false;
+
+                const uint32_t* const edge    = &edges[get_edge_id(face.edges[i]) * 4];
+                const bool            inverse = face.edges[i] < 0;
+
+                e_vertices[i][0] = edge[inverse ? 3 : 0];
+                e_vertices[i][1] = edge[inverse ? 0 : 3];
+            }
+
+            if (e_vertices[0][0] != e_vertices[1][0] ||
+                e_vertices[0][1] != e_vertices[2][0] ||
+                e_vertices[3][0] != e_vertices[1][1] ||
+                e_vertices[3][1] != e_vertices[2][1])
+                return false;
+        }
+
+        return true;
+    }
+}
+
+bool Sculptor::Geometry::save(const char* filename) const
+{
+    FileHeader header = { };
+    mstd::mem_copy(header.magic, file_magic, sizeof(file_magic));
+    header.version      = file_version;
+    header.header_size  = sizeof(FileHeader);
+    header.num_vertices = num_vertices;
+    header.num_edges    = num_edges;
+    header.num_faces    = num_faces;
+    if ( ! compute_layout(&header)) {
+        d_printf("Geometry is too large to save\n");
+        return false;
+    }
+
+    FILE* const file = fopen(filename, "wb");
+    if ( ! file) {
+        d_printf("Failed to create %s\n", filename);
+        return false;
+    }
+
+    // The header is written again with the checksum after all sections
+    FileWriter writer(file);
+    writer.ok = fwrite(&header, 1, sizeof(header), file) == sizeof(header);
+
+    static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0, "Vertices must be made of whole words");
+    writer.write(obj_vertices, num_vertices * static_cast<uint32_t>(sizeof(Vertex)));
+    writer.pad_to(header.edges_offset);
+
+    // Edges and faces are converted to their GPU layout in chunks
+    constexpr uint32_t chunk_size = 256;
+
+    for (uint32_t first = 0; first < num_edges; first += chunk_size) {
+        const uint32_t count = mstd::min(num_edges - first, chunk_size);
+
+        uint32_t chunk[chunk_size * 4];
+        for (uint32_t i = 0; i < count; i++)
+            mstd::mem_copy(&chunk[i * 4], obj_edges[first + i].vertices, edge_size);
+
+        writer.write(chunk, count * edge_size);
+    }
+    writer.pad_to(header.faces_offset);
+
+    for (uint32_t first = 0; first < num_faces; first += chunk_size) {
+        const uint32_t count = mstd::min(num_faces - first, chunk_size);
+
+        FaceRecord chunk[chunk_size];
+        for (uint32_t i = 0; i < count; i++) {
+            const Face& face   = obj_faces[first + i];
+            FaceRecord& record = chunk[i];
+
+            for (uint32_t j = 0; j < 4; j++) {
+                record.edges[j]         = face.edges[j];
+                record.ctrl_vertices[j] = face.ctrl_vertices[j];
+            }
+            record.material_id = face.material_id;
+            record.selected    = face.selected;
+            record.padding[0]  = 0;
+            record.padding[1]  = 0;
+        }
+
+        writer.write(chunk, count * static_cast<uint32_t>(sizeof(FaceRecord)));
+    }
+
+    assert( ! writer.ok || writer.get_offset() == header.file_size);
+
+    header.checksum[0] = writer.get_checksum().sum1;
+    header.checksum[1] = writer.get_checksum().sum2;
+
+    bool ok = writer.ok &&
+              fseek(file, 0, SEEK_SET) == 0 &&
+              fwrite(&header, 1, sizeof(header), file) == sizeof(header);
+
+    if (fclose(file))
+        ok = false;
+
+    if ( ! ok) {
+        d_printf("Failed to write %s\n", filename);
+        remove(filename);
+    }
+
+    return ok;
+}
+
+bool Sculptor::Geometry::load(const char* filename)
+{
+    MappedFile mapped;
+    if ( ! mapped.map(filename))
+        return false;
+
+    const uint8_t* const data = mapped.get_data();
+
+    FileHeader header;
+    if (mapped.get_size() < sizeof(header)) {
+        d_printf("Invalid geometry file %s\n", filename);
+        return false;
+    }
+    mstd::mem_copy(&header, data, sizeof(header));
+
+    if ( ! is_header_valid(header, mapped.get_size())) {
+        d_printf("Invalid geometry file %s\n", filename);
+        return false;
+    }
+
+    // The mapping is page aligned and sections are aligned, so they are accessed in place
+    Checksum checksum;
+    checksum.add(reinterpret_cast<const uint32_t*>(data + sizeof(FileHeader)),
+                 (header.file_size - static_cast<uint32_t>(sizeof(FileHeader))) / static_cast<uint32_t>(sizeof(uint32_t)));
+    if (checksum.sum1 != header.checksum[0] || checksum.sum2 != header.checksum[1]) {
+        d_printf("Checksum mismatch in %s\n", filename);
+        return false;
+    }
+
+    const Vertex*     const vertices = reinterpret_cast<const Vertex*>(data + header.vertices_offset);
+    const uint32_t*   const edges    = reinterpret_cast<const uint32_t*>(data + header.edges_offset);
+    const FaceRecord* const faces    = reinterpret_cast<const FaceRecord*>(data + header.faces_offset);
+
+    if ( ! is_topology_valid(header, edges, faces)) {
+        d_printf("Invalid topology in %s\n", filename);
+        return false;
+    }
+
+    if ( ! reserve_tables(header.num_vertices, header.num_edges, header.num_faces))
+        return false;
+
+    // Vertices are already in their GPU layout, a saved empty geometry has none
+    if (header.num_vertices)
+        mstd::mem_copy(obj_vertices, vertices, header.num_vertices * static_cast<uint32_t>(sizeof(Vertex)));
+
+    num_vertices = header.num_vertices;
+    num_edges    = header.num_edges;
+    num_faces    = header.num_faces;
+
+    // Adjacency lists are only kept in host tables, so they are rebuilt
+    for (uint32_t vtx = 0; vtx < num_vertices; vtx++)
+        vertex_edges[vtx] = no_link;
+
+    // Vertex selection is not stored in files
+    for (uint32_t i = 0; i < (num_vertices + 31) / 32; i++)
+        vertex_selection[i] = 0;
+
+    for (uint32_t i_edge = 0; i_edge < num_edges; i_edge++) {
+        Edge& edge = obj_edges[i_edge];
+
+        mstd::mem_copy(edge.vertices, &edges[i_edge * 4], edge_size);
+        edge.first_face_slot = no_link;
+        edge.selected        = false;
+
+        link_edge(i_edge);
+    }
+
+    for (uint32_t i_face = 0; i_face < num_faces; i_face++) {
+        const FaceRecord& record = faces[i_face];
+        Face&             face   = obj_faces[i_face];
+
+        for (uint32_t i = 0; i < 4; i++) {
+            face.edges[i]         = record.edges[i];
+            face.ctrl_vertices[i] = record.ctrl_vertices[i];
+        }
+        face.material_id = record.material_id;
+        face.selected    = record.selected != 0;
+
+        link_face(i_face);
+    }
+
+    hovered_face_id   = ~0U;
+    hovered_vertex_id = ~0U;
+
+    // The loaded geometry is not undoable
+    journal.clear();
+
+    bvh.invalidate();
+    vertex_grid.invalidate();
+
+    set_dirty();
+
+    return true;
+}
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_geometry.h"
+
+#include "../d_printf.h"
+#include "../mstdc.h"
+#include "../vecfloat.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+using vmath::float4;
+
+Sculptor::Geometry::VertexBatch::~VertexBatch()
+{
+    free(ids);
+    free(pos);
+}
+
+bool Sculptor::Geometry::VertexBatch::reserve(uint32_t required)
+{
+    if (required <= capacity)
+        return true;
+
+    const uint32_t new_capacity = mstd::align_up(mstd::max(required, capacity * 2), 4U);
+
+    uint32_t* const new_ids = static_cast<uint32_t*>(realloc(ids, new_capacity * sizeof(uint32_t)));
+    if ( ! new_ids) {
+        d_printf("Failed to allocate vertex batch of %u vertices\n", new_capacity);
+        return false;
+    }
+    ids = new_ids;
+
+    // Positions are gathered again after growing, so old contents are not preserved
+    free(pos);
+    pos = static_cast<float*>(malloc(new_capacity * 3 * sizeof(float)));
+    if ( ! pos) {
+        d_printf("Failed to allocate vertex batch of %u vertices\n", new_capacity);
+        capacity = 0;
+        return false;
+    }
+
+    capacity = new_capacity;
+    return true;
+}
+
+bool Sculptor::Geometry::VertexBatch::contains(uint32_t vtx) const
+{
+    uint32_t begin = 0;
+    uint32_t end   = count;
+
+    while (begin < end) {
+        const uint32_t mid = (begin + end) / 2;
+
+        if (ids[mid] == vtx)
+            return true;
+
+        if (ids[mid] < vtx)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+
+    return false;
+}
+
+bool Sculptor::Geometry::gather_selected_vertices(VertexBatch* batch) const
+{
+    batch->clear();
+
+    // Vertices shared by selected faces are only gathered once
+    const uint32_t num_words = (num_vertices + 31) / 32;
+    uint32_t* const marks = static_cast<uint32_t*>(calloc(mstd::max(num_words, 1U), sizeof(uint32_t)));
+    if ( ! marks) {
+        d_printf("Failed to allocate vertex marks\n");
+        return false;
+    }
+
+    uint32_t count = 0;
+
+    for (uint32_t face_id = 0; face_id < num_faces; face_id++) {
+        if ( ! obj_faces[face_id].selected)
+            continue;
+
+        uint32_t indices[16];
+        get_face_indices(face_id, indices);
+
+        for (const uint32_t vtx : indices) {
+            const uint32_t bit = 1U << (vtx % 32);
+            if ( ! (marks[vtx / 32] & bit)) {
+                marks[vtx / 32] |= bit;
+                ++count;
+            }
+        }
+    }
+
+    if ( ! batch->reserve(count)) {
+        free(marks);
+        return false;
+    }
+
+    float* const pos_x = batch->pos;
+    float* const pos_y = pos_x + batch->capacity;
+    float* const pos_z = pos_y + batch->capacity;
+
+    vmath::vec3 sum{0.0f, 0.0f, 0.0f};
+
+    for (uint32_t word = 0; word < num_words; word++) {
+        for (uint32_t bits = marks[word]; bits; bits &= bits - 1) {
+            uint32_t bit = 0;
+            while ( ! (bits & (1U << bit)))
+                ++bit;
+
+            const uint32_t i   = batch->count++;
+            const uint32_t vtx = word * 32 + bit;
+            const Vertex&  v   = obj_vertices[vtx];
+
+            batch->ids[i] = vtx;
+            pos_x[i]      = static_cast<float>(v.pos[0]);
+            pos_y[i]      = static_cast<float>(v.pos[1]);
+            pos_z[i]      = static_cast<float>(v.pos[2]);
+
+            sum += vmath::vec3{pos_x[i], pos_y[i], pos_z[i]};
+        }
+    }
+
+    free(marks);
+
+    assert(batch->count == count);
+
+    // Lanes past the last vertex are transformed, but never stored
+    for (uint32_t i = count; i < mstd::align_up(mstd::max(count, 1U), 4U); i++) {
+        pos_x[i] = 0.0f;
+        pos_y[i] = 0.0f;
+        pos_z[i] = 0.0f;
+    }
+
+    batch->center = count ? (sum / static_cast<float>(count)) : sum;
+
+    return true;
+}
+
+void Sculptor::Geometry::transform_vertices(const VertexBatch& batch, const vmath::mat4& xform)
+{
+    if ( ! batch.count)
+        return;
+
+    // Repeated transforms of the same batch in a coalesced step only update new positions
+    VertexListDelta* deltas   = nullptr;
+    bool             existing = false;
+
+    if (journal.is_recording()) {
+        EditJournal::Record* record = journal.find_record(rec_set_vertex_list, 0);
+
+        if (record && record->count == batch.count) {
+            deltas   = record->get_payload<VertexListDelta>();
+            existing = true;
+            for (uint32_t i = 0; i < batch.count; i++) {
+                if (deltas[i].vtx != batch.ids[i]) {
+                    existing = false;
+                    break;
+                }
+            }
+        }
+
+        if ( ! existing) {
+            record = journal.add_record(rec_set_vertex_list, 0, batch.count, sizeof(VertexListDelta));
+            deltas = record ? record->get_payload<VertexListDelta>() : nullptr;
+        }
+    }
+
+    // Rows of the transform are applied to row vectors, like everywhere else in vmath
+    float4 m[12];
+    for (uint32_t i = 0; i < 12; i++)
+        m[i] = vmath::spread4(xform.data[i]);
+
+    const float4 half    = vmath::spread4(0.5f);
+    const float4 min_pos = vmath::spread4(-32768.0f);
+    const float4 max_pos = vmath::spread4(32767.0f);
+
+    const float* const pos_x = batch.pos;
+    const float* const pos_y = pos_x + batch.capacity;
+    const float* const pos_z = pos_y + batch.capacity;
+
+    for (uint32_t i = 0; i < batch.count; i += 4) {
+        const float4 x = float4::load4_aligned(&pos_x[i]);
+        const float4 y = float4::load4_aligned(&pos_y[i]);
+        const float4 z = float4::load4_aligned(&pos_z[i]);
+
+        const float4 new_pos[3] = {
+            x * m[0] + y * m[1] + z * m[2]  + m[3],
+            x * m[4] + y * m[5] + z * m[6]  + m[7],
+            x * m[8] + y * m[9] + z * m[10] + m[11]
+        };
+
+        alignas(16) float rounded[3][4];
+        for (uint32_t c = 0; c < 3; c++)
+            vmath::floor(vmath::min(vmath::max(new_pos[c], min_pos), max_pos) + half).store4_aligned(rounded[c]);
+
+        const uint32_t num_lanes = mstd::min(batch.count - i, 4U);
+
+        for (uint32_t lane = 0; lane < num_lanes; lane++) {
+            const uint32_t vtx = batch.ids[i + lane];
+
+            // Rounding up may only exceed the int16 range at 32767.5, which rounds to 32768
+            const Vertex vertex = {
+                {
+                    static_cast<int16_t>(mstd::min(static_cast<int32_t>(rounded[0][lane]), 32767)),
+                    static_cast<int16_t>(mstd::min(static_cast<int32_t>(rounded[1][lane]), 32767)),
+                    static_cast<int16_t>(mstd::min(static_cast<int32_t>(rounded[2][lane]), 32767))
+                },
+                0
+            };
+
+            if (deltas) {
+                VertexListDelta& delta = deltas[i + lane];
+                if ( ! existing) {
+                    delta.vtx        = vtx;
+                    delta.old_vertex = obj_vertices[vtx];
+                }
+                delta.new_vertex = vertex;
+            }
+
+            obj_vertices[vtx] = vertex;
+
+            vertex_grid.update_vertex(*this, vtx);
+        }
+    }
+
+    // Ids are ascending, so all vertices are in one range
+    mark_dirty(str_vertices, batch.ids[0], batch.ids[batch.count - 1] + 1 - batch.ids[0]);
+
+    // Rebuilding once before the next pick is cheaper than refitting on every step of a drag
+    bvh.invalidate();
+}
+
+void Sculptor::Geometry::store_vertex_list(const VertexListDelta* deltas, uint32_t count, bool new_vertices)
+{
+    if ( ! count)
+        return;
+
+    for (uint32_t i = 0; i < count; i++) {
+        assert(deltas[i].vtx < num_vertices);
+        obj_vertices[deltas[i].vtx] = new_vertices ? deltas[i].new_vertex : deltas[i].old_vertex;
+
+        vertex_grid.update_vertex(*this, deltas[i].vtx);
+    }
+
+    mark_dirty(str_vertices, deltas[0].vtx, deltas[count - 1].vtx + 1 - deltas[0].vtx);
+
+    bvh.invalidate();
+}
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_EXT_multiview: require
+#extension GL_GOOGLE_include_directive: require
+
+#define view_index gl_ViewIndex
+
+#include "sculptor_grid_frag.glsl"
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+// Draws a single triangle covering the whole viewport, the grid is computed per pixel
+
+layout(location = 0) out vec2 out_ndc;
+
+void main()
+{
+    const vec2 ndc = vec2(float((gl_VertexIndex & 1) * 4 - 1),
+                          float((gl_VertexIndex & 2) * 2 - 1));
+
+    gl_Position = vec4(ndc, 0, 1);
+    out_ndc     = ndc;
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by sculptor_grid.frag.glsl and sculptor_grid_single_view.frag.glsl,
+// which define view_index
+
+#include "sculptor_material.glsl"
+#include "transforms.glsl"
+
+// Intersects the view ray of each pixel with a grid plane through the origin and computes
+// anti-aliased grid lines at that point
+
+layout(location = 0) in  vec2 in_ndc;
+
+layout(location = 0) out vec4 out_color;
+
+// Distance between grid lines in object coordinates, same as 0x800 in int16 vertex coordinates
+const float grid_spacing = 2048.0 / 32767.0;
+
+// Distance from the camera in perspective view over which the grid fades out
+const float fade_begin = 1.0;
+const float fade_end   = 2.5;
+
+void main()
+{
+    const mat4 model_view = views[view_index].model_view;
+    const vec4 proj       = views[view_index].proj;
+    const vec4 proj_w     = views[view_index].proj_w;
+
+    // Inverse of the projection, the ray starts at the camera for perspective projection
+    // and on the camera plane for orthographic projection
+    const vec2 view_xy     = in_ndc / proj.xy;
+    const vec3 view_origin = vec3(view_xy * proj_w.w, 0);
+    const vec3 view_dir    = vec3(view_xy * proj_w.z, 1);
+
+    // Inverse of the view transform, which only contains rotation and translation
+    const mat3 rotation    = mat3(model_view);
+    const vec3 translation = vec3(model_view[0].w, model_view[1].w, model_view[2].w);
+    const vec3 origin      = rotation * (view_origin - translation);
+    const vec3 dir         = rotation * view_dir;
+
+    // The grid lies on the ground plane in perspective view and faces the camera in orthographic views
+    uint axis = 1;
+    if (proj_w.z == 0) {
+        const vec3 abs_dir = abs(dir);
+        axis = (abs_dir.x > abs_dir.y && abs_dir.x > abs_dir.z) ? 0 : (abs_dir.z > abs_dir.y) ? 2 : 1;
+    }
+
+    // Pixels whose ray misses the plane are discarded at the end, so that derivatives are valid
+    const float t        = -origin[axis] / dir[axis];
+    const vec3  obj_pos  = origin + t * dir;
+    const vec3  view_pos = (vec4(obj_pos, 1) * model_view).xyz;
+    const vec4  clip_pos = projection(view_pos);
+    const float depth    = clip_pos.z / clip_pos.w;
+
+    const vec2 grid_pos = ((axis == 0) ? obj_pos.yz : (axis == 1) ? obj_pos.xz : obj_pos.xy) / grid_spacing;
+
+    // Distance to the nearest line in pixels
+    const vec2 pixel_size = fwidth(grid_pos);
+    const vec2 line_dist  = abs(fract(grid_pos - 0.5) - 0.5) / pixel_size;
+    float      coverage   = 1 - min(min(line_dist.x, line_dist.y), 1);
+
+    // Lines closer than about two pixels apart alias, so fade them out instead
+    coverage *= 1 - smoothstep(0.25, 0.5, max(pixel_size.x, pixel_size.y));
+
+    if (proj_w.z != 0)
+        coverage *= 1 - smoothstep(fade_begin, fade_end, length(view_pos));
+
+    // Depth is reversed, near plane is at 1 and far plane at 0
+    if ( ! (t > 0) || ! (depth > 0 && depth <= 1) || ! (coverage > 0))
+        discard;
+
+    out_color    = vec4(diffuse_color.xyz, coverage);
+    gl_FragDepth = depth;
+}
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_GOOGLE_include_directive: require
+
+// Used on devices without multiview, only the first view is drawn
+#define view_index 0
+
+#include "sculptor_grid_frag.glsl"
@@ -0,0 +1,333 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_journal.h"
+
+#include "../d_printf.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+namespace {
+    // Type of records which begin steps, for these Record::first is the coalescing key
+    // and Record::count is the offset of the step record of the previous step
+    constexpr uint32_t step_record = 0;
+}
+
+bool Sculptor::EditJournal::allocate(uint32_t size)
+{
+    assert( ! arena);
+
+    arena = static_cast<uint8_t*>(malloc(size));
+    if ( ! arena) {
+        d_printf("Failed to allocate edit journal of %u bytes\n", size);
+        return false;
+    }
+
+    capacity = size;
+    clear();
+    return true;
+}
+
+void Sculptor::EditJournal::clear()
+{
+    assert(open_step == no_record);
+
+    oldest    = no_record;
+    latest    = no_record;
+    head      = 0;
+    undo_step = no_record;
+    redo_step = no_record;
+    overflow  = false;
+    coalesce  = false;
+}
+
+void Sculptor::EditJournal::begin_step(uint32_t coalesce_key)
+{
+    assert(open_step == no_record);
+
+    if ( ! arena)
+        return;
+
+    // Continue recording the last step, new changes of elements already in it only update them
+    if (coalesce_key && coalesce && undo_step != no_record && redo_step == no_record &&
+        get_record(undo_step)->first == coalesce_key) {
+
+        open_step = undo_step;
+        return;
+    }
+
+    // A new step discards all undone steps
+    if (redo_step != no_record)
+        truncate(redo_step);
+
+    const uint32_t offset = reserve(sizeof(Record));
+    assert(offset != no_record);
+
+    Record* const step = get_record(offset);
+    step->type  = step_record;
+    step->size  = sizeof(Record);
+    step->prev  = latest;
+    step->next  = no_record;
+    step->first = coalesce_key;
+    step->count = undo_step;
+
+    link(offset);
+
+    open_step = offset;
+}
+
+void Sculptor::EditJournal::end_step()
+{
+    if (open_step == no_record)
+        return;
+
+    const uint32_t step = open_step;
+    open_step = no_record;
+
+    // A step which did not fit is lost, so none of the steps before it can be undone either
+    if (overflow) {
+        d_printf("Edit journal overflow, discarding undo history\n");
+        clear();
+        return;
+    }
+
+    const Record* const step_rec = get_record(step);
+
+    if (step_rec->next == no_record) {
+        if (step != undo_step)
+            truncate(step);
+        coalesce = false;
+        return;
+    }
+
+    undo_step = step;
+    coalesce  = step_rec->first != 0;
+}
+
+Sculptor::EditJournal::Record* Sculptor::EditJournal::add_record(uint32_t type,
+                                                                 uint32_t first,
+                                                                 uint32_t count,
+                                                                 uint32_t elem_size)
+{
+    assert(type != step_record);
+    assert(elem_size % sizeof(uint32_t) == 0);
+
+    if ( ! is_recording())
+        return nullptr;
+
+    const uint32_t size   = static_cast<uint32_t>(sizeof(Record)) + count * elem_size;
+    const uint32_t offset = reserve(size);
+    if (offset == no_record) {
+        overflow = true;
+        return nullptr;
+    }
+
+    Record* const record = get_record(offset);
+    record->type  = type;
+    record->size  = size;
+    record->prev  = latest;
+    record->next  = no_record;
+    record->first = first;
+    record->count = count;
+
+    link(offset);
+
+    return record;
+}
+
+void* Sculptor::EditJournal::extend_record(uint32_t type, uint32_t idx, uint32_t elem_size)
+{
+    if ( ! is_recording() || latest == open_step)
+        return nullptr;
+
+    Record* const record = get_record(latest);
+    if (record->type != type || record->first + record->count != idx)
+        return nullptr;
+
+    // The last record can only grow into free space which directly follows it
+    const uint32_t end = latest + record->size + elem_size;
+    if (end > capacity || (oldest > latest && end > oldest))
+        return nullptr;
+
+    void* const elem = arena + latest + record->size;
+
+    record->size += elem_size;
+    ++record->count;
+    head = end;
+
+    return elem;
+}
+
+Sculptor::EditJournal::Record* Sculptor::EditJournal::find_record(uint32_t type, uint32_t idx)
+{
+    if ( ! is_recording())
+        return nullptr;
+
+    // The open step is always the last step
+    for (uint32_t offset = get_record(open_step)->next; offset != no_record; ) {
+        Record* const record = get_record(offset);
+
+        if (record->type == type && idx - record->first < record->count)
+            return record;
+
+        offset = record->next;
+    }
+
+    return nullptr;
+}
+
+const Sculptor::EditJournal::Record* Sculptor::EditJournal::begin_undo()
+{
+    if ( ! can_undo())
+        return nullptr;
+
+    const uint32_t step = undo_step;
+    const uint32_t next = get_next_step(step);
+
+    redo_step = step;
+    undo_step = get_record(step)->count;
+    coalesce  = false;
+
+    const uint32_t last = (next == no_record) ? latest : get_record(next)->prev;
+
+    return (last == step) ? nullptr : get_record(last);
+}
+
+const Sculptor::EditJournal::Record* Sculptor::EditJournal::next_undo(const Record* record) const
+{
+    assert(record->prev != no_record);
+
+    const Record* const prev = get_record(record->prev);
+
+    return (prev->type == step_record) ? nullptr : prev;
+}
+
+const Sculptor::EditJournal::Record* Sculptor::EditJournal::begin_redo()
+{
+    if ( ! can_redo())
+        return nullptr;
+
+    const uint32_t step = redo_step;
+
+    undo_step = step;
+    redo_step = get_next_step(step);
+    coalesce  = false;
+
+    return next_redo(get_record(step));
+}
+
+const Sculptor::EditJournal::Record* Sculptor::EditJournal::next_redo(const Record* record) const
+{
+    if (record->next == no_record)
+        return nullptr;
+
+    const Record* const next = get_record(record->next);
+
+    return (next->type == step_record) ? nullptr : next;
+}
+
+void Sculptor::EditJournal::link(uint32_t offset)
+{
+    if (latest != no_record)
+        get_record(latest)->next = offset;
+
+    if (oldest == no_record)
+        oldest = offset;
+
+    latest = offset;
+    head   = offset + get_record(offset)->size;
+}
+
+uint32_t Sculptor::EditJournal::reserve(uint32_t size)
+{
+    // Undone steps are discarded before anything new is recorded
+    assert(redo_step == no_record);
+
+    if (size > capacity)
+        return no_record;
+
+    uint32_t pos = head;
+
+    for (;;) {
+        if (oldest == no_record)
+            return (pos + size <= capacity) ? pos : 0;
+
+        // Free space extends to the end of the arena, or it wraps to the beginning
+        // and the rest of the arena is left unused
+        if (pos > oldest) {
+            if (pos + size <= capacity)
+                return pos;
+            pos = 0;
+            continue;
+        }
+
+        // Free space extends to the oldest step
+        if (pos + size <= oldest)
+            return pos;
+
+        if ( ! evict_oldest_step())
+            return no_record;
+    }
+}
+
+bool Sculptor::EditJournal::evict_oldest_step()
+{
+    // The step being recorded cannot be evicted
+    if (oldest == no_record || oldest == open_step)
+        return false;
+
+    const uint32_t next = get_next_step(oldest);
+
+    if (undo_step == oldest)
+        undo_step = no_record;
+
+    oldest = next;
+
+    if (next == no_record) {
+        latest = no_record;
+        head   = 0;
+    }
+    else {
+        Record* const step = get_record(next);
+        step->prev  = no_record;
+        step->count = no_record;
+    }
+
+    return true;
+}
+
+uint32_t Sculptor::EditJournal::get_next_step(uint32_t step) const
+{
+    uint32_t offset = get_record(step)->next;
+
+    while (offset != no_record) {
+        const Record* const record = get_record(offset);
+        if (record->type == step_record)
+            break;
+        offset = record->next;
+    }
+
+    return offset;
+}
+
+void Sculptor::EditJournal::truncate(uint32_t step)
+{
+    const uint32_t prev = get_record(step)->prev;
+
+    redo_step = no_record;
+
+    if (prev == no_record) {
+        oldest    = no_record;
+        latest    = no_record;
+        head      = 0;
+        undo_step = no_record;
+        return;
+    }
+
+    Record* const last = get_record(prev);
+    last->next = no_record;
+
+    latest = prev;
+    head   = prev + last->size;
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include <stdint.h>
+
+namespace Sculptor {
+
+// Undo/redo history stored as compact deltas in a ring arena of fixed size.
+// Each undoable step begins with a step record, which is followed by records describing
+// the changes made in that step.  The contents of records are defined by the user of the journal.
+// When the arena is full, the oldest steps are discarded to make space for new records.
+// Records are linked in both directions, so a step is undone or redone in time
+// proportional to the size of its records.
+class EditJournal {
+    public:
+        constexpr EditJournal() = default;
+        EditJournal(const EditJournal&)            = delete;
+        EditJournal& operator=(const EditJournal&) = delete;
+
+        static constexpr uint32_t no_record = ~0U;
+
+        struct Record {
+            uint32_t type;  // 0 for step records, other types are defined by the user
+            uint32_t size;  // Size in bytes including this header and the payload
+            uint32_t prev;  // Offset of the previous record
+            uint32_t next;  // Offset of the next record
+            uint32_t first; // First element changed
+            uint32_t count; // Number of elements changed
+
+            template<typename T>
+            T* get_payload() { return reinterpret_cast<T*>(this + 1); }
+            template<typename T>
+            const T* get_payload() const { return reinterpret_cast<const T*>(this + 1); }
+        };
+
+        bool allocate(uint32_t size);
+        bool is_allocated() const { return arena != nullptr; }
+        void clear();
+
+        // Steps with the same non-zero key are coalesced if no other step was recorded
+        // or undone in between, e.g. for continuous drags.  Steps without records are dropped.
+        void begin_step(uint32_t coalesce_key);
+        void end_step();
+        bool is_recording() const { return open_step != no_record && ! overflow; }
+
+        // Adds a record to the open step, returns null if the record doesn't fit,
+        // in which case the whole history is discarded when the step ends
+        Record* add_record(uint32_t type, uint32_t first, uint32_t count, uint32_t elem_size);
+
+        // Appends one element to the last record of the open step if the record has the given type
+        // and its elements are followed by element idx, returns the new element or null
+        void* extend_record(uint32_t type, uint32_t idx, uint32_t elem_size);
+
+        // Finds a record of the open step with the given type which contains element idx
+        Record* find_record(uint32_t type, uint32_t idx);
+
+        bool can_undo() const { return undo_step != no_record && open_step == no_record; }
+        bool can_redo() const { return redo_step != no_record && open_step == no_record; }
+
+        // Undo visits records of the last step from the last to the first, redo visits records
+        // of the next step from the first to the last, both return null after the last record
+        const Record* begin_undo();
+        const Record* next_undo(const Record* record) const;
+        const Record* begin_redo();
+        const Record* next_redo(const Record* record) const;
+
+    private:
+        Record*       get_record(uint32_t offset)       { return reinterpret_cast<Record*>(arena + offset); }
+        const Record* get_record(uint32_t offset) const { return reinterpret_cast<const Record*>(arena + offset); }
+
+        void     link(uint32_t offset);
+        uint32_t reserve(uint32_t size);
+        bool     evict_oldest_step();
+        uint32_t get_next_step(uint32_t step) const;
+        void     truncate(uint32_t step);
+
+        uint8_t* arena     = nullptr;
+        uint32_t capacity  = 0;
+        uint32_t oldest    = no_record; // Step record of the oldest step
+        uint32_t latest    = no_record; // Last record written
+        uint32_t head      = 0;         // Where the next record is written
+        uint32_t undo_step = no_record; // Step record of the last applied step
+        uint32_t redo_step = no_record; // Step record of the first undone step
+        uint32_t open_step = no_record; // Step record of the step being recorded
+        bool     overflow  = false;     // The open step did not fit
+        bool     coalesce  = false;     // The last step can be continued
+};
+
+}
@@ -12,8 +12,25 @@
 VkDescriptorSetLayout Sculptor::desc_set_layout[3];
 VkPipelineLayout      Sculptor::material_layout;
 
+bool Sculptor::use_mesh_shading()
+{
+    // Task and mesh shaders select transforms by view index and require multiview
+    return vk_mesh_shader_features.taskShader && vk_mesh_shader_features.meshShader &&
+           vk_multiview_features.multiview;
+}
+
+bool Sculptor::use_material_textures()
+{
+    return vk_desc_indexing_features.descriptorBindingPartiallyBound &&
+           vk_desc_indexing_features.shaderSampledImageArrayNonUniformIndexing;
+}
+
 bool Sculptor::create_material_layouts()
 {
+    // Stages of the mesh shader extension can only be used if it is enabled
+    const VkShaderStageFlags mesh_stages = use_mesh_shading()
+        ? (VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT) : 0U;
+
     {
         static const VkDescriptorSetLayoutCreateInfo create_empty_set_layout = {
             VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
@@ -32,24 +49,58 @@ bool Sculptor::create_material_layouts()
     }
 
     {
-        static const VkDescriptorSetLayoutBinding per_object_set[] = {
+        static VkDescriptorSetLayoutBinding per_object_set[] = {
             {
                 0, // binding 0: uniform buffer with materials
                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                 1,
                 VK_SHADER_STAGE_FRAGMENT_BIT,
                 nullptr
+            },
+            {
+                1, // binding 1: storage buffer with patch materials, indexed by material id of each face
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
+            },
+            {
+                2, // binding 2: textures of patch materials, indexed by texture id of each material
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                max_material_textures,
+                VK_SHADER_STAGE_FRAGMENT_BIT,
+                nullptr
             }
         };
 
-        static const VkDescriptorSetLayoutCreateInfo create_per_object_set_layout = {
-            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        // Only textures used by materials are written to the texture array
+        static const VkDescriptorBindingFlags binding_flags[] = {
+            0,
+            0,
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+        };
+
+        static const VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
             nullptr,
+            mstd::array_size(binding_flags),
+            binding_flags
+        };
+
+        static VkDescriptorSetLayoutCreateInfo create_per_object_set_layout = {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            &binding_flags_info,
             0, // flags
             mstd::array_size(per_object_set),
             per_object_set
         };
 
+        // Without descriptor indexing, the texture array has no descriptors
+        if ( ! use_material_textures()) {
+            per_object_set[2].descriptorCount  = 0;
+            create_per_object_set_layout.pNext = nullptr;
+        }
+
         const VkResult res = CHK(vkCreateDescriptorSetLayout(vk_dev,
                                                              &create_per_object_set_layout,
                                                              nullptr,
@@ -59,13 +110,15 @@ bool Sculptor::create_material_layouts()
     }
 
     {
-        static const VkDescriptorSetLayoutBinding per_object_set[] = {
+        static VkDescriptorSetLayoutBinding per_object_set[] = {
             {
                 0, // binding 0: uniform buffer with transforms
                 VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                 1,
                 VK_SHADER_STAGE_VERTEX_BIT
-                    | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+                    | VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT
+                    | VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT
+                    | VK_SHADER_STAGE_FRAGMENT_BIT,
                 nullptr
             },
             {
@@ -92,8 +145,42 @@ bool Sculptor::create_material_layouts()
                 VK_SHADER_STAGE_VERTEX_BIT,
                 nullptr
             },
+            {
+                4, // binding 4: storage buffer with face ids of patches which survived culling
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                1,
+                VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT,
+                nullptr
+            },
+            {
+                5, // binding 5: storage buffer with patch indices, stages are set below
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                0,
+                nullptr
+            },
+            {
+                6, // binding 6: storage buffer with hovered vertex and vertex selection bits
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                1,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                nullptr
+            },
+            {
+                7, // binding 7: storage buffer with ids of vertices which survived culling
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+                1,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                nullptr
+            },
         };
 
+        // Task and mesh shaders read control points directly and also need transforms and face data
+        per_object_set[0].stageFlags |= mesh_stages;
+        per_object_set[1].stageFlags |= mesh_stages;
+        per_object_set[3].stageFlags |= mesh_stages;
+        per_object_set[5].stageFlags |= mesh_stages;
+
         static const VkDescriptorSetLayoutCreateInfo create_per_object_set_layout = {
             VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
             nullptr,
@@ -111,6 +198,13 @@ bool Sculptor::create_material_layouts()
     }
 
     {
+        // Number of faces for the task shader
+        static const VkPushConstantRange push_constant_range = {
+            VK_SHADER_STAGE_TASK_BIT_EXT,
+            0,                  // offset
+            sizeof(uint32_t)    // size
+        };
+
         static VkPipelineLayoutCreateInfo layout_create_info = {
             VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             nullptr,
@@ -121,6 +215,11 @@ bool Sculptor::create_material_layouts()
             nullptr // pPushConstantRanges
         };
 
+        if (mesh_stages) {
+            layout_create_info.pushConstantRangeCount = 1;
+            layout_create_info.pPushConstantRanges    = &push_constant_range;
+        }
+
         const VkResult res = CHK(vkCreatePipelineLayout(vk_dev,
                                                         &layout_create_info,
                                                         nullptr,
@@ -175,6 +274,11 @@ bool Sculptor::create_material(const MaterialInfo& mat_info, VkPipeline* pipelin
         }
     };
 
+    // Mesh shading materials replace the vertex shader with a mesh shader and the tessellation
+    // control shader with a task shader
+    shader_stages[0].stage = mat_info.mesh_shading ? VK_SHADER_STAGE_MESH_BIT_EXT : VK_SHADER_STAGE_VERTEX_BIT;
+    shader_stages[2].stage = mat_info.mesh_shading ? VK_SHADER_STAGE_TASK_BIT_EXT : VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+
     uint32_t num_stages;
     for (num_stages = 0; num_stages < mstd::array_size(mat_info.shader_ids); num_stages++) {
         uint8_t* const shader = mat_info.shader_ids[num_stages];
@@ -297,6 +401,11 @@ bool Sculptor::create_material(const MaterialInfo& mat_info, VkPipeline* pipelin
         VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT
     };
 
+    // Alpha output by the fragment shader is coverage
+    color_blend_att.blendEnable         = mat_info.alpha_blend;
+    color_blend_att.srcColorBlendFactor = mat_info.alpha_blend ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ZERO;
+    color_blend_att.dstColorBlendFactor = mat_info.alpha_blend ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO;
+
     static VkPipelineColorBlendStateCreateInfo color_blend_state = {
         VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
         nullptr,
@@ -337,6 +446,7 @@ bool Sculptor::create_material(const MaterialInfo& mat_info, VkPipeline* pipelin
         ? swapchain_create_info.imageFormat
         : static_cast<VkFormat>(mat_info.color_format);
 
+    rendering_info.viewMask              = mat_info.view_mask;
     rendering_info.depthAttachmentFormat = vk_depth_format;
 
     static VkGraphicsPipelineCreateInfo pipeline_create_info = {
@@ -9,6 +9,14 @@ namespace Sculptor {
 
 bool create_material_layouts();
 
+// Patches are culled and evaluated in task and mesh shaders instead of tessellation shaders
+// if the device supports them and multiview
+bool use_mesh_shading();
+
+// Textures of patch materials are in a partially bound array indexed per face,
+// so they are only used if the device supports this kind of descriptor indexing
+bool use_material_textures();
+
 extern VkDescriptorSetLayout desc_set_layout[3];
 extern VkPipelineLayout      material_layout;
 
@@ -26,6 +34,9 @@ struct MaterialInfo {
     uint8_t                                  depth_test;
     uint8_t                                  depth_write;
     uint8_t                                  diffuse_color[3];
+    uint8_t                                  mesh_shading; // Shaders are mesh, fragment and task
+    uint8_t                                  alpha_blend;
+    uint8_t                                  view_mask;    // Views drawn with multiview, 0 without multiview
 };
 
 bool create_material(const MaterialInfo& mat_info, VkPipeline* pipeline);
@@ -34,4 +45,16 @@ struct ShaderMaterial {
     float diffuse_color[4];
 };
 
+// Parameters of all patch materials are in one storage buffer, so patches with different
+// materials are drawn in a single draw call
+constexpr uint32_t max_patch_materials   = 256;
+constexpr uint32_t max_material_textures = 64;
+constexpr uint32_t no_texture            = ~0U;
+
+struct PatchMaterial {
+    float    diffuse_color[4];
+    uint32_t texture_id; // Index into the texture array or no_texture
+    uint32_t padding[3];
+};
+
 }
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by task and mesh shaders, requires bezier_cubic_data.glsl
+
+// Number of patches processed by one task shader workgroup
+const uint patches_per_task = 32;
+
+// Each mesh shader workgroup emits one tile of a patch with up to this many quads along each side
+const uint tile_quads = 8;
+
+struct patch_task {
+    uint face_id;
+    uint inner_levels; // Levels along u and v in consecutive bytes
+    uint edge_levels;  // Levels of edges u = 0, v = 0, u = 1, v = 1 in consecutive bytes
+    uint first_tile;   // Index of the first mesh shader workgroup of the patch
+};
+
+struct task_payload {
+    patch_task patches[patches_per_task];
+    uint       num_patches;
+};
+
+taskPayloadSharedEXT task_payload payload;
+
+layout(set = 2, binding = 3) readonly buffer patch_vertices {
+    uvec2 vertex_pos[]; // int16 x, y, z and unused
+};
+
+layout(set = 2, binding = 5) readonly buffer patch_indices {
+    uint indices[]; // 16-bit indices are packed in pairs
+};
+
+uint get_index(uint face_id, uint i)
+{
+    if ((tess_level.w & 2) != 0)
+        return indices[face_id * 16 + i];
+
+    const uint pair = indices[face_id * 8 + i / 2];
+    return ((i & 1) != 0) ? (pair >> 16) : (pair & 0xFFFF);
+}
+
+vec3 get_obj_pos(uint vtx)
+{
+    const uvec2 packed_pos = vertex_pos[vtx];
+
+    // Sign-extend int16 components
+    const ivec3 pos = ivec3(int(packed_pos.x << 16) >> 16,
+                            int(packed_pos.x) >> 16,
+                            int(packed_pos.y << 16) >> 16);
+
+    // Same conversion as VK_FORMAT_R16G16B16_SNORM
+    return max(vec3(pos) / 32767.0, -1.0);
+}
+
+uint get_level(uint levels, uint i)
+{
+    return (levels >> (i * 8)) & 0xFF;
+}
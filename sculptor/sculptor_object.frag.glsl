@@ -3,28 +3,9 @@
 
 #version 460 core
 
+#extension GL_EXT_nonuniform_qualifier: require
 #extension GL_GOOGLE_include_directive: require
 
-#include "bezier_cubic_data.glsl"
+#define MATERIAL_TEXTURES
 
-layout(location = 0) in  vec4      in_pos;
-layout(location = 1) in  vec3      in_normal;
-layout(location = 2) in  flat uint in_object_id;
-
-layout(location = 0) out vec4      out_color;
-
-void main()
-{
-    vec3 color = vec3(0.5, 0.5, 0.5);
-
-    const uint state = faces[in_object_id].state;
-
-    if (state == 1)
-        color *= vec3(1.2, 1.1, 1.1);
-    else if (state == 2)
-        color *= vec3(1, 1, 1.4);
-
-    out_color = vec4(color, 1);
-
-    gl_FragDepth = in_pos.w;
-}
+#include "sculptor_object.glsl"
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by sculptor_object.frag.glsl and sculptor_object_untextured.frag.glsl,
+// material textures are only sampled if MATERIAL_TEXTURES is defined
+
+#include "bezier_cubic_data.glsl"
+
+layout(location = 0) in  vec4      in_pos;
+layout(location = 1) in  vec3      in_normal;
+layout(location = 2) in  flat uint in_object_id;
+layout(location = 3) in  vec2      in_uv;
+
+layout(location = 0) out vec4      out_color;
+
+struct patch_material {
+    vec4 diffuse_color;
+    uint texture_id;    // Index into material_textures, ~0 if the material has no texture
+};
+
+layout(set = 1, binding = 1) readonly buffer patch_materials {
+    patch_material materials[];
+};
+
+#ifdef MATERIAL_TEXTURES
+layout(set = 1, binding = 2) uniform sampler2D material_textures[64];
+#endif
+
+void main()
+{
+    const patch_material material = materials[faces[in_object_id].material_id];
+
+    vec3 color = material.diffuse_color.xyz;
+
+#ifdef MATERIAL_TEXTURES
+    // Faces with different materials are drawn together, so the index is not uniform
+    if (material.texture_id != ~0U)
+        color *= texture(material_textures[nonuniformEXT(material.texture_id)], in_uv).xyz;
+#endif
+
+    const uint state = faces[in_object_id].state;
+
+    if (state == 1)
+        color *= vec3(1.2, 1.1, 1.1);
+    else if (state == 2)
+        color *= vec3(1, 1, 1.4);
+
+    out_color = vec4(color, 1);
+
+    gl_FragDepth = in_pos.w;
+}
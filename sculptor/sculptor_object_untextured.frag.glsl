@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_GOOGLE_include_directive: require
+
+// Used on devices without non-uniform indexing of partially bound texture arrays,
+// patches still have per-face materials, but without textures
+#include "sculptor_object.glsl"
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_EXT_mesh_shader: require
+#extension GL_EXT_multiview: require
+#extension GL_GOOGLE_include_directive: require
+
+#define view_index gl_ViewIndex
+
+#include "bezier_cubic_data.glsl"
+#include "transforms.glsl"
+#include "sculptor_mesh_patch.glsl"
+
+// Evaluates one tile of a patch into a grid of triangles, outputs match the tessellation evaluation shader.
+// Vertices on patch edges are snapped to the edge's level, so patches sharing an edge produce
+// the same vertices on it and don't produce cracks, even when their inner levels differ.
+
+const uint max_tile_vertices  = (tile_quads + 1) * (tile_quads + 1);
+const uint max_tile_triangles = tile_quads * tile_quads * 2;
+
+layout(local_size_x = max_tile_triangles) in;
+layout(triangles, max_vertices = max_tile_vertices, max_primitives = max_tile_triangles) out;
+
+layout(location = 0) out vec4      out_pos[];
+layout(location = 1) out vec3      out_normal[];
+layout(location = 2) out flat uint out_object_id[];
+layout(location = 3) out vec2      out_uv[];
+
+shared vec3 ctrl[16];
+
+// Snaps a vertex index along a patch edge with the inner level to the nearest vertex with the edge's level
+float edge_coord(uint i, uint level, uint edge_level)
+{
+    const uint snapped = (i * edge_level * 2 + level) / (level * 2);
+    return float(snapped) / float(edge_level);
+}
+
+void main()
+{
+    // Find the patch to which this tile belongs
+    uint slot = 0;
+    while (slot + 1 < payload.num_patches && payload.patches[slot + 1].first_tile <= gl_WorkGroupID.x)
+        ++slot;
+
+    const patch_task task    = payload.patches[slot];
+    const uint       level_u = get_level(task.inner_levels, 0);
+    const uint       level_v = get_level(task.inner_levels, 1);
+    const uint       tiles_u = (level_u + tile_quads - 1) / tile_quads;
+    const uint       tile    = gl_WorkGroupID.x - task.first_tile;
+    const uint       first_u = (tile % tiles_u) * tile_quads;
+    const uint       first_v = (tile / tiles_u) * tile_quads;
+    const uint       quads_u = min(level_u - first_u, tile_quads);
+    const uint       quads_v = min(level_v - first_v, tile_quads);
+    const uint       side    = quads_u + 1;
+
+    if (gl_LocalInvocationIndex < 16)
+        ctrl[gl_LocalInvocationIndex] = get_obj_pos(get_index(task.face_id, gl_LocalInvocationIndex));
+
+    barrier();
+
+    SetMeshOutputsEXT(side * (quads_v + 1), quads_u * quads_v * 2);
+
+    const uint vtx = gl_LocalInvocationIndex;
+
+    if (vtx < side * (quads_v + 1)) {
+        const uint iu = first_u + vtx % side;
+        const uint iv = first_v + vtx / side;
+
+        vec2 coord = vec2(float(iu) / float(level_u), float(iv) / float(level_v));
+
+        if (iu == 0)
+            coord.y = edge_coord(iv, level_v, get_level(task.edge_levels, 0));
+        else if (iu == level_u)
+            coord.y = edge_coord(iv, level_v, get_level(task.edge_levels, 2));
+
+        if (iv == 0)
+            coord.x = edge_coord(iu, level_u, get_level(task.edge_levels, 1));
+        else if (iv == level_v)
+            coord.x = edge_coord(iu, level_u, get_level(task.edge_levels, 3));
+
+        // Same evaluation as in the tessellation evaluation shader
+        vec3 p[4];
+        for (uint i = 0; i < 4; i++) {
+            p[i] = bezier_curve_cubic(ctrl[i * 4],
+                                      ctrl[i * 4 + 1],
+                                      ctrl[i * 4 + 2],
+                                      ctrl[i * 4 + 3],
+                                      coord.x);
+        }
+
+        const vec3 obj_pos  = bezier_curve_cubic(p[0], p[1], p[2], p[3], coord.y);
+        const vec4 view_pos = vec4(obj_pos, 1) * views[view_index].model_view;
+        const vec4 clip_pos = projection(view_pos.xyz);
+
+        gl_MeshVerticesEXT[vtx].gl_Position = clip_pos;
+        out_pos[vtx] = vec4(view_pos.xyz, clip_pos.z / clip_pos.w);
+
+        const vec3 du = bezier_derivative_cubic(p[0], p[1], p[2], p[3], coord.y);
+
+        for (uint i = 0; i < 4; i++) {
+            p[i] = bezier_curve_cubic(ctrl[i],
+                                      ctrl[i + 4],
+                                      ctrl[i + 8],
+                                      ctrl[i + 12],
+                                      coord.y);
+        }
+        const vec3 dv = bezier_derivative_cubic(p[0], p[1], p[2], p[3], coord.x);
+
+        const vec3 obj_normal = cross(dv, du);
+        out_normal[vtx] = normalize(obj_normal) * mat3(views[view_index].model_view_normal);
+
+        out_object_id[vtx] = task.face_id;
+
+        out_uv[vtx] = coord;
+    }
+
+    // Triangles are counter-clockwise in the (u, v) domain like with the tessellator
+    const uint tri = gl_LocalInvocationIndex;
+
+    if (tri < quads_u * quads_v * 2) {
+        const uint quad = tri / 2;
+        const uint i00  = (quad / quads_u) * side + quad % quads_u;
+        const uint i10  = i00 + 1;
+        const uint i01  = i00 + side;
+        const uint i11  = i01 + 1;
+
+        gl_PrimitiveTriangleIndicesEXT[tri] = ((tri & 1) == 0) ? uvec3(i00, i10, i11)
+                                                               : uvec3(i00, i11, i01);
+    }
+}
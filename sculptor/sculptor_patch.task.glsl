@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_EXT_mesh_shader: require
+#extension GL_EXT_multiview: require
+#extension GL_GOOGLE_include_directive: require
+
+#define view_index gl_ViewIndex
+
+#include "bezier_cubic_data.glsl"
+#include "transforms.glsl"
+#include "patch_level.glsl"
+#include "patch_cull.glsl"
+#include "sculptor_mesh_patch.glsl"
+
+// Culls patches and computes their tessellation levels, then launches one mesh shader
+// workgroup for each tile of each visible patch.  With multiview, patches are culled
+// and tessellated for each view separately.
+
+layout(push_constant) uniform push_constants {
+    uint num_faces;
+} push;
+
+layout(local_size_x = patches_per_task) in;
+
+shared uint num_visible;
+shared uint tile_counts[patches_per_task];
+shared uint num_tiles;
+
+void main()
+{
+    if (gl_LocalInvocationIndex == 0)
+        num_visible = 0;
+
+    barrier();
+
+    const uint face_id = gl_GlobalInvocationID.x;
+
+    if (face_id < push.num_faces) {
+        const view_transforms view = views[view_index];
+
+        vec3 obj_pos[16];
+        vec3 view_pos[16];
+        for (uint i = 0; i < 16; i++) {
+            obj_pos[i]  = get_obj_pos(get_index(face_id, i));
+            view_pos[i] = (vec4(obj_pos[i], 1) * view.model_view).xyz;
+        }
+
+        if ( ! outside_frustum(view_pos, view.proj, view.proj_w) && ! back_facing(view_pos, view.proj_w.z != 0)) {
+            vec2 p[16];
+            for (uint i = 0; i < 16; i++)
+                p[i] = project_to_screen(obj_pos[i]);
+
+            // Same levels as in the tessellation control shader
+            float row_level[4];
+            float col_level[4];
+            for (uint i = 0; i < 4; i++) {
+                row_level[i] = curve_level(p[i * 4], p[i * 4 + 1], p[i * 4 + 2], p[i * 4 + 3]);
+                col_level[i] = curve_level(p[i], p[i + 4], p[i + 8], p[i + 12]);
+            }
+
+            const float max_level = float(tess_level.y);
+
+            const uint edge_u0 = uint(clamp(ceil(col_level[0]), 1, max_level));
+            const uint edge_v0 = uint(clamp(ceil(row_level[0]), 1, max_level));
+            const uint edge_u1 = uint(clamp(ceil(col_level[3]), 1, max_level));
+            const uint edge_v1 = uint(clamp(ceil(row_level[3]), 1, max_level));
+
+            // Inner levels are never lower than levels of the edges in the same direction
+            const float inner_u = max(max(row_level[0], row_level[1]), max(row_level[2], row_level[3]));
+            const float inner_v = max(max(col_level[0], col_level[1]), max(col_level[2], col_level[3]));
+
+            const uint level_u = uint(clamp(ceil(inner_u), 1, max_level));
+            const uint level_v = uint(clamp(ceil(inner_v), 1, max_level));
+
+            const uint slot = atomicAdd(num_visible, 1);
+
+            payload.patches[slot].face_id      = face_id;
+            payload.patches[slot].inner_levels = level_u | (level_v << 8);
+            payload.patches[slot].edge_levels  = edge_u0 | (edge_v0 << 8) | (edge_u1 << 16) | (edge_v1 << 24);
+
+            tile_counts[slot] = ((level_u + tile_quads - 1) / tile_quads) *
+                                ((level_v + tile_quads - 1) / tile_quads);
+        }
+    }
+
+    barrier();
+
+    if (gl_LocalInvocationIndex == 0) {
+        uint first_tile = 0;
+        for (uint i = 0; i < num_visible; i++) {
+            payload.patches[i].first_tile = first_tile;
+            first_tile += tile_counts[i];
+        }
+
+        payload.num_patches = num_visible;
+        num_tiles           = first_tile;
+    }
+
+    barrier();
+
+    EmitMeshTasksEXT(num_tiles, 1, 1);
+}
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_GOOGLE_include_directive: require
+
+#include "patch_cull.glsl"
+
+// Culls patches against the view frustum and removes back-facing patches,
+// then compacts patch indices of the remaining patches for an indirect draw.
+// With multiple views, which are drawn with multiview, a patch is kept if it
+// is visible in any of the views.  Vertices of patches are marked for culling
+// of vertex handles, which follows.
+
+layout(push_constant) uniform push_constants {
+    uint num_faces;
+    uint wide_indices;  // 0: 16-bit indices, 1: 32-bit indices
+    uint backface_cull;
+    uint num_views;
+    uint num_vertices;
+} push;
+
+layout(set = 0, binding = 0) readonly buffer vertices {
+    uvec2 vertex_pos[]; // int16 x, y, z and unused
+};
+
+layout(set = 0, binding = 1) readonly buffer patch_indices {
+    uint indices[]; // 16-bit indices are packed in pairs
+};
+
+layout(set = 0, binding = 2) buffer draw_command {
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int  vertex_offset;
+    uint first_instance;
+};
+
+layout(set = 0, binding = 3) writeonly buffer visible_faces {
+    uint visible_face_ids[]; // Face id of each patch in the compacted index buffer
+};
+
+layout(set = 0, binding = 4) writeonly buffer culled_indices {
+    uint out_indices[];
+};
+
+struct cull_view {
+    mat4 model_view;
+    vec4 proj;
+    vec4 proj_w;        // perspective: [0, 0, 1, 0], orthographic: [0, 0, 0, 1]
+};
+
+layout(set = 0, binding = 5) readonly buffer cull_views {
+    cull_view views[];
+};
+
+layout(set = 0, binding = 6) buffer vertex_marks {
+    uint marks[];       // Bits of vertices of visible patches, followed by bits of vertices used by patches
+};
+
+layout(local_size_x = 64) in;
+
+uint get_index(uint face_id, uint i)
+{
+    if (push.wide_indices != 0)
+        return indices[face_id * 16 + i];
+
+    const uint pair = indices[face_id * 8 + i / 2];
+    return ((i & 1) != 0) ? (pair >> 16) : (pair & 0xFFFF);
+}
+
+vec3 get_obj_pos(uint vtx)
+{
+    const uvec2 packed_pos = vertex_pos[vtx];
+
+    // Sign-extend int16 components
+    const ivec3 pos = ivec3(int(packed_pos.x << 16) >> 16,
+                            int(packed_pos.x) >> 16,
+                            int(packed_pos.y << 16) >> 16);
+
+    // Same conversion as VK_FORMAT_R16G16B16_SNORM
+    return max(vec3(pos) / 32767.0, -1.0);
+}
+
+bool is_visible(vec3 obj_pos[16], uint view_idx)
+{
+    const cull_view view = views[view_idx];
+
+    vec3 view_pos[16];
+    for (uint i = 0; i < 16; i++)
+        view_pos[i] = (vec4(obj_pos[i], 1) * view.model_view).xyz;
+
+    if (outside_frustum(view_pos, view.proj, view.proj_w))
+        return false;
+
+    if (push.backface_cull != 0 && back_facing(view_pos, view.proj_w.z != 0))
+        return false;
+
+    return true;
+}
+
+void main()
+{
+    if (gl_GlobalInvocationID.x == 0)
+        instance_count = 1;
+
+    if (gl_GlobalInvocationID.x >= push.num_faces)
+        return;
+
+    const uint face_id = gl_GlobalInvocationID.x;
+
+    uint vtx_ids[16];
+    vec3 obj_pos[16];
+    for (uint i = 0; i < 16; i++) {
+        vtx_ids[i] = get_index(face_id, i);
+        obj_pos[i] = get_obj_pos(vtx_ids[i]);
+    }
+
+    bool visible = false;
+    for (uint view_idx = 0; view_idx < push.num_views && ! visible; view_idx++)
+        visible = is_visible(obj_pos, view_idx);
+
+    const uint num_words = (push.num_vertices + 31) / 32;
+
+    for (uint i = 0; i < 16; i++) {
+        const uint vtx = vtx_ids[i];
+        const uint bit = 1u << (vtx % 32);
+
+        atomicOr(marks[num_words + vtx / 32], bit);
+        if (visible)
+            atomicOr(marks[vtx / 32], bit);
+    }
+
+    if ( ! visible)
+        return;
+
+    const uint patch_id = atomicAdd(index_count, 16) / 16;
+
+    visible_face_ids[patch_id] = face_id;
+
+    if (push.wide_indices != 0) {
+        for (uint i = 0; i < 16; i++)
+            out_indices[patch_id * 16 + i] = indices[face_id * 16 + i];
+    }
+    else {
+        for (uint i = 0; i < 8; i++)
+            out_indices[patch_id * 8 + i] = indices[face_id * 8 + i];
+    }
+}
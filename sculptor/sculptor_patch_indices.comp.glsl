@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+// Generates 16 patch indices and face state for each face from face and edge tables
+
+layout(push_constant) uniform push_constants {
+    uint first_face;
+    uint num_faces;
+    uint hovered_face;
+    uint wide_indices;  // 0: 16-bit indices, 1: 32-bit indices
+} push;
+
+struct face_record {
+    ivec4 edges;        // Negative edge index -e-1 means that edge e is reversed
+    uvec4 ctrl_vertices;
+    uint  material_id;
+    uint  selected;
+};
+
+struct face_data {
+    uint material_id;
+    uint state; // 0: default, 1: hovered, 2: selected
+};
+
+layout(set = 0, binding = 0) readonly buffer face_records {
+    face_record records[];
+};
+
+layout(set = 0, binding = 1) readonly buffer edge_indices {
+    uvec4 edges[];
+};
+
+layout(set = 0, binding = 2) writeonly buffer patch_indices {
+    uint indices[]; // 16-bit indices are packed in pairs
+};
+
+layout(set = 0, binding = 3) writeonly buffer faces_data {
+    ivec4     tess_level;
+    face_data faces[];
+};
+
+layout(local_size_x = 64) in;
+
+const uint idx_map[16] = uint[](
+     0,  1,  2,  3,
+     0,  4,  8, 12,
+     3,  7, 11, 15,
+    12, 13, 14, 15
+);
+
+void main()
+{
+    if (gl_GlobalInvocationID.x >= push.num_faces)
+        return;
+
+    const uint        face_id = push.first_face + gl_GlobalInvocationID.x;
+    const face_record face    = records[face_id];
+
+    uint idx[16];
+
+    // Indices for the edges; note the indices of corners overlap
+    for (uint i_edge = 0; i_edge < 4; i_edge++) {
+        const int   edge_sel     = face.edges[i_edge];
+        const bool  inverse_edge = edge_sel < 0;
+        const uvec4 edge         = edges[inverse_edge ? (-edge_sel - 1) : edge_sel];
+
+        for (uint i_idx = 0; i_idx < 4; i_idx++)
+            idx[idx_map[i_edge * 4 + i_idx]] = edge[inverse_edge ? (3 - i_idx) : i_idx];
+    }
+
+    // 4 center indices which control the face, which are not included in edges
+    idx[5]  = face.ctrl_vertices.x;
+    idx[6]  = face.ctrl_vertices.y;
+    idx[9]  = face.ctrl_vertices.z;
+    idx[10] = face.ctrl_vertices.w;
+
+    if (push.wide_indices != 0) {
+        for (uint i = 0; i < 16; i++)
+            indices[face_id * 16 + i] = idx[i];
+    }
+    else {
+        for (uint i = 0; i < 8; i++)
+            indices[face_id * 8 + i] = idx[i * 2] | (idx[i * 2 + 1] << 16);
+    }
+
+    faces[face_id].material_id = face.material_id;
+    faces[face_id].state       = (face_id == push.hovered_face) ? 1 : ((face.selected != 0) ? 2 : 0);
+}
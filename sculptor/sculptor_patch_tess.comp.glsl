@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_GOOGLE_include_directive: require
+
+#include "bezier_cubic.glsl"
+
+// Evaluates Bezier patches into a triangle mesh, for devices without tessellation shaders.
+// Each invocation produces one vertex of a patch and the two triangles of one quad.
+
+layout(push_constant) uniform push_constants {
+    uint first_face;
+    uint num_faces;
+    uint wide_indices;  // 0: 16-bit indices, 1: 32-bit indices
+    uint tess_level;    // Number of quads along each side of a patch
+} push;
+
+layout(set = 0, binding = 0) readonly buffer vertices {
+    uvec2 vertex_pos[]; // int16 x, y, z and unused
+};
+
+layout(set = 0, binding = 1) readonly buffer patch_indices {
+    uint indices[]; // 16-bit indices are packed in pairs
+};
+
+struct tess_vertex {
+    vec3  pos;
+    uint  face_id;
+    vec3  normal;
+    uint  uv;       // u and v as 16-bit unorm
+};
+
+layout(set = 0, binding = 2) writeonly buffer tess_vertices {
+    tess_vertex out_vertices[];
+};
+
+layout(set = 0, binding = 3) writeonly buffer tess_indices {
+    uint out_indices[];
+};
+
+layout(local_size_x = 64) in;
+
+uint get_index(uint face_id, uint i)
+{
+    if (push.wide_indices != 0)
+        return indices[face_id * 16 + i];
+
+    const uint pair = indices[face_id * 8 + i / 2];
+    return ((i & 1) != 0) ? (pair >> 16) : (pair & 0xFFFF);
+}
+
+vec3 get_obj_pos(uint vtx)
+{
+    const uvec2 packed_pos = vertex_pos[vtx];
+
+    // Sign-extend int16 components
+    const ivec3 pos = ivec3(int(packed_pos.x << 16) >> 16,
+                            int(packed_pos.x) >> 16,
+                            int(packed_pos.y << 16) >> 16);
+
+    // Same conversion as VK_FORMAT_R16G16B16_SNORM
+    return max(vec3(pos) / 32767.0, -1.0);
+}
+
+void main()
+{
+    const uint level           = push.tess_level;
+    const uint side            = level + 1;
+    const uint verts_per_patch = side * side;
+
+    if (gl_GlobalInvocationID.x >= push.num_faces * verts_per_patch)
+        return;
+
+    const uint face_id   = push.first_face + gl_GlobalInvocationID.x / verts_per_patch;
+    const uint local_idx = gl_GlobalInvocationID.x % verts_per_patch;
+    const uint iu        = local_idx % side;
+    const uint iv        = local_idx / side;
+    const vec2 coord     = vec2(iu, iv) / float(level);
+
+    vec3 ctrl[16];
+    for (uint i = 0; i < 16; i++)
+        ctrl[i] = get_obj_pos(get_index(face_id, i));
+
+    // Same evaluation as in the tessellation evaluation shader
+    vec3 p[4];
+    for (uint i = 0; i < 4; i++) {
+        p[i] = bezier_curve_cubic(ctrl[i * 4],
+                                  ctrl[i * 4 + 1],
+                                  ctrl[i * 4 + 2],
+                                  ctrl[i * 4 + 3],
+                                  coord.x);
+    }
+
+    const vec3 obj_pos = bezier_curve_cubic(p[0], p[1], p[2], p[3], coord.y);
+
+    const vec3 du = bezier_derivative_cubic(p[0], p[1], p[2], p[3], coord.y);
+
+    for (uint i = 0; i < 4; i++) {
+        p[i] = bezier_curve_cubic(ctrl[i],
+                                  ctrl[i + 4],
+                                  ctrl[i + 8],
+                                  ctrl[i + 12],
+                                  coord.y);
+    }
+    const vec3 dv = bezier_derivative_cubic(p[0], p[1], p[2], p[3], coord.x);
+
+    const uint base_vertex = face_id * verts_per_patch;
+
+    out_vertices[base_vertex + local_idx].pos     = obj_pos;
+    out_vertices[base_vertex + local_idx].face_id = face_id;
+    out_vertices[base_vertex + local_idx].normal  = cross(dv, du);
+    out_vertices[base_vertex + local_idx].uv      = packUnorm2x16(coord);
+
+    // Each vertex except the last row and column starts a quad,
+    // triangles are counter-clockwise in the (u, v) domain like with the tessellator
+    if (iu < level && iv < level) {
+        const uint i00 = base_vertex + local_idx;
+        const uint i10 = i00 + 1;
+        const uint i01 = i00 + side;
+        const uint i11 = i01 + 1;
+
+        const uint first = (face_id * level * level + iv * level + iu) * 6;
+
+        out_indices[first]     = i00;
+        out_indices[first + 1] = i10;
+        out_indices[first + 2] = i11;
+        out_indices[first + 3] = i00;
+        out_indices[first + 4] = i11;
+        out_indices[first + 5] = i01;
+    }
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by sculptor_tessellated.vert.glsl and sculptor_tessellated_single_view.vert.glsl,
+// which define view_index
+
+#include "transforms.glsl"
+
+// Draws patches tessellated by a compute shader, outputs match the tessellation evaluation shader
+
+layout(location = 0) in  vec3 in_pos;
+layout(location = 1) in  uint in_face_id;
+layout(location = 2) in  vec3 in_normal;
+layout(location = 3) in  vec2 in_uv;
+
+layout(location = 0) out vec4 out_pos;
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out uint out_object_id;
+layout(location = 3) out vec2 out_uv;
+
+void main()
+{
+    const vec4 view_pos = vec4(in_pos, 1) * views[view_index].model_view;
+
+    gl_Position = projection(view_pos.xyz);
+    out_pos     = vec4(view_pos.xyz, gl_Position.z / gl_Position.w);
+
+    out_normal = normalize(in_normal) * mat3(views[view_index].model_view_normal);
+
+    out_object_id = in_face_id;
+
+    out_uv = in_uv;
+}
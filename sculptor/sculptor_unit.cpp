@@ -0,0 +1,994 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_geometry.h"
+#include "../mstdc.h"
+#include "../rng.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST(test) if ( ! (test)) { failed(#test, __FILE__, __LINE__); }
+
+static int exit_code = 0;
+
+static void failed(const char* test, const char* file, int line)
+{
+    exit_code = 1;
+    fprintf(stderr, "%s:%d: Error: Failed condition %s\n",
+            file, line, test);
+}
+
+// The test is linked with the whole sculptor except main_linux.cpp, which defines these
+bool create_surface(struct Window*)
+{
+    return false;
+}
+
+uint64_t get_current_time_ms()
+{
+    return 0;
+}
+
+// Flat grid of size x size patches in the z = 0 plane, control points are spaced evenly
+// and numbered row by row.  Edges on odd rows run backwards, so faces use them inverted.
+// Control points of large grids are closer, so that they fit in the int16 range.
+static int32_t get_grid_spacing(uint32_t size)
+{
+    return mstd::min(200, static_cast<int32_t>(60000U / (3 * size)));
+}
+
+static uint32_t get_grid_vertex(uint32_t size, uint32_t row, uint32_t column)
+{
+    return row * (3 * size + 1) + column;
+}
+
+static int16_t get_grid_coord(uint32_t size, uint32_t idx)
+{
+    const int32_t spacing = get_grid_spacing(size);
+
+    return static_cast<int16_t>(static_cast<int32_t>(idx) * spacing -
+                                static_cast<int32_t>(3 * size) * spacing / 2);
+}
+
+static void build_grid(Sculptor::Geometry& geom, uint32_t size)
+{
+    const uint32_t num_points = 3 * size + 1;
+
+    for (uint32_t row = 0; row < num_points; row++) {
+        for (uint32_t column = 0; column < num_points; column++)
+            geom.add_vertex(get_grid_coord(size, column), get_grid_coord(size, num_points - 1 - row), 0);
+    }
+
+    // Edges along rows, row by row, followed by edges along columns, column by column
+    for (uint32_t row = 0; row < num_points; row += 3) {
+        const bool inverse = (row / 3) & 1U;
+
+        for (uint32_t column = 0; column + 1 < num_points; column += 3) {
+            uint32_t vertices[4];
+            for (uint32_t i = 0; i < 4; i++)
+                vertices[inverse ? (3 - i) : i] = get_grid_vertex(size, row, column + i);
+
+            geom.add_edge(vertices[0], vertices[1], vertices[2], vertices[3]);
+        }
+    }
+
+    const uint32_t num_row_edges = (size + 1) * size;
+
+    for (uint32_t column = 0; column < num_points; column += 3) {
+        for (uint32_t row = 0; row + 1 < num_points; row += 3)
+            geom.add_edge(get_grid_vertex(size, row,     column),
+                          get_grid_vertex(size, row + 1, column),
+                          get_grid_vertex(size, row + 2, column),
+                          get_grid_vertex(size, row + 3, column));
+    }
+
+    for (uint32_t i_row = 0; i_row < size; i_row++) {
+        for (uint32_t i_column = 0; i_column < size; i_column++) {
+            const uint32_t row    = i_row * 3;
+            const uint32_t column = i_column * 3;
+
+            const int32_t top    = static_cast<int32_t>(i_row * size + i_column);
+            const int32_t bottom = top + static_cast<int32_t>(size);
+            const int32_t left   = static_cast<int32_t>(num_row_edges + i_column * size + i_row);
+            const int32_t right  = left + static_cast<int32_t>(size);
+
+            geom.add_face((i_row & 1U)       ? (-top - 1)    : top,
+                          left,
+                          right,
+                          ((i_row + 1) & 1U) ? (-bottom - 1) : bottom,
+                          get_grid_vertex(size, row + 1, column + 1),
+                          get_grid_vertex(size, row + 1, column + 2),
+                          get_grid_vertex(size, row + 2, column + 1),
+                          get_grid_vertex(size, row + 2, column + 2));
+        }
+    }
+}
+
+// Checks that control points of a flat patch with evenly spaced control points are
+// in the order of patch indices, row by row from edge 0 to edge 3
+static bool is_regular_patch(const Sculptor::Geometry& geom, const uint32_t* indices)
+{
+    for (uint32_t i = 0; i < 16; i++) {
+        for (uint32_t j = 0; j < i; j++) {
+            if (indices[i] == indices[j])
+                return false;
+        }
+    }
+
+    const Sculptor::Geometry::Vertex& corner_00 = geom.get_vertex(indices[0]);
+    const Sculptor::Geometry::Vertex& corner_03 = geom.get_vertex(indices[3]);
+    const Sculptor::Geometry::Vertex& corner_12 = geom.get_vertex(indices[12]);
+
+    for (uint32_t i = 0; i < 16; i++) {
+        const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(indices[i]);
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            const int32_t origin   = corner_00.pos[axis];
+            const int32_t along    = static_cast<int32_t>(i % 4) * (corner_03.pos[axis] - origin);
+            const int32_t across   = static_cast<int32_t>(i / 4) * (corner_12.pos[axis] - origin);
+            if (3 * vertex.pos[axis] != 3 * origin + along + across)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Checks that each side shared by two patches goes in opposite directions in them,
+// patches go around corners 0, 3, 15 and 12 of their indices
+static bool is_consistently_oriented(const Sculptor::Geometry& geom)
+{
+    static const uint8_t corners[] = { 0, 3, 15, 12 };
+
+    for (uint32_t face_id = 0; face_id < geom.get_num_faces(); face_id++) {
+        uint32_t indices[16];
+        geom.get_face_indices(face_id, indices);
+
+        for (uint32_t other_id = face_id + 1; other_id < geom.get_num_faces(); other_id++) {
+            uint32_t other_indices[16];
+            geom.get_face_indices(other_id, other_indices);
+
+            for (uint32_t side = 0; side < 4; side++) {
+                for (uint32_t other_side = 0; other_side < 4; other_side++) {
+                    if (indices[corners[side]]           == other_indices[corners[other_side]] &&
+                        indices[corners[(side + 1) % 4]] == other_indices[corners[(other_side + 1) % 4]])
+                        return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Vertices and patch indices of a small geometry, for comparing it before and after edits
+struct Snapshot {
+    uint32_t                   num_vertices;
+    uint32_t                   num_edges;
+    uint32_t                   num_faces;
+    Sculptor::Geometry::Vertex vertices[64];
+    uint32_t                   indices[8][16];
+};
+
+static void take_snapshot(const Sculptor::Geometry& geom, Snapshot* snapshot)
+{
+    *snapshot = { };
+
+    snapshot->num_vertices = geom.get_num_vertices();
+    snapshot->num_edges    = geom.get_num_edges();
+    snapshot->num_faces    = geom.get_num_faces();
+
+    for (uint32_t vtx = 0; vtx < snapshot->num_vertices; vtx++)
+        snapshot->vertices[vtx] = geom.get_vertex(vtx);
+
+    for (uint32_t face_id = 0; face_id < snapshot->num_faces; face_id++)
+        geom.get_face_indices(face_id, snapshot->indices[face_id]);
+}
+
+static bool is_same(const Snapshot& snapshot1, const Snapshot& snapshot2)
+{
+    if (snapshot1.num_vertices != snapshot2.num_vertices ||
+        snapshot1.num_edges    != snapshot2.num_edges    ||
+        snapshot1.num_faces    != snapshot2.num_faces)
+        return false;
+
+    for (uint32_t vtx = 0; vtx < snapshot1.num_vertices; vtx++) {
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            if (snapshot1.vertices[vtx].pos[axis] != snapshot2.vertices[vtx].pos[axis])
+                return false;
+        }
+    }
+
+    for (uint32_t face_id = 0; face_id < snapshot1.num_faces; face_id++) {
+        for (uint32_t i = 0; i < 16; i++) {
+            if (snapshot1.indices[face_id][i] != snapshot2.indices[face_id][i])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Overwrites a 32-bit word in a file
+static bool patch_file(const char* filename, uint32_t offset, uint32_t value)
+{
+    FILE* const file = fopen(filename, "r+b");
+    if ( ! file)
+        return false;
+
+    const bool ok = fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+                    fwrite(&value, 1, sizeof(value), file) == sizeof(value);
+
+    return (fclose(file) == 0) && ok;
+}
+
+static int16_t get_random_coord(RNG& rng, uint32_t range)
+{
+    return static_cast<int16_t>(static_cast<int32_t>(rng.get_random() % (2 * range + 1)) - static_cast<int32_t>(range));
+}
+
+// Computed exactly like the vertex grid does, so distances can be compared for equality
+static float get_dist_sq(const Sculptor::Geometry& geom, uint32_t vtx, const vmath::vec3& pos)
+{
+    const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(vtx);
+
+    const float dx = static_cast<float>(vertex.pos[0]) - pos.x;
+    const float dy = static_cast<float>(vertex.pos[1]) - pos.y;
+    const float dz = static_cast<float>(vertex.pos[2]) - pos.z;
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Compares spatial hash queries against testing every vertex.  Nearest vertices are compared
+// by distance, because vertices at the same distance can be returned in any order.
+static void test_vertex_queries(Sculptor::Geometry& geom, RNG& rng, uint32_t range)
+{
+    constexpr uint32_t num_queries = 200;
+
+    static const uint32_t max_counts[] = { 1, 8, Sculptor::VertexGrid::max_nearest };
+
+    static uint32_t found[1024];
+    static uint8_t  is_found[16384];
+
+    const uint32_t num_vertices = geom.get_num_vertices();
+    assert(num_vertices <= sizeof(is_found));
+
+    uint32_t num_nearest_mismatched = 0;
+    uint32_t num_radius_mismatched  = 0;
+
+    for (uint32_t query = 0; query < num_queries; query++) {
+        // Most points are near vertices, some are far outside of the model
+        vmath::vec3 pos;
+        if (query % 8 == 0) {
+            for (uint32_t axis = 0; axis < 3; axis++)
+                pos[axis] = static_cast<float>(get_random_coord(rng, 0x7FFFU));
+        }
+        else {
+            const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(rng.get_random() % num_vertices);
+            for (uint32_t axis = 0; axis < 3; axis++)
+                pos[axis] = static_cast<float>(vertex.pos[axis] + get_random_coord(rng, range / 50));
+        }
+
+        const float    max_dist  = (query % 3 == 0) ? 1e30f : static_cast<float>(rng.get_random() % range + 1);
+        const uint32_t max_count = max_counts[query % 3];
+
+        // Nearest vertices by testing every vertex
+        float    expected[Sculptor::VertexGrid::max_nearest];
+        uint32_t num_expected = 0;
+
+        for (uint32_t vtx = 0; vtx < num_vertices; vtx++) {
+            const float dist_sq = get_dist_sq(geom, vtx, pos);
+            if (dist_sq > max_dist * max_dist)
+                continue;
+
+            if (num_expected == max_count) {
+                if (dist_sq >= expected[num_expected - 1])
+                    continue;
+                --num_expected;
+            }
+
+            uint32_t i = num_expected++;
+            for ( ; i > 0 && expected[i - 1] > dist_sq; i--)
+                expected[i] = expected[i - 1];
+            expected[i] = dist_sq;
+        }
+
+        const uint32_t num_nearest = geom.find_nearest_vertices(pos, max_dist, found, max_count);
+
+        bool nearest_ok = num_nearest == num_expected;
+        for (uint32_t i = 0; nearest_ok && i < num_nearest; i++)
+            nearest_ok = get_dist_sq(geom, found[i], pos) == expected[i];
+        if ( ! nearest_ok)
+            ++num_nearest_mismatched;
+
+        // Vertices in radius by testing every vertex
+        const float radius = static_cast<float>(rng.get_random() % (range / 4) + 1);
+
+        uint32_t num_in_radius = 0;
+        for (uint32_t vtx = 0; vtx < num_vertices; vtx++) {
+            is_found[vtx] = 0;
+            if (get_dist_sq(geom, vtx, pos) <= radius * radius)
+                ++num_in_radius;
+        }
+
+        const uint32_t num_radius = geom.find_vertices_in_radius(pos, radius, found, mstd::array_size(found));
+
+        // Only as many vertices as fit are written
+        const uint32_t num_written = mstd::min(num_radius, mstd::array_size(found));
+
+        bool radius_ok = num_radius == num_in_radius;
+        for (uint32_t i = 0; radius_ok && i < num_written; i++) {
+            radius_ok = ! is_found[found[i]] && get_dist_sq(geom, found[i], pos) <= radius * radius;
+            is_found[found[i]] = 1;
+        }
+        if ( ! radius_ok)
+            ++num_radius_mismatched;
+    }
+
+    TEST(num_nearest_mismatched == 0);
+    TEST(num_radius_mismatched  == 0);
+}
+
+// Benchmarks print how long each operation took, they are run with the "bench" argument
+static uint64_t get_time_us()
+{
+    timespec ts = { };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000U + static_cast<uint64_t>(ts.tv_nsec) / 1000U;
+}
+
+static double get_elapsed_ms(uint64_t start_us, uint64_t end_us)
+{
+    return static_cast<double>(end_us - start_us) / 1000.0;
+}
+
+// Building grids of 1K to 1M patches grows all tables from their initial capacity.  Patch indices
+// are what the GPU upload writes to the host buffer for each changed patch, besides copying vertices.
+static void bench_grid_scaling()
+{
+    static constexpr uint32_t  sizes[] = { 32, 100, 317, 1000 };
+    static Sculptor::Geometry  geoms[mstd::array_size(sizes)];
+    static uint32_t            indices[4096 * 16];
+
+    printf("%10s %10s %10s %12s %12s\n", "patches", "vertices", "build ms", "indices ms", "indices MB/s");
+
+    for (uint32_t i = 0; i < mstd::array_size(sizes); i++) {
+        const uint32_t      size      = sizes[i];
+        const uint32_t      num_faces = size * size;
+        Sculptor::Geometry& geom      = geoms[i];
+
+        const uint64_t build_start = get_time_us();
+        build_grid(geom, size);
+        const uint64_t build_end = get_time_us();
+
+        uint32_t num_mismatched = 0;
+        for (uint32_t face_id = 0; face_id < num_faces; face_id++) {
+            uint32_t* const face_indices = &indices[(face_id % 4096) * 16];
+            geom.get_face_indices(face_id, face_indices);
+            if (face_indices[15] != get_grid_vertex(size, (face_id / size) * 3 + 3, (face_id % size) * 3 + 3))
+                ++num_mismatched;
+        }
+        const uint64_t indices_end = get_time_us();
+
+        TEST(geom.get_num_faces() == num_faces);
+        TEST(num_mismatched == 0);
+
+        const double indices_ms = get_elapsed_ms(build_end, indices_end);
+        const double indices_mb = static_cast<double>(num_faces) * 16.0 * sizeof(uint32_t) / (1024.0 * 1024.0);
+
+        printf("%10u %10u %10.1f %12.1f %12.0f\n",
+               num_faces,
+               geom.get_num_vertices(),
+               get_elapsed_ms(build_start, build_end),
+               indices_ms,
+               indices_mb * 1000.0 / mstd::max(indices_ms, 0.001));
+    }
+}
+
+// Extrude visits only selected faces and their edges, finding boundary edges through adjacency
+static void bench_extrude()
+{
+    constexpr uint32_t size       = 317;
+    constexpr uint32_t block_size = 100;
+
+    static Sculptor::Geometry geoms[2];
+
+    printf("%10s %10s %10s %12s\n", "patches", "selected", "new", "extrude ms");
+
+    for (uint32_t i = 0; i < 2; i++) {
+        Sculptor::Geometry& geom = geoms[i];
+        build_grid(geom, size);
+
+        // A block in the middle of the grid, then the whole grid
+        const uint32_t first = i ? 0    : (size - block_size) / 2;
+        const uint32_t count = i ? size : block_size;
+
+        for (uint32_t row = first; row < first + count; row++) {
+            for (uint32_t column = first; column < first + count; column++)
+                geom.select_face(row * size + column);
+        }
+
+        const uint64_t start = get_time_us();
+        TEST(geom.extrude_selected_faces());
+        const uint64_t end = get_time_us();
+
+        TEST(geom.get_num_faces() == size * size + 4 * count);
+
+        printf("%10u %10u %10u %12.1f\n",
+               size * size,
+               count * count,
+               geom.get_num_faces() - size * size,
+               get_elapsed_ms(start, end));
+    }
+
+    // Neighbors of every face of the extruded grid
+    Sculptor::Geometry& geom = geoms[1];
+
+    uint32_t num_border = 0;
+
+    const uint64_t start = get_time_us();
+    for (uint32_t face_id = 0; face_id < geom.get_num_faces(); face_id++) {
+        for (uint32_t i_edge = 0; i_edge < 4; i_edge++) {
+            if (geom.get_adjacent_face(face_id, i_edge) == ~0U)
+                ++num_border;
+        }
+    }
+    const uint64_t end = get_time_us();
+
+    // Faces added along the border of the grid have no neighbors across the original border edges
+    TEST(num_border == 4 * size);
+
+    printf("%u adjacent face queries: %.1f ms\n", geom.get_num_faces() * 4, get_elapsed_ms(start, end));
+}
+
+// Queries around vertices on surfaces of a cube, like snapping to a model, compared to testing every vertex
+static void bench_vertex_queries()
+{
+    constexpr uint32_t num_vertices  = 1'000'000;
+    constexpr uint32_t range         = 30000;
+    constexpr uint32_t num_queries   = 100'000;
+    constexpr uint32_t num_scans     = 100;
+    constexpr float    snap_distance = 64.0f;
+    constexpr float    radius        = 256.0f;
+
+    static Sculptor::Geometry geom;
+    static RNG                rng;
+
+    rng.init(5678U);
+
+    for (uint32_t i = 0; i < num_vertices; i++) {
+        int16_t pos[3];
+        for (uint32_t axis = 0; axis < 3; axis++)
+            pos[axis] = get_random_coord(rng, range);
+        pos[i % 3] = static_cast<int16_t>((i % 2) ? range : -static_cast<int32_t>(range));
+
+        geom.add_vertex(pos[0], pos[1], pos[2]);
+    }
+
+    static vmath::vec3 positions[num_queries];
+    for (vmath::vec3& pos : positions) {
+        const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(rng.get_random() % num_vertices);
+        pos = vmath::vec3{static_cast<float>(vertex.pos[0] + get_random_coord(rng, 32)),
+                          static_cast<float>(vertex.pos[1] + get_random_coord(rng, 32)),
+                          static_cast<float>(vertex.pos[2] + get_random_coord(rng, 32))};
+    }
+
+    uint32_t found[Sculptor::VertexGrid::max_nearest];
+
+    // The grid is built by the first query
+    const uint64_t build_start = get_time_us();
+    geom.find_nearest_vertices(positions[0], snap_distance, found, 1);
+    const uint64_t build_end = get_time_us();
+
+    uint32_t num_found = 0;
+    for (const vmath::vec3& pos : positions)
+        num_found += geom.find_nearest_vertices(pos, snap_distance, found, 1);
+    const uint64_t nearest_end = get_time_us();
+
+    for (const vmath::vec3& pos : positions)
+        geom.find_nearest_vertices(pos, radius, found, 16);
+    const uint64_t nearest_16_end = get_time_us();
+
+    uint32_t num_in_radius = 0;
+    for (const vmath::vec3& pos : positions)
+        num_in_radius += geom.find_vertices_in_radius(pos, radius, found, mstd::array_size(found));
+    const uint64_t radius_end = get_time_us();
+
+    // Every query starts within 32 units of a vertex on each axis
+    TEST(num_found == num_queries);
+
+    uint32_t num_mismatched = 0;
+    for (uint32_t i = 0; i < num_scans; i++) {
+        float    min_dist_sq = snap_distance * snap_distance;
+        uint32_t nearest     = ~0U;
+        for (uint32_t vtx = 0; vtx < num_vertices; vtx++) {
+            const float dist_sq = get_dist_sq(geom, vtx, positions[i]);
+            if (dist_sq < min_dist_sq) {
+                min_dist_sq = dist_sq;
+                nearest     = vtx;
+            }
+        }
+        if (nearest == ~0U || ! geom.find_nearest_vertices(positions[i], snap_distance, found, 1) ||
+            get_dist_sq(geom, found[0], positions[i]) != min_dist_sq)
+            ++num_mismatched;
+    }
+    const uint64_t scan_end = get_time_us();
+
+    TEST(num_mismatched == 0);
+
+    printf("%u vertices, grid built in %.1f ms\n", num_vertices, get_elapsed_ms(build_start, build_end));
+    printf("%-28s %10.3f us\n", "nearest vertex",
+           get_elapsed_ms(build_end, nearest_end) * 1000.0 / num_queries);
+    printf("%-28s %10.3f us\n", "16 nearest vertices",
+           get_elapsed_ms(nearest_end, nearest_16_end) * 1000.0 / num_queries);
+    printf("%-28s %10.3f us, %.1f vertices per query\n", "vertices in radius",
+           get_elapsed_ms(nearest_16_end, radius_end) * 1000.0 / num_queries,
+           static_cast<double>(num_in_radius) / num_queries);
+    printf("%-28s %10.3f us\n", "testing every vertex",
+           get_elapsed_ms(radius_end, scan_end) * 1000.0 / num_scans);
+}
+
+int main(int argc, char* argv[])
+{
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // dirty ranges
+
+    {
+        Sculptor::DirtyRanges ranges = { };
+
+        ranges.add(5, 0);
+        TEST(ranges.num_ranges == 0);
+
+        // Separate ranges are kept apart, a range touching both merges them
+        ranges.add(10, 5);
+        ranges.add(20, 5);
+        TEST(ranges.num_ranges == 2);
+
+        ranges.add(15, 5);
+        TEST(ranges.num_ranges == 1);
+        TEST(ranges.begin[0] == 10);
+        TEST(ranges.end[0]   == 25);
+
+        ranges.add(12, 3);
+        TEST(ranges.num_ranges == 1);
+
+        TEST( ! ranges.contains(9));
+        TEST(ranges.contains(10));
+        TEST(ranges.contains(24));
+        TEST( ! ranges.contains(25));
+
+        // When out of ranges, the new range is merged with the closest one
+        ranges.add(100, 1);
+        ranges.add(200, 1);
+        ranges.add(300, 1);
+        TEST(ranges.num_ranges == Sculptor::DirtyRanges::max_ranges);
+
+        ranges.add(400, 10);
+        TEST(ranges.num_ranges == Sculptor::DirtyRanges::max_ranges);
+        TEST(ranges.contains(100));
+        TEST(ranges.contains(200));
+        TEST(ranges.contains(350));
+        TEST(ranges.contains(409));
+        TEST( ! ranges.contains(250));
+        TEST( ! ranges.contains(410));
+    }
+
+    {
+        Sculptor::DirtyRanges ranges = { };
+
+        ranges.add(0, 2);
+        ranges.add(5, 3);
+        ranges.add(10, 2);
+
+        // Elements are 8 bytes after a 16-byte header, ranges are clipped to the number of elements
+        VkBufferCopy regions[Sculptor::DirtyRanges::max_ranges];
+        const uint32_t num_regions = ranges.get_copy_regions(regions, 6, 8, 16, 1000, 0);
+        TEST(num_regions == 2);
+
+        // The header is uploaded with the first element
+        TEST(regions[0].srcOffset == 1000);
+        TEST(regions[0].dstOffset == 0);
+        TEST(regions[0].size      == 32);
+
+        TEST(regions[1].srcOffset == 1056);
+        TEST(regions[1].dstOffset == 56);
+        TEST(regions[1].size      == 8);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // patch indices of a closed surface
+
+    {
+        static Sculptor::Geometry geom;
+
+        geom.set_cube();
+        TEST(geom.get_num_faces() == 6);
+
+        uint32_t indices[6][16];
+        for (uint32_t face_id = 0; face_id < 6; face_id++) {
+            geom.get_face_indices(face_id, indices[face_id]);
+            TEST(is_regular_patch(geom, indices[face_id]));
+        }
+
+        // Each side of a patch is shared with exactly one other patch, possibly reversed
+        static const uint8_t sides[4][4] = {
+            {  0,  1,  2,  3 },
+            {  0,  4,  8, 12 },
+            {  3,  7, 11, 15 },
+            { 12, 13, 14, 15 }
+        };
+
+        for (uint32_t face_id = 0; face_id < 6; face_id++) {
+            for (const uint8_t* side : sides) {
+                uint32_t num_shared = 0;
+
+                for (uint32_t other_id = 0; other_id < 6; other_id++) {
+                    for (const uint8_t* other_side : sides) {
+                        bool same    = true;
+                        bool reverse = true;
+                        for (uint32_t i = 0; i < 4; i++) {
+                            const uint32_t idx = indices[face_id][side[i]];
+                            same    = same    && (idx == indices[other_id][other_side[i]]);
+                            reverse = reverse && (idx == indices[other_id][other_side[3 - i]]);
+                        }
+                        if ((same || reverse) && (other_id != face_id))
+                            ++num_shared;
+                    }
+                }
+
+                TEST(num_shared == 1);
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // undo and redo
+
+    {
+        static Sculptor::Geometry geom;
+        static Snapshot           original;
+        static Snapshot           edited;
+        static Snapshot           current;
+
+        geom.set_cube();
+        TEST( ! geom.can_undo());
+        take_snapshot(geom, &original);
+
+        // One step which moves a vertex, adds vertices and changes indices of two patches
+        geom.begin_edit();
+        geom.set_vertex(5, 100, 200, -300);
+        const uint32_t vtx_a = geom.add_vertex(-128, 500, -384);
+        const uint32_t vtx_b = geom.add_vertex(128, 500, -384);
+        geom.set_edge(0, 0, vtx_a, vtx_b, 3);
+        geom.end_edit();
+
+        take_snapshot(geom, &edited);
+        TEST( ! is_same(edited, original));
+        TEST(geom.can_undo());
+        TEST( ! geom.can_redo());
+
+        TEST(geom.undo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, original));
+        TEST( ! geom.can_undo());
+        TEST(geom.can_redo());
+
+        TEST(geom.redo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, edited));
+        TEST( ! geom.can_redo());
+
+        // Edits with the same key, e.g. during a drag, are undone together
+        geom.begin_edit(1);
+        geom.set_vertex(20, 10, 10, 10);
+        geom.end_edit();
+        geom.begin_edit(1);
+        geom.set_vertex(20, 20, 20, 20);
+        geom.set_vertex(21, 20, 20, 20);
+        geom.end_edit();
+
+        TEST(geom.undo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, edited));
+
+        // A new edit discards undone steps
+        TEST(geom.can_redo());
+        geom.begin_edit();
+        geom.set_vertex(20, 30, 30, 30);
+        geom.end_edit();
+        TEST( ! geom.can_redo());
+
+        TEST(geom.undo());
+        TEST(geom.undo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, original));
+        TEST( ! geom.can_undo());
+    }
+
+    {
+        static Sculptor::Geometry geom;
+        static Snapshot           original;
+        static Snapshot           current;
+
+        build_grid(geom, 1);
+        take_snapshot(geom, &original);
+
+        // Selection is not journaled, a selected face stays selected when its control
+        // vertices are changed, undone and redone
+        geom.select_face(0);
+        geom.begin_edit();
+        const uint32_t vtx = geom.add_vertex(0, 0, 100);
+        geom.set_face(0, 0, 2, 3, -2, vtx, vtx, vtx, vtx);
+        geom.end_edit();
+        TEST(geom.is_face_selected(0));
+
+        TEST(geom.undo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, original));
+        TEST(geom.is_face_selected(0));
+
+        TEST(geom.redo());
+        TEST(geom.is_face_selected(0));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // extrude
+
+    {
+        static Sculptor::Geometry                 geom;
+        static Sculptor::Geometry::VertexBatch    batch;
+        static Snapshot                           original;
+        static Snapshot                           current;
+
+        // Two patches in the first row of a 2x2 grid, they share one edge, which is not copied
+        build_grid(geom, 2);
+        take_snapshot(geom, &original);
+
+        geom.select_face(0);
+        geom.select_face(1);
+
+        geom.begin_edit();
+        TEST(geom.extrude_selected_faces());
+        geom.end_edit();
+
+        // Each of 6 boundary edges is copied and connected with a new patch, edges from
+        // boundary corners to their copies are shared by new patches
+        TEST(geom.get_num_faces()    == 4 + 6);
+        TEST(geom.get_num_edges()    == 12 + 6 + 6);
+        TEST(geom.get_num_vertices() == 49 + 6 * 3 + 6 * 2 + 6 * 4);
+
+        TEST(geom.is_face_selected(0));
+        TEST(geom.is_face_selected(1));
+        TEST( ! geom.is_face_selected(4));
+
+        // New patches are flat until extruded faces move
+        for (uint32_t face_id = 0; face_id < geom.get_num_faces(); face_id++) {
+            uint32_t indices[16];
+            geom.get_face_indices(face_id, indices);
+            TEST(is_regular_patch(geom, indices));
+        }
+        TEST(is_consistently_oriented(geom));
+
+        // Extruded faces are only connected to each other and to new faces
+        TEST(geom.get_adjacent_face(0, 2) == 1);
+        for (uint32_t face_id = 0; face_id < 2; face_id++) {
+            for (uint32_t i_edge = 0; i_edge < 4; i_edge++) {
+                const uint32_t adjacent = geom.get_adjacent_face(face_id, i_edge);
+                TEST(adjacent == (1 - face_id) || adjacent >= 4);
+            }
+        }
+        TEST(geom.get_adjacent_face(2, 0) >= 4);
+        TEST(geom.get_adjacent_face(3, 0) >= 4);
+
+        // Moving extruded faces does not move the rest
+        TEST(geom.gather_selected_vertices(&batch));
+        TEST(batch.size() == 2 * 16 - 4);
+
+        geom.begin_edit();
+        geom.transform_vertices(batch, vmath::translate(vmath::vec3{0, 0, 300}));
+        geom.end_edit();
+
+        for (uint32_t face_id = 0; face_id < 4; face_id++) {
+            uint32_t indices[16];
+            geom.get_face_indices(face_id, indices);
+            TEST(is_regular_patch(geom, indices));
+
+            const int16_t z = (face_id < 2) ? 300 : 0;
+            for (const uint32_t vtx : indices)
+                TEST(geom.get_vertex(vtx).pos[2] == z);
+        }
+
+        TEST(geom.undo());
+        TEST(geom.undo());
+        take_snapshot(geom, &current);
+        TEST(is_same(current, original));
+
+        TEST(geom.redo());
+        TEST(geom.get_num_faces() == 4 + 6);
+        TEST(is_consistently_oriented(geom));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // saving and loading
+
+    {
+        static Sculptor::Geometry saved;
+        static Sculptor::Geometry loaded;
+        static Snapshot           expected;
+        static Snapshot           actual;
+
+        char filename[] = "/tmp/sculptor_unit_XXXXXX";
+        const int fd = mkstemp(filename);
+        TEST(fd >= 0);
+        close(fd);
+
+        // The grid has inverted edges and patches sharing edges
+        build_grid(saved, 2);
+        take_snapshot(saved, &expected);
+
+        TEST(saved.save(filename));
+        TEST(loaded.load(filename));
+        take_snapshot(loaded, &actual);
+        TEST(is_same(actual, expected));
+
+        // Adjacency is rebuilt
+        TEST(loaded.get_adjacent_face(0, 2) == 1);
+        TEST(loaded.get_adjacent_face(0, 3) == 2);
+        TEST(loaded.get_adjacent_face(3, 0) == 1);
+        TEST(loaded.get_adjacent_face(3, 3) == ~0U);
+
+        // Files of other versions are rejected and the current geometry is kept,
+        // the version follows the 8-byte magic
+        TEST(patch_file(filename, 8, 2));
+        TEST( ! loaded.load(filename));
+        take_snapshot(loaded, &actual);
+        TEST(is_same(actual, expected));
+
+        // Corrupted sections are rejected, the first vertex follows the 64-byte header
+        TEST(saved.save(filename));
+        TEST(patch_file(filename, 64, 0x12345678U));
+        TEST( ! loaded.load(filename));
+        take_snapshot(loaded, &actual);
+        TEST(is_same(actual, expected));
+
+        // Empty geometry
+        static Sculptor::Geometry empty;
+
+        TEST(empty.save(filename));
+        TEST(loaded.load(filename));
+        TEST(loaded.get_num_vertices() == 0);
+        TEST(loaded.get_num_edges()    == 0);
+        TEST(loaded.get_num_faces()    == 0);
+
+        remove(filename);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // nearest vertices and vertices in radius
+
+    {
+        static Sculptor::Geometry geom;
+        static RNG                rng;
+
+        rng.init(1234U);
+
+        // Vertices on faces of a cube, like on a surface of a model, with a dense cluster
+        // in the middle, so some cells are crowded and many are empty
+        constexpr uint32_t range = 4000;
+
+        for (uint32_t i = 0; i < 3000; i++) {
+            int16_t pos[3];
+            for (uint32_t axis = 0; axis < 3; axis++)
+                pos[axis] = get_random_coord(rng, range);
+
+            if (i % 4 == 0) {
+                for (uint32_t axis = 0; axis < 3; axis++)
+                    pos[axis] = static_cast<int16_t>(pos[axis] / 20);
+            }
+            else
+                pos[i % 3] = static_cast<int16_t>((i % 2) ? range : -static_cast<int32_t>(range));
+
+            geom.add_vertex(pos[0], pos[1], pos[2]);
+        }
+
+        test_vertex_queries(geom, rng, range);
+
+        // The grid is updated when vertices move, also outside of the initial bounds,
+        // when vertices are added and when added vertices are removed by undo
+        geom.begin_edit();
+        for (uint32_t i = 0; i < 500; i++) {
+            const uint32_t vtx = rng.get_random() % geom.get_num_vertices();
+            geom.set_vertex(vtx,
+                            get_random_coord(rng, 2 * range),
+                            get_random_coord(rng, 2 * range),
+                            get_random_coord(rng, 2 * range));
+        }
+        geom.end_edit();
+
+        test_vertex_queries(geom, rng, range);
+
+        geom.begin_edit();
+        for (uint32_t i = 0; i < 200; i++)
+            geom.add_vertex(get_random_coord(rng, range),
+                            get_random_coord(rng, range),
+                            get_random_coord(rng, range));
+        geom.end_edit();
+
+        test_vertex_queries(geom, rng, range);
+
+        TEST(geom.undo());
+        TEST(geom.get_num_vertices() == 3000);
+
+        test_vertex_queries(geom, rng, range);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // growth past 16-bit vertex ids
+
+    {
+        // Geometry is static, so its tables are not reported as leaks
+        static Sculptor::Geometry geom;
+
+        constexpr uint32_t size       = 90;
+        constexpr uint32_t num_points = 3 * size + 1;
+
+        build_grid(geom, size);
+
+        TEST(geom.get_num_vertices() == num_points * num_points);
+        TEST(geom.get_num_vertices() > Sculptor::Geometry::max_16bit_vertices);
+        TEST(geom.get_num_edges()    == 2 * size * (size + 1));
+        TEST(geom.get_num_faces()    == size * size);
+
+        // Vertices are kept when tables are reallocated
+        uint32_t num_mismatched = 0;
+        for (uint32_t row = 0; row < num_points; row++) {
+            for (uint32_t column = 0; column < num_points; column++) {
+                const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(get_grid_vertex(size, row, column));
+                if (vertex.pos[0] != get_grid_coord(size, column) ||
+                    vertex.pos[1] != get_grid_coord(size, num_points - 1 - row) ||
+                    vertex.pos[2] != 0)
+                    ++num_mismatched;
+            }
+        }
+        TEST(num_mismatched == 0);
+
+        // Patch indices are not truncated to 16 bits
+        num_mismatched = 0;
+        for (uint32_t face_id = 0; face_id < size * size; face_id++) {
+            uint32_t indices[16];
+            geom.get_face_indices(face_id, indices);
+
+            for (uint32_t i = 0; i < 16; i++) {
+                const uint32_t row    = (face_id / size) * 3 + i / 4;
+                const uint32_t column = (face_id % size) * 3 + i % 4;
+                if (indices[i] != get_grid_vertex(size, row, column))
+                    ++num_mismatched;
+            }
+        }
+        TEST(num_mismatched == 0);
+
+        // The last patch only uses vertices above 16 bits
+        const uint32_t last_face = size * size - 1;
+        const float    center    = get_grid_coord(size, 3 * size - 3) + 1.5f * static_cast<float>(get_grid_spacing(size));
+        float          hit_dist  = 0;
+        const uint32_t hit_face  = geom.pick_face(vmath::vec3(center, -center, 1000.0f),
+                                                  vmath::vec3(0.0f, 0.0f, -1.0f),
+                                                  &hit_dist);
+        TEST(hit_face == last_face);
+        TEST(hit_dist > 999.0f && hit_dist < 1001.0f);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // benchmarks
+
+    if ((argc > 1) && (mstd::strcmp(argv[1], "bench") == 0)) {
+        bench_grid_scaling();
+        bench_extrude();
+        bench_vertex_queries();
+    }
+
+    return exit_code;
+}
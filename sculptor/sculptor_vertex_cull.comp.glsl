@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+// Culls vertex handles against the view frustum and removes vertices whose patches
+// were all culled, then compacts ids of the remaining vertices for an indirect draw.
+// Runs after patch culling, which marks vertices of visible patches and vertices
+// used by any patch.  Vertices which are not used by any patch are only frustum culled.
+
+layout(push_constant) uniform push_constants {
+    uint num_faces;
+    uint wide_indices;
+    uint backface_cull;
+    uint num_views;
+    uint num_vertices;
+} push;
+
+layout(set = 0, binding = 0) readonly buffer vertices {
+    uvec2 vertex_pos[]; // int16 x, y, z and unused
+};
+
+struct cull_view {
+    mat4 model_view;
+    vec4 proj;
+    vec4 proj_w;        // perspective: [0, 0, 1, 0], orthographic: [0, 0, 0, 1]
+};
+
+layout(set = 0, binding = 5) readonly buffer cull_views {
+    cull_view views[];
+};
+
+layout(set = 0, binding = 6) readonly buffer vertex_marks {
+    uint marks[];       // Bits of vertices of visible patches, followed by bits of vertices used by patches
+};
+
+layout(set = 0, binding = 7) buffer vertex_draw_command {
+    uint vertex_count;
+    uint instance_count;
+    uint first_vertex;
+    uint first_instance;
+};
+
+layout(set = 0, binding = 8) writeonly buffer visible_vertices {
+    uint visible_vertex_ids[];
+};
+
+layout(local_size_x = 64) in;
+
+vec3 get_obj_pos(uint vtx)
+{
+    const uvec2 packed_pos = vertex_pos[vtx];
+
+    // Sign-extend int16 components
+    const ivec3 pos = ivec3(int(packed_pos.x << 16) >> 16,
+                            int(packed_pos.x) >> 16,
+                            int(packed_pos.y << 16) >> 16);
+
+    // Same conversion as VK_FORMAT_R16G16B16_SNORM
+    return max(vec3(pos) / 32767.0, -1.0);
+}
+
+bool is_visible(vec3 obj_pos, uint view_idx)
+{
+    const cull_view view = views[view_idx];
+
+    const vec3  pos = (vec4(obj_pos, 1) * view.model_view).xyz;
+    const vec2  xy  = pos.xy * view.proj.xy;
+    const float z   = pos.z * view.proj.z + view.proj.w;
+    const float w   = pos.z * view.proj_w.z + view.proj_w.w;
+
+    // Depth is reversed, near plane is at z == w and far plane at z == 0
+    return all(lessThanEqual(abs(xy), vec2(w))) && z <= w && z >= 0;
+}
+
+void main()
+{
+    if (gl_GlobalInvocationID.x == 0)
+        vertex_count = 4;
+
+    if (gl_GlobalInvocationID.x >= push.num_vertices)
+        return;
+
+    const uint vtx       = gl_GlobalInvocationID.x;
+    const uint num_words = (push.num_vertices + 31) / 32;
+    const uint bit       = 1u << (vtx % 32);
+
+    const bool front = (marks[vtx / 32] & bit) != 0;
+    const bool used  = (marks[num_words + vtx / 32] & bit) != 0;
+
+    // All patches of the vertex face away from the camera or are outside of the views
+    if (used && ! front)
+        return;
+
+    const vec3 obj_pos = get_obj_pos(vtx);
+
+    bool visible = false;
+    for (uint view_idx = 0; view_idx < push.num_views && ! visible; view_idx++)
+        visible = is_visible(obj_pos, view_idx);
+
+    if ( ! visible)
+        return;
+
+    visible_vertex_ids[atomicAdd(instance_count, 1)] = vtx;
+}
@@ -0,0 +1,379 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sculptor_vertex_grid.h"
+#include "sculptor_geometry.h"
+
+#include "../d_printf.h"
+#include "../mstdc.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+namespace {
+    // Vertex coordinates are offset by this to make cell coordinates unsigned
+    constexpr int32_t  coord_offset      = 0x8000;
+    constexpr uint32_t max_coord         = 0xFFFFU;
+
+    constexpr uint32_t min_buckets       = 64;
+
+    // Target number of vertices in each occupied cell
+    constexpr uint32_t vertices_per_cell = 2;
+
+    // Margin of visited cells which cover the whole range of coordinates
+    constexpr float    no_margin         = 1e30f;
+}
+
+template<typename T>
+static bool reserve_array(T** array, uint32_t* capacity, uint32_t required)
+{
+    if (required <= *capacity)
+        return true;
+
+    const uint32_t new_capacity = mstd::max(required, *capacity * 2);
+
+    T* const new_array = static_cast<T*>(realloc(*array, new_capacity * sizeof(T)));
+    if ( ! new_array) {
+        d_printf("Failed to allocate vertex grid array of %u entries\n", new_capacity);
+        return false;
+    }
+
+    *array    = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+static float get_dist_sq(const Sculptor::Geometry& geom, uint32_t vtx, const vmath::vec3& pos)
+{
+    const Sculptor::Geometry::Vertex& vertex = geom.get_vertex(vtx);
+
+    const float dx = static_cast<float>(vertex.pos[0]) - pos.x;
+    const float dy = static_cast<float>(vertex.pos[1]) - pos.y;
+    const float dz = static_cast<float>(vertex.pos[2]) - pos.z;
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+bool Sculptor::VertexGrid::build(const Geometry& geom)
+{
+    valid        = false;
+    num_vertices = geom.get_num_vertices();
+
+    uint32_t new_num_buckets = min_buckets;
+    while (new_num_buckets < num_vertices * 2)
+        new_num_buckets *= 2;
+
+    if ( ! reserve_array(&buckets, &buckets_cap, new_num_buckets) ||
+         ! reserve_array(&links,   &links_cap,   num_vertices))
+        return false;
+
+    num_buckets = new_num_buckets;
+
+    int32_t min_pos = coord_offset;
+    int32_t max_pos = -coord_offset;
+
+    for (uint32_t vtx = 0; vtx < num_vertices; vtx++) {
+        const Geometry::Vertex& vertex = geom.get_vertex(vtx);
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            min_pos = mstd::min(min_pos, static_cast<int32_t>(vertex.pos[axis]));
+            max_pos = mstd::max(max_pos, static_cast<int32_t>(vertex.pos[axis]));
+        }
+    }
+
+    // Vertices lie on the surface of the model, so the cell size is chosen for a surface
+    // which spans the bounds of the model
+    uint32_t cells_per_axis = 1;
+    while (cells_per_axis * cells_per_axis * vertices_per_cell < num_vertices)
+        cells_per_axis *= 2;
+
+    const uint32_t extent = (max_pos >= min_pos) ? static_cast<uint32_t>(max_pos - min_pos + 1) : 1U;
+
+    cell_shift = 0;
+    while ((cells_per_axis << cell_shift) < extent)
+        ++cell_shift;
+
+    for (uint32_t i = 0; i < num_buckets; i++)
+        buckets[i] = no_vertex;
+
+    for (uint32_t vtx = 0; vtx < num_vertices; vtx++)
+        link(vtx, get_bucket(get_vertex_cell(geom, vtx)));
+
+    valid = true;
+    return true;
+}
+
+void Sculptor::VertexGrid::update_vertex(const Geometry& geom, uint32_t vtx)
+{
+    if ( ! valid)
+        return;
+
+    const uint32_t bucket = get_bucket(get_vertex_cell(geom, vtx));
+
+    if (vtx < num_vertices) {
+        // Vertices which move within a bucket stay in it
+        if (links[vtx].bucket != bucket) {
+            unlink(vtx);
+            link(vtx, bucket);
+        }
+        return;
+    }
+
+    // New vertices are appended, the grid is rebuilt when the buckets get crowded
+    if (vtx != num_vertices || num_vertices >= num_buckets ||
+        ! reserve_array(&links, &links_cap, num_vertices + 1)) {
+
+        valid = false;
+        return;
+    }
+
+    ++num_vertices;
+    link(vtx, bucket);
+}
+
+void Sculptor::VertexGrid::remove_vertex(uint32_t vtx)
+{
+    if ( ! valid)
+        return;
+
+    // Only the last vertex is ever removed
+    if (vtx + 1 != num_vertices) {
+        valid = false;
+        return;
+    }
+
+    unlink(vtx);
+    --num_vertices;
+}
+
+template<typename F>
+void Sculptor::VertexGrid::visit_cell(const Geometry& geom, const Cell& cell, F& func) const
+{
+    // Other cells which share the bucket are skipped
+    for (uint32_t vtx = buckets[get_bucket(cell)]; vtx != no_vertex; vtx = links[vtx].next) {
+        const Cell vtx_cell = get_vertex_cell(geom, vtx);
+
+        if (vtx_cell.coord[0] == cell.coord[0] &&
+            vtx_cell.coord[1] == cell.coord[1] &&
+            vtx_cell.coord[2] == cell.coord[2])
+            func(vtx);
+    }
+}
+
+uint32_t Sculptor::VertexGrid::find_nearest(const Geometry&    geom,
+                                            const vmath::vec3& pos,
+                                            float              max_dist,
+                                            uint32_t*          vertices,
+                                            uint32_t           max_count) const
+{
+    max_count = mstd::min(max_count, max_nearest);
+
+    if ( ! valid || ! num_vertices || ! max_count)
+        return 0;
+
+    const float max_dist_sq = max_dist * max_dist;
+
+    // Found vertices are kept sorted by distance
+    float    dist_sq[max_nearest];
+    uint32_t num_found = 0;
+
+    auto add_vertex = [&](uint32_t vtx) {
+        const float vtx_dist_sq = get_dist_sq(geom, vtx, pos);
+
+        if (vtx_dist_sq > max_dist_sq)
+            return;
+
+        if (num_found == max_count) {
+            if (vtx_dist_sq >= dist_sq[num_found - 1])
+                return;
+            --num_found;
+        }
+
+        uint32_t i = num_found++;
+        for ( ; i > 0 && dist_sq[i - 1] > vtx_dist_sq; i--) {
+            dist_sq[i]  = dist_sq[i - 1];
+            vertices[i] = vertices[i - 1];
+        }
+
+        dist_sq[i]  = vtx_dist_sq;
+        vertices[i] = vtx;
+    };
+
+    const Cell     center     = get_cell(pos);
+    const uint32_t last_cell  = max_coord >> cell_shift;
+    const float    cell_size  = static_cast<float>(1U << cell_shift);
+    const uint32_t max_visits = num_vertices * 2 + min_buckets;
+    uint32_t       num_visits = 0;
+
+    // Visit shells of cells of growing size around the center cell, until the nearest
+    // vertex outside of visited cells cannot be closer than the vertices already found
+    for (uint32_t ring = 0; ; ring++) {
+
+        uint32_t lo[3];
+        uint32_t hi[3];
+        float    margin = no_margin;
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            const uint32_t c = center.coord[axis];
+            lo[axis] = (c > ring) ? (c - ring) : 0U;
+            hi[axis] = mstd::min(c + ring, last_cell);
+
+            const float p = pos[axis] + static_cast<float>(coord_offset);
+            if (c > ring)
+                margin = mstd::min(margin, p - static_cast<float>(c - ring) * cell_size);
+            if (c + ring < last_cell)
+                margin = mstd::min(margin, static_cast<float>(c + ring + 1) * cell_size - p);
+        }
+
+        Cell cell;
+        for (cell.coord[2] = lo[2]; cell.coord[2] <= hi[2]; cell.coord[2]++) {
+            const bool z_face = (cell.coord[2] + ring == center.coord[2]) || (cell.coord[2] == center.coord[2] + ring);
+
+            for (cell.coord[1] = lo[1]; cell.coord[1] <= hi[1]; cell.coord[1]++) {
+                const bool y_face = (cell.coord[1] + ring == center.coord[1]) || (cell.coord[1] == center.coord[1] + ring);
+
+                if (z_face || y_face) {
+                    for (cell.coord[0] = lo[0]; cell.coord[0] <= hi[0]; cell.coord[0]++)
+                        visit_cell(geom, cell, add_vertex);
+                    num_visits += hi[0] - lo[0] + 1;
+                    continue;
+                }
+
+                // Inside of the shell, only cells on both ends of the row were not visited yet
+                if (center.coord[0] >= ring) {
+                    cell.coord[0] = center.coord[0] - ring;
+                    visit_cell(geom, cell, add_vertex);
+                    ++num_visits;
+                }
+                if (center.coord[0] + ring <= last_cell) {
+                    cell.coord[0] = center.coord[0] + ring;
+                    visit_cell(geom, cell, add_vertex);
+                    ++num_visits;
+                }
+            }
+        }
+
+        if (margin == no_margin)
+            break;
+
+        if (num_found == max_count && dist_sq[num_found - 1] <= margin * margin)
+            break;
+
+        if (margin > max_dist)
+            break;
+
+        // Vertices are too sparse around the point, it is cheaper to test all of them
+        if (num_visits > max_visits) {
+            num_found = 0;
+            for (uint32_t vtx = 0; vtx < num_vertices; vtx++)
+                add_vertex(vtx);
+            break;
+        }
+    }
+
+    return num_found;
+}
+
+uint32_t Sculptor::VertexGrid::find_in_radius(const Geometry&    geom,
+                                              const vmath::vec3& pos,
+                                              float              radius,
+                                              uint32_t*          vertices,
+                                              uint32_t           max_count) const
+{
+    if ( ! valid || ! num_vertices)
+        return 0;
+
+    const float radius_sq = radius * radius;
+    uint32_t    num_found = 0;
+
+    auto add_vertex = [&](uint32_t vtx) {
+        if (get_dist_sq(geom, vtx, pos) <= radius_sq) {
+            if (num_found < max_count)
+                vertices[num_found] = vtx;
+            ++num_found;
+        }
+    };
+
+    const Cell lo = get_cell(pos - vmath::vec3{radius, radius, radius});
+    const Cell hi = get_cell(pos + vmath::vec3{radius, radius, radius});
+
+    uint64_t num_cells = 1;
+    for (uint32_t axis = 0; axis < 3; axis++)
+        num_cells *= hi.coord[axis] - lo.coord[axis] + 1;
+
+    // Large radius covers more cells than there are vertices
+    if (num_cells > num_vertices) {
+        for (uint32_t vtx = 0; vtx < num_vertices; vtx++)
+            add_vertex(vtx);
+        return num_found;
+    }
+
+    Cell cell;
+    for (cell.coord[2] = lo.coord[2]; cell.coord[2] <= hi.coord[2]; cell.coord[2]++)
+        for (cell.coord[1] = lo.coord[1]; cell.coord[1] <= hi.coord[1]; cell.coord[1]++)
+            for (cell.coord[0] = lo.coord[0]; cell.coord[0] <= hi.coord[0]; cell.coord[0]++)
+                visit_cell(geom, cell, add_vertex);
+
+    return num_found;
+}
+
+Sculptor::VertexGrid::Cell Sculptor::VertexGrid::get_vertex_cell(const Geometry& geom, uint32_t vtx) const
+{
+    const Geometry::Vertex& vertex = geom.get_vertex(vtx);
+
+    Cell cell;
+    for (uint32_t axis = 0; axis < 3; axis++)
+        cell.coord[axis] = static_cast<uint32_t>(vertex.pos[axis] + coord_offset) >> cell_shift;
+
+    return cell;
+}
+
+Sculptor::VertexGrid::Cell Sculptor::VertexGrid::get_cell(const vmath::vec3& pos) const
+{
+    Cell cell;
+    for (uint32_t axis = 0; axis < 3; axis++) {
+        const float coord = mstd::min(mstd::max(pos[axis] + static_cast<float>(coord_offset), 0.0f),
+                                      static_cast<float>(max_coord));
+        cell.coord[axis] = static_cast<uint32_t>(coord) >> cell_shift;
+    }
+
+    return cell;
+}
+
+uint32_t Sculptor::VertexGrid::get_bucket(const Cell& cell) const
+{
+    const uint32_t hash = (cell.coord[0] * 73856093U) ^
+                          (cell.coord[1] * 19349663U) ^
+                          (cell.coord[2] * 83492791U);
+
+    return hash & (num_buckets - 1);
+}
+
+void Sculptor::VertexGrid::link(uint32_t vtx, uint32_t bucket)
+{
+    const uint32_t next = buckets[bucket];
+
+    links[vtx].prev   = no_vertex;
+    links[vtx].next   = next;
+    links[vtx].bucket = bucket;
+
+    if (next != no_vertex)
+        links[next].prev = vtx;
+
+    buckets[bucket] = vtx;
+}
+
+void Sculptor::VertexGrid::unlink(uint32_t vtx)
+{
+    const Link& vtx_link = links[vtx];
+
+    if (vtx_link.prev != no_vertex)
+        links[vtx_link.prev].next = vtx_link.next;
+    else {
+        assert(buckets[vtx_link.bucket] == vtx);
+        buckets[vtx_link.bucket] = vtx_link.next;
+    }
+
+    if (vtx_link.next != no_vertex)
+        links[vtx_link.next].prev = vtx_link.prev;
+}
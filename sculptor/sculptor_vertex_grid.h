@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include "../vmath.h"
+
+#include <stdint.h>
+
+namespace Sculptor {
+
+class Geometry;
+
+// Uniform grid over vertex positions, used for finding nearby vertices, e.g. for snapping.
+// Grid cells are hashed into buckets, each bucket is a doubly-linked list of vertices,
+// so adding, moving and removing a vertex takes constant time.  Queries visit only cells
+// around the queried point, vertices of other cells in the same bucket are skipped.
+class VertexGrid {
+    public:
+        constexpr VertexGrid() = default;
+        VertexGrid(const VertexGrid&)            = delete;
+        VertexGrid& operator=(const VertexGrid&) = delete;
+
+        static constexpr uint32_t max_nearest = 64;
+
+        bool is_valid() const { return valid; }
+        void invalidate()     { valid = false; }
+
+        bool build(const Geometry& geom);
+        void update_vertex(const Geometry& geom, uint32_t vtx);
+        void remove_vertex(uint32_t vtx);
+
+        // Finds at most max_count (up to max_nearest) vertices nearest to pos within max_dist,
+        // sorted by distance, returns the number of vertices found
+        uint32_t find_nearest(const Geometry&    geom,
+                              const vmath::vec3& pos,
+                              float              max_dist,
+                              uint32_t*          vertices,
+                              uint32_t           max_count) const;
+
+        // Finds vertices within radius of pos in no particular order, returns the total number
+        // of vertices found, but writes at most max_count of them
+        uint32_t find_in_radius(const Geometry&    geom,
+                                const vmath::vec3& pos,
+                                float              radius,
+                                uint32_t*          vertices,
+                                uint32_t           max_count) const;
+
+    private:
+        static constexpr uint32_t no_vertex = ~0U;
+
+        struct Link {
+            uint32_t prev;   // Previous vertex in the bucket or no_vertex for the first one
+            uint32_t next;   // Next vertex in the bucket or no_vertex for the last one
+            uint32_t bucket;
+        };
+
+        struct Cell {
+            uint32_t coord[3];
+        };
+
+        Cell     get_vertex_cell(const Geometry& geom, uint32_t vtx) const;
+        Cell     get_cell(const vmath::vec3& pos) const;
+        uint32_t get_bucket(const Cell& cell) const;
+        void     link(uint32_t vtx, uint32_t bucket);
+        void     unlink(uint32_t vtx);
+        template<typename F>
+        void     visit_cell(const Geometry& geom, const Cell& cell, F& func) const;
+
+        uint32_t* buckets      = nullptr; // First vertex in each bucket
+        Link*     links        = nullptr;
+        uint32_t  buckets_cap  = 0;
+        uint32_t  links_cap    = 0;
+        uint32_t  num_buckets  = 0;       // Power of 2
+        uint32_t  num_vertices = 0;
+        uint32_t  cell_shift   = 0;       // Cell size is 1 << cell_shift in int16 units
+        bool      valid        = false;
+};
+
+}
@@ -8,12 +8,20 @@
 #include "sculptor_material.glsl"
 
 layout(location = 0) in  float in_depth;
+layout(location = 1) flat in uint in_state;
 
 layout(location = 0) out vec4  out_color;
 
 void main()
 {
-    out_color = vec4(diffuse_color.rgb, 1);
+    vec3 color = diffuse_color.rgb;
+
+    if (in_state == 1)
+        color *= vec3(1.2, 1.1, 1.1);
+    else if (in_state == 2)
+        color *= vec3(1, 1, 1.4);
+
+    out_color = vec4(color, 1);
 
     gl_FragDepth = in_depth * 1.00195325;
 }
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+// Shared by sculptor_vertex_select.vert.glsl and sculptor_vertex_select_single_view.vert.glsl,
+// which define view_index
+
+#include "transforms.glsl"
+
+layout(location = 0) out float out_depth;
+layout(location = 1) flat out uint out_state; // 0: default, 1: hovered, 2: selected
+
+struct vertex_data {
+    uint xy;
+    uint z;
+};
+
+layout(set = 2, binding = 3) buffer object_vertices {
+    vertex_data vertices[];
+};
+
+layout(set = 2, binding = 6) readonly buffer vertex_state {
+    uint hovered_vertex;
+    uint flags;                 // 1: instances are vertices which survived culling
+    uint padding[2];
+    uint selected_vertices[];   // One bit per vertex
+};
+
+layout(set = 2, binding = 7) readonly buffer visible_vertices {
+    uint visible_vertex_ids[];
+};
+
+vec3 read_vertex(uint index)
+{
+    const vertex_data data = vertices[index];
+
+    const int ix = int(data.xy << 16) >> 16;
+    const int iy = int(data.xy) >> 16;
+    const int iz = int(data.z << 16) >> 16;
+
+    const float x = float(ix) / 32767.0;
+    const float y = float(iy) / 32767.0;
+    const float z = float(iz) / 32767.0;
+
+    return vec3(x, y, z);
+}
+
+void main()
+{
+    const uint vtx         = ((flags & 1) != 0) ? visible_vertex_ids[gl_InstanceIndex] : gl_InstanceIndex;
+    const vec3 orig_vertex = read_vertex(vtx);
+    const vec4 view_pos    = vec4(orig_vertex, 1) * views[view_index].model_view;
+    vec4       pos         = projection(view_pos.xyz);
+
+    pos.xy += vec2(ivec2(gl_VertexIndex & 1, gl_VertexIndex >> 1) * 2 - 1) * views[view_index].pixel_dim * 3.0 * pos.w;
+
+    gl_Position = pos;
+    out_depth   = pos.z / pos.w;
+    out_state   = (vtx == hovered_vertex) ? 1 : (((selected_vertices[vtx / 32] >> (vtx % 32)) & 1) * 2);
+}
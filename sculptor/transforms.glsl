@@ -1,7 +1,12 @@
 // SPDX-License-Identifier: MIT
 // SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
 
-layout(set = 2, binding = 0) uniform transform_data {
+// Requires view_index, which is gl_ViewIndex with multiview or 0 without it
+
+// Must match max_views in sculptor_geom_edit.cpp
+const uint max_views = 4;
+
+struct view_transforms {
     mat4   model_view;
     mat3x4 model_view_normal;
     vec4   proj;
@@ -9,8 +14,17 @@ layout(set = 2, binding = 0) uniform transform_data {
     vec2   pixel_dim;
 };
 
+// In quad view all views are drawn in one pass with multiview, outside of multiview
+// view_index is 0 and only the first view is used
+layout(set = 2, binding = 0) uniform transform_data {
+    view_transforms views[max_views];
+};
+
 vec4 projection(vec3 pos)
 {
+    const vec4 proj   = views[view_index].proj;
+    const vec4 proj_w = views[view_index].proj_w;
+
     return vec4(pos.xy * proj.xy,
                 pos.z * proj.z + proj.w,
                 pos.z * proj_w.z + proj_w.w);
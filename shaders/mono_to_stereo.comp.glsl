@@ -7,6 +7,8 @@
 
 layout(push_constant) uniform push_constants {
     uint num_samples;
+    uint in_offs;   // Index of the first sample in in_sound
+    uint out_offs;  // Index of the first stereo frame in out_sound
 } push;
 
 layout(set = 0, binding = 0) buffer input_data  { float   in_sound[];  };
@@ -18,11 +20,11 @@ void main()
 {
     const uint delta = gl_WorkGroupSize.x * gl_NumWorkGroups.x;
 
-    for (uint in_offs = gl_GlobalInvocationID.x; in_offs < push.num_samples; in_offs += delta) {
+    for (uint i = gl_GlobalInvocationID.x; i < push.num_samples; i += delta) {
 
-        const uint out_offs = in_offs * 2;
+        const uint out_offs = (push.out_offs + i) * 2;
 
-        const float   value   = clamp(in_sound[in_offs], -1.0, 1.0);
+        const float   value   = clamp(in_sound[push.in_offs + i], -1.0, 1.0);
         const int16_t value16 = int16_t(value * 32767.0);
 
         out_sound[out_offs]     = value16;
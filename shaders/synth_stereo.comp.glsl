@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#version 460 core
+
+#extension GL_GOOGLE_include_directive: require
+
+#include "synth.glsl"
+
+// Renders a note directly into interleaved stereo frames, with volume and panning
+// of the voice applied.  This avoids storing and reloading intermediate mono samples
+// like synth.comp.glsl followed by mono_to_stereo.comp.glsl.
+
+const uint format_int16   = 0; // 16-bit signed integer
+const uint format_float32 = 1; // 32-bit float, not clamped
+const uint format_int24   = 2; // 24-bit signed integer in low bits of 32-bit integer
+
+layout(constant_id = 0) const uint out_format = format_int16;
+
+layout(push_constant) uniform push_constants {
+    uint  num_samples;   // Number of samples in the whole note
+    uint  base_freq;     // Frequency of the note being played
+    uint  first_sample;  // First sample of the note to generate
+    uint  num_generated; // Number of samples to generate, starting at first_sample
+    uint  out_offs;      // Index of stereo frame in output where the first sample is stored
+    float volume;        // 0..1
+    float pan;           // 0 is left, 1 is right
+} push;
+
+// Only the declaration matching out_format is used
+layout(set = 0, binding = 1) writeonly buffer output_int16   { int16_t out_int16[];   };
+layout(set = 0, binding = 1) writeonly buffer output_float32 { float   out_float32[]; };
+layout(set = 0, binding = 1) writeonly buffer output_int32   { int     out_int32[];   };
+
+// Work group size is set by the application from maxComputeWorkGroupInvocations
+layout(local_size_x_id = 1) in;
+
+void main()
+{
+    const uint delta = gl_WorkGroupSize.x * gl_NumWorkGroups.x;
+
+    const uint end_offs = push.first_sample + push.num_generated;
+
+    // Equal volume on both sides in the center, full volume on one side when panned
+    const float left_gain  = push.volume * min(2 * (1 - push.pan), 1.0);
+    const float right_gain = push.volume * min(2 * push.pan, 1.0);
+
+    for (uint offs = push.first_sample + gl_GlobalInvocationID.x; offs < end_offs; offs += delta) {
+
+        const float value = generate_sample(offs, push.num_samples, push.base_freq);
+
+        const float left  = value * left_gain;
+        const float right = value * right_gain;
+
+        const uint out_offs = (push.out_offs + offs - push.first_sample) * 2;
+
+        if (out_format == format_float32) {
+            out_float32[out_offs]     = left;
+            out_float32[out_offs + 1] = right;
+        }
+        else if (out_format == format_int24) {
+            out_int32[out_offs]     = int(clamp(left,  -1.0, 1.0) * 8388607.0);
+            out_int32[out_offs + 1] = int(clamp(right, -1.0, 1.0) * 8388607.0);
+        }
+        else {
+            out_int16[out_offs]     = int16_t(clamp(left,  -1.0, 1.0) * 32767.0);
+            out_int16[out_offs + 1] = int16_t(clamp(right, -1.0, 1.0) * 32767.0);
+        }
+    }
+}
@@ -1,10 +1,12 @@
 // SPDX-License-Identifier: MIT
 // SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
 
+#include "sound.h"
+#include "d_printf.h"
+#include "gpu_synth.h"
 #include "minivulkan.h"
 #include "mstdc.h"
-#include "vmath.h"
-#include "vecfloat.h"
+#include "tracker.h"
 
 #ifdef __APPLE__
 #   define NEED_WAV_HEADER 1
@@ -29,11 +31,6 @@ struct WAVHeader {
 
 static_assert(sizeof(WAVHeader) == 44);
 
-struct Sample16Stereo {
-    int16_t left;
-    int16_t right;
-};
-
 struct WAVFile16Stereo {
 #if NEED_WAV_HEADER
     WAVHeader      header;
@@ -41,10 +38,6 @@ struct WAVFile16Stereo {
     Sample16Stereo data[1];
 };
 
-static constexpr uint32_t sampling_rate   = 44100;
-static constexpr uint16_t num_channels    = 2;
-static constexpr uint16_t bits_per_sample = 16;
-
 #if NEED_WAV_HEADER
 static const WAVHeader wav_header = {
     { 'R', 'I', 'F', 'F' },
@@ -62,13 +55,166 @@ static const WAVHeader wav_header = {
 };
 #endif
 
+static void copy_frames(Sample16Stereo* dest, const Sample16Stereo* src, uint32_t num_frames)
+{
+    if (num_frames)
+        mstd::mem_copy(dest, src, num_frames * static_cast<uint32_t>(sizeof(Sample16Stereo)));
+}
+
+void SoundRing::init(Sample16Stereo* storage, uint32_t capacity)
+{
+    assert(capacity && ! (capacity & (capacity - 1)));
+
+    buffer = storage;
+    mask   = capacity - 1;
+    write_pos.store(0, std::memory_order_relaxed);
+    read_pos.store(0, std::memory_order_relaxed);
+}
+
+uint32_t SoundRing::get_num_free() const
+{
+    const uint32_t used = write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_acquire);
+
+    return mask + 1 - used;
+}
+
+uint32_t SoundRing::get_num_used() const
+{
+    return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_relaxed);
+}
+
+uint32_t SoundRing::write(const Sample16Stereo* frames, uint32_t num_frames)
+{
+    const uint32_t pos = write_pos.load(std::memory_order_relaxed);
+
+    num_frames = mstd::min(num_frames, get_num_free());
+
+    // Copy in up to two parts if the frames wrap around the end of the buffer
+    const uint32_t begin     = pos & mask;
+    const uint32_t first_num = mstd::min(num_frames, mask + 1 - begin);
+    copy_frames(&buffer[begin], frames, first_num);
+    copy_frames(buffer, &frames[first_num], num_frames - first_num);
+
+    // Publish the frames to the consumer
+    write_pos.store(pos + num_frames, std::memory_order_release);
+
+    return num_frames;
+}
+
+uint32_t SoundRing::read(Sample16Stereo* frames, uint32_t num_frames)
+{
+    const uint32_t pos = read_pos.load(std::memory_order_relaxed);
+
+    num_frames = mstd::min(num_frames, get_num_used());
+
+    const uint32_t begin     = pos & mask;
+    const uint32_t first_num = mstd::min(num_frames, mask + 1 - begin);
+    copy_frames(frames, &buffer[begin], first_num);
+    copy_frames(&frames[first_num], buffer, num_frames - first_num);
+
+    // Return the space to the producer
+    read_pos.store(pos + num_frames, std::memory_order_release);
+
+    return num_frames;
+}
+
+// Barely audible test tone, A4 for 50 ms
+static constexpr uint32_t test_duration_ms = 50;
+
+static const Synth::Instrument test_instrument = {
+    { },    // lfo
+    { },    // envelope
+    {
+        { 1, Synth::wave_sine, 0, 0, 0, 0, 0 }
+    },
+    1       // num_comps
+};
+
+static const Tracker::Cell test_cells[] = {
+    { 69, 1, 1, Tracker::effect_none }
+};
+
+static const Tracker::Pattern test_patterns[] = {
+    { test_cells, mstd::array_size(test_cells) }
+};
+
+static const uint8_t test_order[] = { 0 };
+
+static const Tracker::Song test_song = {
+    &test_instrument,
+    test_patterns,
+    test_order,
+    mstd::array_size(test_order),
+    mstd::align_down(test_duration_ms * sampling_rate / 1000u, 4u), // samples_per_row
+    1                                                               // num_tracks
+};
+
+static Tracker::Sequencer sequencer;
+static NoteCache          note_cache;
+static GpuSynth           gpu_synth;
+static uint8_t*           gpu_synth_shader;
+
+void set_gpu_synth_shader(uint8_t* shader)
+{
+    gpu_synth_shader = shader;
+}
+
+static bool init_gpu_synth()
+{
+    if ( ! gpu_synth_shader || ! GpuSynth::is_available())
+        return false;
+
+    // Frames are rendered directly in the format of the sound stream and the WAV track
+    static_assert(bits_per_sample == 16);
+    constexpr GpuSynth::SampleFormat format = GpuSynth::SampleFormat::int16;
+
+    if ( ! gpu_synth.init(gpu_synth_shader, format)) {
+        d_printf("Failed to initialize GPU synth, using CPU synth\n");
+        return false;
+    }
+
+    // The test song is a single A4 note, which lasts until the end of the song
+    const float volume = static_cast<float>(test_cells[0].volume) / 255.0f;
+
+    return gpu_synth.start_note(test_instrument, 440, Tracker::get_song_length(test_song), volume);
+}
+
 bool init_sound()
 {
-    constexpr uint64_t duration_ms  = 50;
-    constexpr uint32_t frequency_hz = 440; // A
+    const bool use_gpu_synth = init_gpu_synth();
+
+    if ( ! use_gpu_synth) {
+        sequencer.set_note_cache(&note_cache);
+        sequencer.start(test_song);
+    }
+
+#ifdef __linux__
+    // Render a few hundred milliseconds ahead of playback
+    static SoundStreamConfig config = {
+        Tracker::Sequencer::render_stream,
+        &sequencer,
+        1024,   // period_frames
+        4,      // num_periods
+        16384   // ring_frames
+    };
+
+    if (use_gpu_synth) {
+        config.render = GpuSynth::render_stream;
+        config.user   = &gpu_synth;
+    }
+
+    // Missing sound is not fatal
+    if ( ! open_sound_stream(config)) {
+        d_printf("Failed to open sound stream, sound is disabled\n");
+    }
 
-    constexpr uint32_t total_samples = static_cast<uint32_t>((duration_ms * sampling_rate) / 1000u);
-    constexpr uint32_t data_size     = total_samples * num_channels * (bits_per_sample / 8u);
+    return true;
+#else
+    // Platforms without streaming render the whole song up front
+    const uint32_t total_samples = Tracker::get_song_length(test_song);
+
+    constexpr uint32_t max_samples   = test_duration_ms * sampling_rate / 1000u;
+    constexpr uint32_t data_size     = max_samples * num_channels * (bits_per_sample / 8u);
     constexpr uint32_t wav_hdr_size  = NEED_WAV_HEADER ? static_cast<uint32_t>(sizeof(WAVHeader)) : 0u;
     constexpr uint32_t alloc_size    = wav_hdr_size + data_size;
 
@@ -76,23 +222,18 @@ bool init_sound()
 
     WAVFile16Stereo& wav_file = *reinterpret_cast<WAVFile16Stereo*>(audio_buf);
 
+    assert(total_samples <= max_samples);
+    const uint32_t num_samples = use_gpu_synth ? gpu_synth.render(wav_file.data, total_samples)
+                                               : sequencer.render(wav_file.data, total_samples);
+    const uint32_t used_size   = wav_hdr_size + num_samples * num_channels * (bits_per_sample / 8u);
+
     #if NEED_WAV_HEADER
     mstd::mem_copy(audio_buf, &wav_header, sizeof(wav_header));
 
-    wav_file.header.file_size = alloc_size - 8;
-    wav_file.header.data_size = data_size;
+    wav_file.header.file_size = used_size - 8;
+    wav_file.header.data_size = used_size - wav_hdr_size;
     #endif
 
-    constexpr float coeff = vmath::two_pi * frequency_hz / sampling_rate;
-
-    for (uint32_t i = 0; i < total_samples; i++) {
-        const vmath::sin_cos_result sc = vmath::sincos(static_cast<float>(i) * coeff);
-        const int16_t value = static_cast<int16_t>(sc.cos * 0.001f * 32767);
-
-        Sample16Stereo& out = wav_file.data[i];
-        out.left  = value;
-        out.right = value;
-    }
-
-    return load_sound_track(audio_buf, mstd::array_size(audio_buf));
+    return load_sound_track(audio_buf, used_size);
+#endif
 }
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+struct Sample16Stereo {
+    int16_t left;
+    int16_t right;
+};
+
+static constexpr uint32_t sampling_rate   = 44100;
+static constexpr uint16_t num_channels    = 2;
+static constexpr uint16_t bits_per_sample = 16;
+
+// Single-producer single-consumer ring of stereo frames, which does not use locks.
+// One thread may only write and another thread may only read.
+class SoundRing {
+    public:
+        // Capacity must be a power of two
+        void init(Sample16Stereo* storage, uint32_t capacity);
+
+        // Called only by the producer, returns number of frames actually written
+        uint32_t write(const Sample16Stereo* frames, uint32_t num_frames);
+        uint32_t get_num_free() const;
+
+        // Called only by the consumer, returns number of frames actually read
+        uint32_t read(Sample16Stereo* frames, uint32_t num_frames);
+        uint32_t get_num_used() const;
+
+    private:
+        Sample16Stereo* buffer = nullptr;
+        uint32_t        mask   = 0;
+
+        // Free-running positions, kept on separate cache lines to avoid false sharing
+        alignas(64) std::atomic<uint32_t> write_pos{0};
+        alignas(64) std::atomic<uint32_t> read_pos{0};
+};
+
+// Renders subsequent frames of a sound stream, returns fewer frames than requested
+// when the stream ends
+typedef uint32_t (*SoundRenderFunc)(void* user, Sample16Stereo* frames, uint32_t num_frames);
+
+struct SoundStreamConfig {
+    SoundRenderFunc render;        // Called on the producer thread
+    void*           user;          // Passed to render
+    uint32_t        period_frames; // Frames written to the device at a time
+    uint32_t        num_periods;   // Periods buffered by the device
+    uint32_t        ring_frames;   // Frames rendered ahead, rounded up to a power of two
+};
+
+struct SoundStreamStats {
+    uint32_t ring_underruns;   // Periods for which the producer did not render frames in time
+    uint32_t device_underruns; // Times the device ran out of frames
+    uint64_t frames_played;
+};
+
+// Streaming playback, currently only implemented on Linux.  The ring is filled
+// before the stream is started.  A real-time thread moves frames from the ring
+// to the device and plays silence if the ring runs out of frames.
+bool open_sound_stream(const SoundStreamConfig& config);
+bool start_sound_stream();
+void close_sound_stream();
+SoundStreamStats get_sound_stream_stats();
+
+// Shader used to render notes with GpuSynth, e.g. shaders/synth_stereo.comp.glsl.
+// Shaders are built per project, so the application sets it before init_sound().
+// Without it, or if GpuSynth is not available, notes are rendered by the CPU synth.
+void set_gpu_synth_shader(uint8_t* shader);
+
+// Platform playback of a whole sound track, which on Linux plays through the stream
+bool load_sound_track(const void* data, uint32_t size);
+bool play_sound_track();
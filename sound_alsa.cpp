@@ -0,0 +1,426 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "sound.h"
+#include "d_printf.h"
+#include "mstdc.h"
+
+#include <alloca.h>
+#include <assert.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// ALSA is loaded dynamically, so that the executable still runs, without sound,
+// on systems where it is not installed.  The few types and functions which are used
+// are declared here, so that building does not require ALSA development headers.
+// The functions are only used to obtain their types, they are never linked.
+typedef struct _snd_pcm           snd_pcm_t;
+typedef struct _snd_pcm_hw_params snd_pcm_hw_params_t;
+typedef unsigned long             snd_pcm_uframes_t;
+typedef long                      snd_pcm_sframes_t;
+
+enum snd_pcm_stream_t {
+    SND_PCM_STREAM_PLAYBACK = 0
+};
+
+enum snd_pcm_access_t {
+    SND_PCM_ACCESS_RW_INTERLEAVED = 3
+};
+
+enum snd_pcm_format_t {
+    SND_PCM_FORMAT_S16_LE = 2
+};
+
+extern "C" {
+    int               snd_pcm_open(snd_pcm_t** pcm, const char* name, snd_pcm_stream_t stream, int mode);
+    int               snd_pcm_close(snd_pcm_t* pcm);
+    size_t            snd_pcm_hw_params_sizeof();
+    int               snd_pcm_hw_params_any(snd_pcm_t* pcm, snd_pcm_hw_params_t* params);
+    int               snd_pcm_hw_params_set_access(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, snd_pcm_access_t access);
+    int               snd_pcm_hw_params_set_format(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, snd_pcm_format_t format);
+    int               snd_pcm_hw_params_set_channels(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, unsigned int val);
+    int               snd_pcm_hw_params_set_rate_near(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, unsigned int* val, int* dir);
+    int               snd_pcm_hw_params_set_period_size_near(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, snd_pcm_uframes_t* val, int* dir);
+    int               snd_pcm_hw_params_set_periods_near(snd_pcm_t* pcm, snd_pcm_hw_params_t* params, unsigned int* val, int* dir);
+    int               snd_pcm_hw_params(snd_pcm_t* pcm, snd_pcm_hw_params_t* params);
+    int               snd_pcm_prepare(snd_pcm_t* pcm);
+    snd_pcm_sframes_t snd_pcm_writei(snd_pcm_t* pcm, const void* buffer, snd_pcm_uframes_t size);
+    int               snd_pcm_recover(snd_pcm_t* pcm, int err, int silent);
+    int               snd_pcm_drop(snd_pcm_t* pcm);
+    const char*       snd_strerror(int errnum);
+}
+
+#define ALSA_FUNCTIONS \
+    X(snd_pcm_open) \
+    X(snd_pcm_close) \
+    X(snd_pcm_hw_params_sizeof) \
+    X(snd_pcm_hw_params_any) \
+    X(snd_pcm_hw_params_set_access) \
+    X(snd_pcm_hw_params_set_format) \
+    X(snd_pcm_hw_params_set_channels) \
+    X(snd_pcm_hw_params_set_rate_near) \
+    X(snd_pcm_hw_params_set_period_size_near) \
+    X(snd_pcm_hw_params_set_periods_near) \
+    X(snd_pcm_hw_params) \
+    X(snd_pcm_prepare) \
+    X(snd_pcm_writei) \
+    X(snd_pcm_recover) \
+    X(snd_pcm_drop) \
+    X(snd_strerror)
+
+namespace {
+    void* alsa_lib;
+
+    #define X(func) decltype(&::func) func;
+    struct AlsaFunctions {
+        ALSA_FUNCTIONS
+    } alsa;
+    #undef X
+
+    constexpr uint32_t max_period_frames = 4096;
+    constexpr uint32_t max_ring_frames   = 65536; // About 1.5 s
+
+    Sample16Stereo ring_storage[max_ring_frames];
+    SoundRing      ring;
+
+    SoundStreamConfig stream_config;
+    snd_pcm_t*        pcm;
+    pthread_t         device_thread;
+    pthread_t         producer_thread;
+    bool              threads_started;
+
+    std::atomic<bool>     playing;
+    std::atomic<bool>     quit;
+    std::atomic<bool>     producer_done;
+    std::atomic<uint32_t> ring_underruns;
+    std::atomic<uint32_t> device_underruns;
+    std::atomic<uint64_t> frames_played;
+
+    bool load_alsa()
+    {
+        if (alsa_lib)
+            return true;
+
+        static const char lib_name[] = "libasound.so.2";
+
+        alsa_lib = dlopen(lib_name, RTLD_NOW | RTLD_LOCAL);
+
+        d_printf("%s %s\n", alsa_lib ? "Loaded" : "Failed to load", lib_name);
+
+        if ( ! alsa_lib)
+            return false;
+
+        #define X(func)                                                         \
+            alsa.func = reinterpret_cast<decltype(alsa.func)>(dlsym(alsa_lib, #func)); \
+            if ( ! alsa.func) {                                                 \
+                d_printf("Failed to load %s\n", #func);                         \
+                dlclose(alsa_lib);                                              \
+                alsa_lib = nullptr;                                             \
+                return false;                                                   \
+            }
+        ALSA_FUNCTIONS
+        #undef X
+
+        return true;
+    }
+
+    bool check_alsa(int err, const char* desc)
+    {
+        if (err >= 0)
+            return true;
+
+        d_printf("ALSA: %s failed: %s\n", desc, alsa.snd_strerror(err));
+        return false;
+    }
+
+    bool configure_device(snd_pcm_t* dev)
+    {
+        snd_pcm_hw_params_t* const params = static_cast<snd_pcm_hw_params_t*>(
+                alloca(alsa.snd_pcm_hw_params_sizeof()));
+
+        unsigned int      rate        = sampling_rate;
+        snd_pcm_uframes_t period_size = stream_config.period_frames;
+        unsigned int      periods     = stream_config.num_periods;
+
+        if ( ! check_alsa(alsa.snd_pcm_hw_params_any(dev, params), "snd_pcm_hw_params_any") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_access(dev, params, SND_PCM_ACCESS_RW_INTERLEAVED), "set_access") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_format(dev, params, SND_PCM_FORMAT_S16_LE), "set_format") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_channels(dev, params, num_channels), "set_channels") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_rate_near(dev, params, &rate, nullptr), "set_rate_near") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_period_size_near(dev, params, &period_size, nullptr), "set_period_size_near") ||
+             ! check_alsa(alsa.snd_pcm_hw_params_set_periods_near(dev, params, &periods, nullptr), "set_periods_near") ||
+             ! check_alsa(alsa.snd_pcm_hw_params(dev, params), "snd_pcm_hw_params"))
+            return false;
+
+        if (rate != sampling_rate) {
+            d_printf("ALSA: unsupported sampling rate %u\n", rate);
+            return false;
+        }
+
+        // The device may round the period, the thread writes whatever size it picked
+        stream_config.period_frames = mstd::min(static_cast<uint32_t>(period_size), max_period_frames);
+        stream_config.num_periods   = periods;
+
+        d_printf("ALSA: period %u frames, %u periods\n", stream_config.period_frames, periods);
+
+        return true;
+    }
+
+    void sleep_frames(uint32_t num_frames)
+    {
+        const uint64_t ns = static_cast<uint64_t>(num_frames) * 1'000'000'000u / sampling_rate;
+
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(ns / 1'000'000'000u);
+        ts.tv_nsec = static_cast<long>(ns % 1'000'000'000u);
+
+        nanosleep(&ts, nullptr);
+    }
+
+    // Renders as many whole periods as fit in the ring
+    void fill_ring()
+    {
+        Sample16Stereo frames[max_period_frames];
+
+        const uint32_t period_frames = stream_config.period_frames;
+
+        while ( ! producer_done.load(std::memory_order_relaxed) && ring.get_num_free() >= period_frames) {
+            const uint32_t num_rendered = stream_config.render(stream_config.user, frames, period_frames);
+
+            ring.write(frames, num_rendered);
+
+            if (num_rendered < period_frames)
+                producer_done.store(true, std::memory_order_release);
+        }
+    }
+
+    void* producer_thread_func(void*)
+    {
+        while ( ! quit.load(std::memory_order_relaxed) && ! producer_done.load(std::memory_order_relaxed)) {
+            fill_ring();
+
+            // Wake up when about half of the ring has been played
+            sleep_frames(mstd::max(ring.get_num_used() / 2, stream_config.period_frames));
+        }
+
+        return nullptr;
+    }
+
+    void* device_thread_func(void*)
+    {
+        Sample16Stereo frames[max_period_frames];
+
+        const uint32_t period_frames = stream_config.period_frames;
+
+        while ( ! quit.load(std::memory_order_relaxed)) {
+
+            if ( ! playing.load(std::memory_order_acquire)) {
+                sleep_frames(period_frames);
+                continue;
+            }
+
+            const bool     done       = producer_done.load(std::memory_order_acquire);
+            const uint32_t num_frames = ring.read(frames, period_frames);
+
+            if (done && ! num_frames)
+                break;
+
+            if (num_frames < period_frames) {
+                if ( ! done)
+                    ring_underruns.fetch_add(1, std::memory_order_relaxed);
+
+                mstd::mem_zero(&frames[num_frames], (period_frames - num_frames) * static_cast<uint32_t>(sizeof(Sample16Stereo)));
+            }
+
+            uint32_t written = 0;
+            while (written < period_frames) {
+                const snd_pcm_sframes_t res = alsa.snd_pcm_writei(pcm, &frames[written], period_frames - written);
+
+                if (res >= 0) {
+                    written += static_cast<uint32_t>(res);
+                    continue;
+                }
+
+                if (res == -EPIPE)
+                    device_underruns.fetch_add(1, std::memory_order_relaxed);
+
+                if ( ! check_alsa(alsa.snd_pcm_recover(pcm, static_cast<int>(res), 1), "snd_pcm_recover"))
+                    return nullptr;
+            }
+
+            frames_played.fetch_add(num_frames, std::memory_order_relaxed);
+        }
+
+        return nullptr;
+    }
+
+    bool start_threads()
+    {
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+
+        // Real-time priority requires privileges, fall back to normal priority without them
+        struct sched_param param = { };
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+
+        bool ok = pthread_create(&device_thread, &attr, device_thread_func, nullptr) == 0;
+        pthread_attr_destroy(&attr);
+
+        if ( ! ok) {
+            d_printf("ALSA: failed to start real-time thread, using normal priority\n");
+            ok = pthread_create(&device_thread, nullptr, device_thread_func, nullptr) == 0;
+        }
+
+        if ( ! ok) {
+            d_printf("ALSA: failed to start device thread\n");
+            return false;
+        }
+
+        if (pthread_create(&producer_thread, nullptr, producer_thread_func, nullptr) != 0) {
+            d_printf("ALSA: failed to start producer thread\n");
+            quit.store(true, std::memory_order_relaxed);
+            pthread_join(device_thread, nullptr);
+            return false;
+        }
+
+        threads_started = true;
+        return true;
+    }
+
+    // Pre-rendered track played through the stream
+    const Sample16Stereo* track_frames;
+    uint32_t              track_num_frames;
+    uint32_t              track_pos;
+
+    uint32_t render_track(void*, Sample16Stereo* frames, uint32_t num_frames)
+    {
+        num_frames = mstd::min(num_frames, track_num_frames - track_pos);
+
+        if (num_frames)
+            mstd::mem_copy(frames, &track_frames[track_pos], num_frames * static_cast<uint32_t>(sizeof(Sample16Stereo)));
+        track_pos += num_frames;
+
+        return num_frames;
+    }
+}
+
+bool open_sound_stream(const SoundStreamConfig& config)
+{
+    assert( ! pcm);
+    assert(config.render);
+
+    if ( ! load_alsa())
+        return false;
+
+    stream_config = config;
+    stream_config.period_frames = mstd::min(mstd::max(config.period_frames, 64U), max_period_frames);
+    stream_config.num_periods   = mstd::max(config.num_periods, 2U);
+
+    if ( ! check_alsa(alsa.snd_pcm_open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0), "snd_pcm_open")) {
+        pcm = nullptr;
+        return false;
+    }
+
+    if ( ! configure_device(pcm)) {
+        close_sound_stream();
+        return false;
+    }
+
+    uint32_t ring_frames = 1;
+    while (ring_frames < mstd::max(config.ring_frames, stream_config.period_frames * 2) && ring_frames < max_ring_frames)
+        ring_frames *= 2;
+    ring.init(ring_storage, ring_frames);
+
+    playing.store(false, std::memory_order_relaxed);
+    quit.store(false, std::memory_order_relaxed);
+    producer_done.store(false, std::memory_order_relaxed);
+    ring_underruns.store(0, std::memory_order_relaxed);
+    device_underruns.store(0, std::memory_order_relaxed);
+    frames_played.store(0, std::memory_order_relaxed);
+
+    // Render ahead before playback starts, so that it does not begin with an underrun
+    fill_ring();
+
+    if ( ! start_threads()) {
+        close_sound_stream();
+        return false;
+    }
+
+    return true;
+}
+
+bool start_sound_stream()
+{
+    if ( ! pcm)
+        return false;
+
+    if ( ! check_alsa(alsa.snd_pcm_prepare(pcm), "snd_pcm_prepare"))
+        return false;
+
+    playing.store(true, std::memory_order_release);
+    return true;
+}
+
+void close_sound_stream()
+{
+    if (threads_started) {
+        quit.store(true, std::memory_order_relaxed);
+        pthread_join(producer_thread, nullptr);
+        pthread_join(device_thread, nullptr);
+        threads_started = false;
+    }
+
+    if (pcm) {
+        alsa.snd_pcm_drop(pcm);
+        alsa.snd_pcm_close(pcm);
+        pcm = nullptr;
+    }
+
+    playing.store(false, std::memory_order_relaxed);
+}
+
+SoundStreamStats get_sound_stream_stats()
+{
+    SoundStreamStats stats;
+    stats.ring_underruns   = ring_underruns.load(std::memory_order_relaxed);
+    stats.device_underruns = device_underruns.load(std::memory_order_relaxed);
+    stats.frames_played    = frames_played.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool load_sound_track(const void* data, uint32_t size)
+{
+    track_frames     = static_cast<const Sample16Stereo*>(data);
+    track_num_frames = size / static_cast<uint32_t>(sizeof(Sample16Stereo));
+    track_pos        = 0;
+
+    static const SoundStreamConfig config = {
+        render_track,
+        nullptr, // user
+        1024,    // period_frames
+        4,       // num_periods
+        16384    // ring_frames
+    };
+
+    // Missing sound is not fatal
+    if ( ! open_sound_stream(config)) {
+        d_printf("Failed to open sound stream, sound is disabled\n");
+    }
+
+    return true;
+}
+
+bool play_sound_track()
+{
+    if (pcm && ! start_sound_stream()) {
+        d_printf("Failed to start soundtrack\n");
+    }
+
+    return true;
+}
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "synth.h"
+
+#include "mstdc.h"
+#include "parallel.h"
+#include "vecfloat.h"
+#include "vmath.h"
+
+using vmath::float4;
+
+// Integer arithmetic follows the shader, including 32-bit wrap-around, so that
+// envelopes, LFOs and periods are the same on the CPU and on the GPU.
+// Only waves are evaluated 4 samples at a time, because sine dominates the cost.
+
+namespace {
+    // Below this many samples per thread it's not worth starting more threads
+    constexpr uint32_t min_samples_per_thread = 8192;
+
+    constexpr uint32_t num_lanes = 4;
+
+    uint32_t random(uint32_t index)
+    {
+        // Use offset (index to the sample) as seed for a trivial LCG
+        uint32_t state = (index << 1) | 1;
+
+        // Loop a few times through the LCG
+        for (uint32_t i = 0; i < 4; i++)
+            state = (state * 0x8088405U) + 1;
+
+        // Use xorshift+ RNG from the above seed generated with LCG
+        uint32_t rand = (state * 0x8088405U) + 1;
+        rand ^= rand << 23;
+        rand ^= rand >> 18;
+        rand ^= state ^ (state >> 5);
+        rand = (state + rand) & 0xFFFFU;
+
+        return rand;
+    }
+
+    // Phase is offset within the period, noise uses the offset directly
+    float wave(uint32_t wave_type, uint32_t offs, uint32_t phase, uint32_t period)
+    {
+        if (wave_type == Synth::wave_noise)
+            return static_cast<float>(random(offs) & 0xFFFFU) / 32768.0f - 1;
+
+        const uint32_t half_period = period / 2;
+
+        if (wave_type == Synth::wave_square)
+            return (phase < half_period) ? -1.0f : 1.0f;
+
+        const float value = (static_cast<float>(phase) / static_cast<float>(half_period)) - 1;
+
+        // Convert sawtooth to triangle wave
+        if (wave_type == Synth::wave_triangle)
+            return (((value < 0) ? -value : value) * 2) - 1;
+
+        return value;
+    }
+
+    float4 wave4(uint32_t wave_type, const uint32_t* offs, const uint32_t* phase, const uint32_t* period)
+    {
+        alignas(16) float values[num_lanes];
+
+        if (wave_type == Synth::wave_sine) {
+            // The phase is reduced before converting to float, unlike in the shader,
+            // which loses precision with large offsets
+            for (uint32_t lane = 0; lane < num_lanes; lane++)
+                values[lane] = static_cast<float>(phase[lane]) * (vmath::two_pi / static_cast<float>(period[lane]));
+
+            return vmath::sincos(float4::load4_aligned(values)).sin;
+        }
+
+        for (uint32_t lane = 0; lane < num_lanes; lane++)
+            values[lane] = wave(wave_type, offs[lane], phase[lane], period[lane]);
+
+        return float4::load4_aligned(values);
+    }
+
+    // Fills phases of consecutive offsets with a fixed period without dividing for each offset
+    void fill_phases(uint32_t* phase, uint32_t count, uint32_t offs, uint32_t period)
+    {
+        uint32_t cur_phase = offs % period;
+
+        for (uint32_t i = 0; i < count; i++) {
+            phase[i] = cur_phase;
+            if (++cur_phase == period)
+                cur_phase = 0;
+        }
+    }
+
+    uint32_t get_period(uint32_t freq)
+    {
+        // Unlike in the shader, degenerate frequencies do not divide by zero
+        return mstd::max(freq ? (Synth::mix_freq / freq) : Synth::mix_freq, 2U);
+    }
+
+    uint16_t mix16(uint16_t start_value, uint16_t end_value, uint32_t offs, uint32_t end_offs)
+    {
+        const int32_t range = static_cast<int32_t>(end_value) - static_cast<int32_t>(start_value);
+        const int32_t delta = static_cast<int32_t>(offs * static_cast<uint32_t>(range)) /
+                              static_cast<int32_t>(end_offs);
+        return static_cast<uint16_t>(static_cast<int32_t>(start_value) + delta);
+    }
+
+    uint32_t envelope(const Synth::ADSR& envelope, uint32_t offs, uint32_t duration_ms)
+    {
+        constexpr uint32_t mix_freq = Synth::mix_freq;
+
+        const uint32_t attack_end_offs = envelope.attack_ms * mix_freq / 1000;
+        if (offs < attack_end_offs)
+            return mix16(envelope.init_value, envelope.max_value, offs, attack_end_offs);
+
+        offs -= attack_end_offs;
+
+        const uint32_t decay_end_offs = envelope.decay_ms * mix_freq / 1000;
+        if (offs < decay_end_offs)
+            return mix16(envelope.max_value, envelope.sustain_value, offs, decay_end_offs);
+
+        offs -= decay_end_offs;
+
+        const uint32_t att_dec_rel_ms   = static_cast<uint32_t>(envelope.attack_ms) + envelope.decay_ms + envelope.release_ms;
+        const uint32_t sustain_ms       = duration_ms - att_dec_rel_ms;
+        const uint32_t sustain_end_offs = sustain_ms * mix_freq / 1000;
+        if (offs < sustain_end_offs)
+            return envelope.sustain_value;
+
+        offs -= sustain_end_offs;
+
+        const uint32_t release_end_offs = envelope.release_ms * mix_freq / 1000;
+        if (offs < release_end_offs)
+            return mix16(envelope.sustain_value, envelope.end_value, offs, release_end_offs);
+
+        return envelope.end_value;
+    }
+
+    // Samples are rendered in chunks, one component at a time, so that parameters
+    // which are constant for a component are only computed once per chunk
+    constexpr uint32_t chunk_size = 256;
+
+    void render_chunk(const Synth::Instrument& instrument,
+                      uint32_t                 base_freq,
+                      uint32_t                 num_samples,
+                      uint32_t                 first_offs,
+                      uint32_t                 count,
+                      float*                   out_sound)
+    {
+        constexpr uint32_t mix_freq = Synth::mix_freq;
+
+        // Lanes past count are computed, but never stored
+        const uint32_t num_padded = mstd::align_up(count, num_lanes);
+
+        uint32_t offs[chunk_size];
+        uint32_t phase[chunk_size];
+        uint32_t period[chunk_size];
+
+        for (uint32_t i = 0; i < num_padded; i++)
+            offs[i] = first_offs + i;
+
+        int32_t lfo_values[Synth::max_lfos][chunk_size];
+        for (uint32_t i = 0; i < Synth::max_lfos; i++) {
+            const Synth::LFO& lfo = instrument.lfo[i];
+
+            if (lfo.period_ms == 0) {
+                for (uint32_t j = 0; j < num_padded; j++)
+                    lfo_values[i][j] = 0;
+                continue;
+            }
+
+            const uint32_t lfo_period = lfo.period_ms * mix_freq / 1000;
+            const float4   peak_delta = vmath::spread4(static_cast<float>(lfo.peak_delta));
+
+            fill_phases(phase, num_padded, first_offs, lfo_period);
+            for (uint32_t j = 0; j < num_padded; j++)
+                period[j] = lfo_period;
+
+            for (uint32_t j = 0; j < num_padded; j += num_lanes) {
+                alignas(16) float values[num_lanes];
+                (wave4(lfo.wave_type, &offs[j], &phase[j], &period[j]) * peak_delta).store4_aligned(values);
+
+                for (uint32_t lane = 0; lane < num_lanes; lane++)
+                    lfo_values[i][j + lane] = static_cast<int32_t>(values[lane]);
+            }
+        }
+
+        alignas(16) float accum[chunk_size];
+        alignas(16) float amp[chunk_size];
+
+        for (uint32_t i = 0; i < num_padded; i++)
+            accum[i] = 0;
+
+        const uint32_t duration_ms = num_samples * 1000 / mix_freq;
+        const uint32_t num_comps   = mstd::min(instrument.num_comps, Synth::max_components);
+
+        for (uint32_t i = 0; i < num_comps; i++) {
+            const Synth::Component& comp = instrument.comps[i];
+
+            // Samples before the start of the component are skipped
+            const uint32_t start_offs = comp.delay_us * mix_freq / 1000000;
+            if (first_offs + num_padded <= start_offs)
+                continue;
+
+            const uint32_t skip     = (start_offs > first_offs) ? mstd::align_down(start_offs - first_offs, num_lanes) : 0U;
+            const uint32_t delay_ms = (comp.delay_us > 0) ? ((comp.delay_us - 1U) / 1000 + 1) : 0;
+
+            const Synth::ADSR* const freq_env = comp.freq_env      ? &instrument.envelope[comp.freq_env - 1]      : nullptr;
+            const Synth::ADSR* const amp_env  = comp.amplitude_env ? &instrument.envelope[comp.amplitude_env - 1] : nullptr;
+            const int32_t*     const freq_lfo = comp.freq_lfo      ? lfo_values[comp.freq_lfo - 1]                : nullptr;
+            const int32_t*     const amp_lfo  = comp.amplitude_lfo ? lfo_values[comp.amplitude_lfo - 1]          : nullptr;
+
+            uint32_t comp_offs[chunk_size];
+
+            for (uint32_t j = skip; j < num_padded; j++) {
+                // Samples in the first group before the start of the component are computed, but silenced
+                const bool active = offs[j] >= start_offs;
+
+                comp_offs[j] = active ? (offs[j] - start_offs) : 0U;
+
+                float value_mult = active ? 1.0f : 0.0f;
+
+                if (amp_lfo)
+                    value_mult *= static_cast<float>(amp_lfo[j]) / 65535.0f;
+
+                if (amp_env)
+                    value_mult *= static_cast<float>(envelope(*amp_env, comp_offs[j], duration_ms - delay_ms)) / 65536.0f;
+
+                amp[j] = value_mult;
+            }
+
+            // Without frequency modulation the period is constant
+            if ( ! freq_lfo && ! freq_env) {
+                const uint32_t comp_period = get_period(base_freq * comp.freq_mult);
+
+                for (uint32_t j = skip; j < num_padded; j++)
+                    period[j] = comp_period;
+
+                const uint32_t first_active = (start_offs > first_offs) ? (start_offs - first_offs) : 0U;
+                for (uint32_t j = skip; j < first_active; j++)
+                    phase[j] = 0;
+                fill_phases(&phase[first_active], num_padded - first_active, comp_offs[first_active], comp_period);
+            }
+            else {
+                for (uint32_t j = skip; j < num_padded; j++) {
+                    int32_t freq_delta = freq_lfo ? freq_lfo[j] : 0;
+
+                    if (freq_env)
+                        freq_delta += static_cast<int32_t>(envelope(*freq_env, comp_offs[j], duration_ms - delay_ms)) - 32768;
+
+                    period[j] = get_period((base_freq + static_cast<uint32_t>(freq_delta)) * comp.freq_mult);
+                    phase[j]  = comp_offs[j] % period[j];
+                }
+            }
+
+            for (uint32_t j = skip; j < num_padded; j += num_lanes) {
+                const float4 value = wave4(comp.wave_type, &comp_offs[j], &phase[j], &period[j]) *
+                                     float4::load4_aligned(&amp[j]);
+                (float4::load4_aligned(&accum[j]) + value).store4_aligned(&accum[j]);
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+            out_sound[i] = accum[i];
+    }
+
+    struct NoteJob {
+        const Synth::Instrument* instrument;
+        uint32_t                 base_freq;
+        uint32_t                 num_samples;
+        float*                   out_sound;
+    };
+
+    void render_job_range(void* user, uint32_t begin, uint32_t end)
+    {
+        const NoteJob& job = *static_cast<const NoteJob*>(user);
+
+        Synth::render_note_range(*job.instrument, job.base_freq, job.num_samples, begin, end, &job.out_sound[begin]);
+    }
+}
+
+void Synth::render_note_range(const Instrument& instrument,
+                              uint32_t          base_freq,
+                              uint32_t          num_samples,
+                              uint32_t          begin,
+                              uint32_t          end,
+                              float*            out_sound)
+{
+    for (uint32_t offs = begin; offs < end; offs += chunk_size)
+        render_chunk(instrument, base_freq, num_samples, offs, mstd::min(end - offs, chunk_size), &out_sound[offs - begin]);
+}
+
+void Synth::render_note(const Instrument& instrument,
+                        uint32_t          base_freq,
+                        uint32_t          num_samples,
+                        float*            out_sound)
+{
+    NoteJob job = { &instrument, base_freq, num_samples, out_sound };
+
+    run_parallel(render_job_range, &job, num_samples, min_samples_per_thread, num_lanes);
+}
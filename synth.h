@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include <stdint.h>
+
+// CPU implementation of the instrument synthesizer in shaders/synth.glsl,
+// which produces the same samples within the precision of sine evaluation.
+// See the shader for description of components, LFOs and envelopes.
+namespace Synth {
+
+enum WaveType : uint8_t {
+    wave_sine,
+    wave_triangle,
+    wave_sawtooth,
+    wave_square,
+    wave_noise
+};
+
+struct Component {
+    uint8_t  freq_mult;     // Base frequency multiplier
+    uint8_t  wave_type;     // See WaveType
+    uint16_t delay_us;      // Delay after which this component starts playing
+    uint8_t  amplitude_lfo; // 1-based index of LFO, 0 means none
+    uint8_t  freq_lfo;      // 1-based index of LFO, 0 means none
+    uint8_t  amplitude_env; // 1-based index of envelope, 0 means none
+    uint8_t  freq_env;      // 1-based index of envelope, 0 means none
+};
+
+struct LFO {
+    uint8_t  wave_type;     // See WaveType
+    uint8_t  dummy1;
+    uint16_t period_ms;     // 0 means that LFO is disabled
+    uint16_t peak_delta;
+    uint16_t dummy2;
+};
+
+struct ADSR {
+    uint16_t init_value;
+    uint16_t max_value;
+    uint16_t sustain_value;
+    uint16_t end_value;
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint16_t dummy;
+    uint16_t release_ms;
+};
+
+static_assert(sizeof(Component) == 8, "Component must match the shader");
+static_assert(sizeof(LFO)       == 8, "LFO must match the shader");
+static_assert(sizeof(ADSR)      == 16, "ADSR must match the shader");
+
+constexpr uint32_t mix_freq       = 44100;
+constexpr uint32_t max_components = 32;
+constexpr uint32_t max_lfos       = 4;
+
+// Same layout as the shader's instrument storage buffer
+struct Instrument {
+    LFO       lfo[max_lfos];
+    ADSR      envelope[max_lfos];
+    Component comps[max_components];
+    uint32_t  num_comps;
+};
+
+// Renders a single note of an instrument into num_samples mono samples,
+// 4 samples at a time.  Long notes are split between multiple threads.
+void render_note(const Instrument& instrument,
+                 uint32_t          base_freq,
+                 uint32_t          num_samples,
+                 float*            out_sound);
+
+// Renders samples [begin, end) of a note into end - begin samples of out_sound
+// on the calling thread, begin must be a multiple of 4
+void render_note_range(const Instrument& instrument,
+                       uint32_t          base_freq,
+                       uint32_t          num_samples,
+                       uint32_t          begin,
+                       uint32_t          end,
+                       float*            out_sound);
+
+} // namespace Synth
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "synth.h"
+#include "mstdc.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(test) if ( ! (test)) { failed(#test, __FILE__, __LINE__); }
+
+static int exit_code = 0;
+
+static void failed(const char* test, const char* file, int line)
+{
+    exit_code = 1;
+    fprintf(stderr, "%s:%d: Error: Failed condition %s\n",
+            file, line, test);
+}
+
+// Scalar reference, which evaluates one sample at a time exactly like shaders/synth.glsl
+namespace reference {
+    uint32_t random(uint32_t index)
+    {
+        uint32_t state = (index << 1) | 1;
+
+        for (uint32_t i = 0; i < 4; i++)
+            state = (state * 0x8088405U) + 1;
+
+        uint32_t rand = (state * 0x8088405U) + 1;
+        rand ^= rand << 23;
+        rand ^= rand >> 18;
+        rand ^= state ^ (state >> 5);
+        rand = (state + rand) & 0xFFFFU;
+
+        return rand;
+    }
+
+    float wave(uint32_t wave_type, uint32_t offs, uint32_t period)
+    {
+        if (wave_type == Synth::wave_sine)
+            return static_cast<float>(sin(static_cast<double>(offs % period) * 6.283185307179586 / period));
+
+        if (wave_type == Synth::wave_noise)
+            return static_cast<float>(random(offs) & 0xFFFFU) / 32768.0f - 1;
+
+        offs %= period;
+        const uint32_t half_period = period / 2;
+
+        if (wave_type == Synth::wave_square)
+            return (offs < half_period) ? -1.0f : 1.0f;
+
+        float value = (static_cast<float>(offs) / static_cast<float>(half_period)) - 1;
+
+        if (wave_type == Synth::wave_triangle)
+            value = (fabsf(value) * 2) - 1;
+
+        return value;
+    }
+
+    int32_t lfo(const Synth::LFO& lfo, uint32_t offs)
+    {
+        if (lfo.period_ms == 0)
+            return 0;
+
+        const uint32_t lfo_period = lfo.period_ms * Synth::mix_freq / 1000;
+
+        return static_cast<int32_t>(wave(lfo.wave_type, offs, lfo_period) * lfo.peak_delta);
+    }
+
+    uint32_t mix16(uint32_t start_value, uint32_t end_value, uint32_t offs, uint32_t end_offs)
+    {
+        const int32_t range = static_cast<int32_t>(end_value) - static_cast<int32_t>(start_value);
+        const int32_t delta = static_cast<int32_t>(offs * static_cast<uint32_t>(range)) /
+                              static_cast<int32_t>(end_offs);
+        return static_cast<uint16_t>(static_cast<int32_t>(start_value) + delta);
+    }
+
+    uint32_t envelope(const Synth::ADSR& envelope, uint32_t offs, uint32_t duration_ms)
+    {
+        const uint32_t attack_end_offs = envelope.attack_ms * Synth::mix_freq / 1000;
+        if (offs < attack_end_offs)
+            return mix16(envelope.init_value, envelope.max_value, offs, attack_end_offs);
+
+        offs -= attack_end_offs;
+
+        const uint32_t decay_end_offs = envelope.decay_ms * Synth::mix_freq / 1000;
+        if (offs < decay_end_offs)
+            return mix16(envelope.max_value, envelope.sustain_value, offs, decay_end_offs);
+
+        offs -= decay_end_offs;
+
+        const uint32_t att_dec_rel_ms   = static_cast<uint32_t>(envelope.attack_ms) + envelope.decay_ms + envelope.release_ms;
+        const uint32_t sustain_end_offs = (duration_ms - att_dec_rel_ms) * Synth::mix_freq / 1000;
+        if (offs < sustain_end_offs)
+            return envelope.sustain_value;
+
+        offs -= sustain_end_offs;
+
+        const uint32_t release_end_offs = envelope.release_ms * Synth::mix_freq / 1000;
+        if (offs < release_end_offs)
+            return mix16(envelope.sustain_value, envelope.end_value, offs, release_end_offs);
+
+        return envelope.end_value;
+    }
+
+    float generate_sample(const Synth::Instrument& instr, uint32_t out_offs, uint32_t num_samples, uint32_t base_freq)
+    {
+        float value = 0;
+
+        int32_t lfo_values[Synth::max_lfos];
+        for (uint32_t i = 0; i < Synth::max_lfos; i++)
+            lfo_values[i] = lfo(instr.lfo[i], out_offs);
+
+        const uint32_t duration_ms = num_samples * 1000 / Synth::mix_freq;
+
+        for (uint32_t i = 0; i < instr.num_comps; i++) {
+            const Synth::Component& comp = instr.comps[i];
+
+            const uint32_t start_offs = comp.delay_us * Synth::mix_freq / 1000000;
+            if (out_offs < start_offs)
+                continue;
+
+            const uint32_t delay_ms = (comp.delay_us > 0) ? ((comp.delay_us - 1U) / 1000 + 1) : 0;
+            const uint32_t offs     = out_offs - start_offs;
+
+            int32_t freq_delta = 0;
+            if (comp.freq_lfo > 0)
+                freq_delta = lfo_values[comp.freq_lfo - 1];
+
+            if (comp.freq_env > 0)
+                freq_delta += static_cast<int32_t>(envelope(instr.envelope[comp.freq_env - 1], offs, duration_ms - delay_ms)) - 32768;
+
+            const uint32_t period = Synth::mix_freq / ((base_freq + static_cast<uint32_t>(freq_delta)) * comp.freq_mult);
+
+            float comp_value = wave(comp.wave_type, offs, period);
+
+            if (comp.amplitude_lfo > 0)
+                comp_value *= static_cast<float>(lfo_values[comp.amplitude_lfo - 1]) / 65535.0f;
+
+            if (comp.amplitude_env > 0)
+                comp_value *= static_cast<float>(envelope(instr.envelope[comp.amplitude_env - 1], offs, duration_ms - delay_ms)) / 65536.0f;
+
+            value += comp_value;
+        }
+
+        return value;
+    }
+}
+
+// The sine approximation in vmath is the only source of differences
+static constexpr float max_error = 0.005f;
+
+static void test_instrument(const char*              name,
+                            const Synth::Instrument& instrument,
+                            uint32_t                 base_freq,
+                            uint32_t                 num_samples)
+{
+    float* const out_sound = static_cast<float*>(malloc(num_samples * sizeof(float)));
+
+    Synth::render_note(instrument, base_freq, num_samples, out_sound);
+
+    float    worst_error = 0;
+    uint32_t worst_offs  = 0;
+
+    for (uint32_t offs = 0; offs < num_samples; offs++) {
+        const float expected = reference::generate_sample(instrument, offs, num_samples, base_freq);
+        const float error    = fabsf(out_sound[offs] - expected);
+
+        if (error > worst_error) {
+            worst_error = error;
+            worst_offs  = offs;
+        }
+    }
+
+    if (worst_error > max_error) {
+        fprintf(stderr, "Error: %s: sample %u is %f but should be %f\n",
+                name,
+                worst_offs,
+                static_cast<double>(out_sound[worst_offs]),
+                static_cast<double>(reference::generate_sample(instrument, worst_offs, num_samples, base_freq)));
+        exit_code = 1;
+    }
+
+    // A range which starts in the middle of the note must produce the same samples
+    const uint32_t begin = mstd::align_down(num_samples / 3, 4U);
+    const uint32_t end   = num_samples - 1;
+
+    float* const range_sound = static_cast<float*>(malloc((end - begin) * sizeof(float)));
+
+    Synth::render_note_range(instrument, base_freq, num_samples, begin, end, range_sound);
+
+    uint32_t num_mismatched = 0;
+    for (uint32_t offs = begin; offs < end; offs++) {
+        if (range_sound[offs - begin] != out_sound[offs])
+            ++num_mismatched;
+    }
+
+    TEST(num_mismatched == 0);
+
+    free(range_sound);
+    free(out_sound);
+}
+
+int main()
+{
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // each wave type as a single component
+
+    static const char* const wave_names[] = {
+        "sine", "triangle", "sawtooth", "square", "noise"
+    };
+
+    for (uint32_t wave_type = Synth::wave_sine; wave_type <= Synth::wave_noise; wave_type++) {
+        Synth::Instrument instrument = { };
+        instrument.comps[0].freq_mult = 1;
+        instrument.comps[0].wave_type = static_cast<uint8_t>(wave_type);
+        instrument.num_comps          = 1;
+
+        test_instrument(wave_names[wave_type], instrument, 440, 10000);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // amplitude envelope and delayed components
+
+    {
+        Synth::Instrument instrument = { };
+        instrument.envelope[0] = { 0, 65535, 40000, 0, 30, 60, 0, 100 };
+        instrument.comps[0]    = { 1, Synth::wave_sine,     0,    0, 0, 1, 0 };
+        instrument.comps[1]    = { 2, Synth::wave_triangle, 500,  0, 0, 1, 0 };
+        instrument.comps[2]    = { 3, Synth::wave_square,   1234, 0, 0, 1, 0 };
+        instrument.num_comps   = 3;
+
+        test_instrument("adsr", instrument, 220, 30000);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // amplitude and frequency LFOs
+
+    {
+        Synth::Instrument instrument = { };
+        instrument.lfo[0]      = { Synth::wave_sine,     0, 200, 30000, 0 };
+        instrument.lfo[1]      = { Synth::wave_triangle, 0, 50,  20,    0 };
+        instrument.comps[0]    = { 1, Synth::wave_sine,     0,   1, 0, 0, 0 };
+        instrument.comps[1]    = { 2, Synth::wave_sawtooth, 0,   0, 2, 0, 0 };
+        instrument.comps[2]    = { 1, Synth::wave_noise,    700, 1, 0, 0, 0 };
+        instrument.num_comps   = 3;
+
+        test_instrument("lfo", instrument, 330, 30000);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // frequency envelope, long enough to be split between threads
+
+    {
+        Synth::Instrument instrument = { };
+        instrument.lfo[0]      = { Synth::wave_sine,     0, 200, 30000, 0 };
+        instrument.lfo[1]      = { Synth::wave_triangle, 0, 50,  20,    0 };
+        instrument.envelope[0] = { 0, 65535, 40000, 0, 30, 60, 0, 100 };
+        instrument.envelope[1] = { 32768, 32800, 32770, 32760, 10, 20, 0, 30 };
+        instrument.comps[0]    = { 1, Synth::wave_sine,     0,    1, 0, 1, 0 };
+        instrument.comps[1]    = { 2, Synth::wave_triangle, 500,  0, 2, 1, 0 };
+        instrument.comps[2]    = { 3, Synth::wave_sawtooth, 1234, 0, 0, 1, 2 };
+        instrument.comps[3]    = { 1, Synth::wave_square,   0,    0, 0, 1, 0 };
+        instrument.comps[4]    = { 1, Synth::wave_noise,    2000, 1, 0, 1, 0 };
+        instrument.num_comps   = 5;
+
+        test_instrument("full", instrument, 440, Synth::mix_freq * 2 + 3);
+    }
+
+    return exit_code;
+}
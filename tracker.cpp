@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "tracker.h"
+
+#include "mstdc.h"
+#include "vecfloat.h"
+
+#include <assert.h>
+
+using vmath::float4;
+
+namespace {
+    // Frequencies of notes C8..B8 in 1/16 Hz, lower octaves are obtained by shifting
+    constexpr uint32_t octave8_freqs[12] = {
+        66976, 70959, 75178, 79648, 84385, 89402, 94719, 100351, 106318, 112640, 119338, 126434
+    };
+
+    uint32_t get_base_freq(uint32_t note)
+    {
+        // MIDI note 108 is C8
+        const uint32_t shift = 13 - note / 12;
+
+        return (octave8_freqs[note % 12] + (1U << (shift - 1))) >> shift;
+    }
+
+    const Tracker::Cell& get_cell(const Tracker::Song& song, uint32_t order_idx, uint32_t row, uint32_t track)
+    {
+        const Tracker::Pattern& pattern = song.patterns[song.order[order_idx]];
+
+        return pattern.cells[row * song.num_tracks + track];
+    }
+}
+
+uint32_t Tracker::get_song_length(const Song& song)
+{
+    uint32_t num_rows = 0;
+
+    for (uint32_t i = 0; i < song.order_length; i++)
+        num_rows += song.patterns[song.order[i]].num_rows;
+
+    return num_rows * song.samples_per_row;
+}
+
+void Tracker::Sequencer::start(const Song& new_song)
+{
+    assert(new_song.samples_per_row && new_song.samples_per_row % 4 == 0);
+    assert(new_song.num_tracks <= max_tracks);
+
+    for (Voice& voice : voices)
+        release_note(voice);
+
+    song       = &new_song;
+    order_idx  = 0;
+    row        = 0;
+    row_pos    = 0;
+    ended      = ! new_song.order_length;
+    block_pos  = 0;
+    block_size = 0;
+
+    for (Voice& voice : voices) {
+        voice = Voice{};
+        voice.volume = 1;
+        voice.pan    = 0.5f;
+    }
+}
+
+uint32_t Tracker::Sequencer::get_note_length(uint32_t track) const
+{
+    uint32_t num_rows  = 1;
+    uint32_t first_row = row + 1;
+
+    // The note lasts until the next note or note off on the same track, or until the end of the song
+    for (uint32_t cur_order = order_idx; cur_order < song->order_length; cur_order++) {
+        const uint32_t pattern_rows = song->patterns[song->order[cur_order]].num_rows;
+
+        for (uint32_t cur_row = first_row; cur_row < pattern_rows; cur_row++) {
+            if (get_cell(*song, cur_order, cur_row, track).note != note_none)
+                return num_rows * song->samples_per_row;
+
+            ++num_rows;
+        }
+
+        first_row = 0;
+    }
+
+    return num_rows * song->samples_per_row;
+}
+
+void Tracker::Sequencer::release_note(Voice& voice)
+{
+    if (voice.cache_entry != NoteCache::no_entry) {
+        note_cache->release(voice.cache_entry);
+        voice.cache_entry = NoteCache::no_entry;
+    }
+}
+
+void Tracker::Sequencer::process_row()
+{
+    for (uint32_t track = 0; track < song->num_tracks; track++) {
+        const Cell& cell  = get_cell(*song, order_idx, row, track);
+        Voice&      voice = voices[track];
+
+        if (cell.note == note_off) {
+            voice.note_length = voice.pos;
+            release_note(voice);
+        }
+        else if (cell.note != note_none) {
+            release_note(voice);
+
+            if (cell.instrument)
+                voice.instrument = cell.instrument;
+
+            voice.base_freq   = get_base_freq(cell.note);
+            voice.note_length = get_note_length(track);
+            voice.pos         = 0;
+            voice.volume      = 1;
+
+            if (note_cache && voice.instrument) {
+                const NoteCache::Lookup lookup = note_cache->acquire(
+                        NoteCache::hash_instrument(song->instruments[voice.instrument - 1]),
+                        voice.base_freq,
+                        voice.note_length);
+
+                voice.cache_entry    = lookup.entry;
+                voice.cache_complete = lookup.complete;
+                voice.cache_step     = lookup.step;
+            }
+        }
+
+        if (cell.volume)
+            voice.volume = static_cast<float>(cell.volume) / 255.0f;
+
+        const uint32_t effect = cell.effect >> 4;
+        const float    param  = static_cast<float>(cell.effect & 0xFU);
+
+        voice.volume_step = 0;
+
+        switch (effect) {
+            case effect_pan:
+                voice.pan = param / 15.0f;
+                break;
+
+            case effect_volume_up:
+            case effect_volume_down: {
+                const float delta  = (effect == effect_volume_up) ? (param / 16.0f) : (param / -16.0f);
+                const float target = mstd::min(mstd::max(voice.volume + delta, 0.0f), 1.0f);
+
+                voice.volume_step = (target - voice.volume) / static_cast<float>(song->samples_per_row);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+void Tracker::Sequencer::render_voice(Voice& voice, uint32_t num_frames, float* left, float* right)
+{
+    const uint32_t num_note_frames = (voice.instrument && voice.pos < voice.note_length)
+                                     ? mstd::min(num_frames, voice.note_length - voice.pos) : 0U;
+
+    if (num_note_frames) {
+        alignas(16) float samples[block_frames];
+
+        if (voice.cache_entry != NoteCache::no_entry && voice.cache_complete) {
+            if (voice.cache_step == 1.0f)
+                note_cache->read(voice.cache_entry, voice.pos, num_note_frames, samples);
+            else
+                note_cache->read_resampled(voice.cache_entry,
+                                           static_cast<float>(voice.pos) * voice.cache_step,
+                                           voice.cache_step,
+                                           num_note_frames,
+                                           samples);
+        }
+        else {
+            Synth::render_note_range(song->instruments[voice.instrument - 1],
+                                     voice.base_freq,
+                                     voice.note_length,
+                                     voice.pos,
+                                     voice.pos + num_note_frames,
+                                     samples);
+
+            if (voice.cache_entry != NoteCache::no_entry)
+                note_cache->write(voice.cache_entry, voice.pos, num_note_frames, samples);
+        }
+
+        // Equal volume on both sides in the center, full volume on one side when panned
+        const float4 left_gain  = vmath::spread4(mstd::min(2 * (1 - voice.pan), 1.0f));
+        const float4 right_gain = vmath::spread4(mstd::min(2 * voice.pan, 1.0f));
+
+        const float step   = voice.volume_step;
+        float4      volume = float4(voice.volume, voice.volume + step, voice.volume + 2 * step, voice.volume + 3 * step);
+        const float4 step4 = vmath::spread4(4 * step);
+
+        // Note lengths and positions are multiples of 4
+        for (uint32_t i = 0; i < num_note_frames; i += 4) {
+            const float4 value = float4::load4_aligned(&samples[i]) * volume;
+
+            (float4::load4_aligned(&left[i])  + value * left_gain).store4_aligned(&left[i]);
+            (float4::load4_aligned(&right[i]) + value * right_gain).store4_aligned(&right[i]);
+
+            volume = volume + step4;
+        }
+
+        voice.pos += num_note_frames;
+
+        if (voice.pos == voice.note_length)
+            release_note(voice);
+    }
+
+    voice.volume = mstd::min(mstd::max(voice.volume + voice.volume_step * static_cast<float>(num_frames), 0.0f), 1.0f);
+}
+
+uint32_t Tracker::Sequencer::render_block()
+{
+    alignas(16) float left[block_frames];
+    alignas(16) float right[block_frames];
+
+    mstd::mem_zero(left, static_cast<uint32_t>(sizeof(left)));
+    mstd::mem_zero(right, static_cast<uint32_t>(sizeof(right)));
+
+    uint32_t num_frames = 0;
+
+    while (num_frames < block_frames && ! ended) {
+        if ( ! row_pos)
+            process_row();
+
+        const uint32_t num_segment_frames = mstd::min(block_frames - num_frames, song->samples_per_row - row_pos);
+
+        for (uint32_t track = 0; track < song->num_tracks; track++)
+            render_voice(voices[track], num_segment_frames, &left[num_frames], &right[num_frames]);
+
+        num_frames += num_segment_frames;
+        row_pos    += num_segment_frames;
+
+        if (row_pos == song->samples_per_row) {
+            row_pos = 0;
+
+            if (++row == song->patterns[song->order[order_idx]].num_rows) {
+                row = 0;
+                ended = ++order_idx == song->order_length;
+            }
+        }
+    }
+
+    const float4 min_value = vmath::spread4(-1.0f);
+    const float4 max_value = vmath::spread4(1.0f);
+    const float4 scale     = vmath::spread4(32767.0f);
+
+    for (uint32_t i = 0; i < num_frames; i += 4) {
+        alignas(16) float left_values[4];
+        alignas(16) float right_values[4];
+
+        (vmath::min(vmath::max(float4::load4_aligned(&left[i]), min_value), max_value) * scale).store4_aligned(left_values);
+        (vmath::min(vmath::max(float4::load4_aligned(&right[i]), min_value), max_value) * scale).store4_aligned(right_values);
+
+        for (uint32_t j = 0; j < 4; j++) {
+            block[i + j].left  = static_cast<int16_t>(left_values[j]);
+            block[i + j].right = static_cast<int16_t>(right_values[j]);
+        }
+    }
+
+    return num_frames;
+}
+
+uint32_t Tracker::Sequencer::render(Sample16Stereo* frames, uint32_t num_frames)
+{
+    uint32_t num_rendered = 0;
+
+    while (num_rendered < num_frames) {
+        if (block_pos == block_size) {
+            if (ended)
+                break;
+
+            block_pos  = 0;
+            block_size = render_block();
+
+            if ( ! block_size)
+                break;
+        }
+
+        const uint32_t num_copied = mstd::min(num_frames - num_rendered, block_size - block_pos);
+
+        mstd::mem_copy(&frames[num_rendered], &block[block_pos], num_copied * static_cast<uint32_t>(sizeof(Sample16Stereo)));
+
+        num_rendered += num_copied;
+        block_pos    += num_copied;
+    }
+
+    return num_rendered;
+}
+
+uint32_t Tracker::Sequencer::render_stream(void* user, Sample16Stereo* frames, uint32_t num_frames)
+{
+    return static_cast<Sequencer*>(user)->render(frames, num_frames);
+}
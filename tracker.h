@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#pragma once
+
+#include "note_cache.h"
+#include "sound.h"
+#include "synth.h"
+
+// Tracker-style music: a song is a sequence of patterns, each pattern is a grid
+// of rows and tracks, and each cell can start or stop a note on its track.
+namespace Tracker {
+
+constexpr uint8_t note_none = 0;   // Cell does not change the note
+constexpr uint8_t note_off  = 128; // Cell stops the note playing on the track
+
+enum Effect : uint8_t {
+    effect_none,
+    effect_pan,         // Param 0 is left, 15 is right
+    effect_volume_up,   // Increase volume by param / 16 over the row
+    effect_volume_down  // Decrease volume by param / 16 over the row
+};
+
+struct Cell {
+    uint8_t note;       // MIDI note number 1..127, note_none or note_off
+    uint8_t instrument; // 1-based index of instrument, 0 reuses previous instrument on the track
+    uint8_t volume;     // Volume 1..255, 0 keeps current volume, which is 255 for a new note
+    uint8_t effect;     // Effect in high 4 bits, parameter in low 4 bits
+};
+
+struct Pattern {
+    const Cell* cells;  // num_rows * num_tracks cells, row by row
+    uint32_t    num_rows;
+};
+
+struct Song {
+    const Synth::Instrument* instruments;
+    const Pattern*           patterns;
+    const uint8_t*           order;           // Indices of patterns in playback order
+    uint32_t                 order_length;
+    uint32_t                 samples_per_row; // Must be a multiple of 4
+    uint32_t                 num_tracks;
+};
+
+constexpr uint32_t max_tracks = 8;
+
+uint32_t get_song_length(const Song& song);
+
+// Renders a song in fixed-size blocks on demand.  A note is rendered block by
+// block, so rendering a long note does not delay playback.
+class Sequencer {
+    public:
+        void start(const Song& new_song);
+
+        // Notes which repeat are read from the cache instead of being rendered again
+        void set_note_cache(NoteCache* cache) { note_cache = cache; }
+
+        // Returns fewer frames than requested when the song ends
+        uint32_t render(Sample16Stereo* frames, uint32_t num_frames);
+
+        // Can be used as SoundStreamConfig::render, with the sequencer as user
+        static uint32_t render_stream(void* user, Sample16Stereo* frames, uint32_t num_frames);
+
+        static constexpr uint32_t block_frames = 1024;
+
+    private:
+        struct Voice {
+            uint32_t instrument;     // 1-based, 0 if not set yet
+            uint32_t base_freq;
+            uint32_t note_length;    // Number of samples until the next note or note off
+            uint32_t pos;            // Number of samples rendered since note start
+            float    volume;
+            float    volume_step;    // Volume change per sample
+            float    pan;
+            uint32_t cache_entry = NoteCache::no_entry;
+            bool     cache_complete; // Samples are read from the cache entry
+            float    cache_step;     // Position increment in the cache entry per sample
+        };
+
+        void release_note(Voice& voice);
+        void process_row();
+        uint32_t get_note_length(uint32_t track) const;
+        void render_voice(Voice& voice, uint32_t num_frames, float* left, float* right);
+        uint32_t render_block();
+
+        const Song* song           = nullptr;
+        NoteCache*  note_cache     = nullptr;
+        uint32_t    order_idx      = 0;
+        uint32_t    row            = 0;
+        uint32_t    row_pos        = 0; // Samples rendered since row start
+        bool        ended          = true;
+        Voice       voices[max_tracks];
+
+        Sample16Stereo block[block_frames];
+        uint32_t       block_pos   = 0;
+        uint32_t       block_size  = 0;
+};
+
+} // namespace Tracker
@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright (c) 2021-2024 Chris Dragan
+
+#include "tracker.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST(test) if ( ! (test)) { failed(#test, __FILE__, __LINE__); }
+
+static int exit_code = 0;
+
+static void failed(const char* test, const char* file, int line)
+{
+    exit_code = 1;
+    fprintf(stderr, "%s:%d: Error: Failed condition %s\n",
+            file, line, test);
+}
+
+static int16_t to_int16(float value)
+{
+    value = (value < -1.0f) ? -1.0f : (value > 1.0f) ? 1.0f : value;
+    return static_cast<int16_t>(value * 32767.0f);
+}
+
+static bool is_near(int16_t value1, int16_t value2)
+{
+    return abs(value1 - value2) <= 1;
+}
+
+// Compares a channel of rendered frames against a note played on that channel alone
+static uint32_t count_mismatches(const Sample16Stereo* frames,
+                                 uint32_t              num_frames,
+                                 bool                  right,
+                                 const float*          note,
+                                 uint32_t              note_start,
+                                 uint32_t              note_length,
+                                 float                 volume)
+{
+    uint32_t num_mismatched = 0;
+
+    for (uint32_t i = 0; i < num_frames; i++) {
+        const int16_t actual   = right ? frames[i].right : frames[i].left;
+        const bool    playing  = (i >= note_start) && (i < note_start + note_length);
+        const int16_t expected = playing ? to_int16(note[i - note_start] * volume) : int16_t(0);
+
+        if ( ! is_near(actual, expected))
+            ++num_mismatched;
+    }
+
+    return num_mismatched;
+}
+
+static const Synth::Instrument instruments[] = {
+    {
+        { { Synth::wave_sine, 0, 300, 20, 0 } },
+        { { 0, 65535, 40000, 0, 10, 50, 0, 20 } },
+        {
+            { 1, Synth::wave_sine,     0, 0, 1, 1, 0 },
+            { 2, Synth::wave_triangle, 0, 0, 0, 1, 0 }
+        },
+        2
+    }
+};
+
+int main()
+{
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // note events of a pattern
+
+    {
+        // Track 0 plays A4 panned left for two rows, track 1 plays A3 panned right
+        // at half volume from the second row until the end of the song
+        static const Tracker::Cell cells[] = {
+            { 69,                 1, 0,   Tracker::effect_pan << 4        }, { Tracker::note_none, 0, 0, 0 },
+            { Tracker::note_none, 0, 0,   0                               }, { 57, 1, 128, (Tracker::effect_pan << 4) | 15 },
+            { Tracker::note_off,  0, 0,   0                               }, { Tracker::note_none, 0, 0, 0 },
+            { Tracker::note_none, 0, 0,   0                               }, { Tracker::note_none, 0, 0, 0 }
+        };
+        static const Tracker::Pattern patterns[] = { { cells, 4 } };
+        static const uint8_t          order[]    = { 0 };
+
+        constexpr uint32_t samples_per_row = 4408;
+
+        static const Tracker::Song song = { instruments, patterns, order, 1, samples_per_row, 2 };
+
+        const uint32_t song_length = Tracker::get_song_length(song);
+        TEST(song_length == 4 * samples_per_row);
+
+        static Tracker::Sequencer sequencer;
+        sequencer.start(song);
+
+        Sample16Stereo* const frames = static_cast<Sample16Stereo*>(malloc((song_length + 1000) * sizeof(Sample16Stereo)));
+
+        // Request sizes which do not match blocks or rows
+        uint32_t num_frames = 0;
+        for (;;) {
+            const uint32_t num_rendered = sequencer.render(&frames[num_frames], 777);
+            num_frames += num_rendered;
+            if (num_rendered < 777)
+                break;
+        }
+
+        TEST(num_frames == song_length);
+        TEST(sequencer.render(frames, 1) == 0);
+
+        // A4 is 440 Hz and A3 is 220 Hz
+        const uint32_t note0_length = 2 * samples_per_row;
+        const uint32_t note1_length = 3 * samples_per_row;
+
+        float* const note0 = static_cast<float*>(malloc(note0_length * sizeof(float)));
+        float* const note1 = static_cast<float*>(malloc(note1_length * sizeof(float)));
+
+        Synth::render_note(instruments[0], 440, note0_length, note0);
+        Synth::render_note(instruments[0], 220, note1_length, note1);
+
+        TEST(count_mismatches(frames, num_frames, false, note0, 0, note0_length, 1) == 0);
+        TEST(count_mismatches(frames, num_frames, true, note1, samples_per_row, note1_length, 128.0f / 255.0f) == 0);
+
+        free(note1);
+        free(note0);
+        free(frames);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////
+    // volume slide and empty song
+
+    {
+        static const Tracker::Cell cells[] = {
+            { 69,                 1, 0, (Tracker::effect_volume_down << 4) | 8 },
+            { Tracker::note_none, 0, 0, 0                                   }
+        };
+        static const Tracker::Pattern patterns[] = { { cells, 2 } };
+        static const uint8_t          order[]    = { 0 };
+
+        static const Tracker::Song song = { instruments, patterns, order, 1, 1024, 1 };
+
+        static Tracker::Sequencer sequencer;
+        sequencer.start(song);
+
+        static Sample16Stereo frames[2048];
+        TEST(sequencer.render(frames, 2048) == 2048);
+
+        // Volume drops by half over the first row and stays there in the second row
+        float note[2048];
+        Synth::render_note(instruments[0], 440, 2048, note);
+
+        uint32_t num_mismatched = 0;
+        for (uint32_t i = 0; i < 2048; i++) {
+            const float volume = (i < 1024) ? (1.0f - 0.5f * static_cast<float>(i) / 1024.0f) : 0.5f;
+            if ( ! is_near(frames[i].left, to_int16(note[i] * volume)))
+                ++num_mismatched;
+        }
+        TEST(num_mismatched == 0);
+
+        static const Tracker::Song empty_song = { instruments, patterns, order, 0, 1024, 1 };
+
+        sequencer.start(empty_song);
+        TEST(sequencer.render(frames, 2048) == 0);
+    }
+
+    return exit_code;
+}
@@ -18,7 +18,8 @@
 #define SUPPORTED_DEVICE_EXTENSIONS_BASE \
     X(VK_KHR_swapchain,                 REQUIRED) \
     X(VK_KHR_dynamic_rendering,         REQUIRED) \
-    X(VK_KHR_8bit_storage,              REQUIRED)
+    X(VK_KHR_8bit_storage,              REQUIRED) \
+    X(VK_EXT_mesh_shader,               OPTIONAL)
 
 #ifdef __APPLE__
 #   define SUPPORTED_INSTANCE_EXTENSIONS SUPPORTED_INSTANCE_EXTENSIONS_BASE \
@@ -74,9 +74,11 @@
     X(vkWaitForFences) \
     X(vkResetFences) \
     X(vkCreateSemaphore) \
+    X(vkWaitSemaphores) \
     X(vkAllocateMemory) \
     X(vkMapMemory) \
     X(vkFlushMappedMemoryRanges) \
+    X(vkInvalidateMappedMemoryRanges) \
     X(vkCreateImage) \
     X(vkDestroyImage) \
     X(vkGetImageMemoryRequirements) \
@@ -110,13 +112,19 @@
     X(vkCmdBindVertexBuffers) \
     X(vkCmdBindIndexBuffer) \
     X(vkCmdBindDescriptorSets) \
+    X(vkCmdPushConstants) \
     X(vkCmdSetViewport) \
     X(vkCmdSetScissor) \
     X(vkCmdDraw) \
     X(vkCmdDrawIndexed) \
+    X(vkCmdDrawIndirect) \
+    X(vkCmdDrawIndexedIndirect) \
     X(vkCmdPipelineBarrier) \
     X(vkCmdCopyBuffer) \
+    X(vkCmdFillBuffer) \
+    X(vkCmdUpdateBuffer) \
     X(vkCmdCopyImage) \
+    X(vkCmdCopyImageToBuffer) \
     X(vkCmdDispatch)
 
 extern PFN_vkVoidFunction vk_lib_functions[];
@@ -180,9 +188,11 @@ enum e_device_functions {
 #define vkWaitForFences                           SELECT_VK_FUNCTION(device,   vkWaitForFences)
 #define vkResetFences                             SELECT_VK_FUNCTION(device,   vkResetFences)
 #define vkCreateSemaphore                         SELECT_VK_FUNCTION(device,   vkCreateSemaphore)
+#define vkWaitSemaphores                          SELECT_VK_FUNCTION(device,   vkWaitSemaphores)
 #define vkAllocateMemory                          SELECT_VK_FUNCTION(device,   vkAllocateMemory)
 #define vkMapMemory                               SELECT_VK_FUNCTION(device,   vkMapMemory)
 #define vkFlushMappedMemoryRanges                 SELECT_VK_FUNCTION(device,   vkFlushMappedMemoryRanges)
+#define vkInvalidateMappedMemoryRanges            SELECT_VK_FUNCTION(device,   vkInvalidateMappedMemoryRanges)
 #define vkCreateImage                             SELECT_VK_FUNCTION(device,   vkCreateImage)
 #define vkDestroyImage                            SELECT_VK_FUNCTION(device,   vkDestroyImage)
 #define vkGetImageMemoryRequirements              SELECT_VK_FUNCTION(device,   vkGetImageMemoryRequirements)
@@ -216,11 +226,17 @@ enum e_device_functions {
 #define vkCmdBindVertexBuffers                    SELECT_VK_FUNCTION(device,   vkCmdBindVertexBuffers)
 #define vkCmdBindIndexBuffer                      SELECT_VK_FUNCTION(device,   vkCmdBindIndexBuffer)
 #define vkCmdBindDescriptorSets                   SELECT_VK_FUNCTION(device,   vkCmdBindDescriptorSets)
+#define vkCmdPushConstants                        SELECT_VK_FUNCTION(device,   vkCmdPushConstants)
 #define vkCmdSetViewport                          SELECT_VK_FUNCTION(device,   vkCmdSetViewport)
 #define vkCmdSetScissor                           SELECT_VK_FUNCTION(device,   vkCmdSetScissor)
 #define vkCmdDraw                                 SELECT_VK_FUNCTION(device,   vkCmdDraw)
 #define vkCmdDrawIndexed                          SELECT_VK_FUNCTION(device,   vkCmdDrawIndexed)
+#define vkCmdDrawIndirect                         SELECT_VK_FUNCTION(device,   vkCmdDrawIndirect)
+#define vkCmdDrawIndexedIndirect                  SELECT_VK_FUNCTION(device,   vkCmdDrawIndexedIndirect)
 #define vkCmdPipelineBarrier                      SELECT_VK_FUNCTION(device,   vkCmdPipelineBarrier)
 #define vkCmdCopyBuffer                           SELECT_VK_FUNCTION(device,   vkCmdCopyBuffer)
+#define vkCmdFillBuffer                           SELECT_VK_FUNCTION(device,   vkCmdFillBuffer)
+#define vkCmdUpdateBuffer                         SELECT_VK_FUNCTION(device,   vkCmdUpdateBuffer)
 #define vkCmdCopyImage                            SELECT_VK_FUNCTION(device,   vkCmdCopyImage)
+#define vkCmdCopyImageToBuffer                    SELECT_VK_FUNCTION(device,   vkCmdCopyImageToBuffer)
 #define vkCmdDispatch                             SELECT_VK_FUNCTION(device,   vkCmdDispatch)